@@ -31,10 +31,15 @@
 #include <vle/utils/Trace.hpp>
 #include <vle/utils/Path.hpp>
 #include <vle/utils/Package.hpp>
+#include <vle/utils/PackageBuilder.hpp>
 #include <vle/utils/Preferences.hpp>
 #include <vle/utils/RemoteManager.hpp>
 #include <vle/utils/i18n.hpp>
+#include <vle/vpz/Vpz.hpp>
+#include <vle/vpz/BaseModel.hpp>
+#include <vle/vpz/CompiledVpz.hpp>
 #include <vle/vle.hpp>
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
@@ -316,6 +321,47 @@ static bool init_package(vle::utils::Package& pkg, const CmdArgs &args)
     return true;
 }
 
+static bool show_package_depends(const vle::utils::Package& pkg)
+{
+    try {
+        vle::utils::PackageBuilder builder(1, std::cout, std::cerr);
+        builder.add(pkg.name());
+
+        std::vector < std::string > names = builder.order();
+        names.pop_back();
+        for (CmdArgs::const_iterator it = names.begin(); it != names.end();
+             ++it) {
+            std::cout << vle::fmt(_("%1% (source)\n")) % *it;
+        }
+
+        names = builder.installed();
+        for (CmdArgs::const_iterator it = names.begin(); it != names.end();
+             ++it) {
+            std::cout << vle::fmt(_("%1% (installed)\n")) % *it;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << vle::fmt(_("Depends error: %1%\n")) % e.what();
+        return false;
+    }
+
+    return true;
+}
+
+static bool build_package_depends(const vle::utils::Package& pkg,
+                                  int processor)
+{
+    try {
+        vle::utils::PackageBuilder builder(std::max(processor, 1), std::cerr,
+                                           std::cerr);
+        builder.add(pkg.name());
+
+        return builder.run();
+    } catch (const std::exception &e) {
+        std::cerr << vle::fmt(_("Build error: %1%\n")) % e.what();
+        return false;
+    }
+}
+
 static int manage_package_mode(const std::string &packagename, bool manager,
                                int processor, const CmdArgs &args)
 {
@@ -363,11 +409,9 @@ static int manage_package_mode(const std::string &packagename, bool manager,
             pkg.wait(std::cerr, std::cerr);
             stop = not pkg.isSuccess();
         } else if (*it == "all") {
-            std::cerr << "all is not yet implemented\n";
-            stop = true;
+            stop = not build_package_depends(pkg, processor);
         } else if (*it == "depends") {
-            std::cerr << "Depends is not yet implemented\n";
-            stop = true;
+            stop = not show_package_depends(pkg);
         } else if (*it == "list") {
             show_package_content(pkg);
         } else {
@@ -385,8 +429,6 @@ static int manage_package_mode(const std::string &packagename, bool manager,
         vle::devs::ExternalEvent::deallocated = 0;
         vle::devs::InternalEvent::allocated = 0;
         vle::devs::InternalEvent::deallocated = 0;
-        vle::value::Value::allocated = 0;
-        vle::value::Value::deallocated = 0;
 #endif
         if (manager)
             ret = run_manager(it, end, processor, pkg);
@@ -403,8 +445,8 @@ static int manage_package_mode(const std::string &packagename, bool manager,
             vle::devs::ExternalEvent::deallocated %
             vle::devs::InternalEvent::allocated %
             vle::devs::InternalEvent::deallocated %
-            vle::value::Value::allocated %
-            vle::value::Value::deallocated;
+            static_cast < long >(vle::value::Value::allocated) %
+            static_cast < long >(vle::value::Value::deallocated);
 #endif
     }
 
@@ -433,6 +475,10 @@ static int manage_remote_mode(const std::string &remotecmd, const CmdArgs &args)
         vle::utils::RemoteManager rm;
         rm.start(act, args.front(), &std::cout);
         rm.join();
+
+        if (rm.hasError()) {
+            ret = EXIT_FAILURE;
+        }
     } catch (const std::exception &e) {
         std::cerr << vle::fmt(_("Remote error: %1%\n")) % e.what();
         ret = EXIT_FAILURE;
@@ -475,6 +521,29 @@ static int manage_config_mode(const std::string &configvar, const CmdArgs &args)
     return ret;
 }
 
+static int manage_compile_mode(const CmdArgs &args)
+{
+    int ret = EXIT_SUCCESS;
+
+    for (CmdArgs::const_iterator it = args.begin(); it != args.end(); ++it) {
+        std::string output = *it + 'c';
+
+        try {
+            vle::vpz::Vpz vpz(*it);
+            vle::vpz::CompiledVpz::write(vpz, output);
+            delete vpz.project().model().model();
+
+            std::cout << vle::fmt(_("Compile `%1%' into `%2%'\n")) % *it %
+                output;
+        } catch (const std::exception &e) {
+            std::cerr << vle::fmt(_("Compile error: %1%\n")) % e.what();
+            ret = EXIT_FAILURE;
+        }
+    }
+
+    return ret;
+}
+
 enum ProgramOptionsCode
 {
     PROGRAM_OPTIONS_FAILURE = -1,
@@ -482,6 +551,7 @@ enum ProgramOptionsCode
     PROGRAM_OPTIONS_PACKAGE = 1,
     PROGRAM_OPTIONS_REMOTE = 2,
     PROGRAM_OPTIONS_CONFIG = 3,
+    PROGRAM_OPTIONS_COMPILE = 4,
 };
 
 struct ProgramOptions
@@ -506,7 +576,8 @@ struct ProgramOptions
                          " standard output"))
             ("manager,m", _("Use the manager mode to run experimental frames"))
             ("processor,o", po::value < int >(processor)->default_value(1),
-             _("Select number of processor in manager mode [>= 0]"))
+             _("Select number of processor in manager mode or of packages"
+               " built in parallel by the all command [>= 0]"))
             ("verbose,V", po::value < int >(verbose)->default_value(0),
              ("Verbose mode 0 - 3. [default 0]\n"
               "0 no trace and no long exception\n"
@@ -523,7 +594,8 @@ struct ProgramOptions
                  "vle -P foo clean: clean up the build directory\n"
                  "vle -P foo rclean: delete binary directories\n"
                  "vle -P foo package: build packages\n"
-                 "vle -P foo all: build all depends of foo package\n"
+                 "vle -P foo all: build foo and its source depends, -o"
+                 " packages in parallel\n"
                  "vle -P foo depends: list depends of foo package\n"
                  "vle -P foo list: list vpz and library package"))
             ("remote,R", po::value < std::string >(remotecmd),
@@ -540,6 +612,10 @@ struct ProgramOptions
                 " `variable'\n"
                 "vle -C vle.author me\n"
                 "vle -C gvle.editor.font Monospace 10"))
+            ("compile-vpz", _("Select compile mode,\n  compile-vpz [files]...\n"
+                "Write for each vpz file `foo.vpz' the binary file `foo.vpzc'"
+                " loaded without XML parsing by simulators.\n"
+                "vle --compile-vpz foo.vpz bar.vpz"))
             ;
 
         hidden.add_options()
@@ -598,14 +674,17 @@ struct ProgramOptions
 
             if (vm.count("config"))
                 return PROGRAM_OPTIONS_CONFIG;
+
+            if (vm.count("compile-vpz"))
+                return PROGRAM_OPTIONS_COMPILE;
         } catch (const std::exception &e) {
             std::cerr << e.what() << std::endl;
 
             return PROGRAM_OPTIONS_FAILURE;
         }
 
-        std::cerr << _("Nothing to do. Use package, remote or config mode."
-                " See the help.\n");
+        std::cerr << _("Nothing to do. Use package, remote, config or compile"
+                " mode. See the help.\n");
 
         return PROGRAM_OPTIONS_END;
     }
@@ -640,8 +719,9 @@ int main(int argc, char *argv[])
             return EXIT_SUCCESS;
     }
 
-    VLE app(verbose, trace); /* We are in package, remote or configuration
-                                mode, we need to initialize VLE's API. */
+    VLE app(verbose, trace); /* We are in package, remote, configuration or
+                                compile mode, we need to initialize VLE's
+                                API. */
 
     switch (ret) {
     case PROGRAM_OPTIONS_PACKAGE:
@@ -651,6 +731,8 @@ int main(int argc, char *argv[])
         return manage_remote_mode(remotecmd, args);
     case PROGRAM_OPTIONS_CONFIG:
         return manage_config_mode(configvar, args);
+    case PROGRAM_OPTIONS_COMPILE:
+        return manage_compile_mode(args);
     default:
         break;
     };
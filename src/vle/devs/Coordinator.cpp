@@ -73,12 +73,13 @@ Coordinator::~Coordinator()
 }
 
 void Coordinator::init(const vpz::Model& mdls, const Time& current,
-                       const Time& duration)
+                       const Time& duration, unsigned int threads)
 {
     m_currentTime = current;
     m_durationTime = duration;
     buildViews();
-    addModels(mdls);
+    addModels(mdls, threads);
+    buildSimulatorsTarget();
     m_toDelete = 0;
     m_isStarted = true;
 }
@@ -399,9 +400,17 @@ void Coordinator::delCoupledModel(vpz::CoupledModel* mdl)
                       std::mem_fun(&Coordinator::delAtomicModel), this));
 }
 
-void Coordinator::addModels(const vpz::Model& model)
+void Coordinator::addModels(const vpz::Model& model, unsigned int threads)
 {
-    m_modelFactory.createModels(*this, model);
+    m_modelFactory.createModels(*this, model, threads);
+}
+
+void Coordinator::buildSimulatorsTarget()
+{
+    for (SimulatorMap::iterator it = m_modelList.begin();
+         it != m_modelList.end(); ++it) {
+        it->second->updateSimulatorTargets(m_modelList);
+    }
 }
 
 void Coordinator::dispatchExternalEvent(ExternalEventList& eventList,
@@ -413,13 +422,9 @@ void Coordinator::dispatchExternalEvent(ExternalEventList& eventList,
         std::pair < Simulator::iterator, Simulator::iterator > x;
         x = sim->targets((*it)->getPortName(), m_modelList);
 
-        if (x.first != x.second and x.first->second.first) {
-            for (Simulator::iterator jt = x.first; jt != x.second; ++jt) {
-                m_eventTable.putExternalEvent(
-                    new ExternalEvent(*(*it),
-                                      jt->second.first,
-                                      jt->second.second));
-            }
+        for (Simulator::iterator jt = x.first; jt != x.second; ++jt) {
+            m_eventTable.putExternalEvent(
+                new ExternalEvent(*(*it), jt->first, jt->second));
         }
 
         delete (*it);
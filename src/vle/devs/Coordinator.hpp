@@ -65,11 +65,14 @@ public:
      * call for each Simulator the processInitEvent. Before this,
      * dispatchStateEvent is call for all StateEvent.
      *
+     * @param threads the number of threads used to build the atomic
+     * models, see ModelFactory::createModels.
+     *
      * @throw Exception::Internal if a condition have no model port name
      * associed.
      */
     void init(const vpz::Model& mdls, const Time& current,
-              const Time& duration);
+              const Time& duration, unsigned int threads = 1);
 
     /**
      * @brief Return the top devs::Time of the devs::EventTable.
@@ -341,8 +344,16 @@ private:
     /**
      * @brief build the simulator from the vpz::BaseModel stock.
      * @param model
+     * @param threads the number of threads used to build the models.
+     */
+    void addModels(const vpz::Model& model, unsigned int threads);
+
+    /**
+     * @brief Flatten the hierarchy of models: compute for all the output
+     * ports of each devs::Simulator the list of target simulators. The
+     * Executive updates these lists when it changes the structure.
      */
-    void addModels(const vpz::Model& model);
+    void buildSimulatorsTarget();
 
     /**
      * Read all ExternalEventList including External and Instantaneous
@@ -221,4 +221,10 @@ std::string Dynamics::getPackageExpFile(const std::string& name) const
     }
 }
 
+utils::TimeSeriesCache::TimeSeriesPtr Dynamics::getTimeSeries(
+    const std::string& name) const
+{
+    return utils::TimeSeriesCache::get(getPackageDataFile(name));
+}
+
 }} // namespace vle devs
@@ -41,6 +41,8 @@
 #include <vle/value/Boolean.hpp>
 #include <vle/value/String.hpp>
 #include <vle/utils/PackageTable.hpp>
+#include <vle/utils/Philox.hpp>
+#include <vle/utils/TimeSeries.hpp>
 #include <vle/version.hpp>
 #include <string>
 
@@ -78,8 +80,9 @@ namespace vle { namespace devs {
     {
     public:
         DynamicsInit(const vpz::AtomicModel& model,
-                     PackageId packageid)
-            : m_model(model), m_packageid(packageid)
+                     PackageId packageid,
+                     utils::Philox::key_type streamkey = 0)
+            : m_model(model), m_packageid(packageid), m_streamkey(streamkey)
         {}
 
         virtual ~DynamicsInit()
@@ -87,10 +90,12 @@ namespace vle { namespace devs {
 
         const vpz::AtomicModel& model() const { return m_model; }
         PackageId packageid() const { return m_packageid; }
+        utils::Philox::key_type streamkey() const { return m_streamkey; }
 
     private:
         const vpz::AtomicModel&       m_model;
         PackageId                       m_packageid;
+        utils::Philox::key_type         m_streamkey;
     };
 
     /**
@@ -108,7 +113,8 @@ namespace vle { namespace devs {
          */
         Dynamics(const DynamicsInit& init,
                  const vle::devs::InitEventList&  /* events */)
-            : m_model(init.model()), m_packageid(init.packageid())
+            : m_model(init.model()), m_packageid(init.packageid()),
+            m_streamkey(init.streamkey())
         {}
 
 	/**
@@ -444,6 +450,36 @@ namespace vle { namespace devs {
          */
         std::string getPackageExpFile(const std::string& name) const;
 
+        /**
+         * @brief Get the forcing data of a data package file. The file is
+         * read and mapped in memory once per process, all the models and
+         * threads share the same read-only time series.
+         * @param name The name of the file.
+         * @return The time series of the file.
+         * @throw utils::FileError if the package is not installed or if
+         * the file can not be read.
+         */
+        utils::TimeSeriesCache::TimeSeriesPtr getTimeSeries(
+            const std::string& name) const;
+
+        /*  - - - - - - - - - - - - - --ooOoo-- - - - - - - - - - - -  */
+
+        /**
+         * @brief Build the random stream of the model. The stream depends
+         * only on the seed of the experiment, the complete name of the model
+         * and the instance of the project, not on the order of construction
+         * of the models nor on the number of threads.
+         * @code
+         * // in the constructor:
+         * mRand = getRandomStream();
+         * // in a transition:
+         * double x = mRand.getDouble();
+         * @endcode
+         * @return A counter-based generator at the beginning of the stream.
+         */
+        utils::Philox getRandomStream() const
+        { return utils::Philox(m_streamkey); }
+
         /*  - - - - - - - - - - - - - --ooOoo-- - - - - - - - - - - -  */
 
         /**
@@ -460,6 +496,9 @@ namespace vle { namespace devs {
 
         PackageId m_packageid; /**< An iterator to std::set of the
                                  vle::utils::PackageTable. */
+
+        utils::Philox::key_type m_streamkey; /**< The key of the random
+                                               stream of the model. */
     };
 
 }} // namespace vle devs
@@ -36,16 +36,19 @@ DynamicsDbg::DynamicsDbg(const DynamicsInit& init,
     : Dynamics(init, events), mDynamics(0),
     mName(init.model().getCompleteName())
 {
-    TraceDevs(fmt(_("                     %1% [DEVS] constructor")) % mName);
+    TraceDevs(utils::TraceRecord(
+            _("                     %1% [DEVS] constructor")) % mName);
 }
 
 Time DynamicsDbg::init(const Time& time)
 {
-    TraceDevs(fmt(_("%1$20.10g %2% [DEVS] init")) % time % mName);
+    TraceDevs(utils::TraceRecord(
+            _("%1$20.10g %2% [DEVS] init")) % time % mName);
 
     Time duration(mDynamics->init(time));
 
-    TraceDevs(fmt(_("                .... %1% [DEVS] init returns %2%")) %
+    TraceDevs(utils::TraceRecord(
+            _("                .... %1% [DEVS] init returns %2%")) %
               mName % duration);
 
     return duration;
@@ -53,16 +56,17 @@ Time DynamicsDbg::init(const Time& time)
 
 void DynamicsDbg::output(const Time& time, ExternalEventList& output) const
 {
-    TraceDevs(fmt(_("%1$20.10g %2% [DEVS] output")) % time % mName);
+    TraceDevs(utils::TraceRecord(
+            _("%1$20.10g %2% [DEVS] output")) % time % mName);
 
     mDynamics->output(time, output);
 
     if (output.empty()) {
-        TraceDevs(fmt(
+        TraceDevs(utils::TraceRecord(
                 _("                .... %1% [DEVS] output returns "
                   "empty output")) % mName);
     } else {
-        TraceDevs(fmt(
+        TraceDevs(utils::TraceRecord(
                 _("                .... %1% [DEVS] output returns "
                   "%2%")) % mName % output);
     }
@@ -70,11 +74,13 @@ void DynamicsDbg::output(const Time& time, ExternalEventList& output) const
 
 Time DynamicsDbg::timeAdvance() const
 {
-    TraceDevs(fmt(_("                     %1% [DEVS] ta")) % mName);
+    TraceDevs(utils::TraceRecord(
+            _("                     %1% [DEVS] ta")) % mName);
 
     Time time(mDynamics->timeAdvance());
 
-    TraceDevs(fmt(_("                .... %1% [DEVS] ta returns %2%")) %
+    TraceDevs(utils::TraceRecord(
+            _("                .... %1% [DEVS] ta returns %2%")) %
               mName % time);
 
     return time;
@@ -82,7 +88,8 @@ Time DynamicsDbg::timeAdvance() const
 
 void DynamicsDbg::internalTransition(const Time& time)
 {
-    TraceDevs(fmt(_("%1$20.10g %2% [DEVS] internal transition")) % time %
+    TraceDevs(utils::TraceRecord(
+            _("%1$20.10g %2% [DEVS] internal transition")) % time %
               mName);
 
     mDynamics->internalTransition(time);
@@ -91,7 +98,8 @@ void DynamicsDbg::internalTransition(const Time& time)
 void DynamicsDbg::externalTransition(const ExternalEventList& event,
                                      const Time& time)
 {
-    TraceDevs(fmt(_("%1$20.10g %2% [DEVS] external transition: [%3%]")) % time
+    TraceDevs(utils::TraceRecord(
+            _("%1$20.10g %2% [DEVS] external transition: [%3%]")) % time
               % mName % event);
 
     mDynamics->externalTransition(event, time);
@@ -101,7 +109,7 @@ void DynamicsDbg::confluentTransitions(
     const Time& time,
     const ExternalEventList& extEventlist)
 {
-    TraceDevs(fmt(
+    TraceDevs(utils::TraceRecord(
             _("%1$20.10g %2% [DEVS] confluent transition: [%3%]")) % time %
         mName % extEventlist);
 
@@ -111,7 +119,8 @@ void DynamicsDbg::confluentTransitions(
 vle::value::Value* DynamicsDbg::observation(
     const ObservationEvent& event) const
 {
-    TraceDevs(fmt(_("%1$20.10g %2% [DEVS] observation: [from: '%3%'"
+    TraceDevs(utils::TraceRecord(
+            _("%1$20.10g %2% [DEVS] observation: [from: '%3%'"
                     " port: '%4%']")) % event.getTime() % mName
               % event.getViewName() % event.getPortName());
 
@@ -120,7 +129,8 @@ vle::value::Value* DynamicsDbg::observation(
 
 void DynamicsDbg::finish()
 {
-    TraceDevs(fmt(_("                     %1% [DEVS] finish")) % mName);
+    TraceDevs(utils::TraceRecord(
+            _("                     %1% [DEVS] finish")) % mName);
 
     mDynamics->finish();
 }
@@ -27,6 +27,8 @@
 
 #include <vle/devs/Executive.hpp>
 #include <vle/vpz/Vpz.hpp>
+#include <vle/vpz/ClassModel.hpp>
+#include <algorithm>
 
 namespace vle { namespace devs {
 
@@ -82,6 +84,60 @@ Executive::createModelFromClass(const std::string& classname,
     return m_coordinator.createModelFromClass(classname, cpled(), modelname);
 }
 
+vpz::LatticeModel* Executive::createLattice(const std::string& name,
+                                            unsigned int rows,
+                                            unsigned int columns)
+{
+    if (cpled()->exist(name)) {
+        throw utils::DevsGraphError(fmt(
+                _("Executive error: model `%1%' already exists")) % name);
+    }
+
+    return new vpz::LatticeModel(name, cpled(), rows, columns);
+}
+
+const vpz::AtomicModel*
+Executive::createCell(vpz::LatticeModel* lattice,
+                      unsigned int row,
+                      unsigned int column,
+                      const std::string& name,
+                      const std::vector < std::string >& inputs,
+                      const std::vector < std::string >& outputs,
+                      const std::string& dynamics,
+                      const std::vector < std::string >& conditions,
+                      const std::string& observable)
+{
+    if (not lattice or lattice->getParent() != cpled()) {
+        throw utils::DevsGraphError(fmt(
+                _("Executive error: the lattice is not a model of `%1%'")) %
+            cpled()->getName());
+    }
+
+    vpz::AtomicModel* model = lattice->addCell(row, column, name);
+    std::vector < std::string >::const_iterator it;
+
+    for (it = inputs.begin(); it != inputs.end(); ++it) {
+        model->addInputPort(*it);
+    }
+
+    for (it = outputs.begin(); it != outputs.end(); ++it) {
+        model->addOutputPort(*it);
+    }
+
+    m_coordinator.createModel(model, dynamics, conditions, observable);
+
+    UpdateList toupdate;
+    m_coordinator.getSimulatorsSource(model, toupdate);
+
+    Simulator* simulator = m_coordinator.getModel(model);
+    for (it = outputs.begin(); it != outputs.end(); ++it) {
+        toupdate.push_back(std::make_pair(simulator, *it));
+    }
+
+    updateSimulatorsTarget(toupdate);
+    return model;
+}
+
 void Executive::delModel(const std::string& modelname)
 {
     std::vector < std::pair < Simulator*, std::string > > toupdate;
@@ -93,11 +149,38 @@ void Executive::delModel(const std::string& modelname)
             modelname);
     }
 
+    flushInputs();
+
     m_coordinator.getSimulatorsSource(mdl, toupdate);
 
+    {
+        vpz::AtomicModelVector deleted;
+        vpz::BaseModel::getAtomicModelList(mdl, deleted);
+
+        std::vector < Simulator* > simulators;
+        for (vpz::AtomicModelVector::iterator it = deleted.begin();
+             it != deleted.end(); ++it) {
+            simulators.push_back(m_coordinator.getModel(*it));
+        }
+        std::sort(simulators.begin(), simulators.end());
+
+        UpdateList* lists[2] = { &toupdate, &m_changes };
+        for (int i = 0; i < 2; ++i) {
+            UpdateList::iterator it = lists[i]->begin();
+            while (it != lists[i]->end()) {
+                if (std::binary_search(simulators.begin(), simulators.end(),
+                                       it->first)) {
+                    it = lists[i]->erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+
     m_coordinator.delModel(cpled(), modelname);
 
-    m_coordinator.updateSimulatorsTarget(toupdate);
+    updateSimulatorsTarget(toupdate);
 }
 
 void Executive::renameModel(const std::string& oldname,
@@ -141,7 +224,7 @@ void Executive::addConnection(const std::string& srcModelName,
 
         if (modelName == srcModelName) {
             cpled()->addInputConnection(srcPortName, dstModel, dstPortName);
-            m_coordinator.getSimulatorsSource(srcModel, srcPortName, toupdate);
+            getSimulatorsSource(srcModel, srcPortName, toupdate);
         } else if (modelName == dstModelName) {
             cpled()->addOutputConnection(srcModel, srcPortName, dstPortName);
             vpz::ModelPortList lst;
@@ -149,16 +232,15 @@ void Executive::addConnection(const std::string& srcModelName,
 
             for (vpz::ModelPortList::iterator it = lst.begin(); it !=
                  lst.end(); ++it) {
-                m_coordinator.getSimulatorsSource(it->first, it->second,
-                                                  toupdate);
+                getSimulatorsSource(it->first, it->second, toupdate);
             }
         } else {
             cpled()->addInternalConnection(srcModel, srcPortName, dstModel,
                                            dstPortName);
-            m_coordinator.getSimulatorsSource(dstModel, dstPortName, toupdate);
+            getSimulatorsSource(dstModel, dstPortName, toupdate);
         }
 
-        m_coordinator.updateSimulatorsTarget(toupdate);
+        updateSimulatorsTarget(toupdate);
     } else {
         throw utils::DevsGraphError(fmt(
                 _("Executive error: cannot add connection (`%1%', `%2%') to "
@@ -197,7 +279,7 @@ void Executive::removeConnection(const std::string& srcModelName,
                                            dstPortName);
         }
 
-        m_coordinator.updateSimulatorsTarget(toupdate);
+        updateSimulatorsTarget(toupdate);
     } else {
         throw utils::DevsGraphError(fmt(
                 _("Executive error: cannot remove connection (%1%, %2%) to "
@@ -245,7 +327,7 @@ void Executive::removeInputPort(const std::string& modelName,
     std::vector < std::pair < Simulator*, std::string > > toupdate;
     m_coordinator.getSimulatorsSource(mdl, portName, toupdate);
     mdl->delInputPort(portName);
-    m_coordinator.updateSimulatorsTarget(toupdate);
+    updateSimulatorsTarget(toupdate);
 }
 
 void Executive::removeOutputPort(const std::string& modelName,
@@ -265,10 +347,81 @@ void Executive::removeOutputPort(const std::string& modelName,
         std::vector < std::pair < Simulator*, std::string > > toupdate;
         m_coordinator.getSimulatorsSource(mdl, portName, toupdate);
         mdl->delOutputPort(portName);
+        updateSimulatorsTarget(toupdate);
+    }
+}
+
+void Executive::beginChanges()
+{
+    m_changesDepth++;
+}
+
+void Executive::commitChanges()
+{
+    if (m_changesDepth == 0) {
+        throw utils::DevsGraphError(
+            _("Executive error: commit changes without begin changes"));
+    }
+
+    if (--m_changesDepth == 0) {
+        UpdateList toupdate;
+
+        flushInputs();
+        toupdate.swap(m_changes);
+        std::sort(toupdate.begin(), toupdate.end());
+        toupdate.erase(std::unique(toupdate.begin(), toupdate.end()),
+                       toupdate.end());
+
+        UpdateList::iterator it = toupdate.begin();
+        while (it != toupdate.end()) {
+            if (it->first and not it->first->getStructure()->existOutputPort(
+                    it->second)) {
+                it = toupdate.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        m_coordinator.updateSimulatorsTarget(toupdate);
+    }
+}
+
+void Executive::updateSimulatorsTarget(UpdateList& toupdate)
+{
+    if (m_changesDepth) {
+        m_changes.insert(m_changes.end(), toupdate.begin(), toupdate.end());
+    } else {
         m_coordinator.updateSimulatorsTarget(toupdate);
     }
 }
 
+void Executive::getSimulatorsSource(vpz::BaseModel* model,
+                                    const std::string& port,
+                                    UpdateList& toupdate)
+{
+    if (m_changesDepth) {
+        m_inputs.push_back(std::make_pair(model, port));
+    } else {
+        m_coordinator.getSimulatorsSource(model, port, toupdate);
+    }
+}
+
+void Executive::flushInputs()
+{
+    InputList inputs;
+
+    inputs.swap(m_inputs);
+    std::sort(inputs.begin(), inputs.end());
+    inputs.erase(std::unique(inputs.begin(), inputs.end()), inputs.end());
+
+    for (InputList::iterator it = inputs.begin(); it != inputs.end(); ++it) {
+        if (it->first->existInputPort(it->second)) {
+            m_coordinator.getSimulatorsSource(it->first, it->second,
+                                              m_changes);
+        }
+    }
+}
+
 void Executive::dump(std::ostream& out, const std::string& name) const
 {
     vpz::Vpz f;
@@ -300,4 +453,15 @@ void Executive::dump(std::ostream& out, const std::string& name) const
     f.project().model().setModel(0);
 }
 
+vpz::CoupledModel* Executive::cpled()
+{
+    vpz::CoupledModel* parent = getModel().getParent();
+
+    if (parent->isClass()) {
+        static_cast < vpz::ClassModel* >(parent)->expand();
+    }
+
+    return parent;
+}
+
 }} // namespace vle devs
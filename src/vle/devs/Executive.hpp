@@ -32,6 +32,7 @@
 #include <vle/devs/Coordinator.hpp>
 #include <vle/devs/Dynamics.hpp>
 #include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/LatticeModel.hpp>
 #include <vle/vpz/Dynamics.hpp>
 #include <vle/vpz/Conditions.hpp>
 #include <vle/vpz/Observables.hpp>
@@ -66,8 +67,10 @@ class VLE_API ExecutiveInit : public DynamicsInit
 public:
     ExecutiveInit(const vpz::AtomicModel& model,
                   PackageId packageid,
-                  Coordinator& coordinator)
-        : DynamicsInit(model, packageid), m_coordinator(coordinator)
+                  Coordinator& coordinator,
+                  utils::Philox::key_type streamkey = 0)
+        : DynamicsInit(model, packageid, streamkey),
+        m_coordinator(coordinator)
     {}
 
     virtual ~ExecutiveInit()
@@ -95,7 +98,8 @@ public:
      */
     Executive(const ExecutiveInit& init,
               const InitEventList& events)
-        : Dynamics(init, events), m_coordinator(init.coordinator())
+        : Dynamics(init, events), m_coordinator(init.coordinator()),
+        m_changesDepth(0)
     {}
 
     /**
@@ -216,6 +220,48 @@ public:
         createModelFromClass(const std::string& classname,
                              const std::string& modelname);
 
+    /**
+     * @brief Build a new empty vpz::LatticeModel in the coupled model. The
+     * neighbourhood, the wrap options and the fields of the lattice must be
+     * defined before the creation of the cells.
+     * @param name the name of the lattice.
+     * @param rows the number of rows.
+     * @param columns the number of columns.
+     * @return the new lattice.
+     * @throw utils::DevsGraphError if name already exist.
+     */
+    virtual vpz::LatticeModel* createLattice(const std::string& name,
+                                             unsigned int rows,
+                                             unsigned int columns);
+
+    /**
+     * @brief Build a new devs::Simulator for a cell of a lattice. The
+     * targets of the cell and of its neighbours are updated according to
+     * the stencil of the lattice.
+     * @param lattice the lattice built by createLattice.
+     * @param row the row of the cell.
+     * @param column the column of the cell.
+     * @param name the name of the vpz::AtomicModel to create.
+     * @param inputs the list of input ports.
+     * @param outputs the list of output ports.
+     * @param dynamics the name of the dynamics to attach.
+     * @param condition the list of condition to attach.
+     * @param observable the name of the observable to attach.
+     * @throw utils::DevsGraphError if the lattice does not belong to the
+     * coupled model or if the position is already used.
+     */
+    virtual const vpz::AtomicModel*
+        createCell(vpz::LatticeModel* lattice,
+                   unsigned int row,
+                   unsigned int column,
+                   const std::string& name,
+                   const std::vector < std::string >& inputs,
+                   const std::vector < std::string >& outputs,
+                   const std::string& dynamics,
+                   const std::vector < std::string >& conditions =
+                       std::vector < std::string >(),
+                   const std::string& observable = std::string());
+
     /**
      * @brief Delete the specified model from coupled model. All
      * connection are deleted, Simulator are deleted and all events are
@@ -314,6 +360,32 @@ public:
     virtual void removeOutputPort(const std::string& modelName,
                                   const std::string& portName);
 
+    /**
+     * @brief Start a group of structural changes. Until the matching
+     * commitChanges(), the models, the ports and the connections are
+     * modified immediately and the errors are reported immediately, but the
+     * routing tables of the simulators are updated only once per output
+     * port, at commit. The sources of the new connections are also
+     * searched once, at commit. Groups can be nested.
+     * @code
+     * beginChanges();
+     * for (int i = 0; i < n; ++i) {
+     *     addConnection(name(i), "out", name(i + 1), "in");
+     * }
+     * commitChanges();
+     * @endcode
+     */
+    void beginChanges();
+
+    /**
+     * @brief End a group of structural changes started by beginChanges()
+     * and, for the outermost group, update the routing tables of the
+     * simulators modified by the group.
+     *
+     * @throw utils::DevsGraphError if no group is started.
+     */
+    void commitChanges();
+
 
     // / / / /
     //
@@ -350,15 +422,55 @@ public:
     { return coupledmodel().getName(); }
 
 private:
+    typedef std::vector < std::pair < Simulator*, std::string > > UpdateList;
+
     Coordinator& m_coordinator; /**< A reference to the coordinator of this
                                   executive to allow modification of coupled
                                   model. */
 
+    UpdateList m_changes; /**< The output ports to update at the end of the
+                            current group of changes. */
+
+    typedef std::vector < std::pair < vpz::BaseModel*, std::string > >
+        InputList;
+
+    InputList m_inputs; /**< The input ports of the new connections, their
+                          sources are searched at the end of the current
+                          group of changes. */
+
+    unsigned int m_changesDepth; /**< The number of nested groups of
+                                   changes. */
+
     /**
-     * @brief Get a reference to the current coupled model.
+     * @brief Append the output ports connected to the input port of the
+     * model now or, in a group of changes, at the commit.
+     * @param model The model.
+     * @param port The input port.
+     * @param toupdate The output ports to update.
+     */
+    void getSimulatorsSource(vpz::BaseModel* model, const std::string& port,
+                             UpdateList& toupdate);
+
+    /**
+     * @brief Search the sources of the input ports stored by
+     * getSimulatorsSource() into the current group of changes.
+     */
+    void flushInputs();
+
+    /**
+     * @brief Update the routing tables of the output ports now or, in a
+     * group of changes, at the commit.
+     * @param toupdate The output ports to update.
+     */
+    void updateSimulatorsTarget(UpdateList& toupdate);
+
+    /**
+     * @brief Get a reference to the current coupled model. If the coupled
+     * model is a class instance, its connections are copied from its class
+     * before any structural change.
      * @return A reference to the coupled model.
      */
-    vpz::CoupledModel* cpled() { return getModel().getParent(); }
+    vpz::CoupledModel* cpled();
 };
 
 }} // namespace vle devs
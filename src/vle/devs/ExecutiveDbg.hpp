@@ -66,7 +66,8 @@ public:
         : UserModel(init, events), mCurrentTime(),
         mName(init.model().getCompleteName())
     {
-        TraceExtension(fmt(_("                     %1% [DEVS] constructor"))
+        TraceExtension(utils::TraceRecord(
+                _("                     %1% [DEVS] constructor"))
                        % mName);
     }
 
@@ -77,7 +78,7 @@ public:
     {
         mCurrentTime = time;
 
-        TraceDevs(fmt(_("%1$20.10g %2% [DEVS] init")) % time %
+        TraceDevs(utils::TraceRecord(_("%1$20.10g %2% [DEVS] init")) % time %
                   mName);
 
         return UserModel::init(time);
@@ -85,17 +86,17 @@ public:
 
     virtual void output(const Time& time, ExternalEventList& output) const
     {
-        TraceDevs(fmt(_("%1$20.10g %2% [DEVS] output")) % time %
+        TraceDevs(utils::TraceRecord(_("%1$20.10g %2% [DEVS] output")) % time %
                   mName);
 
         UserModel::output(time, output);
 
         if (output.empty()) {
-            TraceDevs(fmt(
+            TraceDevs(utils::TraceRecord(
                     _("                .... %1% [DEVS] output returns empty "
                       "output")) % mName);
         } else {
-            TraceDevs(fmt(
+            TraceDevs(utils::TraceRecord(
                     _("                .... %1% [DEVS] output returns %2%")) %
                 mName % output);
         }
@@ -103,12 +104,13 @@ public:
 
     virtual Time timeAdvance() const
     {
-        TraceDevs(fmt(_("                     %1% [DEVS] ta")) %
+        TraceDevs(utils::TraceRecord(_("                     %1% [DEVS] ta")) %
                   mName);
 
         Time time(UserModel::timeAdvance());
 
-        TraceDevs(fmt(_("                .... %1% [DEVS] ta returns %2%")) %
+        TraceDevs(utils::TraceRecord(
+                _("                .... %1% [DEVS] ta returns %2%")) %
                   mName % time);
 
         return time;
@@ -118,7 +120,8 @@ public:
     {
         mCurrentTime = time;
 
-        TraceDevs(fmt(_("%1$20.10g %2% [DEVS] internal transition")) % time %
+        TraceDevs(utils::TraceRecord(
+                _("%1$20.10g %2% [DEVS] internal transition")) % time %
                   mName);
 
         UserModel::internalTransition(time);
@@ -129,7 +132,8 @@ public:
     {
         mCurrentTime = time;
 
-        TraceDevs(fmt(_("%1$20.10g %2% [DEVS] external transition: [%3%]")) %
+        TraceDevs(utils::TraceRecord(
+                _("%1$20.10g %2% [DEVS] external transition: [%3%]")) %
                   time % mName % event);
 
         UserModel::externalTransition(event, time);
@@ -139,7 +143,7 @@ public:
         const Time& time,
         const ExternalEventList& extEventlist)
     {
-        TraceDevs(fmt(
+        TraceDevs(utils::TraceRecord(
                 _("%1$20.10g %2% [DEVS] confluent transition: [%3%]")) % time %
             mName % extEventlist);
 
@@ -149,7 +153,8 @@ public:
     virtual vle::value::Value* observation(
         const ObservationEvent& event) const
     {
-        TraceDevs(fmt(_("%1$20.10g %2% [DEVS] observation: [from: '%3%'"
+        TraceDevs(utils::TraceRecord(
+                _("%1$20.10g %2% [DEVS] observation: [from: '%3%'"
                         " port: '%4%']")) % event.getTime() % mName
                   % event.getViewName() % event.getPortName());
 
@@ -158,7 +163,8 @@ public:
 
     virtual void finish()
     {
-        TraceDevs(fmt(_("                     %1% [DEVS] finish")) %
+        TraceDevs(utils::TraceRecord(
+                _("                     %1% [DEVS] finish")) %
                   mName);
 
         UserModel::finish();
@@ -214,7 +220,7 @@ public:
             }
         }
 
-        TraceExtension(fmt(
+        TraceExtension(utils::TraceRecord(
                 _("%1$20.10g %2% [EXE] createModel "
                   "name: %3%, inputs: (%4%), output: (%5%), "
                   "dynamics %6%, conditions: (%7%), observable (%8%)")) %
@@ -236,7 +242,7 @@ public:
         const std::string& classname,
         const std::string& modelname)
     {
-        TraceExtension(fmt(
+        TraceExtension(utils::TraceRecord(
                 _("%1$20.10g %2% [EXE] createModelFromClass "
                   "class: %3%, modelname: %4%")) % mCurrentTime %
             mName % classname % modelname);
@@ -252,7 +258,7 @@ public:
      */
     virtual void delModel(const std::string& modelname)
     {
-        TraceExtension(fmt(
+        TraceExtension(utils::TraceRecord(
                 _("%1$20.10g %2% [EXE] delModel "
                   "model: %3%")) % mCurrentTime % mName %
             modelname);
@@ -265,7 +271,7 @@ public:
                                const std::string& modeldestination,
                                const std::string& inputport)
     {
-        TraceExtension(fmt(
+        TraceExtension(utils::TraceRecord(
                 _("%1$20.10g %2% [EXE] addConnection "
                   "from model: %3% port: %4% "
                   "to model %5% port: %6%")) % mCurrentTime %
@@ -281,7 +287,7 @@ public:
                                   const std::string& modeldestination,
                                   const std::string& inputport)
     {
-        TraceExtension(fmt(
+        TraceExtension(utils::TraceRecord(
                 _("%1$20.10g %2% [EXE] removeConnection "
                   "from model: %3% port: %4% "
                   "to model %5% port: %6%")) % mCurrentTime %
@@ -295,7 +301,7 @@ public:
     virtual void addInputPort(const std::string& modelName,
                               const std::string& portName)
     {
-        TraceExtension(fmt(
+        TraceExtension(utils::TraceRecord(
                 _("%1$20.10g %2% [EXE] addInputPort "
                   "model: %3%, port: %4%")) % mCurrentTime %
             mName % modelName % portName);
@@ -306,7 +312,7 @@ public:
     virtual void addOutputPort(const std::string& modelName,
                                const std::string& portName)
     {
-        TraceExtension(fmt(
+        TraceExtension(utils::TraceRecord(
                 _("%1$20.10g %2% [EXE] addOutputPort "
                   "model: %3%, port: %4%")) % mCurrentTime %
             mName % modelName % portName);
@@ -317,7 +323,7 @@ public:
     virtual void removeInputPort(const std::string& modelName,
                                  const std::string& portName)
     {
-        TraceExtension(fmt(
+        TraceExtension(utils::TraceRecord(
                 _("%1$20.10g %2% [EXE] removeInputPort "
                   "model: %3%, port: %4%")) % mCurrentTime %
             mName % modelName % portName);
@@ -328,7 +334,7 @@ public:
     virtual void removeOutputPort(const std::string& modelName,
                                   const std::string& portName)
     {
-        TraceExtension(fmt(
+        TraceExtension(utils::TraceRecord(
                 _("%1$20.10g %2% [EXE] removeOutputPort "
                   "model: %3%, port: %4%")) % mCurrentTime %
             mName % modelName % portName);
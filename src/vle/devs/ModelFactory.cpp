@@ -35,8 +35,11 @@
 #include <vle/vpz/BaseModel.hpp>
 #include <vle/vpz/AtomicModel.hpp>
 #include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/ClassModel.hpp>
 #include <vle/utils/Package.hpp>
 #include <vle/utils/Algo.hpp>
+#include <boost/thread/thread.hpp>
+#include <memory>
 
 namespace vle { namespace devs {
 
@@ -91,57 +94,79 @@ void ModelFactory::addPermanent(const vpz::Observable& observable)
     }
 }
 
-void ModelFactory::createModel(Coordinator& coordinator,
-                               vpz::AtomicModel* model,
-                               const std::string& dynamics,
-                               const std::vector < std::string >& conditions,
-                               const std::string& observable)
+void ModelFactory::fillInitValues(
+    const std::vector < std::string >& conditions,
+    value::Map& initValues) const
 {
-    const vpz::Dynamic& dyn = mDynamics.get(dynamics);
-
-    const SimulatorMap& result(coordinator.modellist());
-    if (result.find(model) != result.end()) {
-        throw utils::InternalError(fmt(_(
-                "The model '%1%' already exist in coordinator")) %
-            model->getName());
-    }
-
-    Simulator* sim = new Simulator(model);
-    coordinator.addModel(model, sim);
-
-    value::Map initValues;
-    if (not conditions.empty()) {
+    try {
         for (std::vector < std::string >::const_iterator it =
              conditions.begin(); it != conditions.end(); ++it) {
-	    const vpz::Condition& cnd(mExperiment.conditions().get(*it));
-	    value::MapValue vl;
-	    cnd.fillWithFirstValues(vl);
+            const vpz::ConditionValues& values(
+                mExperiment.conditions().get(*it).conditionvalues());
 
-	    for (value::MapValue::const_iterator itv = vl.begin();
-		 itv != vl.end(); ++itv) {
+            for (vpz::ConditionValues::const_iterator itv = values.begin();
+                 itv != values.end(); ++itv) {
 
                 if (initValues.exist(itv->first)) {
-                    initValues.value().clear();
                     throw utils::InternalError(fmt(_(
                             "Multiples condition with the same init port " \
                             "name '%1%'")) % itv->first);
                 }
-                initValues.add(itv->first, itv->second);
+                initValues.add(itv->first, itv->second->size() > 0 ?
+                               itv->second->get(0) : (value::Value*)0);
             }
-
-            vl.clear();
-	}
+        }
+    } catch(const std::exception& /*e*/) {
+        initValues.value().clear();
+        throw;
     }
+}
+
+void ModelFactory::createModel(Coordinator& coordinator,
+                               vpz::AtomicModel* model,
+                               const std::string& dynamics,
+                               const std::vector < std::string >& conditions,
+                               const std::string& observable)
+{
+    value::Map initValues;
+    fillInitValues(conditions, initValues);
 
     try {
-        sim->addDynamics(attachDynamics(coordinator, sim, dyn, initValues));
+        createSimulator(coordinator, model, dynamics, initValues, observable);
     } catch(const std::exception& /*e*/) {
         initValues.value().clear();
         throw;
     }
 
     initValues.value().clear();
+}
+
+void ModelFactory::createSimulator(Coordinator& coordinator,
+                                   vpz::AtomicModel* model,
+                                   const std::string& dynamics,
+                                   const InitEventList& initValues,
+                                   const std::string& observable)
+{
+    const vpz::Dynamic& dyn = mDynamics.get(dynamics);
 
+    const SimulatorMap& result(coordinator.modellist());
+    if (result.find(model) != result.end()) {
+        throw utils::InternalError(fmt(_(
+                "The model '%1%' already exist in coordinator")) %
+            model->getName());
+    }
+
+    Simulator* sim = new Simulator(model);
+    coordinator.addModel(model, sim);
+    sim->addDynamics(attachDynamics(coordinator, sim, dyn, initValues));
+
+    initSimulator(coordinator, sim, observable);
+}
+
+void ModelFactory::initSimulator(Coordinator& coordinator,
+                                 Simulator* sim,
+                                 const std::string& observable)
+{
     if (not observable.empty()) {
         vpz::Observable& ob(mExperiment.views().observables().get(observable));
         const vpz::ObservablePortList& lst(ob.observableportlist());
@@ -173,7 +198,8 @@ void ModelFactory::createModel(Coordinator& coordinator,
 }
 
 void ModelFactory::createModels(Coordinator& coordinator,
-                                const vpz::Model& model)
+                                const vpz::Model& model,
+                                unsigned int threads)
 {
     vpz::AtomicModelVector atomicmodellist;
     vpz::BaseModel* mdl = model.model();
@@ -185,6 +211,11 @@ void ModelFactory::createModels(Coordinator& coordinator,
             vpz::BaseModel::getAtomicModelList(mdl, atomicmodellist);
         }
 
+        if (threads > 1 and atomicmodellist.size() >= 2 * threads) {
+            createModelsParallel(coordinator, atomicmodellist, threads);
+            return;
+        }
+
         for (vpz::AtomicModelVector::iterator it = atomicmodellist.begin();
              it != atomicmodellist.end(); ++it) {
             createModel(coordinator,
@@ -202,7 +233,17 @@ vpz::BaseModel* ModelFactory::createModelFromClass(Coordinator& coordinator,
                                                  const std::string& modelname)
 {
     vpz::Class& classe(mClasses.get(classname));
-    vpz::BaseModel* mdl(classe.model()->clone());
+    const vpz::BaseModel* cls(classe.model());
+    vpz::BaseModel* mdl;
+
+    if (cls->isCoupled() and not cls->isLattice()) {
+        mdl = new vpz::ClassModel(modelname, 0,
+                                  static_cast < const vpz::CoupledModel* >(
+                                      cls));
+    } else {
+        mdl = cls->clone();
+    }
+
     vpz::AtomicModelVector atomicmodellist;
     vpz::BaseModel::getAtomicModelList(mdl, atomicmodellist);
     parent->addModel(mdl, modelname);
@@ -223,7 +264,8 @@ static devs::Dynamics* buildNewDynamicsWrapper(
     devs::Simulator* atom,
     const vpz::Dynamic& dyn,
     const InitEventList& events,
-    void* symbol)
+    void* symbol,
+    utils::Philox::key_type streamkey)
 {
     typedef Dynamics*(*fctdw)(const DynamicsWrapperInit&, const InitEventList&);
 
@@ -234,7 +276,7 @@ static devs::Dynamics* buildNewDynamicsWrapper(
         return fct(DynamicsWrapperInit(
                 *atom->getStructure(),
                 pkg_table.get(dyn.package()),
-                dyn.library()), events);
+                dyn.library(), streamkey), events);
     } catch(const std::exception& e) {
         throw utils::ModellingError(
             fmt(_("Atomic model wrapper `%1%:%2%' (from dynamics `%3%'"
@@ -250,7 +292,8 @@ static devs::Dynamics* buildNewDynamics(
     devs::Simulator* atom,
     const vpz::Dynamic& dyn,
     const InitEventList& events,
-    void *symbol)
+    void *symbol,
+    utils::Philox::key_type streamkey)
 {
     typedef Dynamics*(*fctdyn)(const DynamicsInit&, const InitEventList&);
 
@@ -260,7 +303,8 @@ static devs::Dynamics* buildNewDynamics(
         utils::PackageTable pkg_table;
         return fct(DynamicsInit(
                 *atom->getStructure(),
-                pkg_table.get(dyn.package())),
+                pkg_table.get(dyn.package()),
+                streamkey),
             events);
     } catch(const std::exception& e) {
         throw utils::ModellingError(
@@ -277,7 +321,8 @@ static devs::Dynamics* buildNewExecutive(
     devs::Simulator* atom,
     const vpz::Dynamic& dyn,
     const InitEventList& events,
-    void *symbol)
+    void *symbol,
+    utils::Philox::key_type streamkey)
 {
     typedef Dynamics*(*fctexe)(const ExecutiveInit&, const InitEventList&);
 
@@ -288,7 +333,7 @@ static devs::Dynamics* buildNewExecutive(
         return fct(ExecutiveInit(
                 *atom->getStructure(),
                 pkg_table.get(dyn.package()),
-                coordinator), events);
+                coordinator, streamkey), events);
     } catch(const std::exception& e) {
         throw utils::ModellingError(
             fmt(_("Executive model `%1%:%2%' (from dynamics `%3%'"
@@ -300,35 +345,201 @@ static devs::Dynamics* buildNewExecutive(
     }
 }
 
+void* ModelFactory::getSymbol(const vpz::Dynamic& dyn,
+                              utils::ModuleType* type)
+{
+    SymbolList::key_type key(dyn.package(), dyn.library());
+    SymbolList::iterator it = mSymbols.find(key);
+
+    if (it == mSymbols.end()) {
+        void *symbol = NULL;
+        utils::ModuleType newtype = utils::MODULE_DYNAMICS;
+
+        try {
+            symbol = mModuleMgr.get(dyn.package(), dyn.library(),
+                                    utils::MODULE_DYNAMICS, &newtype);
+        } catch (const std::exception& e) {
+            throw utils::ModellingError(fmt(
+                    _("Dynamic library loading problem: cannot get any"
+                      " dynamics, executive or wrapper '%1%' in library"
+                      " '%2%' package '%3%'\n:%4%")) % dyn.name() %
+                dyn.library() % dyn.package() % e.what());
+        }
+
+        it = mSymbols.insert(
+            std::make_pair(key, std::make_pair(symbol, newtype))).first;
+    }
+
+    *type = it->second.second;
+    return it->second.first;
+}
+
+utils::Philox::key_type ModelFactory::streamKey(
+    const vpz::AtomicModel* model) const
+{
+    return mRoot.stream(model->getCompleteName()).key();
+}
+
 devs::Dynamics* ModelFactory::attachDynamics(Coordinator& coordinator,
                                              devs::Simulator* atom,
                                              const vpz::Dynamic& dyn,
                                              const InitEventList& events)
 {
-    void *symbol = NULL;
-    utils::ModuleType type = utils::MODULE_DYNAMICS;
-
-    try {
-        symbol = mModuleMgr.get(dyn.package(), dyn.library(),
-                                utils::MODULE_DYNAMICS, &type);
-    } catch (const std::exception& e) {
-        throw utils::ModellingError(fmt(
-                _("Dynamic library loading problem: cannot get any"
-                  " dynamics, executive or wrapper '%1%' in library"
-                  " '%2%' package '%3%'\n:%4%")) % dyn.name() %
-            dyn.library() % dyn.package() % e.what());
-    }
+    utils::ModuleType type;
+    void *symbol = getSymbol(dyn, &type);
+    utils::Philox::key_type streamkey = streamKey(atom->getStructure());
 
     switch (type) {
     case utils::MODULE_DYNAMICS:
-        return buildNewDynamics(atom, dyn, events, symbol);
+        return buildNewDynamics(atom, dyn, events, symbol, streamkey);
     case utils::MODULE_DYNAMICS_EXECUTIVE:
-        return buildNewExecutive(coordinator, atom, dyn, events, symbol);
+        return buildNewExecutive(coordinator, atom, dyn, events, symbol,
+                                 streamkey);
     case utils::MODULE_DYNAMICS_WRAPPER:
-        return buildNewDynamicsWrapper(atom, dyn, events, symbol);
+        return buildNewDynamicsWrapper(atom, dyn, events, symbol,
+                                       streamkey);
     default:
         throw utils::ModellingError();
     }
 }
 
+/**
+ * An atomic model to build by the threads of
+ * ModelFactory::createModelsParallel.
+ */
+struct ModelFactory::ModelJob
+{
+    ModelJob()
+        : model(0), dynamic(0), symbol(0), type(utils::MODULE_DYNAMICS),
+        simulator(0), failed(false)
+    {
+    }
+
+    vpz::AtomicModel* model;
+    const vpz::Dynamic* dynamic;
+    void* symbol;
+    utils::ModuleType type;
+    Simulator* simulator;
+    bool failed;
+    std::string error;
+};
+
+/**
+ * A thread of ModelFactory::createModelsParallel: builds the simulators
+ * and the dynamics of the jobs index, index + step, index + 2 * step etc.
+ */
+class ModelFactory::ModelWorker
+{
+public:
+    ModelWorker(const ModelFactory& factory, std::vector < ModelJob >& jobs,
+                std::vector < ModelJob >::size_type index,
+                std::vector < ModelJob >::size_type step)
+        : mFactory(factory), mJobs(jobs), mIndex(index), mStep(step)
+    {
+    }
+
+    void operator()()
+    {
+        for (std::vector < ModelJob >::size_type i = mIndex;
+             i < mJobs.size(); i += mStep) {
+            ModelJob& job(mJobs[i]);
+
+            if (job.type == utils::MODULE_DYNAMICS_EXECUTIVE) {
+                continue;
+            }
+
+            value::Map initValues;
+
+            try {
+                mFactory.fillInitValues(job.model->conditions(), initValues);
+
+                std::auto_ptr < Simulator > sim(new Simulator(job.model));
+                utils::Philox::key_type streamkey =
+                    mFactory.streamKey(job.model);
+                if (job.type == utils::MODULE_DYNAMICS) {
+                    sim->addDynamics(buildNewDynamics(
+                            sim.get(), *job.dynamic, initValues, job.symbol,
+                            streamkey));
+                } else {
+                    sim->addDynamics(buildNewDynamicsWrapper(
+                            sim.get(), *job.dynamic, initValues, job.symbol,
+                            streamkey));
+                }
+                job.simulator = sim.release();
+            } catch (const std::exception& e) {
+                job.failed = true;
+                job.error.assign(e.what());
+            }
+
+            initValues.value().clear();
+        }
+    }
+
+private:
+    const ModelFactory& mFactory;
+    std::vector < ModelJob >& mJobs;
+    std::vector < ModelJob >::size_type mIndex;
+    std::vector < ModelJob >::size_type mStep;
+};
+
+void ModelFactory::createModelsParallel(
+    Coordinator& coordinator,
+    const vpz::AtomicModelVector& atomicmodellist,
+    unsigned int threads)
+{
+    std::vector < ModelJob > jobs(atomicmodellist.size());
+
+    for (std::vector < ModelJob >::size_type i = 0; i < jobs.size(); ++i) {
+        jobs[i].model = atomicmodellist[i];
+        jobs[i].dynamic = &mDynamics.get(atomicmodellist[i]->dynamics());
+        jobs[i].symbol = getSymbol(*jobs[i].dynamic, &jobs[i].type);
+    }
+
+    {
+        boost::thread_group group;
+
+        for (unsigned int i = 0; i < threads; ++i) {
+            group.create_thread(ModelWorker(*this, jobs, i, threads));
+        }
+
+        group.join_all();
+    }
+
+    std::vector < ModelJob >::size_type i = 0;
+
+    try {
+        for (; i < jobs.size(); ++i) {
+            ModelJob& job(jobs[i]);
+
+            if (job.type == utils::MODULE_DYNAMICS_EXECUTIVE) {
+                createModel(coordinator, job.model, job.model->dynamics(),
+                            job.model->conditions(),
+                            job.model->observables());
+                continue;
+            }
+
+            if (job.failed) {
+                throw utils::ModellingError(job.error);
+            }
+
+            const SimulatorMap& result(coordinator.modellist());
+            if (result.find(job.model) != result.end()) {
+                throw utils::InternalError(fmt(_(
+                            "The model '%1%' already exist in coordinator")) %
+                    job.model->getName());
+            }
+
+            Simulator* sim = job.simulator;
+            job.simulator = 0;
+            coordinator.addModel(job.model, sim);
+            initSimulator(coordinator, sim, job.model->observables());
+        }
+    } catch (const std::exception& /*e*/) {
+        for (; i < jobs.size(); ++i) {
+            delete jobs[i].simulator;
+        }
+        throw;
+    }
+}
+
 }} // namespace vle devs
@@ -37,7 +37,9 @@
 #include <vle/devs/InitEventList.hpp>
 #include <vle/devs/ExternalEventList.hpp>
 #include <vle/utils/ModuleManager.hpp>
+#include <vle/utils/Philox.hpp>
 #include <boost/noncopyable.hpp>
+#include <map>
 
 namespace vle { namespace devs {
 
@@ -210,11 +212,21 @@ public:
      * hierarchy.
      * @param coordinator the coordinator where attach the simulator.
      * @param model the hierachy of model (coupled model) or atomic model.
+     * @param threads the number of threads used to build the simulators
+     * and the dynamics of the atomic models. The executives are always
+     * built by the calling thread and the simulators are attached to the
+     * coordinator, the views and the event table in the order of the
+     * model list, whatever the number of threads. With several threads,
+     * the constructors of the dynamics must be thread-safe.
      */
-    void createModels(Coordinator& coordinator, const vpz::Model& vpmdl);
+    void createModels(Coordinator& coordinator, const vpz::Model& vpmdl,
+                      unsigned int threads = 1);
 
     /**
      * @brief Build a new devs::Simulator from the vpz::Classes information.
+     * A coupled class is instantiated as a vpz::ClassModel: the instances
+     * share the connections of the model of the class, which must not be
+     * modified during the simulation. The other classes are cloned.
      * @param classname the name of the class to clone.
      * @param modelname the new name of the model.
      * @throw utils::badArg if modelname already exist or if the classname
@@ -238,6 +250,83 @@ private:
                                            vpz::Experiment. */
     RootCoordinator&        mRoot;
 
+    /**
+     * The symbols of the dynamics already loaded, indexed by the package
+     * and the library of the vpz::Dynamic.
+     */
+    typedef std::map < std::pair < std::string, std::string >,
+                       std::pair < void*, utils::ModuleType > > SymbolList;
+
+    SymbolList              mSymbols; /**< The symbols already loaded. */
+
+    /**
+     * @brief Merge the first values of the conditions into a map. The
+     * values are not cloned, the map must be cleared before its deletion.
+     * @param conditions the names of the conditions.
+     * @param initValues [out] the map to fill.
+     * @throw utils::InternalError if two conditions have the same port.
+     */
+    void fillInitValues(const std::vector < std::string >& conditions,
+                        value::Map& initValues) const;
+
+    /**
+     * @brief Get the key of the random stream of an atomic model from the
+     * seed of the simulation and the complete name of the model.
+     * @param model the atomic model.
+     * @return The key given to the devs::DynamicsInit.
+     */
+    utils::Philox::key_type streamKey(const vpz::AtomicModel* model) const;
+
+    struct ModelJob;
+    class ModelWorker;
+    friend class ModelWorker;
+
+    /**
+     * @brief Build the simulators of the atomic models with several
+     * threads then attach them to the coordinator in the order of the
+     * list.
+     * @param coordinator the coordinator where attach the simulators.
+     * @param atomicmodellist the atomic models to build.
+     * @param threads the number of threads.
+     */
+    void createModelsParallel(Coordinator& coordinator,
+                              const vpz::AtomicModelVector& atomicmodellist,
+                              unsigned int threads);
+
+    /**
+     * @brief Get the symbol of the dynamics library.
+     * @param dyn the vpz::Dynamic to load.
+     * @param type [out] the type of the module.
+     * @return the symbol.
+     * @throw utils::ModellingError if the library cannot be loaded.
+     */
+    void* getSymbol(const vpz::Dynamic& dyn, utils::ModuleType* type);
+
+    /**
+     * @brief Attach the observables of the devs::Simulator to the views
+     * and push its first internal event.
+     * @param coordinator the coordinator of the simulator.
+     * @param sim the simulator to initialize.
+     * @param observable the name of the observable to attach.
+     */
+    void initSimulator(Coordinator& coordinator, Simulator* sim,
+                       const std::string& observable);
+
+    /**
+     * @brief Build the devs::Simulator of the model with the specified
+     * initial values.
+     * @param coordinator the coordinator where attach the simulator.
+     * @param model the vpz::AtomicModel source of the devs::Simulator.
+     * @param dynamics the name of the dynamics to attach.
+     * @param initValues the initial values of the dynamics.
+     * @param observable the name of the observable to attach.
+     */
+    void createSimulator(Coordinator& coordinator,
+                         vpz::AtomicModel* model,
+                         const std::string& dynamics,
+                         const InitEventList& initValues,
+                         const std::string& observable);
+
     /**
      * Try to open the plug-in and return the type of opened plugin
      * (MODULE_DYNAMICS, MODULE_DYNAMICS_WRAPPER or MODULE_EXECUTIVE).
@@ -31,6 +31,7 @@
 #include <vle/DllDefines.hpp>
 #include <vle/devs/Attribute.hpp>
 #include <vle/devs/Time.hpp>
+#include <vle/utils/Symbol.hpp>
 #include <vector>
 
 namespace vle { namespace devs {
@@ -45,10 +46,18 @@ class Simulator;
 class VLE_API ObservationEvent
 {
 public:
+    /**
+     * @brief Build an observation of a port. The view and port names are
+     * interned, the devs::View builds the events from its own symbols.
+     * @param time The date of the observation.
+     * @param model The observed model.
+     * @param viewname The name of the view.
+     * @param portName The name of the observed port.
+     */
     ObservationEvent(const Time& time,
                      Simulator* model,
-                     const std::string& viewname,
-                     const std::string& portName) :
+                     const utils::Symbol& viewname,
+                     const utils::Symbol& portName) :
         m_model(model),
         m_attributes(0),
         m_time(time),
@@ -63,10 +72,10 @@ public:
     }
 
     const std::string& getViewName() const
-    { return m_viewName; }
+    { return m_viewName.str(); }
 
     const std::string& getPortName() const
-    { return m_portName; }
+    { return m_portName.str(); }
 
     bool onPort(std::string const& portName) const
     { return m_portName == portName; }
@@ -231,8 +240,8 @@ private:
     Simulator  *m_model;
     value::Map *m_attributes;
     Time        m_time;
-    std::string m_viewName;
-    std::string m_portName;
+    utils::Symbol m_viewName;
+    utils::Symbol m_portName;
 };
 
 /**
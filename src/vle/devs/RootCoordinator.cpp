@@ -64,8 +64,9 @@ static value::Map * getMatrixFromView(const ViewList &views)
                        /* - - - - - - - - - -*/
 
 RootCoordinator::RootCoordinator(const utils::ModuleManager& modulemgr)
-    : m_rand(0), m_begin(0), m_currentTime(0), m_end(1.0), m_result(0),
-      m_coordinator(0), m_root(0), m_modulemgr(modulemgr)
+    : m_rand(0), m_seed(0), m_instance(0), m_begin(0), m_currentTime(0),
+      m_end(1.0), m_result(0), m_coordinator(0), m_root(0),
+      m_modulemgr(modulemgr)
 {
 }
 
@@ -75,7 +76,7 @@ RootCoordinator::~RootCoordinator()
     delete m_root;
 }
 
-void RootCoordinator::load(const vpz::Vpz& io)
+void RootCoordinator::load(const vpz::Vpz& io, unsigned int threads)
 {
     if (m_coordinator) {
         delete m_coordinator;
@@ -85,6 +86,8 @@ void RootCoordinator::load(const vpz::Vpz& io)
     m_begin = io.project().experiment().begin();
     m_end = m_begin + io.project().experiment().duration();
     m_currentTime = m_begin;
+    m_instance = io.project().instance();
+    setSeed(io.project().experiment().seed());
 
     m_coordinator = new Coordinator(m_modulemgr,
                                     io.project().dynamics(),
@@ -92,7 +95,7 @@ void RootCoordinator::load(const vpz::Vpz& io)
                                     io.project().experiment(),
                                     *this);
 
-    m_coordinator->init(io.project().model(), m_currentTime, m_end);
+    m_coordinator->init(io.project().model(), m_currentTime, m_end, threads);
 
     m_root = io.project().model().model();
 }
@@ -29,6 +29,7 @@
 #define DEVS_ROOTCOORDINATOR_HPP
 
 #include <vle/DllDefines.hpp>
+#include <vle/utils/Philox.hpp>
 #include <vle/utils/Rand.hpp>
 #include <vle/devs/Time.hpp>
 #include <vle/vpz/Vpz.hpp>
@@ -61,8 +62,10 @@ namespace vle { namespace devs {
          * @brief initialiase a new Coordinator with the specified vpz::Vpz
          * reference and intitialise the simulation time.
          * @param vp a reference to a structure.
+         * @param threads the number of threads used to build the atomic
+         * models.
          */
-        void load(const vpz::Vpz& vp);
+        void load(const vpz::Vpz& vp, unsigned int threads = 1);
 
         /**
          * @brief Initialise RootCoordinator and his Coordinator: initiale time
@@ -107,12 +110,44 @@ namespace vle { namespace devs {
          */
         utils::Rand& rand() { return m_rand; }
 
+        /**
+         * @brief Assign the seed of the random generator and of the
+         * streams of the models. The load() function uses the seed of the
+         * experiment.
+         * @param seed The new seed.
+         */
+        void setSeed(utils::Philox::key_type seed)
+        {
+            m_seed = seed;
+            m_rand.seed(static_cast < utils::Rand::result_type >(seed));
+        }
+
+        /**
+         * @brief Build the random stream of a model. The stream depends only
+         * on the seed of the simulation, the name of the model and the
+         * instance of the project, not on the order of construction of the
+         * models nor on the number of threads.
+         * @param name The complete name of the model.
+         * @return A counter-based generator.
+         */
+        utils::Philox stream(const std::string& name) const
+        {
+            return utils::Philox(
+                utils::Philox::derive(m_seed, name, m_instance));
+        }
+
     private:
         RootCoordinator(const RootCoordinator& other);
         RootCoordinator& operator=(const RootCoordinator& other);
 
         utils::Rand         m_rand;
 
+        /** @brief The seed of m_rand and of the streams of the models. */
+        utils::Philox::key_type m_seed;
+
+        /** @brief The instance of the project, ie. the replicate index. */
+        uint32_t            m_instance;
+
         /** @brief Store the beginning of the simulation. */
         devs::Time          m_begin;
 
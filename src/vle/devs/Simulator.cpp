@@ -29,10 +29,12 @@
 #include <vle/devs/Dynamics.hpp>
 #include <vle/devs/Time.hpp>
 #include <vle/vpz/AtomicModel.hpp>
+#include <algorithm>
 
 namespace vle { namespace devs {
 
 Simulator::Simulator(vpz::AtomicModel* atomic) :
+    mTargetOffsets(1, 0),
     m_dynamics(0),
     m_atomicModel(atomic)
 {
@@ -54,36 +56,92 @@ void Simulator::clear()
     m_atomicModel = 0;
 }
 
+bool Simulator::findTargets(
+    const utils::Symbol& port,
+    std::map < vpz::AtomicModel*, devs::Simulator* >& simulators,
+    TargetSimulatorList& result) const
+{
+    vpz::ModelPortList lst;
+    m_atomicModel->getAtomicModelsTarget(port, lst);
+
+    for (vpz::ModelPortList::iterator it = lst.begin(); it != lst.end();
+         ++it) {
+        std::map < vpz::AtomicModel*, devs::Simulator* >::iterator target;
+        target = simulators.find(
+            reinterpret_cast < vpz::AtomicModel*>(it->first));
+
+        if (target == simulators.end()) {
+            return false;
+        }
+
+        result.push_back(TargetSimulator(target->second, it->second));
+    }
+
+    return true;
+}
+
+void Simulator::setTargets(const utils::Symbol& port,
+                           const TargetSimulatorList& result)
+{
+    std::vector < utils::Symbol >::iterator it =
+        std::lower_bound(mTargetPorts.begin(), mTargetPorts.end(), port);
+    size_type index = it - mTargetPorts.begin();
+
+    if (it == mTargetPorts.end() or *it != port) {
+        mTargetPorts.insert(it, port);
+        mTargetOffsets.insert(mTargetOffsets.begin() + index,
+                              mTargetOffsets[index]);
+    }
+
+    size_type first = mTargetOffsets[index];
+    size_type last = mTargetOffsets[index + 1];
+
+    mTargets.erase(mTargets.begin() + first, mTargets.begin() + last);
+    mTargets.insert(mTargets.begin() + first, result.begin(), result.end());
+
+    for (size_type i = index + 1; i < mTargetOffsets.size(); ++i) {
+        mTargetOffsets[i] += result.size();
+        mTargetOffsets[i] -= last - first;
+    }
+}
+
 void
 Simulator::updateSimulatorTargets(
-        const std::string& port,
+        const utils::Symbol& port,
         std::map < vpz::AtomicModel*, devs::Simulator* >& simulators)
 {
-    mTargets.erase(port);
+    TargetSimulatorList result;
 
-    vpz::ModelPortList result;
-    m_atomicModel->getAtomicModelsTarget(port, result);
-
-    if (result.begin() == result.end()) {
-        mTargets.insert(value_type(port, TargetSimulator(
-                   (Simulator*)0, std::string())));
+    if (findTargets(port, simulators, result)) {
+        setTargets(port, result);
     } else {
-        for (vpz::ModelPortList::iterator it = result.begin(); it !=
-                result.end(); ++it) {
-
-            std::map < vpz::AtomicModel*, devs::Simulator* >::iterator target;
-            target = simulators.find(
-                    reinterpret_cast < vpz::AtomicModel*>(it->first));
-
-            if (target == simulators.end()) {
-                mTargets.erase(port);
-                break;
-            } else {
-                mTargets.insert(std::make_pair(port, TargetSimulator(
-                            target->second, it->second)));
-            }
+        removeTargetPort(port);
+    }
+}
+
+void
+Simulator::updateSimulatorTargets(
+        std::map < vpz::AtomicModel*, devs::Simulator* >& simulators)
+{
+    std::vector < utils::Symbol > ports;
+    std::vector < size_type > offsets(1, 0);
+    TargetSimulatorList targets;
+
+    const vpz::ConnectionList& outs(m_atomicModel->getOutputPortList());
+    for (vpz::ConnectionList::const_iterator it = outs.begin();
+         it != outs.end(); ++it) {
+        TargetSimulatorList result;
+
+        if (findTargets(it->first, simulators, result)) {
+            ports.push_back(it->first);
+            targets.insert(targets.end(), result.begin(), result.end());
+            offsets.push_back(targets.size());
         }
     }
+
+    mTargetPorts.swap(ports);
+    mTargetOffsets.swap(offsets);
+    mTargets.swap(targets);
 }
 
 std::pair < Simulator::iterator, Simulator::iterator >
@@ -91,34 +149,48 @@ Simulator::targets(
     const std::string& port,
     std::map < vpz::AtomicModel*, devs::Simulator* >& simulators)
 {
-    std::pair < iterator, iterator > x = mTargets.equal_range(port);
+    std::vector < utils::Symbol >::iterator it =
+        std::lower_bound(mTargetPorts.begin(), mTargetPorts.end(), port);
 
-    if (x.first == x.second) {
+    if (it == mTargetPorts.end() or *it != port) {
         updateSimulatorTargets(port, simulators);
-        x = mTargets.equal_range(port);
-    } else if (x.first->second.first == 0) {
-        x = make_pair(mTargets.end(), mTargets.end());
+
+        it = std::lower_bound(mTargetPorts.begin(), mTargetPorts.end(),
+                              port);
+        if (it == mTargetPorts.end() or *it != port) {
+            return std::make_pair(mTargets.end(), mTargets.end());
+        }
     }
 
-    return x;
+    size_type index = it - mTargetPorts.begin();
+
+    return std::make_pair(mTargets.begin() + mTargetOffsets[index],
+                          mTargets.begin() + mTargetOffsets[index + 1]);
 }
 
-void Simulator::removeTargetPort(const std::string& port)
+void Simulator::removeTargetPort(const utils::Symbol& port)
 {
-    iterator it = mTargets.find(port);
+    std::vector < utils::Symbol >::iterator it =
+        std::lower_bound(mTargetPorts.begin(), mTargetPorts.end(), port);
 
-    if (it != mTargets.end()) {
-        mTargets.erase(it);
+    if (it != mTargetPorts.end() and *it == port) {
+        size_type index = it - mTargetPorts.begin();
+        size_type first = mTargetOffsets[index];
+        size_type last = mTargetOffsets[index + 1];
+
+        mTargets.erase(mTargets.begin() + first, mTargets.begin() + last);
+        mTargetPorts.erase(it);
+        mTargetOffsets.erase(mTargetOffsets.begin() + index + 1);
+
+        for (size_type i = index + 1; i < mTargetOffsets.size(); ++i) {
+            mTargetOffsets[i] -= last - first;
+        }
     }
 }
 
-void Simulator::addTargetPort(const std::string& port)
+void Simulator::addTargetPort(const utils::Symbol& port)
 {
-    assert(mTargets.find(port) == mTargets.end());
-
-    mTargets.insert(value_type(port,
-                               TargetSimulator((Simulator*)0,
-                                               std::string())));
+    setTargets(port, TargetSimulatorList());
 }
 
 void Simulator::addDynamics(Dynamics* dynamics)
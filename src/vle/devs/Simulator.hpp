@@ -35,6 +35,9 @@
 #include <vle/devs/ExternalEventList.hpp>
 #include <vle/devs/Dynamics.hpp>
 #include <vle/vpz/AtomicModel.hpp>
+#include <vle/utils/Symbol.hpp>
+#include <map>
+#include <vector>
 
 namespace vle { namespace devs {
 
@@ -48,9 +51,8 @@ namespace vle { namespace devs {
     class VLE_API Simulator
     {
     public:
-        typedef std::pair < Simulator*, std::string > TargetSimulator;
-        typedef std::multimap < std::string, TargetSimulator >
-            TargetSimulatorList;
+        typedef std::pair < Simulator*, utils::Symbol > TargetSimulator;
+        typedef std::vector < TargetSimulator > TargetSimulatorList;
         typedef TargetSimulatorList::const_iterator const_iterator;
         typedef TargetSimulatorList::iterator iterator;
         typedef TargetSimulatorList::size_type size_type;
@@ -117,16 +119,28 @@ namespace vle { namespace devs {
         /**
          * @brief Call this function to browse the model's structure (atomic
          * and coupled models) to find all devs::Simulator connected to the
-         * specified output port.
+         * specified output port. The targets of the port are replaced in
+         * the flattened list of targets, the other ports are kept.
          * @param port The output port used to build simulators' target list.
          * @param simulators list of available simulators.
          */
         void updateSimulatorTargets(
-            const std::string& port,
+            const utils::Symbol& port,
+            std::map < vpz::AtomicModel*, devs::Simulator* >& simulators);
+
+        /**
+         * @brief Rebuild the flattened list of targets of all the output
+         * ports of the vpz::AtomicModel. This function is called by the
+         * devs::Coordinator when all the simulators are built to avoid the
+         * browse of the model's structure during the simulation.
+         * @param simulators list of available simulators.
+         */
+        void updateSimulatorTargets(
             std::map < vpz::AtomicModel*, devs::Simulator* >& simulators);
 
         /**
-         * @brief Get two iterators (begin, end) on TargetSimulator.
+         * @brief Get two iterators (begin, end) on TargetSimulator. If the
+         * targets of the port are unknown, they are computed.
          * @param port The output port to get the simulators' target list.
          * @param simulators list of available simulators.
          * @return Two iterators.
@@ -136,16 +150,17 @@ namespace vle { namespace devs {
             std::map < vpz::AtomicModel*, devs::Simulator* >& simulators);
 
         /**
-         * @brief Add an empty target port.
+         * @brief Remove the targets of a port. They will be computed at
+         * the next use of the port.
          * @param port Name of the port.
          */
-        void removeTargetPort(const std::string& port);
+        void removeTargetPort(const utils::Symbol& port);
 
         /**
-         * @brief Remove a target port.
-         * @param port Name of the port to remove.
+         * @brief Add a port without target.
+         * @param port Name of the port to add.
          */
-        void addTargetPort(const std::string& port);
+        void addTargetPort(const utils::Symbol& port);
 
                              /*-*-*-*-*-*-*-*-*-*/
 
@@ -175,12 +190,41 @@ namespace vle { namespace devs {
         value::Value* observation(const ObservationEvent& event) const;
 
     private:
-        TargetSimulatorList mTargets;
+        /**
+         * The targets of the output ports are stored as a compressed sparse
+         * row: the targets of the port mTargetPorts[i] are the elements
+         * [mTargetOffsets[i], mTargetOffsets[i + 1]) of mTargets. The
+         * ports are sorted by name. A port without entry has unknown
+         * targets.
+         */
+        std::vector < utils::Symbol > mTargetPorts;
+        std::vector < size_type >   mTargetOffsets;
+        TargetSimulatorList         mTargets;
         Dynamics*           m_dynamics;
         vpz::AtomicModel*   m_atomicModel;
         std::string         m_parents;
 
 	InternalEvent* buildInternalEvent(const Time& currentTime);
+
+        /**
+         * @brief Find the simulators connected to the output port.
+         * @param port The output port.
+         * @param simulators list of available simulators.
+         * @param result [out] The list of targets.
+         * @return false if a target has no simulator yet.
+         */
+        bool findTargets(const utils::Symbol& port,
+                         std::map < vpz::AtomicModel*,
+                                    devs::Simulator* >& simulators,
+                         TargetSimulatorList& result) const;
+
+        /**
+         * @brief Replace the targets of the port in the flattened list.
+         * @param port The output port.
+         * @param result The new list of targets.
+         */
+        void setTargets(const utils::Symbol& port,
+                        const TargetSimulatorList& result);
     };
 
 }} // namespace vle devs
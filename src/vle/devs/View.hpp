@@ -32,6 +32,7 @@
 #include <vle/devs/StreamWriter.hpp>
 #include <vle/devs/Time.hpp>
 #include <vle/value/Matrix.hpp>
+#include <vle/utils/Symbol.hpp>
 #include <string>
 #include <map>
 
@@ -41,7 +42,7 @@ class Simulator;
 class StreamWriter;
 class View;
 
-typedef std::multimap < Simulator*, std::string > ObservableList;
+typedef std::multimap < Simulator*, utils::Symbol > ObservableList;
 typedef std::map < std::string, View* > ViewList;
 
 /**
@@ -111,7 +112,7 @@ public:
     //
 
     inline const std::string& getName() const
-    { return m_name; }
+    { return m_name.str(); }
 
     inline const ObservableList& getObservableList() const
     { return m_observableList; }
@@ -136,7 +137,7 @@ public:
 
 protected:
     ObservableList      m_observableList;
-    std::string         m_name;
+    utils::Symbol       m_name;
     StreamWriter*       m_stream;
     size_t              m_size;
 };
@@ -36,13 +36,24 @@
 #include <stdexcept>
 #include <limits>
 #include <fstream>
+#include <cstdio>
+#include <set>
+#include <algorithm>
 #include <vle/devs/Coordinator.hpp>
+#include <vle/devs/Executive.hpp>
 #include <vle/devs/RootCoordinator.hpp>
+#include <vle/vpz/ClassModel.hpp>
 #include <vle/vpz/CoupledModel.hpp>
 #include <vle/vpz/Dynamics.hpp>
 #include <vle/vpz/Experiment.hpp>
 #include <vle/vpz/Classes.hpp>
+#include <vle/translator/GraphTranslator.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/oov/Plugin.hpp>
 #include <vle/utils/ModuleManager.hpp>
+#include <vle/utils/Path.hpp>
 
 using namespace vle;
 
@@ -65,3 +76,748 @@ BOOST_AUTO_TEST_CASE(test_del_coupled_model)
     delete depth0;
     delete simdepth2;
 }
+
+BOOST_AUTO_TEST_CASE(test_simulator_targets)
+{
+    vpz::CoupledModel* top = new vpz::CoupledModel("top", 0);
+    vpz::AtomicModel* a = top->addAtomicModel("a");
+    vpz::AtomicModel* b = top->addAtomicModel("b");
+    vpz::AtomicModel* c = top->addAtomicModel("c");
+    vpz::CoupledModel* sub = top->addCoupledModel("sub");
+    vpz::AtomicModel* d = sub->addAtomicModel("d");
+
+    a->addOutputPort("out");
+    a->addOutputPort("other");
+    b->addInputPort("in");
+    c->addInputPort("in");
+    sub->addInputPort("in");
+    d->addInputPort("in");
+    top->addInternalConnection("a", "out", "b", "in");
+    top->addInternalConnection("a", "out", "sub", "in");
+    sub->addInputConnection("in", "d", "in");
+
+    std::map < vpz::AtomicModel*, devs::Simulator* > simulators;
+    devs::Simulator* sa = new devs::Simulator(a);
+    devs::Simulator* sb = new devs::Simulator(b);
+    devs::Simulator* sc = new devs::Simulator(c);
+    devs::Simulator* sd = new devs::Simulator(d);
+    simulators[a] = sa;
+    simulators[b] = sb;
+    simulators[d] = sd;
+
+    sa->updateSimulatorTargets(simulators);
+
+    std::pair < devs::Simulator::iterator, devs::Simulator::iterator > x;
+    x = sa->targets("out", simulators);
+    BOOST_REQUIRE_EQUAL(x.second - x.first, 2);
+    BOOST_REQUIRE_EQUAL(x.first->second, "in");
+
+    x = sa->targets("other", simulators);
+    BOOST_REQUIRE(x.first == x.second);
+
+    top->addInternalConnection("a", "other", "c", "in");
+    sa->updateSimulatorTargets("other", simulators);
+    x = sa->targets("other", simulators);
+    BOOST_REQUIRE(x.first == x.second);
+
+    simulators[c] = sc;
+    sa->updateSimulatorTargets("other", simulators);
+    x = sa->targets("other", simulators);
+    BOOST_REQUIRE_EQUAL(x.second - x.first, 1);
+    BOOST_REQUIRE_EQUAL(x.first->first, sc);
+
+    top->addInternalConnection("a", "out", "c", "in");
+    sa->removeTargetPort("out");
+    x = sa->targets("out", simulators);
+    BOOST_REQUIRE_EQUAL(x.second - x.first, 3);
+    x = sa->targets("other", simulators);
+    BOOST_REQUIRE_EQUAL(x.second - x.first, 1);
+    BOOST_REQUIRE_EQUAL(x.first->first, sc);
+
+    delete sa;
+    delete sb;
+    delete sc;
+    delete sd;
+    delete top;
+}
+
+class TestRandom : public devs::Dynamics
+{
+public:
+    TestRandom(const devs::DynamicsInit& init,
+               const devs::InitEventList& events)
+        : devs::Dynamics(init, events)
+    {}
+};
+
+BOOST_AUTO_TEST_CASE(test_random_streams)
+{
+    utils::ModuleManager modules;
+    devs::RootCoordinator root(modules);
+    vpz::CoupledModel* top = new vpz::CoupledModel("top", 0);
+    vpz::AtomicModel* a = top->addAtomicModel("a");
+    devs::InitEventList events;
+
+    root.setSeed(1234);
+    utils::Philox first = root.stream(a->getCompleteName());
+    utils::Philox other = root.stream("top:b");
+    TestRandom dyn(devs::DynamicsInit(*a, devs::PackageId(), first.key()),
+                   events);
+    utils::Philox fromdyn = dyn.getRandomStream();
+
+    root.setSeed(4321);
+    utils::Philox second = root.stream(a->getCompleteName());
+    root.setSeed(1234);
+    utils::Philox again = root.stream(a->getCompleteName());
+
+    BOOST_REQUIRE(first.key() != second.key());
+    BOOST_REQUIRE(first.key() != other.key());
+    BOOST_REQUIRE_EQUAL(first.key(), again.key());
+
+    bool differ = false;
+    for (int i = 0; i < 16; ++i) {
+        utils::Philox::result_type x = first();
+        BOOST_REQUIRE_EQUAL(x, again());
+        BOOST_REQUIRE_EQUAL(x, fromdyn());
+        differ = differ or x != second();
+    }
+    BOOST_REQUIRE(differ);
+
+    delete top;
+}
+
+class TestExecutive : public devs::Executive
+{
+public:
+    TestExecutive(const devs::ExecutiveInit& init,
+                  const devs::InitEventList& events)
+        : devs::Executive(init, events)
+    {}
+};
+
+BOOST_AUTO_TEST_CASE(test_executive_changes)
+{
+    utils::ModuleManager modules;
+    vpz::Dynamics dyns;
+    vpz::Classes classes;
+    vpz::Experiment expe;
+    devs::RootCoordinator root(modules);
+    devs::Coordinator coord(modules, dyns, classes, expe, root);
+
+    vpz::Model empty;
+    empty.setModel(new vpz::CoupledModel("empty", 0));
+    coord.init(empty, 0.0, 1.0);
+
+    vpz::CoupledModel* top = new vpz::CoupledModel("top", 0);
+    vpz::AtomicModel* exe = top->addAtomicModel("exe");
+    vpz::AtomicModel* a = top->addAtomicModel("a");
+    vpz::AtomicModel* b = top->addAtomicModel("b");
+    vpz::AtomicModel* c = top->addAtomicModel("c");
+    a->addOutputPort("out");
+    b->addOutputPort("out");
+    b->addInputPort("in");
+    c->addInputPort("in");
+
+    std::map < vpz::AtomicModel*, devs::Simulator* > simulators;
+    vpz::AtomicModel* models[4] = { exe, a, b, c };
+    for (int i = 0; i < 4; ++i) {
+        simulators[models[i]] = new devs::Simulator(models[i]);
+        coord.addModel(models[i], simulators[models[i]]);
+    }
+    devs::Simulator* sa = simulators[a];
+    devs::Simulator* sb = simulators[b];
+
+    devs::InitEventList events;
+    TestExecutive executive(devs::ExecutiveInit(*exe,
+                                                devs::PackageId(),
+                                                coord), events);
+
+    std::pair < devs::Simulator::iterator, devs::Simulator::iterator > x;
+
+    executive.addConnection("a", "out", "b", "in");
+    x = sa->targets("out", simulators);
+    BOOST_REQUIRE_EQUAL(x.second - x.first, 1);
+
+    executive.beginChanges();
+    executive.addConnection("a", "out", "c", "in");
+    executive.beginChanges();
+    executive.addConnection("b", "out", "c", "in");
+    executive.commitChanges();
+    x = sa->targets("out", simulators);
+    BOOST_REQUIRE_EQUAL(x.second - x.first, 1);
+    executive.commitChanges();
+
+    x = sa->targets("out", simulators);
+    BOOST_REQUIRE_EQUAL(x.second - x.first, 2);
+    x = sb->targets("out", simulators);
+    BOOST_REQUIRE_EQUAL(x.second - x.first, 1);
+    BOOST_REQUIRE_THROW(executive.commitChanges(), utils::DevsGraphError);
+
+    executive.beginChanges();
+    executive.removeConnection("a", "out", "b", "in");
+    executive.removeConnection("a", "out", "c", "in");
+    executive.addConnection("a", "out", "b", "in");
+    executive.addConnection("b", "out", "b", "in");
+    BOOST_REQUIRE_THROW(executive.addConnection("a", "out", "d", "in"),
+                        utils::DevsGraphError);
+    executive.delModel("b");
+    executive.commitChanges();
+
+    x = sa->targets("out", simulators);
+    BOOST_REQUIRE(x.first == x.second);
+
+    delete top;
+    delete empty.model();
+}
+
+static void fillGraph(value::Map& init, const std::string& prefix,
+                      bool tuples = true)
+{
+    const double offsets[5] = { 0, 2, 3, 3, 4 };
+    const double targets[4] = { 1, 2, 3, 0 };
+
+    init.addInt("number", 4);
+    init.addString("prefix", prefix);
+    init.addString("class", "node");
+    init.addString("port", "in-out");
+    if (not tuples) {
+        return;
+    }
+
+    init.addTuple("offsets");
+    init.addTuple("targets");
+
+    for (int i = 0; i < 5; ++i) {
+        init.getTuple("offsets").add(offsets[i]);
+    }
+    for (int i = 0; i < 4; ++i) {
+        init.getTuple("targets").add(targets[i]);
+    }
+}
+
+static void checkGraph(vpz::CoupledModel* top, const std::string& prefix)
+{
+    vpz::BaseModel* nodes[4];
+    for (int i = 0; i < 4; ++i) {
+        nodes[i] = top->findModel((fmt("%1%-%2%") % prefix % i).str());
+        BOOST_REQUIRE(nodes[i]);
+    }
+
+    BOOST_REQUIRE_EQUAL(nodes[0]->getOutPort("out").size(), 2u);
+    BOOST_REQUIRE(nodes[0]->getOutPort("out").exist(nodes[1], "in"));
+    BOOST_REQUIRE(nodes[0]->getOutPort("out").exist(nodes[2], "in"));
+    BOOST_REQUIRE_EQUAL(nodes[1]->getOutPort("out").size(), 1u);
+    BOOST_REQUIRE(nodes[1]->getOutPort("out").exist(nodes[3], "in"));
+    BOOST_REQUIRE(not nodes[2]->existOutputPort("out"));
+    BOOST_REQUIRE_EQUAL(nodes[3]->getOutPort("out").size(), 1u);
+    BOOST_REQUIRE(nodes[3]->getOutPort("out").exist(nodes[0], "in"));
+}
+
+BOOST_AUTO_TEST_CASE(test_graph_translator)
+{
+    utils::ModuleManager modules;
+    vpz::Dynamics dyns;
+    vpz::Classes classes;
+    classes.add("node").setModel(new vpz::CoupledModel("node", 0));
+    vpz::Experiment expe;
+    devs::RootCoordinator root(modules);
+    devs::Coordinator coord(modules, dyns, classes, expe, root);
+
+    vpz::Model empty;
+    empty.setModel(new vpz::CoupledModel("empty", 0));
+    coord.init(empty, 0.0, 1.0);
+
+    vpz::CoupledModel* top = new vpz::CoupledModel("top", 0);
+    vpz::AtomicModel* exe = top->addAtomicModel("exe");
+    devs::Simulator* sexe = new devs::Simulator(exe);
+    coord.addModel(exe, sexe);
+
+    devs::InitEventList events;
+    TestExecutive executive(devs::ExecutiveInit(*exe,
+                                                devs::PackageId(),
+                                                coord), events);
+
+    {
+        value::Map init;
+        fillGraph(init, "tuple");
+        translator::GraphTranslator tr(executive);
+        tr.translate(init);
+        BOOST_REQUIRE_EQUAL(tr.offsets().size(), 5u);
+        BOOST_REQUIRE_EQUAL(tr.targets().size(), 4u);
+        BOOST_REQUIRE_EQUAL(tr.targets()[2], 3u);
+        BOOST_REQUIRE_EQUAL(tr.size(), 0u);
+        checkGraph(top, "tuple");
+    }
+
+    std::string filename(utils::Path::buildTemp("graph.csr"));
+    {
+        const uint32_t csr[9] = { 0, 2, 3, 3, 4, 1, 2, 3, 0 };
+        std::ofstream file(filename.c_str(),
+                           std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast < const char* >(csr), sizeof(csr));
+    }
+
+    {
+        value::Map init;
+        fillGraph(init, "file", false);
+        init.addString("adjacency file", filename);
+        translator::GraphTranslator tr(executive);
+        tr.translate(init);
+        checkGraph(top, "file");
+    }
+
+    {
+        const uint32_t csr[7] = { 0, 2, 3, 3, 4, 1, 2 };
+        std::ofstream file(filename.c_str(),
+                           std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast < const char* >(csr), sizeof(csr));
+    }
+
+    {
+        value::Map init;
+        fillGraph(init, "truncated", false);
+        init.addString("adjacency file", filename);
+        translator::GraphTranslator tr(executive);
+        BOOST_REQUIRE_THROW(tr.translate(init), utils::FileError);
+        BOOST_REQUIRE(not top->findModel("truncated-0"));
+    }
+    std::remove(filename.c_str());
+
+    {
+        value::Map init;
+        fillGraph(init, "decrease");
+        init.getTuple("offsets")[2] = 1;
+        translator::GraphTranslator tr(executive);
+        BOOST_REQUIRE_THROW(tr.translate(init), utils::ArgError);
+    }
+
+    {
+        value::Map init;
+        fillGraph(init, "short");
+        init.getTuple("offsets").value().pop_back();
+        translator::GraphTranslator tr(executive);
+        BOOST_REQUIRE_THROW(tr.translate(init), utils::ArgError);
+    }
+
+    {
+        value::Map init;
+        fillGraph(init, "first");
+        init.getTuple("offsets")[0] = 1;
+        translator::GraphTranslator tr(executive);
+        BOOST_REQUIRE_THROW(tr.translate(init), utils::ArgError);
+    }
+
+    {
+        value::Map init;
+        fillGraph(init, "unknown");
+        init.getTuple("targets")[3] = 4;
+        translator::GraphTranslator tr(executive);
+        BOOST_REQUIRE_THROW(tr.translate(init), utils::ArgError);
+        BOOST_REQUIRE(not top->findModel("unknown-0"));
+    }
+
+    {
+        value::Map init;
+        fillGraph(init, "edges");
+        init.getTuple("targets").add(1);
+        translator::GraphTranslator tr(executive);
+        BOOST_REQUIRE_THROW(tr.translate(init), utils::ArgError);
+    }
+
+    delete top;
+    delete empty.model();
+}
+
+BOOST_AUTO_TEST_CASE(test_executive_many_edges)
+{
+    utils::ModuleManager modules;
+    vpz::Dynamics dyns;
+    vpz::Classes classes;
+    vpz::Experiment expe;
+    devs::RootCoordinator root(modules);
+    devs::Coordinator coord(modules, dyns, classes, expe, root);
+
+    vpz::Model empty;
+    empty.setModel(new vpz::CoupledModel("empty", 0));
+    coord.init(empty, 0.0, 1.0);
+
+    const int nb = 200;
+    vpz::CoupledModel* top = new vpz::CoupledModel("top", 0);
+    vpz::AtomicModel* exe = top->addAtomicModel("exe");
+    vpz::AtomicModel* dst = top->addAtomicModel("dst");
+    dst->addInputPort("in");
+
+    std::map < vpz::AtomicModel*, devs::Simulator* > simulators;
+    simulators[exe] = new devs::Simulator(exe);
+    coord.addModel(exe, simulators[exe]);
+    simulators[dst] = new devs::Simulator(dst);
+    coord.addModel(dst, simulators[dst]);
+
+    std::vector < vpz::AtomicModel* > sources;
+    for (int i = 0; i < nb; ++i) {
+        vpz::AtomicModel* src = top->addAtomicModel(
+            (fmt("src-%1%") % i).str());
+        src->addOutputPort("out");
+        simulators[src] = new devs::Simulator(src);
+        coord.addModel(src, simulators[src]);
+        sources.push_back(src);
+    }
+
+    devs::InitEventList events;
+    TestExecutive executive(devs::ExecutiveInit(*exe,
+                                                devs::PackageId(),
+                                                coord), events);
+
+    std::pair < devs::Simulator::iterator, devs::Simulator::iterator > x;
+
+    executive.beginChanges();
+    for (int i = 0; i < nb; ++i) {
+        executive.addConnection(sources[i]->getName(), "out", "dst", "in");
+    }
+    executive.commitChanges();
+
+    for (int i = 0; i < nb; ++i) {
+        x = simulators[sources[i]]->targets("out", simulators);
+        BOOST_REQUIRE_EQUAL(x.second - x.first, 1);
+        BOOST_REQUIRE_EQUAL(x.first->first, simulators[dst]);
+        BOOST_REQUIRE_EQUAL(x.first->second, "in");
+    }
+
+    vpz::ModelPortList result;
+    dst->getAtomicModelsSource("in", result);
+    BOOST_REQUIRE_EQUAL(result.size(), (size_t)nb);
+
+    executive.beginChanges();
+    executive.removeConnection(sources[0]->getName(), "out", "dst", "in");
+    executive.addConnection(sources[0]->getName(), "out", "dst", "in");
+    executive.removeConnection(sources[1]->getName(), "out", "dst", "in");
+    executive.commitChanges();
+
+    x = simulators[sources[0]]->targets("out", simulators);
+    BOOST_REQUIRE_EQUAL(x.second - x.first, 1);
+    x = simulators[sources[1]]->targets("out", simulators);
+    BOOST_REQUIRE(x.first == x.second);
+
+    delete top;
+    delete empty.model();
+}
+
+/*
+ * The events of the models built by test_parallel_models: the
+ * initializations and the observables are registered in the order of the
+ * list of the atomic models, the transitions of a bag are processed in
+ * the order of the simulators addresses and are sorted.
+ */
+static std::vector < std::string > parallel_registrations;
+static std::vector < std::string > parallel_transitions;
+static std::set < std::string > parallel_failures;
+
+class TestParallel : public devs::Dynamics
+{
+public:
+    TestParallel(const devs::DynamicsInit& init,
+                 const devs::InitEventList& events)
+        : devs::Dynamics(init, events), m_count(0)
+    {
+        if (parallel_failures.count(getModelName())) {
+            throw utils::ModellingError(fmt("%1% fails") % getModelName());
+        }
+    }
+
+    virtual devs::Time init(const devs::Time& time)
+    {
+        utils::Philox rand = getRandomStream();
+        m_duration = 0.5 * (1 + rand() % 3);
+
+        parallel_registrations.push_back(
+            (fmt("init %1% %2% %3%") % getModelName() % time %
+             m_duration).str());
+        return m_duration;
+    }
+
+    virtual devs::Time timeAdvance() const
+    {
+        return m_count < 3 ? m_duration : devs::infinity;
+    }
+
+    virtual void output(const devs::Time& /*time*/,
+                        devs::ExternalEventList& output) const
+    {
+        output.push_back(buildEvent("out"));
+    }
+
+    virtual void internalTransition(const devs::Time& time)
+    {
+        m_count++;
+        parallel_transitions.push_back(
+            (fmt("int %1% %2%") % getModelName() % time).str());
+    }
+
+    virtual void externalTransition(const devs::ExternalEventList& events,
+                                    const devs::Time& time)
+    {
+        parallel_transitions.push_back(
+            (fmt("ext %1% %2% %3%") % getModelName() % time %
+             events.size()).str());
+    }
+
+    virtual value::Value* observation(const devs::ObservationEvent&) const
+    {
+        return value::Integer::create(m_count);
+    }
+
+private:
+    devs::Time m_duration;
+    int m_count;
+};
+
+static devs::Dynamics* makeTestParallel(const devs::DynamicsInit& init,
+                                        const devs::InitEventList& events)
+{
+    return new TestParallel(init, events);
+}
+
+class TestParallelOutput : public oov::Plugin
+{
+public:
+    TestParallelOutput(const std::string& location)
+        : oov::Plugin(location)
+    {}
+
+    virtual void onParameter(const std::string&, const std::string&,
+                             const std::string&, value::Value* parameters,
+                             const double&)
+    {
+        delete parameters;
+    }
+
+    virtual void onNewObservable(const std::string& simulator,
+                                 const std::string&,
+                                 const std::string& port,
+                                 const std::string& view,
+                                 const double& time)
+    {
+        parallel_registrations.push_back(
+            (fmt("view %1% %2% %3% %4%") % view % simulator % port %
+             time).str());
+    }
+
+    virtual void onDelObservable(const std::string&, const std::string&,
+                                 const std::string&, const std::string&,
+                                 const double&)
+    {}
+
+    virtual void onValue(const std::string& simulator,
+                         const std::string&,
+                         const std::string& port,
+                         const std::string& view,
+                         const double& time,
+                         value::Value* value)
+    {
+        /* the value observed by an event view depends on the order of
+         * the models of the bag. */
+        parallel_transitions.push_back(
+            (fmt("value %1% %2% %3% %4%") % view % simulator % port %
+             time).str());
+        delete value;
+    }
+
+    virtual void close(const double&)
+    {}
+};
+
+static oov::Plugin* makeTestParallelOutput(const std::string& location)
+{
+    return new TestParallelOutput(location);
+}
+
+/*
+ * Build and simulate a ring of 20 models with the specified number of
+ * threads. Returns the error of the initialization, the events are
+ * appended to parallel_registrations and parallel_transitions.
+ */
+static std::string runParallel(unsigned int threads)
+{
+    const int nb = 20;
+    std::string error;
+
+    parallel_registrations.clear();
+    parallel_transitions.clear();
+
+    utils::ModuleManager modules;
+    modules.add("test", "parallel", utils::MODULE_DYNAMICS,
+                reinterpret_cast < void* >(&makeTestParallel));
+    modules.add("test", "output", utils::MODULE_OOV,
+                reinterpret_cast < void* >(&makeTestParallelOutput));
+
+    vpz::Dynamics dyns;
+    vpz::Dynamic dyn("parallel");
+    dyn.setLibrary("parallel");
+    dyn.setPackage("test");
+    dyns.add(dyn);
+
+    vpz::Classes classes;
+    vpz::Experiment expe;
+    expe.setName("parallel");
+    expe.views().addLocalStreamOutput("output1", "", "output", "test");
+    expe.views().addLocalStreamOutput("output2", "", "output", "test");
+    expe.views().addEventView("view1", "output1");
+    expe.views().addEventView("view2", "output2");
+    vpz::Observable& obs(expe.views().addObservable("obs"));
+    vpz::ObservablePort& count(obs.add("count"));
+    count.add("view1");
+    count.add("view2");
+    obs.add("state").add("view1");
+
+    vpz::Model model;
+    vpz::CoupledModel* top = new vpz::CoupledModel("top", 0);
+    model.setModel(top);
+
+    for (int i = 0; i < nb; ++i) {
+        vpz::AtomicModel* atom = top->addAtomicModel((fmt("m%1$02d") %
+                                                      i).str());
+        atom->addInputPort("in");
+        atom->addOutputPort("out");
+        atom->setDynamics("parallel");
+        if (i % 2) {
+            atom->setObservables("obs");
+        }
+    }
+    for (int i = 0; i < nb; ++i) {
+        top->addInternalConnection((fmt("m%1$02d") % i).str(), "out",
+                                   (fmt("m%1$02d") % ((i + 1) % nb)).str(),
+                                   "in");
+    }
+
+    {
+        devs::RootCoordinator root(modules);
+        devs::Coordinator coord(modules, dyns, classes, expe, root);
+
+        try {
+            coord.init(model, 0.0, 5.0, threads);
+
+            while (coord.getNextTime() <= 5.0) {
+                coord.run();
+            }
+            coord.finish();
+        } catch (const std::exception& e) {
+            error.assign(e.what());
+        }
+    }
+
+    delete top;
+    std::sort(parallel_transitions.begin(), parallel_transitions.end());
+    return error;
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_models)
+{
+    parallel_failures.clear();
+
+    BOOST_REQUIRE_EQUAL(runParallel(1), "");
+    std::vector < std::string > registrations(parallel_registrations);
+    std::vector < std::string > transitions(parallel_transitions);
+
+    BOOST_REQUIRE_EQUAL(registrations.size(), 20u + 3u * 10u);
+    BOOST_REQUIRE_EQUAL(registrations.front().substr(0, 9), "init m00 ");
+    BOOST_REQUIRE(not transitions.empty());
+
+    BOOST_REQUIRE_EQUAL(runParallel(4), "");
+    BOOST_REQUIRE(registrations == parallel_registrations);
+    BOOST_REQUIRE(transitions == parallel_transitions);
+
+    /* the first failure of the list is reported, whatever the thread which
+     * built it. */
+    parallel_failures.insert("m13");
+    parallel_failures.insert("m06");
+    std::string sequential = runParallel(1);
+    BOOST_REQUIRE(sequential.find("m06 fails") != std::string::npos);
+    BOOST_REQUIRE_EQUAL(runParallel(4), sequential);
+    BOOST_REQUIRE_EQUAL(runParallel(3), sequential);
+    parallel_failures.clear();
+}
+
+BOOST_AUTO_TEST_CASE(test_class_instances)
+{
+    utils::ModuleManager modules;
+    modules.add("test", "parallel", utils::MODULE_DYNAMICS,
+                reinterpret_cast < void* >(&makeTestParallel));
+
+    vpz::Dynamics dyns;
+    vpz::Dynamic dyn("parallel");
+    dyn.setLibrary("parallel");
+    dyn.setPackage("test");
+    dyns.add(dyn);
+
+    /* the class: in -> a -> b -> out. */
+    vpz::CoupledModel* cell = new vpz::CoupledModel("cell", 0);
+    cell->addInputPort("in");
+    cell->addOutputPort("out");
+    vpz::AtomicModel* a = cell->addAtomicModel("a");
+    vpz::AtomicModel* b = cell->addAtomicModel("b");
+    a->addInputPort("in");
+    a->addOutputPort("out");
+    a->setDynamics("parallel");
+    b->addInputPort("in");
+    b->addOutputPort("out");
+    b->setDynamics("parallel");
+    cell->addInputConnection("in", a, "in");
+    cell->addInternalConnection(a, "out", b, "in");
+    cell->addOutputConnection(b, "out", "out");
+
+    vpz::Classes classes;
+    classes.add("cell").setModel(cell);
+    vpz::Experiment expe;
+
+    vpz::Model model;
+    vpz::CoupledModel* top = new vpz::CoupledModel("top", 0);
+    model.setModel(top);
+
+    {
+        devs::RootCoordinator root(modules);
+        devs::Coordinator coord(modules, dyns, classes, expe, root);
+        coord.init(model, 0.0, 1.0);
+
+        vpz::BaseModel* i1 = coord.createModelFromClass("cell", top, "i1");
+        vpz::BaseModel* i2 = coord.createModelFromClass("cell", top, "i2");
+        top->addInternalConnection("i1", "out", "i2", "in");
+
+        BOOST_REQUIRE(i1->isClass() and i2->isClass());
+        /* the instances share the model of the class of the factory. */
+        const vpz::CoupledModel* shared =
+            static_cast < vpz::ClassModel* >(i1)->classModel();
+        BOOST_REQUIRE(shared and shared->findModel("a"));
+        BOOST_REQUIRE(static_cast < vpz::ClassModel* >(i2)->classModel() ==
+                      shared);
+
+        vpz::AtomicModel* a1 = i1->toCoupled()->findModel("a")->toAtomic();
+        vpz::AtomicModel* b1 = i1->toCoupled()->findModel("b")->toAtomic();
+        vpz::AtomicModel* a2 = i2->toCoupled()->findModel("a")->toAtomic();
+        BOOST_REQUIRE(a1 != a and b1 != b);
+        BOOST_REQUIRE_EQUAL(a1->getOutPort("out").size(), 0u);
+
+        vpz::AtomicModelVector atoms;
+        vpz::BaseModel::getAtomicModelList(top, atoms);
+        BOOST_REQUIRE_EQUAL(atoms.size(), 4u);
+
+        std::map < vpz::AtomicModel*, devs::Simulator* > simulators;
+        for (vpz::AtomicModelVector::iterator it = atoms.begin();
+             it != atoms.end(); ++it) {
+            simulators[*it] = coord.getModel(*it);
+            BOOST_REQUIRE(simulators[*it]);
+        }
+
+        std::pair < devs::Simulator::iterator, devs::Simulator::iterator > x;
+        x = simulators[a1]->targets("out", simulators);
+        BOOST_REQUIRE_EQUAL(x.second - x.first, 1);
+        BOOST_REQUIRE_EQUAL(x.first->first, simulators[b1]);
+        BOOST_REQUIRE_EQUAL(x.first->second, "in");
+
+        x = simulators[b1]->targets("out", simulators);
+        BOOST_REQUIRE_EQUAL(x.second - x.first, 1);
+        BOOST_REQUIRE_EQUAL(x.first->first, simulators[a2]);
+        BOOST_REQUIRE_EQUAL(x.first->second, "in");
+    }
+
+    delete top;
+}
@@ -141,7 +141,7 @@ void AtomicModelBox::InputPortTreeView::build()
     vpz::ConnectionList::const_iterator it = list.begin();
     while (it != list.end()) {
         Gtk::TreeModel::Row row = *(mRefTreeModelInputPort->append());
-        row[mColumnsInputPort.m_col_name] = it->first;
+        row[mColumnsInputPort.m_col_name] = it->first.str();
 
         ++it;
     }
@@ -193,7 +193,7 @@ void AtomicModelBox::InputPortTreeView::onRename()
 	    Glib::ustring new_name = boost::trim_copy(box.run());
 
 	    if (box.valid() and not new_name.empty()
-		and list.find(new_name) == list.end()) {
+		and list.find(new_name.raw()) == list.end()) {
 
 		row.set_value(mColumnsInputPort.m_col_name, new_name);
 
@@ -237,7 +237,7 @@ void AtomicModelBox::InputPortTreeView::onEdition(
 
     vpz::ConnectionList& list = mModel->getInputPortList();
 
-    if (list.find(newName) == list.end() and newName != "") {
+    if (list.find(newName.raw()) == list.end() and newName != "") {
 	Glib::RefPtr<Gtk::TreeView::Selection> refSelection = get_selection();
 	Gtk::TreeModel::iterator iter = refSelection->get_selected();
 
@@ -354,7 +354,7 @@ void AtomicModelBox::OutputPortTreeView::build()
     vpz::ConnectionList::const_iterator it = list.begin();
     while (it != list.end()) {
         Gtk::TreeModel::Row row = *(mRefTreeModelOutputPort->append());
-        row[mColumnsOutputPort.m_col_name] = it->first;
+        row[mColumnsOutputPort.m_col_name] = it->first.str();
 
         ++it;
     }
@@ -406,7 +406,7 @@ void AtomicModelBox::OutputPortTreeView::onRename()
 	    Glib::ustring new_name = boost::trim_copy(box.run());
 
 	    if (box.valid() and not new_name.empty()
-		and list.find(new_name) == list.end()) {
+		and list.find(new_name.raw()) == list.end()) {
 		row.set_value(mColumnsOutputPort.m_col_name, new_name);
 
 		if (mModel->existOutputPort(old_name)) {
@@ -449,7 +449,7 @@ void AtomicModelBox::OutputPortTreeView::onEdition(
 
     vpz::ConnectionList& list = mModel->getOutputPortList();
 
-    if (list.find(newName) == list.end() and newName != "") {
+    if (list.find(newName.raw()) == list.end() and newName != "") {
 	Glib::RefPtr<Gtk::TreeView::Selection> refSelection = get_selection();
 	Gtk::TreeModel::iterator iter = refSelection->get_selected();
 
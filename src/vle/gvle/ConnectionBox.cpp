@@ -85,14 +85,14 @@ void ConnectionBox::assingComboOutputPort(vpz::CoupledModel* parent,
         const vpz::ConnectionList& input = dst->getOutputPortList();
         vpz::ConnectionList::const_iterator it = input.begin();
         while (it != input.end()) {
-            m_comboOutput.append_string((*it).first);
+            m_comboOutput.append_string((*it).first.str());
             ++it;
         }
     } else {
         const vpz::ConnectionList& input = dst->getInputPortList();
         vpz::ConnectionList::const_iterator it = input.begin();
         while (it != input.end()) {
-            m_comboOutput.append_string((*it).first);
+            m_comboOutput.append_string((*it).first.str());
             ++it;
         }
     }
@@ -105,14 +105,14 @@ void ConnectionBox::assingComboInputPort(vpz::CoupledModel* parent,
         const vpz::ConnectionList& output = src->getInputPortList();
         vpz::ConnectionList::const_iterator it = output.begin();
         while (it != output.end()) {
-            m_comboInput.append_string((*it).first);
+            m_comboInput.append_string((*it).first.str());
             ++it;
         }
     } else {
         const vpz::ConnectionList& output = src->getOutputPortList();
         vpz::ConnectionList::const_iterator it = output.begin();
         while (it != output.end()) {
-            m_comboInput.append_string((*it).first);
+            m_comboInput.append_string((*it).first.str());
             ++it;
         }
     }
@@ -124,7 +124,7 @@ void CoupledModelBox::InputPortTreeView::build()
     vpz::ConnectionList::const_iterator it = list.begin();
     while (it != list.end()) {
         Gtk::TreeModel::Row row = *(mRefTreeModelInputPort->append());
-        row[mColumnsInputPort.m_col_name] = it->first;
+        row[mColumnsInputPort.m_col_name] = it->first.str();
 
         ++it;
     }
@@ -168,7 +168,7 @@ void CoupledModelBox::InputPortTreeView::onRename()
 	    Glib::ustring new_name = boost::trim_copy(box.run());
 
 	    if (box.valid() and not new_name.empty()
-		and list.find(new_name) == list.end()) {
+		and list.find(new_name.raw()) == list.end()) {
 		row.set_value(mColumnsInputPort.m_col_name, new_name);
 
 		if (mModel->existInputPort(old_name)) {
@@ -212,7 +212,7 @@ void CoupledModelBox::InputPortTreeView::onEdition(
 
     vpz::ConnectionList& list = mModel->getInputPortList();
 
-    if (list.find(newName) == list.end() and newName != "") {
+    if (list.find(newName.raw()) == list.end() and newName != "") {
 	Glib::RefPtr<Gtk::TreeView::Selection> refSelection = get_selection();
 	Gtk::TreeModel::iterator iter = refSelection->get_selected();
 
@@ -321,7 +321,7 @@ void CoupledModelBox::OutputPortTreeView::build()
     vpz::ConnectionList::const_iterator it = list.begin();
     while (it != list.end()) {
 	Gtk::TreeModel::Row row = *(mRefTreeModelOutputPort->append());
-	row[mColumnsOutputPort.m_col_name] = it->first;
+	row[mColumnsOutputPort.m_col_name] = it->first.str();
 
 	++it;
     }
@@ -365,7 +365,7 @@ void CoupledModelBox::OutputPortTreeView::onRename()
 	    Glib::ustring new_name = boost::trim_copy(box.run());
 
 	    if (box.valid() and not new_name.empty()
-		and list.find(new_name) == list.end()) {
+		and list.find(new_name.raw()) == list.end()) {
 
 		row.set_value(mColumnsOutputPort.m_col_name, new_name);
 
@@ -410,7 +410,7 @@ void CoupledModelBox::OutputPortTreeView::onEdition(
 
     vpz::ConnectionList& list = mModel->getOutputPortList();
 
-    if (list.find(newName) == list.end() and newName != "") {
+    if (list.find(newName.raw()) == list.end() and newName != "") {
 	Glib::RefPtr<Gtk::TreeView::Selection> refSelection = get_selection();
 	Gtk::TreeModel::iterator iter = refSelection->get_selected();
 
@@ -29,6 +29,7 @@
 #include <vle/vpz/Condition.hpp>
 #include <vle/vpz/Vpz.hpp>
 #include <vle/vpz/BaseModel.hpp>
+#include <memory>
 
 
 namespace vle { namespace manager {
@@ -105,8 +106,22 @@ class ExperimentGenerator::Pimpl
         }
     }
 
+    /**
+     * Move the values of the experimental frame into @e mConditions. The
+     * conditions of @e mVpz keep their ports with empty sets: a copy of
+     * @e mVpz does not clone the values of all the combinations.
+     */
+    void splitConditions()
+    {
+        vpz::Conditions& cnds(mVpz.project().experiment().conditions());
+
+        mConditions.add(cnds);
+        cnds.deleteValueSet();
+    }
+
 public:
     vpz::Vpz mVpz;
+    vpz::Conditions mConditions;
     uint32_t mRank;
     uint32_t mWorld;
     uint32_t mCompleteSize;
@@ -122,6 +137,7 @@ public:
         }
 
         computeRange();
+        splitConditions();
     }
 
     Pimpl(const vpz::Vpz& vpz, uint32_t rank, uint32_t size)
@@ -133,6 +149,7 @@ public:
         }
 
         computeRange();
+        splitConditions();
     }
 
     ~Pimpl()
@@ -140,32 +157,33 @@ public:
         delete mVpz.project().model().model();
     }
 
-    void get(uint32_t index, vpz::Conditions *conditions)
+    void get(uint32_t index, vpz::Conditions *conditions) const
     {
-        const vpz::Conditions& cnds(mVpz.project().experiment().conditions());
         conditions->deleteValueSet();
         vpz::ConditionList& cdldst(conditions->conditionlist());
 
         vpz::ConditionList::const_iterator it;
-        for (it = cnds.begin(); it != cnds.end(); ++it) {
+        for (it = mConditions.begin(); it != mConditions.end(); ++it) {
+            vpz::ConditionList::iterator dst = cdldst.find(it->first);
 
-            std::pair < vpz::ConditionList::iterator, bool > r =
-                cdldst.insert(std::make_pair(
-                        it->first, vpz::Condition(it->first)));
+            if (dst == cdldst.end()) {
+                dst = cdldst.insert(std::make_pair(
+                        it->first, vpz::Condition(it->first))).first;
+            }
 
             const vpz::ConditionValues& cnvsrc = it->second.conditionvalues();
-            vpz::ConditionValues& cnvdst = r.first->second.conditionvalues();
+            vpz::ConditionValues& cnvdst = dst->second.conditionvalues();
 
             for (vpz::ConditionValues::const_iterator jt = cnvsrc.begin();
                  jt != cnvsrc.end(); ++jt) {
 
-                value::Set *cpy = new value::Set();
+                const value::Value* selected;
 
                 if (jt->second->size() == 1) {
-                    cpy->add(jt->second->get(0)->clone());
+                    selected = jt->second->get(0);
                 } else if (jt->second->size() > 1 and jt->second->size() >
                            index) {
-                    cpy->add(jt->second->get(index)->clone());
+                    selected = jt->second->get(index);
                 } else {
                     throw utils::InternalError(fmt(
                             _("ExperimentGenerator can not access to the index"
@@ -173,11 +191,24 @@ public:
                         index % it->first % jt->first);
                 }
 
-                delete cnvdst[jt->first];
-                cnvdst[jt->first] = cpy;
+                value::Set*& cpy = cnvdst[jt->first];
+                if (not cpy) {
+                    cpy = new value::Set();
+                }
+
+                cpy->add(selected ? selected->clone() : (value::Value*)0);
             }
         }
     }
+
+    vpz::Vpz* build(uint32_t index) const
+    {
+        std::auto_ptr < vpz::Vpz > file(new vpz::Vpz(mVpz));
+
+        get(index, &file->project().experiment().conditions());
+
+        return file.release();
+    }
 };
 
 //
@@ -207,6 +238,11 @@ void ExperimentGenerator::get(uint32_t index, vpz::Conditions *conditions)
     mPimpl->get(index, conditions);
 }
 
+vpz::Vpz* ExperimentGenerator::build(uint32_t index) const
+{
+    return mPimpl->build(index);
+}
+
 uint32_t ExperimentGenerator::min() const
 {
     return mPimpl->mMin;
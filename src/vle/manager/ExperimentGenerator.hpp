@@ -97,6 +97,18 @@ public:
      */
     void get(uint32_t index, vpz::Conditions *conditions);
 
+    /**
+     * Build a copy of the experimental frame for the specified index.
+     *
+     * Unlike a copy of the @e vpz::Vpz followed by a call to @e get(), only
+     * the selected value of each condition port is cloned.
+     *
+     * @param index The index in the experiment generator table.
+     *
+     * @return A new @e vpz::Vpz, the caller takes the ownership.
+     */
+    vpz::Vpz* build(uint32_t index) const;
+
     /**
      * The minimal index of experiences produce by the object.
      *
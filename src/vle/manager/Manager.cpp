@@ -38,6 +38,7 @@
 #include <vle/vpz/Vpz.hpp>
 #include <vle/vpz/BaseModel.hpp>
 #include <boost/thread/thread.hpp>
+#include <algorithm>
 
 namespace vle { namespace manager {
 
@@ -65,6 +66,34 @@ static void setExperimentName(vpz::Vpz           *destination,
     destination->project().experiment().setName(result);
 }
 
+/**
+ * Send the trace of the calling thread into the log file of an experiment
+ * while an instance of this class exists.
+ */
+class ExperimentLog
+{
+public:
+    ExperimentLog(LogOptions logoptions, const vpz::Vpz *file)
+        : mEnabled(logoptions & manager::LOG_EXPERIMENT)
+    {
+        if (mEnabled) {
+            utils::Trace::setThreadLogFile(
+                utils::Trace::getLogFilename(
+                    file->project().experiment().name() + ".log"));
+        }
+    }
+
+    ~ExperimentLog()
+    {
+        if (mEnabled) {
+            utils::Trace::resetThreadLogFile();
+        }
+    }
+
+private:
+    bool mEnabled;
+};
+
 struct Manager::Pimpl
 {
     Pimpl(LogOptions            logoptions,
@@ -144,14 +173,20 @@ struct Manager::Pimpl
         {
             std::string vpzname(vpz->project().experiment().name());
 
+            /* the processors are shared by the simulations of the
+             * workers, do not oversubscribe the host. */
+            unsigned int initthreads = std::max(
+                1u, boost::thread::hardware_concurrency() / threads);
+
             for (uint32_t i = expgen.min() + index; i <= expgen.max();
                  i += threads) {
-                Simulation sim(mLogOption, mSimulationOption, NULL);
+                Simulation sim(mLogOption, mSimulationOption, NULL,
+                               initthreads);
                 Error err;
-                vpz::Vpz *file = new vpz::Vpz(*vpz);
+                vpz::Vpz *file = expgen.build(i);
                 setExperimentName(file, vpzname, i);
-                expgen.get(i, &file->project().experiment().conditions());
 
+                ExperimentLog log(mLogOption, file);
                 value::Map *simresult = sim.run(file, modulemgr, &err);
 
                 if (err.code) {
@@ -211,10 +246,10 @@ struct Manager::Pimpl
         if (mSimulationOption & manager::SIMULATION_NO_RETURN) {
             for (uint32_t i = expgen.min(); i <= expgen.max(); ++i) {
                 Error err;
-                vpz::Vpz *file = new vpz::Vpz(*vpz);
+                vpz::Vpz *file = expgen.build(i);
                 setExperimentName(file, vpzname, i);
-                expgen.get(i, &file->project().experiment().conditions());
 
+                ExperimentLog log(mLogOption, file);
                 sim.run(file, modulemgr, &err);
 
                 if (err.code) {
@@ -231,10 +266,10 @@ struct Manager::Pimpl
 
             for (uint32_t i = expgen.min(); i <= expgen.max(); ++i) {
                 Error err;
-                vpz::Vpz *file = new vpz::Vpz(*vpz);
+                vpz::Vpz *file = expgen.build(i);
                 setExperimentName(file, vpzname, i);
-                expgen.get(i, &file->project().experiment().conditions());
 
+                ExperimentLog log(mLogOption, file);
                 value::Map *simresult = sim.run(file, modulemgr, &err);
 
                 if (err.code) {
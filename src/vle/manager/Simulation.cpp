@@ -33,6 +33,8 @@
 #include <vle/manager/Simulation.hpp>
 #include <boost/timer.hpp>
 #include <boost/progress.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
 
 namespace vle { namespace manager {
 
@@ -41,14 +43,17 @@ struct Simulation::Pimpl
     std::ostream      *m_out;
     LogOptions         m_logoptions;
     SimulationOptions  m_simulationoptions;
+    unsigned int       m_threads;
 
 public:
     Pimpl(LogOptions         logoptions,
           SimulationOptions  simulationoptionts,
-          std::ostream      *output)
+          std::ostream      *output,
+          unsigned int       threads)
         : m_out(output),
           m_logoptions(logoptions),
-          m_simulationoptions(simulationoptionts)
+          m_simulationoptions(simulationoptionts),
+          m_threads(threads)
     {
         if (m_simulationoptions & manager::SIMULATION_SPAWN_PROCESS)
             TraceAlways(
@@ -60,6 +65,21 @@ public:
     {
     }
 
+    /**
+     * Get the number of threads used to build the models: the number of
+     * threads given to the constructor (the number of processors by
+     * default) if SIMULATION_PARALLEL_INIT is set, one otherwise.
+     */
+    unsigned int threads() const
+    {
+        if (m_simulationoptions & manager::SIMULATION_PARALLEL_INIT) {
+            return std::max(1u, m_threads ? m_threads :
+                            boost::thread::hardware_concurrency());
+        }
+
+        return 1;
+    }
+
     template <typename T>
     void write(const T& t)
     {
@@ -86,7 +106,7 @@ public:
             write(fmt(_("[%1%]\n")) % vpz->filename());
             write(_(" - Coordinator load models ......: "));
 
-            root.load(*vpz);
+            root.load(*vpz, threads());
 
             write(_("ok\n"));
 
@@ -147,7 +167,7 @@ public:
             write(fmt(_("[%1%]\n")) % vpz->filename());
             write(_(" - Coordinator load models ......: "));
 
-            root.load(*vpz);
+            root.load(*vpz, threads());
 
             write(_("ok\n"));
 
@@ -193,7 +213,7 @@ public:
 
         try {
             devs::RootCoordinator root(modulemgr);
-            root.load(*vpz);
+            root.load(*vpz, threads());
             vpz->clear();
             delete vpz;
 
@@ -216,8 +236,10 @@ public:
 
 Simulation::Simulation(LogOptions         logoptions,
                        SimulationOptions  simulationoptionts,
-                       std::ostream      *output)
-    : mPimpl(new Simulation::Pimpl(logoptions, simulationoptionts, output))
+                       std::ostream      *output,
+                       unsigned int       threads)
+    : mPimpl(new Simulation::Pimpl(logoptions, simulationoptionts, output,
+                                   threads))
 {
 }
 
@@ -48,9 +48,15 @@ namespace vle { namespace manager {
 class VLE_API Simulation
 {
 public:
+    /**
+     * @param threads The maximal number of threads used to build the
+     * atomic models if @c SIMULATION_PARALLEL_INIT is set, 0 for the
+     * number of processors.
+     */
     Simulation(LogOptions         logoptions,
                SimulationOptions  simulationoptionts,
-               std::ostream      *output);
+               std::ostream      *output,
+               unsigned int       threads = 0);
 
     ~Simulation();
 
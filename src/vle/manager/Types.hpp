@@ -88,7 +88,12 @@ enum LogOptions {
     LOG_SUMMARY = 1 << 0,       /**< Report summary of the experimental
                                  * frame (size of the plan, number of
                                  * replicas etc.). */
-    LOG_RUN     = 1 << 1        /**< Report information. */
+    LOG_RUN     = 1 << 1,       /**< Report information. */
+    LOG_EXPERIMENT = 1 << 2     /**< Report the trace of each experiment
+                                 * into its own log file
+                                 * ($VLE_HOME/[experiment].log) to avoid
+                                 * the interleaving of concurrent
+                                 * simulations. */
 };
 
 /**
@@ -99,7 +104,11 @@ enum SimulationOptions {
     SIMULATION_NONE          = 0, /**< Default option. */
     SIMULATION_SPAWN_PROCESS = 1 << 0, /**< Launch the simulation in a
                                         * subprocess.  */
-    SIMULATION_NO_RETURN     = 1 << 1 /**< The simulation result are empty. */
+    SIMULATION_NO_RETURN     = 1 << 1, /**< The simulation result are empty. */
+    SIMULATION_PARALLEL_INIT = 1 << 2  /**< The atomic models are built
+                                        * by several threads. The
+                                        * constructors of the dynamics
+                                        * must be thread-safe. */
 };
 
 inline LogOptions operator|(LogOptions lhs, LogOptions rhs)
@@ -224,3 +224,54 @@ BOOST_AUTO_TEST_CASE(experimentgenerator_max_1_max_1)
     BOOST_CHECK_EQUAL(expgen1.max(), 6);
     BOOST_CHECK_EQUAL(expgen1.size(), 7);
 }
+
+BOOST_AUTO_TEST_CASE(experimentgenerator_build)
+{
+    vpz::Vpz vpz;
+    vpz.parseMemory(xml);
+
+    {
+        vpz::Condition& cnd1(vpz.project().experiment().conditions().get(
+                "cond1"));
+        cnd1.clearValueOfPort("init1");
+        cnd1.clearValueOfPort("init2");
+        for (int i = 0; i < 7; ++i) {
+            cnd1.addValueToPort("init1", new value::Double(i));
+        }
+        cnd1.addValueToPort("init2", new value::Double(456.));
+    }
+
+    {
+        vpz::Condition& cnd2(vpz.project().experiment().conditions().get(
+                "cond2"));
+        cnd2.clearValueOfPort("init3");
+        cnd2.clearValueOfPort("init4");
+        cnd2.addValueToPort("init3", new value::Double(.123));
+        cnd2.addValueToPort("init4", new value::Double(.456));
+    }
+
+    manager::ExperimentGenerator expgen(vpz, 0, 1);
+    BOOST_REQUIRE_EQUAL(expgen.size(), 7);
+
+    for (uint32_t i = expgen.min(); i <= expgen.max(); ++i) {
+        vpz::Vpz *file = expgen.build(i);
+        const vpz::Conditions& cnds(file->project().experiment().conditions());
+
+        const value::Set& init1(cnds.get("cond1").getSetValues("init1"));
+        BOOST_REQUIRE_EQUAL(init1.size(), 1);
+        BOOST_REQUIRE_EQUAL(value::toDouble(init1.get(0)), (double)i);
+
+        const value::Set& init2(cnds.get("cond1").getSetValues("init2"));
+        BOOST_REQUIRE_EQUAL(init2.size(), 1);
+        BOOST_REQUIRE_EQUAL(value::toDouble(init2.get(0)), 456.);
+
+        vpz::Conditions conditions;
+        expgen.get(i, &conditions);
+        BOOST_REQUIRE_EQUAL(value::toDouble(
+                conditions.get("cond1").getSetValues("init1").get(0)),
+            (double)i);
+
+        delete file->project().model().model();
+        delete file;
+    }
+}
@@ -27,6 +27,8 @@
 
 #include <vle/translator/GraphTranslator.hpp>
 #include <boost/tokenizer.hpp>
+#include <boost/cast.hpp>
+#include <fstream>
 
 namespace vle { namespace translator {
 
@@ -37,10 +39,6 @@ void GraphTranslator::translate(const value::Map& buffer)
     mNodeNumber = toInteger(init.get("number"));
     if (mNodeNumber <= 0) {
         throw utils::ArgError("GraphTranslator: bad node number");
-    } else {
-        BoolArray::extent_gen extents;
-
-        mGraph.resize(extents[mNodeNumber][mNodeNumber]);
     }
 
     if (init.exist("prefix")) {
@@ -54,60 +52,169 @@ void GraphTranslator::translate(const value::Map& buffer)
         mPort = toString(init.get("port"));
     }
 
-    std::string adjmat = toString(init.get("adjacency matrix"));
-    std::string classes = toString(init.get("classes"));
+    if (init.exist("adjacency matrix")) {
+        readAdjacencyMatrix(toString(init.get("adjacency matrix")));
+    } else if (init.exist("offsets") and init.exist("targets")) {
+        readAdjacencyTuples(init.getTuple("offsets"),
+                            init.getTuple("targets"));
+    } else if (init.exist("adjacency file")) {
+        readAdjacencyFile(toString(init.get("adjacency file")));
+    } else {
+        throw utils::ArgError("GraphTranslator: missing adjacency");
+    }
+
+    if (init.exist("class")) {
+        mClass.assign(mNodeNumber, toString(init.get("class")));
+    } else {
+        typedef boost::tokenizer < boost::char_separator < char > > tokenizer;
+        boost::char_separator<char> sep(" \n\t\r");
+        std::string classes = toString(init.get("classes"));
+        tokenizer tok(classes, sep);
+
+        mClass.reserve(mNodeNumber);
+        for (tokenizer::iterator it = tok.begin(); it != tok.end(); ++it) {
+            mClass.push_back(*it);
+        }
+    }
 
+    if (mClass.size() != mNodeNumber) {
+        throw utils::ArgError("GraphTranslator: bad node number in class");
+    }
+
+    makeBigBang();
+}
+
+void GraphTranslator::readAdjacencyMatrix(const std::string& adjmat)
+{
     typedef boost::tokenizer < boost::char_separator < char > > tokenizer;
     boost::char_separator<char> sep(" \n\t\r");
+    BoolArray::extent_gen extents;
 
-    {
-        tokenizer tok(adjmat, sep);
+    mGraph.resize(extents[mNodeNumber][mNodeNumber]);
+    mOffsets.assign(1, 0);
+    mOffsets.reserve(mNodeNumber + 1);
 
-        size_type i = 0, j = 0;
-        for (tokenizer::iterator it = tok.begin(); it != tok.end(); ++it) {
-            mGraph[j][i] = ((*it) == "1");
+    tokenizer tok(adjmat, sep);
+    size_type i = 0, j = 0;
+    for (tokenizer::iterator it = tok.begin(); it != tok.end(); ++it) {
+        if (j == mNodeNumber) {
+            throw utils::ArgError("GraphTranslator: bad node number in matrix");
+        }
 
-            ++i;
-            if (i == mNodeNumber) {
-                i = 0;
-                ++j;
-            }
+        mGraph[j][i] = ((*it) == "1");
+        if (mGraph[j][i]) {
+            mTargets.push_back(i);
         }
 
-        if (j * mNodeNumber + i != mNodeNumber * mNodeNumber) {
-            throw utils::ArgError("GraphTranslator: bad node number in matrix");
+        ++i;
+        if (i == mNodeNumber) {
+            mOffsets.push_back(mTargets.size());
+            i = 0;
+            ++j;
         }
     }
 
-    {
-        tokenizer tok(classes, sep);
+    if (j * mNodeNumber + i != mNodeNumber * mNodeNumber) {
+        throw utils::ArgError("GraphTranslator: bad node number in matrix");
+    }
+}
 
-        for (tokenizer::iterator it = tok.begin(); it != tok.end(); ++it) {
-            mClass.push_back(*it);
+void GraphTranslator::readAdjacencyTuples(const value::Tuple& offsets,
+                                          const value::Tuple& targets)
+{
+    mOffsets.resize(offsets.size());
+    for (index i = 0; i < offsets.size(); ++i) {
+        mOffsets[i] = boost::numeric_cast < uint32_t >(offsets[i]);
+    }
+    checkOffsets();
+
+    mTargets.resize(targets.size());
+    for (index i = 0; i < targets.size(); ++i) {
+        mTargets[i] = boost::numeric_cast < uint32_t >(targets[i]);
+    }
+    checkTargets();
+}
+
+void GraphTranslator::readAdjacencyFile(const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    if (not file.is_open()) {
+        throw utils::FileError(fmt(
+                _("GraphTranslator: cannot open file `%1%'")) % filename);
+    }
+
+    mOffsets.resize(mNodeNumber + 1);
+    file.read(reinterpret_cast < char* >(&mOffsets[0]),
+              mOffsets.size() * sizeof(uint32_t));
+    if (not file) {
+        throw utils::FileError(fmt(
+                _("GraphTranslator: cannot read the offsets of `%1%'")) %
+            filename);
+    }
+    checkOffsets();
+
+    mTargets.resize(mOffsets.back());
+    if (not mTargets.empty()) {
+        file.read(reinterpret_cast < char* >(&mTargets[0]),
+                  mTargets.size() * sizeof(uint32_t));
+        if (not file) {
+            throw utils::FileError(fmt(
+                    _("GraphTranslator: cannot read the targets of `%1%'")) %
+                filename);
         }
     }
+    checkTargets();
+}
 
-    if (mClass.size() != mNodeNumber) {
-        throw utils::ArgError("GraphTranslator: bad node number in class");
+void GraphTranslator::checkOffsets()
+{
+    if (mOffsets.size() != mNodeNumber + 1 or mOffsets[0] != 0) {
+        throw utils::ArgError("GraphTranslator: bad node number in offsets");
     }
 
-    makeBigBang();
+    for (index i = 1; i < mOffsets.size(); ++i) {
+        if (mOffsets[i] < mOffsets[i - 1]) {
+            throw utils::ArgError(fmt(
+                    _("GraphTranslator: offsets decrease at node %1%")) % i);
+        }
+    }
+}
+
+void GraphTranslator::checkTargets()
+{
+    if (mTargets.size() != mOffsets.back()) {
+        throw utils::ArgError("GraphTranslator: bad edge number in targets");
+    }
+
+    for (index i = 0; i < mTargets.size(); ++i) {
+        if (mTargets[i] >= mNodeNumber) {
+            throw utils::ArgError(fmt(
+                    _("GraphTranslator: unknown node %1% in targets")) %
+                mTargets[i]);
+        }
+    }
 }
 
 void GraphTranslator::makeBigBang()
 {
+    mNode.reserve(mNodeNumber);
     for (size_type i = 0; i < mNodeNumber; ++i){
         std::string name = (boost::format("%1%-%2%") % mPrefix % i).str();
         createNewNode(name, mClass[i]);
     }
 
-    for (size_type i = 0; i < mNodeNumber; ++i) {
-        for (size_type j = 0; j < mNodeNumber; ++j) {
-            if (mGraph[j][i]) {
-                connectNodes(j, i);
+    mExecutive.beginChanges();
+    try {
+        for (size_type i = 0; i < mNodeNumber; ++i) {
+            for (uint32_t k = mOffsets[i]; k < mOffsets[i + 1]; ++k) {
+                connectNodes(i, mTargets[k]);
             }
         }
+    } catch (...) {
+        mExecutive.commitChanges();
+        throw;
     }
+    mExecutive.commitChanges();
 }
 
 void GraphTranslator::createNewNode(const std::string& name,
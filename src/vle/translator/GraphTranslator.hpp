@@ -64,6 +64,19 @@ namespace vle { namespace translator {
  *    0 0 0 1 0 0 0
  *   </string>
  *  </key>
+ *  <!-- or a compressed sparse row adjacency: the successors of the node i
+ *  are the nodes targets[offsets[i]] to targets[offsets[i + 1] - 1]. -->
+ *  <key name="offsets">
+ *   <tuple>0 5 8 10 11 11 13 14</tuple>
+ *  </key>
+ *  <key name="targets">
+ *   <tuple>1 3 4 5 6 4 5 6 5 6 6 2 4 3</tuple>
+ *  </key>
+ *  <!-- or the same arrays in a binary file of 32 bits unsigned integers in
+ *  the native byte order: the number + 1 offsets followed by the targets. -->
+ *  <key name="adjacency file">
+ *   <string>graph.csr</string>
+ *  </key>
  *  <key name="classes">
  *   <string>
  *   <!-- one class per node -->
@@ -71,6 +84,10 @@ namespace vle { namespace translator {
  *   class6 class7
  *   </string>
  *  </key>
+ *  <!-- or the same class for all the nodes -->
+ *  <key name="class">
+ *   <string>class1</string>
+ *  </key>
  *  <key name="port">
  *   <string>
  *   <!-- Type of connection:
@@ -86,6 +103,10 @@ namespace vle { namespace translator {
  *  </key>
  * </map>
  * @endcode
+ * The models, the ports and the connections are built into one group of
+ * changes of the devs::Executive: the routing tables of the simulators are
+ * computed once at the end. The adjacency matrix is only stored when the
+ * graph is read from the "adjacency matrix" key.
  */
 class VLE_API GraphTranslator
 {
@@ -97,6 +118,7 @@ public:
 
     typedef std::vector < std::string > Strings;
     typedef Strings::size_type index;
+    typedef std::vector < uint32_t > Indices;
 
 
     /**
@@ -131,15 +153,37 @@ public:
     inline const_iterator end() const { return mGraph.end(); }
     inline size_type size() const { return mGraph.size(); }
 
+    /**
+     * @brief Get the offsets of the compressed sparse row adjacency: the
+     * successors of the node i are in targets() from offsets()[i] to
+     * offsets()[i + 1].
+     * @return The number + 1 offsets.
+     */
+    inline const Indices& offsets() const { return mOffsets; }
+
+    /**
+     * @brief Get the successors of the compressed sparse row adjacency.
+     * @return The list of successors of all nodes.
+     */
+    inline const Indices& targets() const { return mTargets; }
+
 private:
     devs::Executive& mExecutive;
     unsigned int mNodeNumber;
     BoolArray mGraph;
+    Indices mOffsets;
+    Indices mTargets;
     std::vector < std::string > mNode;
     std::vector < std::string > mClass;
     std::string mPrefix;
     std::string mPort;
 
+    void readAdjacencyMatrix(const std::string& adjmat);
+    void readAdjacencyTuples(const value::Tuple& offsets,
+                             const value::Tuple& targets);
+    void readAdjacencyFile(const std::string& filename);
+    void checkOffsets();
+    void checkTargets();
     void makeBigBang();
     void createNewNode(const std::string& name, std::string& classname);
     void connectNodes(unsigned int from, unsigned int to);
@@ -30,6 +30,7 @@
 #include <vle/value/Set.hpp>
 #include <vle/value/String.hpp>
 #include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/LatticeModel.hpp>
 #include <boost/cast.hpp>
 
 namespace vle { namespace translator {
@@ -157,6 +158,9 @@ void MatrixTranslator::parseXML(const value::Value& value)
         if (cells.exist("symmetricport")) {
             m_symmetricport = cells.getBoolean("symmetricport");
         }
+        if (cells.exist("lattice")) {
+            m_lattice = cells.getBoolean("lattice");
+        }
         m_prefix = cells.getString("prefix");
 
         if (cells.exist("library")) {
@@ -222,138 +226,193 @@ void MatrixTranslator::translate(const value::Value& buffer)
 
         translateDynamics();
         translateConditions();
-        translateStructures();
+
+        m_exe.beginChanges();
+        try {
+            translateStructures();
+        } catch (...) {
+            m_exe.commitChanges();
+            throw;
+        }
+        m_exe.commitChanges();
     } catch (const std::exception& e) {
         throw utils::InternalError(fmt(
                 _("Matrix translator error: %1%")) % e.what());
     }
 }
 
-void MatrixTranslator::translateModel(unsigned int i,
-                                      unsigned int j)
+void MatrixTranslator::getPorts(unsigned int i, unsigned int j,
+                                std::vector < std::string >& inputs,
+                                std::vector < std::string >& outputs)
 {
-    const vpz::AtomicModel* atomicModel;
+    if (m_dimension == 0) {
+        if (i != 1) {
+            inputs.push_back("L");
+        }
 
-    if (not m_library.empty() or not m_libraries.empty()) {
-        std::vector < std::string > conditions;
-        conditions.push_back("cond_cell");
-        conditions.push_back((fmt("cond_%1%_%2%_%3%")
-                              % m_prefix % i % j).str());
+        if (i != m_size[0]) {
+            inputs.push_back("R");
+        }
 
-        atomicModel = m_exe.createModel(getName(i, j),
-                                        std::vector < std::string >(),
-                                        std::vector < std::string >(),
-                                        getDynamics(i, j),
-                                        conditions, "obs_cell");
-        m_models[getName(i,j)] = atomicModel;
-    } else {
-        atomicModel = dynamic_cast < const vpz::AtomicModel*>(
-            m_exe.createModelFromClass(getClass(i, j), getName(i, j)));
+        if (m_symmetricport) {
+            outputs = inputs;
+        } else {
+            outputs.push_back("out");
+        }
+        return;
     }
 
     if (i != 1)
-        m_exe.addInputPort(atomicModel->getName(), "N");
+        inputs.push_back("N");
 
     if (j != 1)
-        m_exe.addInputPort(atomicModel->getName(), "W");
+        inputs.push_back("W");
 
     if (i != m_size[0])
-        m_exe.addInputPort(atomicModel->getName(), "S");
+        inputs.push_back("S");
 
     if (j != m_size[1])
-        m_exe.addInputPort(atomicModel->getName(), "E");
+        inputs.push_back("E");
 
     if (m_connectivity == VON_NEUMANN) {
         if (i != 1 and j != 1) {
-            m_exe.addInputPort(atomicModel->getName(), "NW");
+            inputs.push_back("NW");
         }
 
         if (i != 1 and j != m_size[1]) {
-            m_exe.addInputPort(atomicModel->getName(), "NE");
+            inputs.push_back("NE");
         }
 
         if (i != m_size[0] and j != 1) {
-            m_exe.addInputPort(atomicModel->getName(), "SW");
+            inputs.push_back("SW");
         }
 
         if (i != m_size[0] and j != m_size[1]) {
-            m_exe.addInputPort(atomicModel->getName(), "SE");
+            inputs.push_back("SE");
         }
     }
 
     if (m_symmetricport) {
-        if (i != 1) {
-            m_exe.addOutputPort(atomicModel->getName(), "N");
-        }
+        outputs = inputs;
+    } else {
+        outputs.push_back("out");
+    }
+}
 
-        if (j != 1) {
-            m_exe.addOutputPort(atomicModel->getName(), "W");
-        }
+void MatrixTranslator::translateModel(unsigned int i,
+                                      unsigned int j)
+{
+    const vpz::AtomicModel* atomicModel;
+    std::vector < std::string > inputs, outputs;
 
-        if (i != m_size[0]) {
-            m_exe.addOutputPort(atomicModel->getName(), "S");
+    getPorts(i, j, inputs, outputs);
+
+    if (not m_library.empty() or not m_libraries.empty()) {
+        std::vector < std::string > conditions;
+        conditions.push_back("cond_cell");
+        conditions.push_back((fmt("cond_%1%_%2%_%3%")
+                              % m_prefix % i % j).str());
+
+        if (m_latticemodel) {
+            atomicModel = m_exe.createCell(m_latticemodel, i - 1, j - 1,
+                                           getName(i, j), inputs, outputs,
+                                           getDynamics(i, j), conditions,
+                                           "obs_cell");
+        } else {
+            atomicModel = m_exe.createModel(getName(i, j), inputs, outputs,
+                                            getDynamics(i, j), conditions,
+                                            "obs_cell");
         }
+        m_models[getName(i,j)] = atomicModel;
+    } else {
+        atomicModel = dynamic_cast < const vpz::AtomicModel*>(
+            m_exe.createModelFromClass(getClass(i, j), getName(i, j)));
 
-        if (j != m_size[1]) {
-            m_exe.addOutputPort(atomicModel->getName(), "E");
+        std::vector < std::string >::const_iterator it;
+        for (it = inputs.begin(); it != inputs.end(); ++it) {
+            m_exe.addInputPort(atomicModel->getName(), *it);
         }
 
-        if (m_connectivity == VON_NEUMANN) {
-            if (i != 1 and j != 1) {
-                m_exe.addOutputPort(atomicModel->getName(), "NW");
-            }
+        for (it = outputs.begin(); it != outputs.end(); ++it) {
+            m_exe.addOutputPort(atomicModel->getName(), *it);
+        }
+    }
+}
 
-            if (i != 1 and j != m_size[1]) {
-                m_exe.addOutputPort(atomicModel->getName(), "NE");
+void MatrixTranslator::setNeighbours(vpz::LatticeModel* lattice,
+                                     unsigned int neighbours,
+                                     bool symmetricport)
+{
+    /* The diagonal ports of translateSymmetricConnection2D. */
+    static const int offsets[4][2] = {
+        { -1, -1 }, { -1, 1 }, { 1, -1 }, { 1, 1 } };
+    static const char* outputs[4] = { "SW", "SE", "NW", "NE" };
+    static const char* inputs[4] = { "SE", "SW", "NE", "NW" };
+
+    if (neighbours == 2) {
+        lattice->setNeighbourhood(vpz::LatticeModel::LINEAR, symmetricport);
+    } else {
+        lattice->setNeighbourhood(vpz::LatticeModel::VON_NEUMANN,
+                                  symmetricport);
+
+        if (neighbours == 8) {
+            for (int i = 0; i < 4; ++i) {
+                lattice->addNeighbour(offsets[i][0], offsets[i][1],
+                                      symmetricport ? outputs[i] : "out",
+                                      inputs[i]);
             }
+        }
+    }
+}
 
-            if (i != m_size[0] and j != 1) {
-                m_exe.addOutputPort(atomicModel->getName(), "SW");
-            }
+void MatrixTranslator::translateLattice()
+{
+    if (m_library.empty() and m_libraries.empty()) {
+        throw utils::ArgError(
+            _("MatrixTranslator: lattice cells must be built from "
+              "libraries"));
+    }
 
-            if (i != m_size[0] and j != m_size[1]) {
-                m_exe.addOutputPort(atomicModel->getName(), "SE");
-            }
-        }
-    } else {
-        m_exe.addOutputPort(atomicModel->getName(), "out");
+    if (m_dimension == 0) {
+        m_latticemodel = m_exe.createLattice(m_prefix, 1, m_size[0]);
+        setNeighbours(m_latticemodel, 2, m_symmetricport);
+    } else if (m_dimension == 1) {
+        m_latticemodel = m_exe.createLattice(m_prefix, m_size[0],
+                                             m_size[1]);
+
+        /* The VON_NEUMANN connectivity of this translator is the eight
+         * neighbours. */
+        setNeighbours(m_latticemodel, m_connectivity == VON_NEUMANN ? 8 : 4,
+                      m_symmetricport);
     }
 }
 
 void MatrixTranslator::translateStructures()
 {
+    if (m_lattice) {
+        translateLattice();
+    }
+
     if (m_dimension == 0) {
         for (unsigned int i = 1; i <= m_size[0]; i++) {
-            std::vector < std::string > conditions;
+            std::vector < std::string > conditions, inputs, outputs;
 
             conditions.push_back("cond_cell");
             conditions.push_back((fmt("cond_%1%_%2%") % m_prefix %
                                   i).str());
-            const vpz::AtomicModel* atomicModel = m_exe.createModel(
-                getName(i), std::vector < std::string >(),
-                std::vector < std::string >(), getDynamics(i), conditions,
-                "obs_cell");
-            m_models[getName(i)] = atomicModel;
-
-            if (i != 1) {
-                m_exe.addInputPort(atomicModel->getName(), "L");
-            }
-
-            if (i != m_size[0]) {
-                m_exe.addInputPort(atomicModel->getName(), "R");
-            }
+            getPorts(i, 0, inputs, outputs);
 
-            if (m_symmetricport) {
-                if (i != 1) {
-                    m_exe.addOutputPort(atomicModel->getName(), "L");
-                }
-
-                if (i != m_size[0]) {
-                    m_exe.addOutputPort(atomicModel->getName(), "R");
-                }
+            const vpz::AtomicModel* atomicModel;
+            if (m_latticemodel) {
+                atomicModel = m_exe.createCell(
+                    m_latticemodel, 0, i - 1, getName(i), inputs, outputs,
+                    getDynamics(i), conditions, "obs_cell");
             } else {
-                m_exe.addOutputPort(atomicModel->getName(), "out");
+                atomicModel = m_exe.createModel(
+                    getName(i), inputs, outputs, getDynamics(i), conditions,
+                    "obs_cell");
             }
+            m_models[getName(i)] = atomicModel;
         }
     } else {
         if (m_dimension == 1) {
@@ -367,6 +426,10 @@ void MatrixTranslator::translateStructures()
         }
     }
 
+    if (m_latticemodel) {
+        return;
+    }
+
     if (m_dimension == 0) {
         for (unsigned int i = 1; i <= m_size[0]; i++) {
             if (m_symmetricport) {
@@ -48,6 +48,7 @@ namespace vle { namespace translator {
      *   <map>
      *    <key name="connectivity"><string>neuman|moore</string></key>
      *    <key name="symmetricport"><boolean>0|1</boolean></key>
+     *    <key name="lattice"><boolean>0|1</boolean></key>
      *    <key name="prefix"><string>cell</string></key>
      *    <key name="library"><string>libcellule</string>/key>
      *    <key name="model"><string>model</string>/key>
@@ -114,12 +115,18 @@ namespace vle { namespace translator {
      * Von neumann = 8
      * Mmoore = 4
      * @endcode
+     *
+     * With the lattice option, the cells are built into a vpz::LatticeModel
+     * named by the prefix and the neighbours are computed from its stencil
+     * instead of explicit connections. The cells must be built from
+     * libraries.
      */
     class VLE_API MatrixTranslator
     {
     public:
         MatrixTranslator(devs::Executive& exe)
-            : m_exe(exe), m_dimension(0), m_init(0), m_symmetricport(false)
+            : m_exe(exe), m_dimension(0), m_init(0), m_symmetricport(false),
+            m_lattice(false), m_latticemodel(0)
         {}
 
         virtual ~MatrixTranslator();
@@ -129,6 +136,19 @@ namespace vle { namespace translator {
 	unsigned int getSize(unsigned int i) const;
         void translate(const value::Value& buffer);
 
+        /**
+         * @brief Fill the stencil of a lattice with the neighbours and the
+         * ports of the connections built by the translator without the
+         * lattice option.
+         * @param lattice The lattice to fill.
+         * @param neighbours The number of neighbours: 2 for a vector, 4 or
+         * 8 for a matrix.
+         * @param symmetricport true to use an output port per neighbour.
+         */
+        static void setNeighbours(vpz::LatticeModel* lattice,
+                                  unsigned int neighbours,
+                                  bool symmetricport);
+
     private:
         typedef enum { VON_NEUMANN, MOORE, LINEAR } connectivity_t;
         typedef std::map < unsigned int, std::pair < std::string,
@@ -154,15 +174,21 @@ namespace vle { namespace translator {
         unsigned int* m_init;
         std::map < std::string , const vpz::AtomicModel* > m_models;
         bool m_symmetricport;
+        bool m_lattice;
+        vpz::LatticeModel* m_latticemodel;
 
         bool existModel(unsigned int i, unsigned int j = 0);
         std::string getDynamics(unsigned int i, unsigned int j = 0);
 
         std::string getClass(unsigned int i, unsigned int j = 0);
+        void getPorts(unsigned int i, unsigned int j,
+                      std::vector < std::string >& inputs,
+                      std::vector < std::string >& outputs);
 
         void parseXML(const value::Value& value);
         void translateModel(unsigned int i,
                             unsigned int j);
+        void translateLattice();
         void translateSymmetricConnection2D(unsigned int i,
                                             unsigned int j);
         void translateConnection2D(unsigned int i,
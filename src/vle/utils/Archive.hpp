@@ -0,0 +1,103 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_UTILS_ARCHIVE_HPP
+#define VLE_UTILS_ARCHIVE_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <string>
+
+namespace vle { namespace utils {
+
+/**
+ * A streaming writer of `.tar.gz' tarball. The files are added one by one,
+ * for instance when an output plug-in closes its file, and the tar stream is
+ * compressed by a pool of threads into independent gzip members. The result
+ * is read by tar, gzip and @c utils::Path::decompress.
+ *
+ * @code
+ * vle::utils::Archive archive("results.tar.gz");
+ * archive.add("output/exp_view.csv", "exp_view.csv");
+ * archive.add("output"); // a directory is added recursively.
+ * archive.close();
+ * @endcode
+ */
+class VLE_API Archive
+{
+public:
+    /**
+     * Create or truncate the tarball.
+     *
+     * @param tarfile The path of the `.tar.gz' file.
+     * @param jobs The number of compression threads, 0 uses the number of
+     * processors.
+     * @throw utils::FileError if the file can not be opened.
+     */
+    Archive(const std::string& tarfile, uint32_t jobs = 0);
+
+    /**
+     * Close the tarball if @c close was not called. The errors are lost.
+     */
+    ~Archive();
+
+    /**
+     * Add a file or, recursively, a directory with its path as name.
+     *
+     * @param filepath The file or the directory to add.
+     * @throw utils::FileError if the file can not be read or written.
+     */
+    void add(const std::string& filepath);
+
+    /**
+     * Add a file or, recursively, a directory.
+     *
+     * @param filepath The file or the directory to add.
+     * @param name The name of the file in the tarball.
+     * @throw utils::FileError if the file can not be read or written.
+     */
+    void add(const std::string& filepath, const std::string& name);
+
+    /**
+     * Write the end of the tarball and wait the end of the compression.
+     *
+     * @throw utils::FileError if the tarball can not be written.
+     */
+    void close();
+
+private:
+    Archive(const Archive&);
+    Archive& operator=(const Archive&);
+
+    class Pimpl;
+    Pimpl *mPimpl;
+};
+
+}} // namespace vle utils
+
+#endif
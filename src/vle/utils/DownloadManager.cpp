@@ -71,8 +71,13 @@ public:
         mUrl.assign(url);
         mServerFile.assign("/");
         mServerFile.append(serverfile);
-        mCompletePath.assign("http://");
-        mCompletePath.append(mUrl);
+
+        if (isLocal()) {
+            mCompletePath.assign(mUrl, 7, std::string::npos);
+        } else {
+            mCompletePath.assign("http://");
+            mCompletePath.append(mUrl);
+        }
         mCompletePath.append(mServerFile);
         mIsStarted = true;
         mThread = boost::thread(&DownloadManager::Pimpl::run, this);
@@ -88,6 +93,46 @@ public:
         }
     }
 
+    /**
+     * Return true if the url uses the @c file:// scheme: the resource is a
+     * file of a local mirror.
+     */
+    bool isLocal() const
+    {
+        return mUrl.compare(0, 7, "file://") == 0;
+    }
+
+    /**
+     * Copy the file of a local mirror into the temporary file.
+     */
+    void copy()
+    {
+        std::ifstream in(mCompletePath.c_str(),
+                         std::ios::in | std::ios::binary);
+
+        if (not in) {
+            mErrorMessage.assign((fmt(_("[DownloadManager] Can not open "
+                                        "'%1%'")) % mCompletePath).str());
+            mHasError = true;
+            return;
+        }
+
+        std::ofstream file;
+        mFilename.assign(utils::Path::getTempFile("vle-dl-", &file));
+
+        char buffer[8192];
+        while (in.read(buffer, sizeof(buffer)) or in.gcount() > 0) {
+            file.write(buffer, in.gcount());
+            mDownloadManageredSize += in.gcount();
+        }
+
+        if (in.bad() or not file) {
+            mErrorMessage.assign((fmt(_("[DownloadManager] Failed to copy "
+                                        "'%1%'")) % mCompletePath).str());
+            mHasError = true;
+        }
+    }
+
     void run()
     {
         if (not mIsStarted) {
@@ -95,6 +140,26 @@ public:
                 fmt(_("Download manager: already started")));
         }
 
+        if (isLocal()) {
+            copy();
+            return;
+        }
+
+        try {
+            download();
+        } catch (const std::exception& e) {
+            mErrorMessage.assign((fmt(_("[DownloadManager] Failed to "
+                                        "download '%1%': %2%"))
+                                  % mCompletePath % e.what()).str());
+            mHasError = true;
+        }
+    }
+
+    /**
+     * Download the resource with the http protocol.
+     */
+    void download()
+    {
         utils::Preferences prefs;
         std::string proxyip;
         prefs.get("vle.remote.proxy_ip", &proxyip);
@@ -37,8 +37,10 @@ namespace vle { namespace utils {
  * @brief An http file download process.
  *
  * \c DownloadManager is thread-safe and multi-threaded class which allows to
- * download files via http protocol. \c DownloadManager can not be
- * copied or assigned to another \c DownloadManager.
+ * download files via http protocol. An url with the \c file:// scheme
+ * (e.g. "file:///srv/mirror") copies the file from a local mirror.
+ * \c DownloadManager can not be copied or assigned to another \c
+ * DownloadManager.
  *
  * @code
  * vle::utils::DownloadManager dl;
@@ -74,7 +76,8 @@ public:
      * Start the download of the specified \c url in a thread. If a previous
      * thread is already alive, this function does nothing.
      *
-     * @param url The url of the server (e.g. "www.vle-project.org").
+     * @param url The url of the server (e.g. "www.vle-project.org" or
+     * "file:///srv/mirror").
      * @param serverfile The resource to download (e.g. "vle-1.0.0.dtd").
      */
     void start(const std::string& url,
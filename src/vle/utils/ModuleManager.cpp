@@ -35,6 +35,7 @@
 #include <boost/unordered_map.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/thread.hpp>
+#include <boost/thread/tss.hpp>
 #include <boost/version.hpp>
 
 #ifdef BOOST_WINDOWS
@@ -151,6 +152,10 @@ public:
      */
     void* get()
     {
+        if (mFunction) {
+            return mFunction;
+        }
+
         if (not mHandle) {
             init();
             checkVersion();
@@ -429,6 +434,26 @@ public:
 
     typedef std::map < std::string, void* > MapSymbol;
 
+    /**
+     * @brief The symbols already resolved by a thread. The key is built
+     * from the package, the library and the type wanted, the value is the
+     * symbol and the type of the module. This cache is only read and
+     * written by its thread.
+     */
+    struct SymbolCache
+    {
+        typedef std::pair < void*, ModuleType > value_type;
+        typedef boost::unordered_map < std::string, value_type > table_t;
+
+        SymbolCache(unsigned long owner)
+            : mOwner(owner)
+        {
+        }
+
+        unsigned long mOwner; /**< The identifier of the ModuleManager. */
+        table_t mTable;
+    };
+
     struct ModuleDeleter
     {
         void operator()(value_type& x) const
@@ -470,6 +495,29 @@ public:
 
     Pimpl()
     {
+        static boost::mutex mutex;
+        static unsigned long identifier = 0;
+
+        boost::mutex::scoped_lock lock(mutex);
+        mIdentifier = ++identifier;
+    }
+
+    /**
+     * @brief Get the symbol cache of the current thread. A cache left by a
+     * previous ModuleManager built at the same address is cleared.
+     *
+     * @return The symbol cache of the current thread.
+     */
+    SymbolCache& getSymbolCache()
+    {
+        SymbolCache *cache = mSymbolCache.get();
+
+        if (not cache or cache->mOwner != mIdentifier) {
+            cache = new SymbolCache(mIdentifier);
+            mSymbolCache.reset(cache);
+        }
+
+        return *cache;
     }
 
     ~Pimpl()
@@ -601,6 +649,10 @@ public:
     pimpl::SymbolTable mTableSymbols;
 
     boost::mutex mMutex;
+
+    unsigned long mIdentifier; /**< An unique identifier of the
+                                 ModuleManager. */
+    boost::thread_specific_ptr < SymbolCache > mSymbolCache;
 };
 
 ModuleManager::ModuleManager()
@@ -618,18 +670,33 @@ void *ModuleManager::get(const std::string& package,
                          ModuleType type,
                          ModuleType *newtype) const
 {
-    boost::mutex::scoped_lock lock(mPimpl->mMutex);
+    std::string key;
+    key.reserve(package.size() + library.size() + 2);
+    key.append(package).append(1, '/').append(library).append(
+        1, static_cast < char >('0' + type));
 
+    Pimpl::SymbolCache& cache(mPimpl->getSymbolCache());
+    Pimpl::SymbolCache::table_t::const_iterator it = cache.mTable.find(key);
 
-    if (not newtype) {
-        return mPimpl->getModule(package, library, type)->get();
-    } else {
-        pimpl::Module *module = mPimpl->getModule(package, library, type);
-        void *result = module->get();
-        *newtype = module->mType;
+    if (it == cache.mTable.end()) {
+        Pimpl::SymbolCache::value_type resolved;
+
+        {
+            boost::mutex::scoped_lock lock(mPimpl->mMutex);
+
+            pimpl::Module *module = mPimpl->getModule(package, library, type);
+            resolved.first = module->get();
+            resolved.second = module->mType;
+        }
 
-        return result;
+        it = cache.mTable.insert(std::make_pair(key, resolved)).first;
     }
+
+    if (newtype) {
+        *newtype = it->second.second;
+    }
+
+    return it->second.first;
 }
 
 void *ModuleManager::get(const std::string& symbol)
@@ -639,6 +706,18 @@ void *ModuleManager::get(const std::string& symbol)
     return mPimpl->getSymbol(symbol);
 }
 
+void ModuleManager::add(const std::string& package,
+                        const std::string& library,
+                        ModuleType type,
+                        void *symbol)
+{
+    boost::mutex::scoped_lock lock(mPimpl->mMutex);
+
+    pimpl::Module *module = mPimpl->getModule(package, library, type);
+    module->mFunction = symbol;
+    module->mType = type;
+}
+
 void ModuleManager::browse()
 {
     boost::mutex::scoped_lock lock(mPimpl->mMutex);
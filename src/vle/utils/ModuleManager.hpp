@@ -143,6 +143,10 @@ public:
      * MODULE_DYNAMICS_EXECUTIVE , the @e newtype will be affected by the
      * founded type.
      *
+     * The resolved symbols are cached per thread: only the first call for a
+     * combination of @c package, @c library and @e type takes the lock of
+     * the ModuleManager, the next calls from the same thread are lock-free.
+     *
      * @code
      * // try to load the shared library
      * // $VLE_HOME/.vle/pkgs/glue/lib/libcounter.so
@@ -196,6 +200,29 @@ public:
      */
     void *get(const std::string& symbol);
 
+    /**
+     * @brief Register a module built into the executable.
+     *
+     * The next calls to get(package, library, type) return the @e symbol
+     * without loading a shared library. Like the get(symbol) function, it
+     * allows to build executables where we store the simulators or the
+     * oov's modules, for instance in unit test.
+     *
+     * @code
+     * ModuleManager manager;
+     * manager.add("test", "counter", MODULE_DYNAMICS,
+     *             (void*)&make_new_counter);
+     * @endcode
+     *
+     * @param package The name of the package.
+     * @param library The name of the library.
+     * @param type MODULE_DYNAMICS, MODULE_DYNAMICS_EXECUTIVE,
+     * MODULE_DYNAMICS_WRAPPER or MODULE_OOV.
+     * @param symbol The function which builds the module.
+     */
+    void add(const std::string& package, const std::string& library,
+             ModuleType type, void *symbol);
+
     /*
       * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
        * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
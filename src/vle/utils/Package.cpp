@@ -36,6 +36,7 @@
 #include <glibmm/stringutils.h>
 #include <glibmm/miscutils.h>
 #include <glibmm/shell.h>
+#include <algorithm>
 #include <fstream>
 #include <ostream>
 #include <cstring>
@@ -260,7 +261,7 @@ void Package::test()
     fs::current_path(old_dir);
 }
 
-void Package::build()
+void Package::build(uint32_t jobs)
 {
     std::string pkg_buildir = getBuildDir(PKG_SOURCE);
     if (m_pimpl->mCommandBuild.empty()) {
@@ -289,6 +290,13 @@ void Package::build()
     cmd = (vle::fmt(m_pimpl->mCommandBuild) % pkg_buildir).str();
     buildCommandLine(cmd, exe, argv);
 
+    if (jobs > 1 and
+        std::find(argv.begin(), argv.end(), "--build") != argv.end() and
+        std::find(argv.begin(), argv.end(), "--") == argv.end()) {
+        argv.push_back("--");
+        argv.push_back((fmt("-j%1%") % jobs).str());
+    }
+
     try {
         m_pimpl->process(exe, pkg_buildir, argv);
     } catch(const std::exception& e) {
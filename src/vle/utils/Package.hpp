@@ -31,6 +31,7 @@
 #include <vle/DllDefines.hpp>
 #include <vle/utils/PackageTable.hpp>
 #include <vle/utils/Path.hpp>
+#include <vle/utils/Types.hpp>
 #include <string>
 
 namespace vle { namespace utils {
@@ -93,8 +94,11 @@ public:
 
     /**
      * Build the package by running the 'make all' command.
+     *
+     * @param jobs The number of jobs of the native build tool. If greater
+     * than one, `-- -j<jobs>' is appended to a `cmake --build' command.
      */
-    void build();
+    void build(uint32_t jobs = 1);
 
     /**
      * Install the package by running the 'make install' command from
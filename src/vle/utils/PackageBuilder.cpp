@@ -0,0 +1,548 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#if defined _WIN32 || defined __CYGWIN__
+# define BOOST_THREAD_USE_LIB
+# define BOOST_THREAD_DONT_USE_CHRONO
+#endif
+
+#include <vle/utils/PackageBuilder.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/utils/Package.hpp>
+#include <vle/utils/details/Md5.hpp>
+#include <vle/utils/details/PackageParser.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <sstream>
+
+namespace fs = boost::filesystem;
+
+namespace vle { namespace utils {
+
+/**
+ * The name of the file, in the build directory of a package, where the
+ * checksum of the latest installed build is stored.
+ */
+static const char *checksumFilename = "vle-build.md5";
+
+/**
+ * Append to @e files the regular files of the directory @e dir, except the
+ * @e skip directory, recursively.
+ */
+static void listFiles(const fs::path& dir, const fs::path& skip,
+                      std::vector < fs::path > *files)
+{
+    for (fs::directory_iterator it(dir), end; it != end; ++it) {
+        if (fs::is_directory(it->status())) {
+            if (it->path() != skip) {
+                listFiles(it->path(), skip, files);
+            }
+        } else if (fs::is_regular_file(it->status())) {
+            files->push_back(it->path());
+        }
+    }
+}
+
+/**
+ * Add the name and the content of a file to the checksum.
+ */
+static void updateFile(Md5 *md5, const fs::path& file,
+                       const std::string& name)
+{
+    md5->update(name.c_str(), name.size() + 1);
+
+    std::ifstream in(file.string().c_str(), std::ios::binary);
+    if (not in) {
+        throw FileError(fmt(_("Package builder: failed to read `%1%'")) %
+                        file.string());
+    }
+
+    char buffer[4096];
+    while (in) {
+        in.read(buffer, sizeof(buffer));
+        md5->update(buffer, in.gcount());
+    }
+}
+
+/**
+ * Check if the source package exists in the current directory, ie. if it has
+ * a Description.txt file.
+ */
+static bool existsSource(const Package& package)
+{
+    return fs::exists(package.getFile("Description.txt", PKG_SOURCE));
+}
+
+class PackageBuilder::Pimpl
+{
+public:
+    enum State { WAITING, RUNNING, INSTALLED, FAILED };
+
+    struct Node
+    {
+        Node(const std::string& name)
+            : package(name), state(WAITING), waiting(0)
+        {
+        }
+
+        Package package;
+        std::vector < std::string > installed; /**< Binary dependencies. */
+        std::vector < std::string > descriptions; /**< Their descriptions. */
+        std::vector < std::size_t > depends;   /**< Source dependencies. */
+        std::vector < std::size_t > children;  /**< Source dependents. */
+        std::string checksum;
+        State state;
+        std::size_t waiting;
+    };
+
+    Pimpl(uint32_t jobs, std::ostream& out, std::ostream& err)
+        : mJobs(std::max(jobs, (uint32_t)1)), mOut(out), mErr(err),
+          mRunning(0)
+    {
+    }
+
+    ~Pimpl()
+    {
+        for (std::size_t i = 0; i < mNodes.size(); ++i) {
+            delete mNodes[i];
+        }
+    }
+
+    /**
+     * Add the source package @e name and its source dependencies to the
+     * graph. @e visiting contains the packages being added and detects the
+     * cycles.
+     *
+     * @return The index of the package in the graph.
+     */
+    std::size_t add(const std::string& name,
+                    std::vector < std::string > *visiting)
+    {
+        std::map < std::string, std::size_t >::const_iterator found =
+            mIndex.find(name);
+
+        if (found != mIndex.end()) {
+            return found->second;
+        }
+
+        if (std::find(visiting->begin(), visiting->end(), name) !=
+            visiting->end()) {
+            throw ArgError(
+                fmt(_("Package builder: dependency cycle with `%1%'")) % name);
+        }
+
+        Node *node = new Node(name);
+
+        if (not existsSource(node->package)) {
+            delete node;
+            throw ArgError(
+                fmt(_("Package builder: no source package `%1%'")) % name);
+        }
+
+        PackagesLinkId links;
+        try {
+            PackageParser parser;
+            parser.extract(node->package.getFile("Description.txt",
+                                                 PKG_SOURCE),
+                           std::string());
+
+            if (parser.empty()) {
+                throw ArgError(fmt(_("no package in `%1%'")) %
+                               node->package.getFile("Description.txt",
+                                                     PKG_SOURCE));
+            }
+
+            links = parser.begin()->depends;
+            links.insert(links.end(), parser.begin()->builddepends.begin(),
+                         parser.begin()->builddepends.end());
+        } catch (const std::exception& e) {
+            delete node;
+            throw ArgError(
+                fmt(_("Package builder: failed to read the description of"
+                      " `%1%': %2%")) % name % e.what());
+        }
+
+        visiting->push_back(name);
+
+        try {
+            for (PackagesLinkId::const_iterator it = links.begin();
+                 it != links.end(); ++it) {
+                Package dependency(it->name);
+
+                if (existsSource(dependency)) {
+                    node->depends.push_back(add(it->name, visiting));
+                } else if (dependency.existsBinary()) {
+                    node->installed.push_back(it->name);
+                    node->descriptions.push_back(
+                        dependency.getFile("Description.txt", PKG_BINARY));
+                } else {
+                    throw ArgError(
+                        fmt(_("Package builder: `%1%' depends on `%2%' which"
+                              " is neither a source package nor installed"))
+                        % name % it->name);
+                }
+            }
+        } catch (...) {
+            delete node;
+            throw;
+        }
+
+        visiting->pop_back();
+
+        std::sort(node->depends.begin(), node->depends.end());
+        node->depends.erase(std::unique(node->depends.begin(),
+                                        node->depends.end()),
+                            node->depends.end());
+
+        std::size_t index = mNodes.size();
+        for (std::size_t i = 0; i < node->depends.size(); ++i) {
+            mNodes[node->depends[i]]->children.push_back(index);
+        }
+        node->waiting = node->depends.size();
+
+        mNodes.push_back(node);
+        mIndex[name] = index;
+
+        return index;
+    }
+
+    /**
+     * Compute the checksum of the sources of the package, except the build
+     * directory, of the checksums of its source dependencies and of the
+     * description of its installed dependencies.
+     */
+    std::string checksum(const Node& node) const
+    {
+        fs::path source(node.package.getDir(PKG_SOURCE));
+        fs::path build(node.package.getBuildDir(PKG_SOURCE));
+        std::vector < fs::path > files;
+        Md5 md5;
+
+        listFiles(source, build, &files);
+        std::sort(files.begin(), files.end());
+
+        std::string::size_type prefix = source.string().size();
+        for (std::size_t i = 0; i < files.size(); ++i) {
+            updateFile(&md5, files[i], files[i].string().substr(prefix));
+        }
+
+        for (std::size_t i = 0; i < node.depends.size(); ++i) {
+            const std::string& sum(mNodes[node.depends[i]]->checksum);
+            md5.update(sum.c_str(), sum.size());
+        }
+
+        for (std::size_t i = 0; i < node.installed.size(); ++i) {
+            fs::path file(node.descriptions[i]);
+
+            if (fs::exists(file)) {
+                updateFile(&md5, file, node.installed[i]);
+            }
+        }
+
+        return md5.hexdigest();
+    }
+
+    /**
+     * Start a command of the package, wait its end and write its output.
+     *
+     * @return true if the command succeeds.
+     */
+    bool command(Node *node, const std::string& name, uint32_t jobs)
+    {
+        std::ostringstream out, err;
+        bool success = false;
+
+        try {
+            {
+                /* The commands of the Package class change the current
+                 * directory of the process while they start. */
+                boost::mutex::scoped_lock lock(mCommandMutex);
+
+                if (name == "configure") {
+                    node->package.configure();
+                } else if (name == "build") {
+                    node->package.build(jobs);
+                } else {
+                    node->package.install();
+                }
+            }
+
+            node->package.wait(out, err);
+            success = node->package.isSuccess();
+        } catch (const std::exception& e) {
+            err << e.what() << '\n';
+        }
+
+        boost::mutex::scoped_lock lock(mMutex);
+        mOut << out.str();
+        mErr << err.str();
+        mOut << fmt(_("Package `%1%': %2% %3%\n")) % node->package.name() %
+            name % (success ? _("ok") : _("failed"));
+
+        return success;
+    }
+
+    /**
+     * Build and install the package if its checksum differs from the
+     * checksum of the latest installed build.
+     */
+    bool make(Node *node, uint32_t jobs)
+    {
+        fs::path build(node->package.getBuildDir(PKG_SOURCE));
+        fs::path stamp(build / checksumFilename);
+        std::string sum;
+
+        try {
+            sum = checksum(*node);
+        } catch (const std::exception& e) {
+            boost::mutex::scoped_lock lock(mMutex);
+            mErr << fmt(_("Package `%1%': %2%\n")) % node->package.name() %
+                e.what();
+            return false;
+        }
+
+        if (node->package.existsBinary() and fs::exists(stamp)) {
+            std::ifstream in(stamp.string().c_str());
+            std::string previous;
+
+            if (in >> previous and previous == sum) {
+                boost::mutex::scoped_lock lock(mMutex);
+                node->checksum = sum;
+                mOut << fmt(_("Package `%1%': up to date\n")) %
+                    node->package.name();
+                return true;
+            }
+        }
+
+        if (not fs::exists(build) and not command(node, "configure", jobs)) {
+            return false;
+        }
+
+        if (not command(node, "build", jobs) or
+            not command(node, "install", jobs)) {
+            return false;
+        }
+
+        std::ofstream out(stamp.string().c_str());
+        out << sum << '\n';
+
+        boost::mutex::scoped_lock lock(mMutex);
+        node->checksum = sum;
+        return true;
+    }
+
+    /**
+     * Mark the package and, recursively, its dependents as failed.
+     */
+    void fail(std::size_t index)
+    {
+        Node *node = mNodes[index];
+
+        if (node->state != FAILED) {
+            if (node->state == WAITING) {
+                mOut << fmt(_("Package `%1%': skipped, a dependency"
+                              " failed\n")) % node->package.name();
+            }
+
+            node->state = FAILED;
+            for (std::size_t i = 0; i < node->children.size(); ++i) {
+                fail(node->children[i]);
+            }
+        }
+    }
+
+    /**
+     * The @c Worker is a boost thread functor which builds the packages
+     * whose source dependencies are installed until all the packages are
+     * built or failed.
+     */
+    struct Worker
+    {
+        Pimpl *pimpl;
+        uint32_t jobs;
+
+        Worker(Pimpl *pimpl, uint32_t jobs)
+            : pimpl(pimpl), jobs(jobs)
+        {
+        }
+
+        void operator()() const
+        {
+            boost::mutex::scoped_lock lock(pimpl->mMutex);
+
+            for (;;) {
+                std::size_t index = pimpl->mNodes.size();
+                bool waiting = false;
+
+                for (std::size_t i = 0; i < pimpl->mNodes.size(); ++i) {
+                    const Node *node = pimpl->mNodes[i];
+
+                    if (node->state == WAITING) {
+                        if (node->waiting == 0) {
+                            index = i;
+                            break;
+                        }
+                        waiting = true;
+                    }
+                }
+
+                if (index == pimpl->mNodes.size()) {
+                    if (not waiting or pimpl->mRunning == 0) {
+                        pimpl->mCondition.notify_all();
+                        return;
+                    }
+
+                    pimpl->mCondition.wait(lock);
+                    continue;
+                }
+
+                Node *node = pimpl->mNodes[index];
+                node->state = RUNNING;
+                pimpl->mRunning++;
+
+                lock.unlock();
+                bool success = pimpl->make(node, jobs);
+                lock.lock();
+
+                pimpl->mRunning--;
+                if (success) {
+                    node->state = INSTALLED;
+                    for (std::size_t i = 0; i < node->children.size(); ++i) {
+                        pimpl->mNodes[node->children[i]]->waiting--;
+                    }
+                } else {
+                    pimpl->fail(index);
+                }
+
+                pimpl->mCondition.notify_all();
+            }
+        }
+    };
+
+    bool run()
+    {
+        uint32_t workers = std::min(mJobs, (uint32_t)mNodes.size());
+        boost::thread_group gp;
+
+        if (workers == 0) {
+            return true;
+        }
+
+        for (std::size_t i = 0; i < mNodes.size(); ++i) {
+            mNodes[i]->state = WAITING;
+            mNodes[i]->waiting = mNodes[i]->depends.size();
+        }
+
+        for (uint32_t i = 0; i < workers; ++i) {
+            gp.create_thread(Worker(this, std::max(mJobs / workers,
+                                                   (uint32_t)1)));
+        }
+
+        gp.join_all();
+
+        for (std::size_t i = 0; i < mNodes.size(); ++i) {
+            if (mNodes[i]->state != INSTALLED) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::vector < Node* > mNodes; /**< The packages, dependencies first. */
+    std::map < std::string, std::size_t > mIndex;
+    uint32_t mJobs;
+    std::ostream& mOut;
+    std::ostream& mErr;
+    uint32_t mRunning;
+    boost::mutex mMutex;
+    boost::mutex mCommandMutex;
+    boost::condition_variable mCondition;
+};
+
+PackageBuilder::PackageBuilder(uint32_t jobs, std::ostream& out,
+                               std::ostream& err)
+    : mPimpl(new PackageBuilder::Pimpl(jobs, out, err))
+{
+}
+
+PackageBuilder::~PackageBuilder()
+{
+    delete mPimpl;
+}
+
+void PackageBuilder::add(const std::string& name)
+{
+    std::vector < std::string > visiting;
+
+    mPimpl->add(name, &visiting);
+}
+
+std::vector < std::string > PackageBuilder::order() const
+{
+    std::vector < std::string > result;
+
+    for (std::size_t i = 0; i < mPimpl->mNodes.size(); ++i) {
+        result.push_back(mPimpl->mNodes[i]->package.name());
+    }
+
+    return result;
+}
+
+std::vector < std::string > PackageBuilder::installed() const
+{
+    std::vector < std::string > result;
+
+    for (std::size_t i = 0; i < mPimpl->mNodes.size(); ++i) {
+        const std::vector < std::string >& names(
+            mPimpl->mNodes[i]->installed);
+
+        for (std::size_t j = 0; j < names.size(); ++j) {
+            if (std::find(result.begin(), result.end(), names[j]) ==
+                result.end()) {
+                result.push_back(names[j]);
+            }
+        }
+    }
+
+    return result;
+}
+
+bool PackageBuilder::run()
+{
+    return mPimpl->run();
+}
+
+}} // namespace vle utils
@@ -0,0 +1,118 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_UTILS_PACKAGEBUILDER_HPP
+#define VLE_UTILS_PACKAGEBUILDER_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace vle { namespace utils {
+
+/**
+ * Build several source packages of the current directory at the same time.
+ *
+ * The dependencies (@c Depends and @c Build-Depends fields of the
+ * Description.txt file) of the packages are read to build a graph: a package
+ * is configured, built and installed once all its source dependencies are
+ * installed, and up to @e jobs independent packages are built in parallel.
+ * The dependencies not available as source package must be installed.
+ *
+ * A checksum of the sources of the package and of its dependencies is stored
+ * into the build directory after a successful install. A package with the
+ * same checksum is not rebuilt.
+ *
+ * @code
+ * vle::utils::PackageBuilder builder(4, std::cout, std::cerr);
+ * builder.add("glue");
+ * builder.add("weather");
+ *
+ * if (not builder.run()) {
+ *     std::cerr << "build failure\n";
+ * }
+ * @endcode
+ */
+class VLE_API PackageBuilder
+{
+public:
+    /**
+     * @param jobs The number of processors available. At most @e jobs
+     * packages are built at the same time, each with @e jobs / packages jobs
+     * for the native build tool.
+     * @param out The stream where the output of the commands is written.
+     * @param err The stream where the error of the commands is written.
+     */
+    PackageBuilder(uint32_t jobs, std::ostream& out, std::ostream& err);
+
+    ~PackageBuilder();
+
+    /**
+     * Add the source package @e name and its source dependencies.
+     *
+     * @param name The name of the package in the current directory.
+     * @throw utils::ArgError if the package, a dependency does not exist or
+     * if the dependencies have a cycle.
+     */
+    void add(const std::string& name);
+
+    /**
+     * Get the source packages in the build order, the dependencies first.
+     *
+     * @return The names of the source packages.
+     */
+    std::vector < std::string > order() const;
+
+    /**
+     * Get the dependencies only available as installed packages.
+     *
+     * @return The names of the installed packages.
+     */
+    std::vector < std::string > installed() const;
+
+    /**
+     * Configure, build and install the source packages. The packages which
+     * depend on a failed package are not built.
+     *
+     * @return true if all packages are installed, false otherwise.
+     */
+    bool run();
+
+private:
+    PackageBuilder(const PackageBuilder&);
+    PackageBuilder& operator=(const PackageBuilder&);
+
+    class Pimpl;
+    Pimpl *mPimpl;
+};
+
+}} // namespace vle utils
+
+#endif
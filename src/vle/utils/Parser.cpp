@@ -29,9 +29,14 @@
 #include <vle/utils/Exception.hpp>
 #include <vle/utils/i18n.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <ctime>
 #include <vector>
 #include <string>
 #include <sstream>
+#include <zlib.h>
 
 namespace vle { namespace utils {
 
@@ -58,6 +63,26 @@ Block& Block::addBlock(const std::string& name)
     return it->second;
 }
 
+void Block::swap(Block& block)
+{
+    name.swap(block.name);
+    strings.swap(block.strings);
+    relativeReals.swap(block.relativeReals);
+    reals.swap(block.reals);
+    realArrays.swap(block.realArrays);
+    blocks.swap(block.blocks);
+}
+
+const std::vector < double >& Block::getReals(const std::string& key) const
+{
+    RealArrays::const_iterator it = realArrays.find(key);
+    if (it == realArrays.end()) {
+        throw utils::ParseError(fmt(
+                _("The reals `%1%' do not exist")) % key);
+    }
+    return it->second;
+}
+
 const Block& Block::getBlock(const std::string& name) const
 {
     std::multimap < std::string, Block >::const_iterator it = blocks.find(name);
@@ -68,9 +93,9 @@ const Block& Block::getBlock(const std::string& name) const
     return it->second;
 }
 
-Parser::Parser(std::istream& stream) throw(utils::ParseError)
+Parser::Parser(std::istream& stream, bool flat) throw(utils::ParseError)
     : mRoot(std::string()), mStream(stream), mLine(0), mOldLine(0), mColumn(0),
-    mOldColumn(0), mLast(0)
+    mOldColumn(0), mLast(0), mFlat(flat)
 {
     try {
         readBlock(mRoot);
@@ -315,6 +340,13 @@ void Parser::readBlock(Block& block)
                     readComma();
                     block.addString(str, readQuotedString());
                 }
+            } else if (nextToken() == Real and mFlat) {
+                std::vector < double >& values(block.realArrays[str]);
+                values.push_back(readReal());
+                while (nextToken() == Parser::Comma) {
+                    readComma();
+                    values.push_back(readReal());
+                }
             } else if (nextToken() == Real) {
                 block.addReal(str, readReal());
                 while (nextToken() == Parser::Comma) {
@@ -344,4 +376,143 @@ void Parser::readBlock(Block& block)
     } while (nextToken() != Parser::End and mStream);
 }
 
+namespace {
+
+struct ParserCacheEntry
+{
+    ParserCacheEntry()
+        : mtime(0), size(0)
+    {}
+
+    boost::mutex mutex; ///< taken while the file is parsed
+    std::time_t mtime;
+    boost::uintmax_t size;
+    ParserCache::BlockPtr root;
+};
+
+/*
+ * The cache is leaked to stay valid in the destructors of static objects.
+ */
+struct ParserCacheTable
+{
+    typedef std::map < std::string,
+            boost::shared_ptr < ParserCacheEntry > > Entries;
+
+    boost::mutex mutex;
+    Entries entries;
+};
+
+ParserCacheTable& parserCacheTable()
+{
+    static ParserCacheTable* table = new ParserCacheTable();
+
+    return *table;
+}
+
+/*
+ * Read the whole file. The zlib gzread function reads the gzip compressed
+ * files and copies the others.
+ */
+std::string readFile(const std::string& filepath)
+{
+    gzFile file = gzopen(filepath.c_str(), "rb");
+
+    if (not file) {
+        throw utils::FileError(fmt(
+                _("Parser: failed to open `%1%'")) % filepath);
+    }
+
+    std::string result;
+    char buffer[65536];
+    int len;
+
+    while ((len = gzread(file, buffer, sizeof(buffer))) > 0) {
+        result.append(buffer, len);
+    }
+
+    std::string error;
+    if (len < 0) {
+        int code;
+        const char *msg = gzerror(file, &code);
+        error = msg ? msg : "gzread";
+    }
+
+    gzclose(file);
+
+    if (not error.empty()) {
+        throw utils::FileError(fmt(
+                _("Parser: failed to read `%1%': %2%")) % filepath % error);
+    }
+
+    return result;
+}
+
+} // anonymous namespace
+
+ParserCache::BlockPtr ParserCache::get(const std::string& filepath)
+{
+    namespace fs = boost::filesystem;
+
+    fs::path path(filepath);
+
+    if (not fs::exists(path) or not fs::is_regular_file(path)) {
+        throw utils::FileError(fmt(
+                _("Parser: the file `%1%' does not exist")) % filepath);
+    }
+
+    std::time_t mtime = fs::last_write_time(path);
+    boost::uintmax_t size = fs::file_size(path);
+    boost::shared_ptr < ParserCacheEntry > entry;
+
+    {
+        ParserCacheTable& table(parserCacheTable());
+        boost::lock_guard < boost::mutex > lock(table.mutex);
+
+        boost::shared_ptr < ParserCacheEntry >& found(
+            table.entries[fs::system_complete(path).string()]);
+
+        if (not found) {
+            found.reset(new ParserCacheEntry());
+        }
+
+        entry = found;
+    }
+
+    boost::lock_guard < boost::mutex > lock(entry->mutex);
+
+    if (not entry->root or entry->mtime != mtime or entry->size != size) {
+        std::istringstream in(readFile(filepath));
+        boost::shared_ptr < Block > root(new Block(std::string()));
+
+        try {
+            Parser parser(in, true);
+            root->swap(parser.mRoot);
+        } catch (const std::exception& e) {
+            throw utils::ParseError(fmt(_("%1%: %2%")) % filepath % e.what());
+        }
+
+        entry->root = root;
+        entry->mtime = mtime;
+        entry->size = size;
+    }
+
+    return entry->root;
+}
+
+void ParserCache::clear()
+{
+    ParserCacheTable& table(parserCacheTable());
+    boost::lock_guard < boost::mutex > lock(table.mutex);
+
+    table.entries.clear();
+}
+
+std::size_t ParserCache::size()
+{
+    ParserCacheTable& table(parserCacheTable());
+    boost::lock_guard < boost::mutex > lock(table.mutex);
+
+    return table.entries.size();
+}
+
 }} // namespace vle utils
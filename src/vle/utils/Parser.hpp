@@ -30,9 +30,11 @@
 
 #include <vle/DllDefines.hpp>
 #include <vle/utils/Exception.hpp>
+#include <boost/shared_ptr.hpp>
 #include <istream>
 #include <string>
 #include <map>
+#include <vector>
 
 namespace vle { namespace utils {
 
@@ -42,6 +44,7 @@ struct VLE_API Block
     typedef std::multimap < std::string, double > Reals;
     typedef std::multimap < std::string, double > RelativeReals;
     typedef std::multimap < std::string, Block > Blocks;
+    typedef std::map < std::string, std::vector < double > > RealArrays;
 
     typedef std::pair < Reals::const_iterator,
             Reals::const_iterator > RealsResult;
@@ -64,12 +67,30 @@ struct VLE_API Block
 
     Block& addBlock(const std::string& name);
 
+    /**
+     * Exchange the content of two blocks without copy.
+     *
+     * @param block The block to exchange with.
+     */
+    void swap(Block& block);
+
     const Block& getBlock(const std::string& name) const;
 
+    /**
+     * Get the real values of a key of a block parsed with the flat storage
+     * (see @c Parser).
+     *
+     * @param key The key of the values.
+     * @return The values in the order of the file.
+     * @throw utils::ParseError if the key has no real value.
+     */
+    const std::vector < double >& getReals(const std::string& key) const;
+
     std::string name;
     Strings strings;
     RelativeReals relativeReals;
     Reals reals;
+    RealArrays realArrays; ///< the reals of the flat storage.
     Blocks blocks;
 };
 
@@ -97,9 +118,14 @@ public:
      * @endcode
      *
      * @param stream A standard input stream to read data.
+     * @param flat If true, the reals of a key are stored into a vector of
+     * the @c Block::realArrays map instead of the @c Block::reals multimap:
+     * one contiguous array instead of one tree node per value for the long
+     * numeric sequences.
      * @throw utils::ParseError if an error occured during parsing file.
      */
-    Parser(std::istream& stream) throw(utils::ParseError);
+    Parser(std::istream& stream, bool flat = false)
+        throw(utils::ParseError);
 
     /**
      * @brief Access to the root of the data.
@@ -182,6 +208,8 @@ private:
 
     Token nextToken();
 
+    friend class ParserCache;
+
     //
     // attributes
     //
@@ -193,6 +221,54 @@ private:
     long mColumn; ///< number of character readed
     long mOldColumn; ///< previous number of column read (when use unged)
     char mLast; ///< latest character readed from the stream
+    bool mFlat; ///< store the reals into Block::realArrays
+};
+
+/**
+ * A cache of parsed files shared by all the models, simulations and threads
+ * of the process. A file is parsed once with the flat storage and the
+ * read-only result is shared until the modification time or the size of the
+ * file change. The gzip compressed files are read transparently.
+ *
+ * @code
+ * // in the constructor of a model:
+ * mTable = vle::utils::ParserCache::get(
+ *     pkg.getDataFile("forcing.dat"));
+ * const std::vector < double >& temperatures =
+ *     mTable->getBlock("weather").getReals("temperature");
+ * @endcode
+ */
+class VLE_API ParserCache
+{
+public:
+    typedef boost::shared_ptr < const Block > BlockPtr;
+
+    /**
+     * Get the root block of a file, parsed with the flat storage. This
+     * function is thread-safe.
+     *
+     * @param filepath The file to parse, gzip compressed or not.
+     * @return A shared pointer to the read-only root of the file.
+     * @throw utils::FileError if the file can not be read.
+     * @throw utils::ParseError if the file is not valid.
+     */
+    static BlockPtr get(const std::string& filepath);
+
+    /**
+     * Forget all the parsed files. The blocks still used are released by
+     * their last user.
+     */
+    static void clear();
+
+    /**
+     * Get the number of parsed files in the cache.
+     *
+     * @return The number of files.
+     */
+    static std::size_t size();
+
+private:
+    ParserCache();
 };
 
 }} // namespace vle utils
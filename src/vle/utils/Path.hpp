@@ -239,6 +239,14 @@ public:
      *
      * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+    /**
+     * Compress the file or the directory into a tarball. A `.gz' or `.tgz'
+     * tarball is compressed in parallel with @c utils::Archive, the others
+     * use bzip2.
+     *
+     * @param filepath The file or the directory to compress.
+     * @param compressedfilepath The tarball to build.
+     */
     static void compress(const std::string& filepath,
                          const std::string& compressedfilepath);
 
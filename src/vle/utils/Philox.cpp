@@ -0,0 +1,261 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <vle/utils/Philox.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace vle { namespace utils {
+
+namespace {
+
+const boost::uint32_t PHILOX_M0 = 0xD2511F53;
+const boost::uint32_t PHILOX_M1 = 0xCD9E8D57;
+const boost::uint32_t PHILOX_W0 = 0x9E3779B9;
+const boost::uint32_t PHILOX_W1 = 0xBB67AE85;
+const unsigned int PHILOX_ROUNDS = 10;
+
+/*
+ * Number of blocks computed together by the lanes function. The loops on the
+ * lanes have no dependencies and are vectorised by the compiler (the 32x32
+ * bits products map to pmuludq).
+ */
+const std::size_t PHILOX_LANES = 8;
+
+inline boost::uint32_t lo(boost::uint64_t x)
+{
+    return static_cast < boost::uint32_t >(x);
+}
+
+inline boost::uint32_t hi(boost::uint64_t x)
+{
+    return static_cast < boost::uint32_t >(x >> 32);
+}
+
+/*
+ * Compute the blocks [first, first + PHILOX_LANES) of a stream and write them
+ * in the natural order into out.
+ */
+void lanes(boost::uint64_t key, boost::uint64_t stream,
+           boost::uint64_t first, boost::uint32_t* out)
+{
+    boost::uint32_t c0[PHILOX_LANES], c1[PHILOX_LANES], c2[PHILOX_LANES],
+        c3[PHILOX_LANES];
+    boost::uint32_t k0 = lo(key), k1 = hi(key);
+
+    for (std::size_t l = 0; l < PHILOX_LANES; ++l) {
+        c0[l] = lo(first + l);
+        c1[l] = hi(first + l);
+        c2[l] = lo(stream);
+        c3[l] = hi(stream);
+    }
+
+    for (unsigned int r = 0; r < PHILOX_ROUNDS; ++r) {
+        for (std::size_t l = 0; l < PHILOX_LANES; ++l) {
+            boost::uint64_t p0 = (boost::uint64_t)PHILOX_M0 * c0[l];
+            boost::uint64_t p1 = (boost::uint64_t)PHILOX_M1 * c2[l];
+
+            c0[l] = hi(p1) ^ c1[l] ^ k0;
+            c1[l] = lo(p1);
+            c2[l] = hi(p0) ^ c3[l] ^ k1;
+            c3[l] = lo(p0);
+        }
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    for (std::size_t l = 0; l < PHILOX_LANES; ++l) {
+        out[4 * l] = c0[l];
+        out[4 * l + 1] = c1[l];
+        out[4 * l + 2] = c2[l];
+        out[4 * l + 3] = c3[l];
+    }
+}
+
+/*
+ * Convert the 32 bits numbers pairs into reals [0, 1) like
+ * Philox::getDouble().
+ */
+inline void toDouble(const boost::uint32_t* in, double* out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = ((in[2 * i] >> 5) * 67108864.0 + (in[2 * i + 1] >> 6)) *
+            (1.0 / 9007199254740992.0);
+    }
+}
+
+} // anonymous namespace
+
+const bool Philox::has_fixed_range;
+const Philox::result_type Philox::min_value;
+const Philox::result_type Philox::max_value;
+
+void Philox::block(const boost::uint32_t ctr[4],
+                   const boost::uint32_t key[2],
+                   boost::uint32_t out[4])
+{
+    boost::uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    boost::uint32_t k0 = key[0], k1 = key[1];
+
+    for (unsigned int r = 0; r < PHILOX_ROUNDS; ++r) {
+        boost::uint64_t p0 = (boost::uint64_t)PHILOX_M0 * c0;
+        boost::uint64_t p1 = (boost::uint64_t)PHILOX_M1 * c2;
+
+        c0 = hi(p1) ^ c1 ^ k0;
+        c1 = lo(p1);
+        c2 = hi(p0) ^ c3 ^ k1;
+        c3 = lo(p0);
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+void Philox::seed(key_type key, boost::uint64_t stream)
+{
+    m_key = key;
+    m_stream = stream;
+    m_block = 0;
+    m_index = 4;
+}
+
+Philox::key_type Philox::derive(key_type seed, const std::string& name,
+                                boost::uint32_t replicate)
+{
+    boost::uint64_t hash = UINT64_C(0xCBF29CE484222325); // FNV-1a
+
+    for (std::string::const_iterator it = name.begin(); it != name.end();
+         ++it) {
+        hash ^= static_cast < unsigned char >(*it);
+        hash *= UINT64_C(0x100000001B3);
+    }
+
+    const boost::uint32_t ctr[4] = { lo(hash), hi(hash), replicate,
+        0x564C4531 /* VLE1 */ };
+    const boost::uint32_t key[2] = { lo(seed), hi(seed) };
+    boost::uint32_t out[4];
+
+    block(ctr, key, out);
+
+    return ((boost::uint64_t)out[1] << 32) | out[0];
+}
+
+void Philox::discard(boost::uint64_t n)
+{
+    boost::uint64_t target = position() + n;
+
+    m_block = target / 4;
+    m_index = 4;
+
+    if (target % 4) {
+        refill();
+        m_index = target % 4;
+    }
+}
+
+void Philox::refill()
+{
+    const boost::uint32_t ctr[4] = { lo(m_block), hi(m_block), lo(m_stream),
+        hi(m_stream) };
+    const boost::uint32_t key[2] = { lo(m_key), hi(m_key) };
+
+    block(ctr, key, m_buffer);
+    m_block++;
+    m_index = 0;
+}
+
+void Philox::fill(boost::uint32_t* out, std::size_t n)
+{
+    while (n and m_index < 4) {
+        *out++ = m_buffer[m_index++];
+        n--;
+    }
+
+    while (n >= 4 * PHILOX_LANES) {
+        lanes(m_key, m_stream, m_block, out);
+        m_block += PHILOX_LANES;
+        out += 4 * PHILOX_LANES;
+        n -= 4 * PHILOX_LANES;
+    }
+
+    while (n--) {
+        *out++ = (*this)();
+    }
+}
+
+void Philox::fillUniform(double* out, std::size_t n)
+{
+    boost::uint32_t tmp[16 * 4 * PHILOX_LANES];
+    const std::size_t chunk = sizeof(tmp) / sizeof(tmp[0]) / 2;
+
+    while (n) {
+        std::size_t m = std::min(n, chunk);
+
+        fill(tmp, 2 * m);
+        toDouble(tmp, out, m);
+        out += m;
+        n -= m;
+    }
+}
+
+void Philox::fillUniform(double* out, std::size_t n, double begin, double end)
+{
+    fillUniform(out, n);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = begin + out[i] * (end - begin);
+    }
+}
+
+void Philox::fillNormal(double* out, std::size_t n, double mean, double sigma)
+{
+    const double twopi = 6.28318530717958647692;
+
+    fillUniform(out, n);
+
+    for (std::size_t i = 0; i + 1 < n; i += 2) {
+        double r = std::sqrt(-2.0 * std::log(1.0 - out[i]));
+        double theta = twopi * out[i + 1];
+
+        out[i] = mean + sigma * r * std::cos(theta);
+        out[i + 1] = mean + sigma * r * std::sin(theta);
+    }
+
+    if (n % 2) {
+        double r = std::sqrt(-2.0 * std::log(1.0 - out[n - 1]));
+        double theta = twopi * getDouble();
+
+        out[n - 1] = mean + sigma * r * std::cos(theta);
+    }
+}
+
+}} // namespace vle utils
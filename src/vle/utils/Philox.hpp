@@ -0,0 +1,230 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_UTILS_PHILOX_HPP
+#define VLE_UTILS_PHILOX_HPP
+
+#include <vle/DllDefines.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <string>
+
+namespace vle { namespace utils {
+
+    /**
+     * @brief vle::utils::Philox is a counter-based pseudo-random number
+     * generator (Philox4x32-10). Each output block is a bijection of a
+     * 128 bits counter under a 64 bits key: the generator has no hidden
+     * state, any position of a stream can be reached in constant time and
+     * independent streams are obtained by changing the key or the high part
+     * of the counter. The sequences produced are the same on all platforms
+     * and do not depend on the number of threads used to consume them.
+     *
+     * Philox models the boost UniformRandomNumberGenerator concept and can
+     * be used with all the boost::random distributions.
+     *
+     * @note "Parallel random numbers: as easy as 1, 2, 3", John K. Salmon,
+     * Mark A. Moraes, Ron O. Dror and David E. Shaw, Proceedings of 2011
+     * International Conference for High Performance Computing, Networking,
+     * Storage and Analysis.
+     *
+     * @code
+     * // A stream per model and per replicate of an experiment.
+     * vle::utils::Philox r(vle::utils::Philox::derive(12345, "top:A", 3));
+     * r(); // uint32_t [0, 2^32-1]
+     * r.getDouble(); // double [0.0, 1.0)
+     *
+     * // A stream per worker: the sequences do not overlap.
+     * vle::utils::Philox w1(r.split(1)), w2(r.split(2));
+     *
+     * std::vector < double > x(1000);
+     * w1.fillNormal(&x[0], x.size(), 0.0, 1.0);
+     * @endcode
+     */
+    class VLE_API Philox
+    {
+    public:
+        typedef boost::uint32_t result_type;
+        typedef boost::uint64_t key_type;
+
+        static const bool has_fixed_range = true;
+        static const result_type min_value = 0;
+        static const result_type max_value = 0xFFFFFFFF;
+
+        /**
+         * @brief Build a generator on the stream 0 of the key.
+         * @param key The key (the seed) of the generator.
+         * @param stream The stream identifier, ie. the high 64 bits of the
+         * counter.
+         */
+        explicit Philox(key_type key = 0, boost::uint64_t stream = 0)
+        { seed(key, stream); }
+
+        /**
+         * @brief Restart the generator at the beginning of a stream.
+         * @param key The key (the seed) of the generator.
+         * @param stream The stream identifier.
+         */
+        void seed(key_type key, boost::uint64_t stream = 0);
+
+        /**
+         * @brief Build a key from the seed of an experiment, the name of a
+         * model and the index of a replicate. The key does not depend on the
+         * order in which the models or the replicates are built.
+         * @param seed The seed of the experiment.
+         * @param name The complete name of the model.
+         * @param replicate The index of the replicate.
+         * @return A key for the Philox constructor.
+         */
+        static key_type derive(key_type seed, const std::string& name,
+                               boost::uint32_t replicate);
+
+        /**
+         * @brief Build a generator which shares the key of this generator on
+         * another stream. Two streams of a key never overlap: each of them
+         * provides 2^66 numbers.
+         * @param stream The identifier of the stream.
+         * @return A generator at the beginning of the stream.
+         */
+        Philox split(boost::uint64_t stream) const
+        { return Philox(m_key, stream); }
+
+        /**
+         * @brief Skip numbers of the stream in constant time.
+         * @param n The number of 32 bits numbers to skip.
+         */
+        void discard(boost::uint64_t n);
+
+        /**
+         * @brief Get the key of the generator.
+         * @return The key.
+         */
+        key_type key() const
+        { return m_key; }
+
+        /**
+         * @brief Get the identifier of the stream of the generator.
+         * @return The stream identifier.
+         */
+        boost::uint64_t stream() const
+        { return m_stream; }
+
+        /**
+         * @brief Get the number of 32 bits numbers already produced on the
+         * stream.
+         * @return The position in the stream.
+         */
+        boost::uint64_t position() const
+        { return m_block * 4 - (4 - m_index); }
+
+        /**
+         * @brief Generate an unsigned int value [0..2^32-1].
+         * @return a random unsigned int.
+         */
+        result_type operator()()
+        {
+            if (m_index == 4) {
+                refill();
+            }
+            return m_buffer[m_index++];
+        }
+
+        result_type min() const { return min_value; }
+        result_type max() const { return max_value; }
+
+        /**
+         * @brief Generate a real value [0, 1) with 53 random bits from two
+         * consecutive numbers of the stream.
+         * @return a random real.
+         */
+        double getDouble()
+        {
+            boost::uint32_t a = (*this)() >> 5;
+            boost::uint32_t b = (*this)() >> 6;
+
+            return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
+        }
+
+        /**
+         * @brief Fill a buffer with 32 bits numbers. The result is the same
+         * as @e n calls to operator() but the blocks are computed by lanes.
+         * @param out The buffer to fill.
+         * @param n The number of numbers.
+         */
+        void fill(boost::uint32_t* out, std::size_t n);
+
+        /**
+         * @brief Fill a buffer with reals [0, 1). The result is the same as
+         * @e n calls to getDouble().
+         * @param out The buffer to fill.
+         * @param n The number of reals.
+         */
+        void fillUniform(double* out, std::size_t n);
+
+        /**
+         * @brief Fill a buffer with reals [begin, end).
+         * @param out The buffer to fill.
+         * @param n The number of reals.
+         * @param begin The minimum value.
+         * @param end The limit (exclude) of the range.
+         */
+        void fillUniform(double* out, std::size_t n, double begin, double end);
+
+        /**
+         * @brief Fill a buffer with reals from the normal law, using the Box
+         * Muller transform on the reals given by fillUniform.
+         * @param out The buffer to fill.
+         * @param n The number of reals.
+         * @param mean The mean of the law.
+         * @param sigma The standard deviation of the law.
+         */
+        void fillNormal(double* out, std::size_t n, double mean, double sigma);
+
+        /**
+         * @brief Compute one block of the Philox4x32-10 function.
+         * @param ctr The counter, 4 words.
+         * @param key The key, 2 words.
+         * @param out The result, 4 words.
+         */
+        static void block(const boost::uint32_t ctr[4],
+                          const boost::uint32_t key[2],
+                          boost::uint32_t out[4]);
+
+    private:
+        void refill();
+
+        key_type         m_key;
+        boost::uint64_t  m_stream;
+        boost::uint64_t  m_block; /**< next block of the stream to compute. */
+        boost::uint32_t  m_buffer[4];
+        unsigned int     m_index;
+    };
+
+}} // namespace vle utils
+
+#endif
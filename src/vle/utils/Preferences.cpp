@@ -166,7 +166,10 @@ public:
             ("vle.remote.proxy_ip", po::value < std::string >
              (NULL)->default_value(""))
             ("vle.remote.proxy_port", po::value < std::string >
-             (NULL)->default_value(""));
+             (NULL)->default_value(""))
+            ("vle.remote.jobs", po::value < uint32_t >
+             (NULL)->default_value(4),
+             _("Number of parallel downloads"));
 
         mConfigFileOptions.add(mVlePackageOptions).
             add(mGvleEditorOptions).add(mGvleGraphicsOptions).
@@ -69,6 +69,28 @@ double Rand::getDoubleExcluded()
     return x ;
 }
 
+void Rand::fillUniform(double* out, std::size_t n)
+{
+    boost::uniform_real < > distrib(0.0, 1.0);
+    boost::variate_generator < boost::mt19937&,
+        boost::uniform_real < > > gen(m_rand, distrib);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = gen();
+    }
+}
+
+void Rand::fillNormal(double* out, std::size_t n, double mean, double sigma)
+{
+    boost::normal_distribution < > distrib(mean, sigma);
+    boost::variate_generator < boost::mt19937&,
+        boost::normal_distribution < > > gen(m_rand, distrib);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = gen();
+    }
+}
+
 double Rand::weibull(const double a, const double b)
 {
     double x = pow(-log(getDoubleExcluded()), 1.0 / a);
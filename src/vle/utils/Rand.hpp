@@ -43,6 +43,7 @@
 #include <boost/random/cauchy_distribution.hpp>
 #include <boost/random/triangle_distribution.hpp>
 #include <vle/DllDefines.hpp>
+#include <cstddef>
 
 namespace vle { namespace utils {
 
@@ -73,7 +74,15 @@ namespace vle { namespace utils {
      * r.cauchy(0.0, 1.0);
      * r.triangle(0.0, 0.5, 1.0);
      * r.weibull(1.0, 1.0);
+     *
+     * std::vector < double > x(1000);
+     * r.fillUniform(&x[0], x.size()); // double [0.0, 1.0)
+     * r.fillNormal(&x[0], x.size(), 0.0, 1.0);
      * @endcode
+     *
+     * @note vle::utils::Rand is a sequential generator. To get reproducible
+     * streams for several models, replicates or threads, use the
+     * counter-based vle::utils::Philox generator.
      */
     class VLE_API Rand
     {
@@ -190,6 +199,24 @@ namespace vle { namespace utils {
             return gen();
         }
 
+        /**
+         * @brief Fill a buffer with reals [0, 1). A single distribution is
+         * used for the whole buffer.
+         * @param out The buffer to fill.
+         * @param n The number of reals.
+         */
+        void fillUniform(double* out, std::size_t n);
+
+        /**
+         * @brief Fill a buffer with reals from the normal law. A single
+         * distribution is used for the whole buffer.
+         * @param out The buffer to fill.
+         * @param n The number of reals.
+         * @param mean
+         * @param sigma
+         */
+        void fillNormal(double* out, std::size_t n, double mean, double sigma);
+
         /**
          * @brief Generate a real using the Log Normal law.
          * @param mean
@@ -38,6 +38,7 @@
 #include <vle/utils/Package.hpp>
 #include <vle/utils/Preferences.hpp>
 #include <vle/utils/Trace.hpp>
+#include <vle/utils/details/Md5.hpp>
 #include <vle/utils/details/Package.hpp>
 #include <vle/utils/details/PackageParser.hpp>
 #include <vle/utils/details/PackageManager.hpp>
@@ -52,6 +53,7 @@
 #include <fstream>
 #include <ostream>
 #include <iostream>
+#include <set>
 #include <string>
 
 #define PACKAGESID_VECTOR_RESERVED_SIZE 100u
@@ -123,6 +125,112 @@ std::ostream& operator<<(std::ostream& os, const PackageId& b)
 
 namespace fs = boost::filesystem;
 
+/**
+ * Split an url into the server and the resource used by the @c
+ * DownloadManager: @e "http://host/path/file" gives @e "host" and @e
+ * "path/file", @e "file:///srv/mirror/file" gives @e "file:///srv/mirror"
+ * and @e "file".
+ */
+static void splitUrl(const std::string& url, std::string *server,
+                     std::string *resource)
+{
+    if (url.compare(0, 7, "file://") == 0) {
+        std::string::size_type slash = url.rfind('/');
+
+        if (slash == std::string::npos or slash < 7) {
+            server->assign("file://");
+            resource->assign(url, 7, std::string::npos);
+        } else {
+            server->assign(url, 0, slash);
+            resource->assign(url, slash + 1, std::string::npos);
+        }
+    } else {
+        std::string::size_type begin = 0;
+
+        if (url.compare(0, 7, "http://") == 0) {
+            begin = 7;
+        }
+
+        std::string::size_type slash = url.find('/', begin);
+
+        if (slash == std::string::npos) {
+            server->assign(url, begin, std::string::npos);
+            resource->clear();
+        } else {
+            server->assign(url, begin, slash - begin);
+            resource->assign(url, slash + 1, std::string::npos);
+        }
+    }
+}
+
+/**
+ * Compare the version of a package with the version of a link: the
+ * undefined numbers of the link are ignored.
+ *
+ * @return -1, 0 or 1 if the package is older, equal or newer.
+ */
+static int compareVersion(const PackageId& pkg, const PackageLinkId& link)
+{
+    const int32_t lhs[3] = { pkg.major, pkg.minor, pkg.patch };
+    const int32_t rhs[3] = { link.major, link.minor, link.patch };
+
+    for (int i = 0; i < 3 and rhs[i] >= 0; ++i) {
+        if (lhs[i] != rhs[i]) {
+            return lhs[i] < rhs[i] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Check if a package satisfies the version constraint of a link. A link
+ * without version is satisfied by all the packages of the same name.
+ */
+static bool satisfy(const PackageId& pkg, const PackageLinkId& link)
+{
+    if (pkg.name != link.name) {
+        return false;
+    }
+
+    if (link.major < 0) {
+        return true;
+    }
+
+    int cmp = compareVersion(pkg, link);
+
+    switch (link.op) {
+    case PACKAGE_OPERATOR_EQUAL:
+        return cmp == 0;
+    case PACKAGE_OPERATOR_LESS:
+        return cmp < 0;
+    case PACKAGE_OPERATOR_LESS_OR_EQUAL:
+        return cmp <= 0;
+    case PACKAGE_OPERATOR_GREATER:
+        return cmp > 0;
+    case PACKAGE_OPERATOR_GREATER_OR_EQUAL:
+        return cmp >= 0;
+    }
+
+    return false;
+}
+
+/**
+ * Return true if the version of @e lhs is older than the version of @e rhs.
+ */
+static bool isOlder(const PackageId& lhs, const PackageId& rhs)
+{
+    if (lhs.major != rhs.major) {
+        return lhs.major < rhs.major;
+    }
+
+    if (lhs.minor != rhs.minor) {
+        return lhs.minor < rhs.minor;
+    }
+
+    return lhs.patch < rhs.patch;
+}
+
 class RemoteManager::Pimpl
 {
 public:
@@ -301,34 +409,306 @@ public:
     // threaded slot
     //
 
-    struct Download
-        : public std::unary_function < std::string, void >
+    /**
+     * A file downloaded by the @c DownloadWorker: the temporary file (empty
+     * if the download failed) and its md5sum.
+     */
+    struct Downloaded
     {
-        PackageParser* parser;
+        std::string filename;
+        std::string md5sum;
+    };
 
-        Download(PackageParser *parser)
-            : parser(parser)
+    /**
+     * A thread of the download pool: takes the next url of the list until
+     * the end of the list or a call to @c stop().
+     */
+    struct DownloadWorker
+    {
+        Pimpl *pimpl;
+        const std::vector < std::string > *urls;
+        std::vector < Downloaded > *files;
+        std::size_t *next;
+
+        DownloadWorker(Pimpl *pimpl,
+                       const std::vector < std::string > *urls,
+                       std::vector < Downloaded > *files,
+                       std::size_t *next)
+            : pimpl(pimpl), urls(urls), files(files), next(next)
         {
-            assert(parser);
         }
 
-        void operator()(const std::string& url) const
+        void operator()() const
         {
-            DownloadManager dl;
+            for (;;) {
+                std::size_t index;
+
+                {
+                    boost::mutex::scoped_lock lock(pimpl->mMutex);
+
+                    if (pimpl->mStop or *next >= urls->size()) {
+                        return;
+                    }
+
+                    index = (*next)++;
+                }
+
+                std::string server, resource;
+                splitUrl((*urls)[index], &server, &resource);
+
+                DownloadManager dl;
+                dl.start(server, resource);
+                dl.join();
+
+                Downloaded result;
+                std::string error;
+
+                if (dl.hasError()) {
+                    error = dl.getErrorMessage();
+                } else {
+                    try {
+                        result.md5sum = md5sum(dl.filename());
+                        result.filename = dl.filename();
+                    } catch (const std::exception& e) {
+                        error = e.what();
+                    }
+                }
+
+                boost::mutex::scoped_lock lock(pimpl->mMutex);
+                (*files)[index] = result;
+
+                if (error.empty()) {
+                    pimpl->out(fmt(_("Download `%1%': ok\n")) %
+                               (*urls)[index]);
+                } else {
+                    pimpl->out(fmt(_("Download `%1%': failed: %2%\n")) %
+                               (*urls)[index] % error);
+                    pimpl->mHasError = true;
+                }
+            }
+        }
+    };
+
+    /**
+     * Download the urls with a pool of at most @e vle.remote.jobs threads.
+     *
+     * @param urls The urls to download.
+     * @param [out] files The downloaded files in the order of the urls.
+     */
+    void download(const std::vector < std::string >& urls,
+                  std::vector < Downloaded > *files)
+    {
+        uint32_t jobs = 4;
+
+        try {
+            utils::Preferences prefs;
+            prefs.get("vle.remote.jobs", &jobs);
+        } catch (const std::exception& /*e*/) {
+            TraceAlways(_("Failed to read preferences file"));
+        }
 
-            dl.start(url, "packages");
-            dl.join();
+        jobs = std::max(1u, std::min(jobs, (uint32_t)urls.size()));
+        files->assign(urls.size(), Downloaded());
 
-            std::cout << vle::fmt("%1% %2%\n") % url % dl.hasError();
+        std::size_t next = 0;
+        boost::thread_group pool;
 
-            if (not dl.hasError()) {
-                std::cout << vle::fmt("%1% %2%\n") % dl.filename() % url;
-                parser->extract(dl.filename(), url);
-            } else {
-                std::cout << vle::fmt("failed: %1%\n") % dl.getErrorMessage();
+        for (uint32_t i = 0; i < jobs; ++i) {
+            pool.create_thread(DownloadWorker(this, &urls, files, &next));
+        }
+
+        pool.join_all();
+    }
+
+    /**
+     * Get the archives of the packages. An archive is stored in the @e
+     * VLE_HOME/cache directory under its md5sum: the archives already in
+     * the cache are not downloaded, the others are downloaded in parallel
+     * and checked against the @c md5sum field of the package.
+     *
+     * @param pkgs The packages to get.
+     * @param [out] files The archives in the order of the packages, an
+     * empty string if the archive is not available.
+     *
+     * @return true if all the archives are available.
+     */
+    bool fetch(const Packages& pkgs, std::vector < std::string > *files)
+    {
+        fs::path cache(utils::Path::path().getHomeFile("cache"));
+        fs::create_directories(cache);
+
+        std::vector < std::string > urls;
+        std::vector < Packages::size_type > missing;
+
+        files->assign(pkgs.size(), std::string());
+
+        for (Packages::size_type i = 0; i < pkgs.size(); ++i) {
+            if (not pkgs[i].md5sum.empty()) {
+                fs::path cached(cache / pkgs[i].md5sum);
+
+                if (fs::exists(cached) and
+                    md5sum(cached.string()) == pkgs[i].md5sum) {
+                    out(fmt(_("Cache `%1%': ok\n")) % pkgs[i].name);
+                    (*files)[i] = cached.string();
+                    continue;
+                }
             }
+
+            urls.push_back(pkgs[i].url);
+            missing.push_back(i);
         }
-    };
+
+        std::vector < Downloaded > downloaded;
+        download(urls, &downloaded);
+
+        bool success = true;
+        for (std::vector < Downloaded >::size_type j = 0;
+             j < downloaded.size(); ++j) {
+            const PackageId& pkg(pkgs[missing[j]]);
+            const Downloaded& dl(downloaded[j]);
+
+            if (dl.filename.empty()) {
+                success = false;
+                continue;
+            }
+
+            if (not pkg.md5sum.empty() and dl.md5sum != pkg.md5sum) {
+                out(fmt(_("Package `%1%': bad md5sum %2% (expected %3%)\n"))
+                    % pkg.name % dl.md5sum % pkg.md5sum);
+                fs::remove(dl.filename);
+                mHasError = true;
+                success = false;
+                continue;
+            }
+
+            fs::path cached(cache / dl.md5sum);
+            fs::remove(cached);
+            fs::copy_file(dl.filename, cached);
+            fs::remove(dl.filename);
+            (*files)[missing[j]] = cached.string();
+        }
+
+        return success;
+    }
+
+    /**
+     * Find the newest remote package which satisfies the link.
+     *
+     * @return A pointer to the package or NULL if no package satisfies the
+     * link.
+     */
+    const PackageId* findRemote(const PackageLinkId& link) const
+    {
+        PackageId tmp;
+        tmp.name = link.name;
+
+        std::pair < PackagesIdSet::const_iterator,
+            PackagesIdSet::const_iterator > found = remote.equal_range(tmp);
+        const PackageId *result = 0;
+
+        for (; found.first != found.second; ++found.first) {
+            if (satisfy(*found.first, link) and
+                (not result or isOlder(*result, *found.first))) {
+                result = &*found.first;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Check if an installed package satisfies the link.
+     */
+    bool isInstalled(const PackageLinkId& link) const
+    {
+        PackageId tmp;
+        tmp.name = link.name;
+
+        std::pair < PackagesIdSet::const_iterator,
+            PackagesIdSet::const_iterator > found = local.equal_range(tmp);
+
+        for (; found.first != found.second; ++found.first) {
+            if (satisfy(*found.first, link)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Append to @e order the packages to install to satisfy the link: the
+     * dependencies not already installed first, the package last.
+     *
+     * @return false if a package is not available.
+     */
+    bool resolve(const PackageLinkId& link, std::set < std::string > *visited,
+                 Packages *order)
+    {
+        if (not visited->insert(link.name).second or isInstalled(link)) {
+            return true;
+        }
+
+        const PackageId *pkg = findRemote(link);
+
+        if (not pkg) {
+            out(fmt(_("Unknown package `%1%'\n")) % link);
+            mHasError = true;
+            return false;
+        }
+
+        for (PackagesLinkId::const_iterator it = pkg->depends.begin();
+             it != pkg->depends.end(); ++it) {
+            if (not resolve(*it, visited, order)) {
+                return false;
+            }
+        }
+
+        order->push_back(*pkg);
+        return true;
+    }
+
+    /**
+     * Extract the archives of the packages into the directory.
+     */
+    bool extract(const Packages& pkgs, const std::vector < std::string >& files,
+                 const std::string& directory)
+    {
+        fs::path current(fs::current_path());
+        bool success = true;
+
+        for (Packages::size_type i = 0; i < pkgs.size() and success; ++i) {
+            try {
+                utils::Path::decompress(files[i], directory);
+                out(fmt(_("Extract `%1%': ok\n")) % pkgs[i].name);
+            } catch (const std::exception& e) {
+                out(fmt(_("Extract `%1%': failed: %2%\n")) % pkgs[i].name %
+                    e.what());
+                mHasError = true;
+                success = false;
+            }
+        }
+
+        fs::current_path(current);
+        return success;
+    }
+
+    /**
+     * Split the argument of the action into package names.
+     */
+    std::vector < std::string > names() const
+    {
+        std::vector < std::string > args;
+
+        boost::algorithm::split(args, mArgs,
+                                boost::algorithm::is_any_of(" "),
+                                boost::algorithm::token_compress_on);
+
+        args.erase(std::remove(args.begin(), args.end(), std::string()),
+                   args.end());
+
+        return args;
+    }
 
     void actionUpdate() throw()
     {
@@ -346,100 +726,128 @@ public:
             TraceAlways(_("Failed to read preferences file"));
         }
 
+        urls.erase(std::remove(urls.begin(), urls.end(), std::string()),
+                   urls.end());
+
+        std::vector < std::string > distributions;
+        for (std::vector < std::string >::const_iterator it = urls.begin();
+             it != urls.end(); ++it) {
+            distributions.push_back(*it + "/packages");
+        }
+
+        std::vector < Downloaded > files;
+        download(distributions, &files);
+
         PackageParser parser;
-        std::for_each(urls.begin(), urls.end(),
-                      Download(&parser));
+        for (std::vector < Downloaded >::size_type i = 0; i < files.size();
+             ++i) {
+            if (not files[i].filename.empty()) {
+                try {
+                    parser.extract(files[i].filename, urls[i]);
+                } catch (const std::exception& e) {
+                    out(fmt(_("Distribution `%1%': failed: %2%\n")) %
+                        urls[i] % e.what());
+                    mHasError = true;
+                }
+                fs::remove(files[i].filename);
+            }
+        }
 
         if (not parser.empty()) {
-            std::set_intersection(local.begin(),
-                                  local.end(),
-                                  parser.begin(),
-                                  parser.end(),
-                                  std::back_inserter(mPackages),
-                                  PackageIdUpdate());
+            remote.clear();
+            remote.insert(parser.begin(), parser.end());
+
+            for (PackagesIdSet::const_iterator it = local.begin();
+                 it != local.end(); ++it) {
+                PackageLinkId link = { it->name, -1, -1, -1,
+                                       PACKAGE_OPERATOR_EQUAL };
+                const PackageId *pkg = findRemote(link);
+
+                if (pkg and PackageIdUpdate()(*it, *pkg)) {
+                    mPackages.push_back(*pkg);
+                }
+            }
         }
 
         mStream = 0;
         mIsFinish = true;
         mIsStarted = false;
         mStop = false;
-        mHasError = false;
     }
 
     void actionInstall() throw()
     {
-        // const_iterator it = mPackages.find(mArgs);
-
-        // if (it != mPackages.end()) {
-        //     std::string url = it->second.getBinaryPackageUrl();
-
-        //     DownloadManager dl;
-
-        //     out(fmt(_("Download binary package `%1%' at %2%")) % mArgs % url);
-        //     dl.start(url);
-        //     dl.join();
-
-        //     if (not dl.hasError()) {
-        //         out(_("install"));
-        //         std::string filename = dl.filename();
-        //         std::string zipfilename = dl.filename();
-        //         zipfilename += ".zip";
-
-        //         boost::filesystem::rename(filename, zipfilename);
-
-        //         utils::Package::package().unzip(mArgs, zipfilename);
-        //         utils::Package::package().wait(*mStream, *mStream);
-        //         out(_(": ok\n"));
-        //     } else {
-        //         out(_(": failed\n"));
-        //     }
-        // } else {
-        //     out(fmt(_("Unknown package `%1%'")) % mArgs);
-        // }
-
-        // mStream = 0;
-        // mIsFinish = true;
-        // mIsStarted = false;
-        // mStop = false;
-        // mHasError = false;
+        try {
+            std::vector < std::string > args(names());
+            std::set < std::string > visited;
+            Packages order;
+            bool success = true;
+
+            for (std::vector < std::string >::const_iterator it =
+                     args.begin(); it != args.end() and success; ++it) {
+                PackageLinkId link = { *it, -1, -1, -1,
+                                       PACKAGE_OPERATOR_EQUAL };
+                success = resolve(link, &visited, &order);
+            }
+
+            std::vector < std::string > files;
+            if (success and fetch(order, &files) and
+                extract(order, files,
+                        utils::Path::path().getBinaryPackagesDir())) {
+                for (Packages::const_iterator it = order.begin();
+                     it != order.end(); ++it) {
+                    local.erase(*it);
+                    local.insert(*it);
+                }
+                mPackages = order;
+            }
+        } catch (const std::exception& e) {
+            out(fmt(_("Install failed: %1%\n")) % e.what());
+            mHasError = true;
+        }
+
+        mStream = 0;
+        mIsFinish = true;
+        mIsStarted = false;
+        mStop = false;
     }
 
     void actionSource() throw()
     {
-        // const_iterator it = mPackages.find(mArgs);
-
-        // if (it != mPackages.end()) {
-        //     std::string url = it->second.getSourcePackageUrl();
-
-        //     DownloadManager dl;
-
-        //     out(fmt(_("Download source package `%1%' at %2%")) % mArgs % url);
-        //     dl.start(url);
-        //     dl.join();
-
-        //     if (not dl.hasError()) {
-        //         out(_("install"));
-        //         std::string filename = dl.filename();
-        //         std::string zipfilename = dl.filename();
-        //         zipfilename += ".zip";
-
-        //         boost::filesystem::rename(filename, zipfilename);
-
-        //         utils::Package::package().unzip(mArgs, zipfilename);
-        //         utils::Package::package().wait(*mStream, *mStream);
-        //         out(_(": ok\n"));
-        //     } else {
-        //         out(_(": failed\n"));
-        //     }
-        // } else {
-        //     out(fmt(_("Unknown package `%1%'")) % mArgs);
-        // }
-
-        // mStream = 0;
-        // mIsFinish = true;
-        // mIsStarted = false;
-        // mStop = false;
-        // mHasError = false;
+        try {
+            std::vector < std::string > args(names());
+            Packages pkgs;
+            bool success = true;
+
+            for (std::vector < std::string >::const_iterator it =
+                     args.begin(); it != args.end(); ++it) {
+                PackageLinkId link = { *it, -1, -1, -1,
+                                       PACKAGE_OPERATOR_EQUAL };
+                const PackageId *pkg = findRemote(link);
+
+                if (pkg) {
+                    pkgs.push_back(*pkg);
+                } else {
+                    out(fmt(_("Unknown package `%1%'\n")) % *it);
+                    mHasError = true;
+                    success = false;
+                }
+            }
+
+            std::vector < std::string > files;
+            if (success and fetch(pkgs, &files) and
+                extract(pkgs, files, utils::Path::getCurrentPath())) {
+                mPackages = pkgs;
+            }
+        } catch (const std::exception& e) {
+            out(fmt(_("Source failed: %1%\n")) % e.what());
+            mHasError = true;
+        }
+
+        mStream = 0;
+        mIsFinish = true;
+        mIsStarted = false;
+        mStop = false;
     }
 
     void actionLocalSearch() throw ()
@@ -455,7 +863,6 @@ public:
         mIsFinish = true;
         mIsStarted = false;
         mStop = false;
-        mHasError = false;
     }
 
     void actionSearch() throw()
@@ -471,7 +878,6 @@ public:
         mIsFinish = true;
         mIsStarted = false;
         mStop = false;
-        mHasError = false;
     }
 
     void actionShow() throw()
@@ -509,7 +915,6 @@ public:
         mIsFinish = true;
         mIsStarted = false;
         mStop = false;
-        mHasError = false;
     }
 
     PackagesIdSet local;
@@ -552,6 +957,11 @@ void RemoteManager::stop()
     mPimpl->stop();
 }
 
+bool RemoteManager::hasError() const
+{
+    return mPimpl->mHasError;
+}
+
 void RemoteManager::getResult(Packages *out)
 {
     if (out) {
@@ -192,6 +192,14 @@ public:
      */
     void stop();
 
+    /**
+     * Check if the last action failed: an unknown package, a download, a
+     * md5sum or an extraction error. The flag is reset by \c start().
+     *
+     * @return true if the last action failed.
+     */
+    bool hasError() const;
+
     void getResult(Packages *out);
 
     /**
@@ -0,0 +1,82 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <vle/utils/Symbol.hpp>
+#include <boost/unordered_set.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+
+namespace vle { namespace utils {
+
+namespace {
+
+/*
+ * The nodes of a boost::unordered_set are never moved by a rehash: the
+ * address of a text is the identity of its symbol. The table is leaked to
+ * stay valid in the destructors of static objects.
+ */
+struct SymbolTable
+{
+    boost::mutex mutex;
+    boost::unordered_set < std::string > texts;
+};
+
+SymbolTable& symbolTable()
+{
+    static SymbolTable* table = new SymbolTable();
+
+    return *table;
+}
+
+} // anonymous namespace
+
+Symbol::Symbol()
+{
+    static const std::string* empty = intern(std::string());
+
+    m_str = empty;
+}
+
+const std::string* Symbol::intern(const std::string& str)
+{
+    SymbolTable& table(symbolTable());
+    boost::lock_guard < boost::mutex > lock(table.mutex);
+
+    return &*table.texts.insert(str).first;
+}
+
+std::size_t Symbol::count()
+{
+    SymbolTable& table(symbolTable());
+    boost::lock_guard < boost::mutex > lock(table.mutex);
+
+    return table.texts.size();
+}
+
+}} // namespace vle utils
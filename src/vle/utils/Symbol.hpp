@@ -0,0 +1,167 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef VLE_UTILS_SYMBOL_HPP
+#define VLE_UTILS_SYMBOL_HPP
+
+#include <vle/DllDefines.hpp>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace vle { namespace utils {
+
+    /**
+     * @brief vle::utils::Symbol is an interned string: all the symbols built
+     * from the same text share the same std::string stored once in a global
+     * table. A Symbol is a pointer into this table, the copy, the assignment
+     * and the equality are pointer operations. The texts are never released
+     * and the table is protected by a mutex, symbols can be built from any
+     * thread.
+     *
+     * The order of the symbols is the lexicographic order of their texts so
+     * a sorted container of symbols is sorted like a container of
+     * std::string.
+     *
+     * @code
+     * vle::utils::Symbol a("out"), b(std::string("out"));
+     * assert(a == b and &a.str() == &b.str());
+     * const std::string& s = a; // no copy.
+     * @endcode
+     */
+    class VLE_API Symbol
+    {
+    public:
+        /**
+         * @brief Build the symbol of the empty string.
+         */
+        Symbol();
+
+        /**
+         * @brief Build the symbol of a text. The text is added to the table
+         * if it does not exist.
+         * @param str The text of the symbol.
+         */
+        Symbol(const std::string& str)
+            : m_str(intern(str))
+        {}
+
+        /**
+         * @brief Build the symbol of a text. The text is added to the table
+         * if it does not exist.
+         * @param str The text of the symbol.
+         */
+        Symbol(const char* str)
+            : m_str(intern(std::string(str)))
+        {}
+
+        const std::string& str() const
+        { return *m_str; }
+
+        operator const std::string&() const
+        { return *m_str; }
+
+        const char* c_str() const
+        { return m_str->c_str(); }
+
+        bool empty() const
+        { return m_str->empty(); }
+
+        std::string::size_type size() const
+        { return m_str->size(); }
+
+        bool operator==(const Symbol& other) const
+        { return m_str == other.m_str; }
+
+        bool operator!=(const Symbol& other) const
+        { return m_str != other.m_str; }
+
+        bool operator<(const Symbol& other) const
+        { return m_str != other.m_str and *m_str < *other.m_str; }
+
+        /**
+         * @brief Get the number of texts stored in the table.
+         * @return The number of symbols.
+         */
+        static std::size_t count();
+
+    private:
+        static const std::string* intern(const std::string& str);
+
+        const std::string* m_str;
+    };
+
+    inline bool operator==(const Symbol& a, const std::string& b)
+    { return a.str() == b; }
+
+    inline bool operator==(const std::string& a, const Symbol& b)
+    { return a == b.str(); }
+
+    inline bool operator==(const Symbol& a, const char* b)
+    { return a.str() == b; }
+
+    inline bool operator==(const char* a, const Symbol& b)
+    { return a == b.str(); }
+
+    inline bool operator!=(const Symbol& a, const std::string& b)
+    { return a.str() != b; }
+
+    inline bool operator!=(const std::string& a, const Symbol& b)
+    { return a != b.str(); }
+
+    inline bool operator!=(const Symbol& a, const char* b)
+    { return a.str() != b; }
+
+    inline bool operator!=(const char* a, const Symbol& b)
+    { return a != b.str(); }
+
+    inline bool operator<(const Symbol& a, const std::string& b)
+    { return a.str() < b; }
+
+    inline bool operator<(const std::string& a, const Symbol& b)
+    { return a < b.str(); }
+
+    inline std::string operator+(const Symbol& a, const std::string& b)
+    { return a.str() + b; }
+
+    inline std::string operator+(const std::string& a, const Symbol& b)
+    { return a + b.str(); }
+
+    inline std::string operator+(const Symbol& a, const char* b)
+    { return a.str() + b; }
+
+    inline std::string operator+(const char* a, const Symbol& b)
+    { return a + b.str(); }
+
+    inline std::ostream& operator<<(std::ostream& out, const Symbol& symbol)
+    { return out << symbol.str(); }
+
+}} // namespace vle utils
+
+#endif
@@ -0,0 +1,634 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <vle/utils/TimeSeries.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Path.hpp>
+#include <vle/utils/i18n.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+
+namespace vle { namespace utils {
+
+namespace {
+
+namespace fs = boost::filesystem;
+namespace ipc = boost::interprocess;
+
+/*
+ * The binary file starts with this header, followed by the complete path
+ * of the source and the names of the columns (a length and the characters)
+ * and by the values of the columns, one after the other, from the offset.
+ * The values are written in the byte order of the host, the order field
+ * detects a foreign file.
+ */
+struct TimeSeriesHeader
+{
+    char magic[8];
+    boost::uint32_t order;
+    boost::uint32_t columns;
+    boost::uint64_t rows;
+    boost::int64_t mtime;
+    boost::uint64_t size;
+    boost::uint64_t offset;
+};
+
+const char timeSeriesMagic[8] = { 'V', 'L', 'E', 'T', 'S', '0', '0', '2' };
+const boost::uint32_t timeSeriesOrder = 0x01020304;
+
+struct TimeSeriesSource
+{
+    std::vector < std::string > names;
+    std::vector < std::vector < double > > columns;
+};
+
+std::string trim(const std::string& str)
+{
+    std::string::size_type begin = str.find_first_not_of(" \t\r\"");
+    std::string::size_type end = str.find_last_not_of(" \t\r\"");
+
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+
+    return str.substr(begin, end - begin + 1);
+}
+
+std::vector < std::string > split(const std::string& line, char separator)
+{
+    std::vector < std::string > result;
+    std::string::size_type begin = 0, end;
+
+    do {
+        end = line.find(separator, begin);
+        result.push_back(trim(line.substr(begin, end == std::string::npos ?
+                                          std::string::npos : end - begin)));
+        begin = end + 1;
+    } while (end != std::string::npos);
+
+    return result;
+}
+
+double toReal(const std::string& cell)
+{
+    if (not cell.empty()) {
+        char *end;
+        double result = std::strtod(cell.c_str(), &end);
+
+        if (*end == '\0') {
+            return result;
+        }
+    }
+
+    return std::numeric_limits < double >::quiet_NaN();
+}
+
+/*
+ * Read the text file: the separator is the first of semicolon, tabulation
+ * or comma found in the header.
+ */
+void readSource(const std::string& filepath, TimeSeriesSource *source)
+{
+    std::ifstream in(filepath.c_str());
+
+    if (not in) {
+        throw utils::FileError(fmt(
+                _("TimeSeries: failed to open `%1%'")) % filepath);
+    }
+
+    std::string line;
+    char separator = ',';
+    long number = 0;
+
+    while (std::getline(in, line)) {
+        number++;
+        std::string::size_type first = line.find_first_not_of(" \t\r");
+
+        if (first == std::string::npos or line[first] == '#') {
+            continue;
+        }
+
+        if (source->names.empty()) {
+            if (line.find(';') != std::string::npos) {
+                separator = ';';
+            } else if (line.find('\t') != std::string::npos) {
+                separator = '\t';
+            }
+
+            source->names = split(line, separator);
+            source->columns.resize(source->names.size());
+            continue;
+        }
+
+        std::vector < std::string > cells = split(line, separator);
+
+        if (cells.size() != source->names.size()) {
+            throw utils::FileError(fmt(
+                    _("TimeSeries: `%1%' line %2%: %3% columns instead of"
+                      " %4%")) % filepath % number % cells.size() %
+                source->names.size());
+        }
+
+        double time = toReal(cells[0]);
+        std::vector < double >& times(source->columns[0]);
+
+        if (time != time or (not times.empty() and time < times.back())) {
+            throw utils::FileError(fmt(
+                    _("TimeSeries: `%1%' line %2%: the time `%3%' is not a"
+                      " number or is before the previous one")) % filepath %
+                number % cells[0]);
+        }
+
+        for (std::size_t i = 0; i < cells.size(); ++i) {
+            source->columns[i].push_back(toReal(cells[i]));
+        }
+    }
+
+    if (in.bad()) {
+        throw utils::FileError(fmt(
+                _("TimeSeries: failed to read `%1%'")) % filepath);
+    }
+
+    if (source->names.empty()) {
+        throw utils::FileError(fmt(
+                _("TimeSeries: `%1%' has no header")) % filepath);
+    }
+}
+
+void writeString(std::ostream& out, const std::string& str)
+{
+    boost::uint32_t length = str.size();
+
+    out.write(reinterpret_cast < const char* >(&length), sizeof(length));
+    out.write(str.data(), length);
+}
+
+bool readString(const char *begin, std::size_t end, std::size_t *position,
+                std::string *str)
+{
+    boost::uint32_t length;
+
+    if (*position + sizeof(length) > end) {
+        return false;
+    }
+
+    std::memcpy(&length, begin + *position, sizeof(length));
+    *position += sizeof(length);
+
+    if (*position + length > end) {
+        return false;
+    }
+
+    str->assign(begin + *position, length);
+    *position += length;
+
+    return true;
+}
+
+/*
+ * Write the binary file into a temporary file renamed at the end, a
+ * process never maps a partially written file.
+ */
+bool writeBinary(const fs::path& path, const std::string& sourcepath,
+                 const TimeSeriesSource& source, boost::int64_t mtime,
+                 boost::uint64_t size)
+{
+    TimeSeriesHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, timeSeriesMagic, sizeof(header.magic));
+    header.order = timeSeriesOrder;
+    header.columns = source.names.size();
+    header.rows = source.columns[0].size();
+    header.mtime = mtime;
+    header.size = size;
+    header.offset = sizeof(header) + sizeof(boost::uint32_t) +
+        sourcepath.size();
+
+    for (std::size_t i = 0; i < source.names.size(); ++i) {
+        header.offset += sizeof(boost::uint32_t) + source.names[i].size();
+    }
+
+    header.offset = (header.offset + sizeof(double) - 1) /
+        sizeof(double) * sizeof(double);
+
+    boost::system::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+
+    fs::path tmp = path.parent_path() /
+        fs::unique_path(path.filename().string() + "-%%%%-%%%%");
+
+    try {
+        std::ofstream out(tmp.string().c_str(),
+                          std::ios::out | std::ios::binary);
+
+        if (not out) {
+            return false;
+        }
+
+        out.write(reinterpret_cast < const char* >(&header), sizeof(header));
+        writeString(out, sourcepath);
+        std::streamoff written = sizeof(header) + sizeof(boost::uint32_t) +
+            sourcepath.size();
+
+        for (std::size_t i = 0; i < source.names.size(); ++i) {
+            writeString(out, source.names[i]);
+            written += sizeof(boost::uint32_t) + source.names[i].size();
+        }
+
+        const char padding[sizeof(double)] = { 0 };
+        out.write(padding, header.offset - written);
+
+        for (std::size_t i = 0; i < source.columns.size(); ++i) {
+            if (header.rows) {
+                out.write(reinterpret_cast < const char* >(
+                        &source.columns[i][0]), header.rows * sizeof(double));
+            }
+        }
+
+        out.close();
+
+        if (not out) {
+            fs::remove(tmp);
+            return false;
+        }
+
+        fs::rename(tmp, path);
+    } catch (const std::exception& /*e*/) {
+        boost::system::error_code ec;
+        fs::remove(tmp, ec);
+        return false;
+    }
+
+    return true;
+}
+
+} // anonymous namespace
+
+class TimeSeries::Pimpl
+{
+public:
+    Pimpl()
+        : values(0), rows(0)
+    {}
+
+    /*
+     * Map the binary file and check that it was built from the current
+     * source.
+     */
+    bool map(const fs::path& path, const std::string& sourcepath,
+             boost::int64_t mtime, boost::uint64_t size)
+    {
+        boost::system::error_code ec;
+
+        if (not fs::is_regular_file(path, ec)) {
+            return false;
+        }
+
+        try {
+            ipc::file_mapping file(path.string().c_str(), ipc::read_only);
+            ipc::mapped_region region(file, ipc::read_only);
+
+            const char *begin = static_cast < const char* >(
+                region.get_address());
+            std::size_t length = region.get_size();
+            TimeSeriesHeader header;
+
+            if (length < sizeof(header)) {
+                return false;
+            }
+
+            std::memcpy(&header, begin, sizeof(header));
+
+            if (std::memcmp(header.magic, timeSeriesMagic,
+                            sizeof(header.magic)) or
+                header.order != timeSeriesOrder or header.columns == 0 or
+                header.mtime != mtime or header.size != size or
+                header.offset % sizeof(double) or header.offset > length or
+                header.rows > (length - header.offset) / sizeof(double) /
+                header.columns) {
+                return false;
+            }
+
+            std::size_t position = sizeof(header);
+            std::string source;
+
+            if (not readString(begin, header.offset, &position, &source) or
+                source != sourcepath) {
+                return false;
+            }
+
+            std::vector < std::string > columns(header.columns);
+
+            for (boost::uint32_t i = 0; i < header.columns; ++i) {
+                if (not readString(begin, header.offset, &position,
+                                   &columns[i])) {
+                    return false;
+                }
+            }
+
+            mapping.swap(file);
+            mapped.swap(region);
+            names.swap(columns);
+            values = reinterpret_cast < const double* >(
+                static_cast < const char* >(mapped.get_address()) +
+                header.offset);
+            rows = header.rows;
+        } catch (const ipc::interprocess_exception& /*e*/) {
+            return false;
+        }
+
+        return true;
+    }
+
+    void check(std::size_t column) const
+    {
+        if (column >= names.size()) {
+            throw utils::ArgError(fmt(
+                    _("TimeSeries: no column %1%")) % column);
+        }
+
+        if (rows == 0) {
+            throw utils::ArgError(_("TimeSeries: the table is empty"));
+        }
+    }
+
+    ipc::file_mapping mapping;
+    ipc::mapped_region mapped;
+    std::vector < std::string > names;
+    const double *values;
+    std::size_t rows;
+};
+
+TimeSeries::TimeSeries()
+    : mPimpl(new TimeSeries::Pimpl())
+{
+}
+
+TimeSeries::~TimeSeries()
+{
+    delete mPimpl;
+}
+
+std::size_t TimeSeries::rows() const
+{
+    return mPimpl->rows;
+}
+
+std::size_t TimeSeries::columns() const
+{
+    return mPimpl->names.size();
+}
+
+const std::vector < std::string >& TimeSeries::names() const
+{
+    return mPimpl->names;
+}
+
+std::size_t TimeSeries::column(const std::string& name) const
+{
+    std::vector < std::string >::const_iterator it =
+        std::find(mPimpl->names.begin(), mPimpl->names.end(), name);
+
+    if (it == mPimpl->names.end()) {
+        throw utils::ArgError(fmt(
+                _("TimeSeries: no column `%1%'")) % name);
+    }
+
+    return it - mPimpl->names.begin();
+}
+
+const double* TimeSeries::data(std::size_t column) const
+{
+    if (column >= mPimpl->names.size()) {
+        throw utils::ArgError(fmt(
+                _("TimeSeries: no column %1%")) % column);
+    }
+
+    return mPimpl->values + column * mPimpl->rows;
+}
+
+double TimeSeries::time(std::size_t row) const
+{
+    if (row >= mPimpl->rows) {
+        throw utils::ArgError(fmt(
+                _("TimeSeries: no row %1%")) % row);
+    }
+
+    return mPimpl->values[row];
+}
+
+std::size_t TimeSeries::find(double time) const
+{
+    if (mPimpl->rows == 0) {
+        throw utils::ArgError(_("TimeSeries: the table is empty"));
+    }
+
+    const double *times = mPimpl->values;
+    std::size_t row = std::upper_bound(times, times + mPimpl->rows, time) -
+        times;
+
+    return row ? row - 1 : 0;
+}
+
+double TimeSeries::value(std::size_t column, double time) const
+{
+    mPimpl->check(column);
+
+    return data(column)[find(time)];
+}
+
+double TimeSeries::interpolate(std::size_t column, double time) const
+{
+    mPimpl->check(column);
+
+    const double *times = mPimpl->values;
+    const double *values = data(column);
+    std::size_t row = find(time);
+
+    if (time <= times[row] or row + 1 == mPimpl->rows) {
+        return values[row];
+    }
+
+    return values[row] + (values[row + 1] - values[row]) *
+        (time - times[row]) / (times[row + 1] - times[row]);
+}
+
+namespace {
+
+struct TimeSeriesEntry
+{
+    TimeSeriesEntry()
+        : mtime(0), size(0)
+    {}
+
+    boost::mutex mutex; ///< taken while the file is converted
+    std::time_t mtime;
+    boost::uintmax_t size;
+    TimeSeriesCache::TimeSeriesPtr series;
+};
+
+/*
+ * The cache is leaked to stay valid in the destructors of static objects.
+ */
+struct TimeSeriesTable
+{
+    typedef std::map < std::string,
+            boost::shared_ptr < TimeSeriesEntry > > Entries;
+
+    boost::mutex mutex;
+    Entries entries;
+};
+
+TimeSeriesTable& timeSeriesTable()
+{
+    static TimeSeriesTable* table = new TimeSeriesTable();
+
+    return *table;
+}
+
+/*
+ * The binary file is written next to the source, or in the cache directory
+ * of the VLE home of the user under a name built from the complete path of
+ * the source. A shared directory like /tmp is not used: another user could
+ * provide the data.
+ */
+std::vector < fs::path > binaryPaths(const fs::path& source)
+{
+    std::vector < fs::path > result;
+    result.push_back(source.string() + ".vlets");
+
+    std::ostringstream name;
+    name << std::hex << boost::hash < std::string >()(source.string())
+         << '-' << source.filename().string() << ".vlets";
+    result.push_back(fs::path(utils::Path::path().getHomeFile("cache")) /
+                     name.str());
+
+    return result;
+}
+
+} // anonymous namespace
+
+TimeSeriesCache::TimeSeriesPtr TimeSeriesCache::get(
+    const std::string& filepath)
+{
+    fs::path path(filepath);
+
+    if (not fs::exists(path) or not fs::is_regular_file(path)) {
+        throw utils::FileError(fmt(
+                _("TimeSeries: the file `%1%' does not exist")) % filepath);
+    }
+
+    path = fs::system_complete(path);
+    std::time_t mtime = fs::last_write_time(path);
+    boost::uintmax_t size = fs::file_size(path);
+    boost::shared_ptr < TimeSeriesEntry > entry;
+
+    {
+        TimeSeriesTable& table(timeSeriesTable());
+        boost::lock_guard < boost::mutex > lock(table.mutex);
+
+        boost::shared_ptr < TimeSeriesEntry >& found(
+            table.entries[path.string()]);
+
+        if (not found) {
+            found.reset(new TimeSeriesEntry());
+        }
+
+        entry = found;
+    }
+
+    boost::lock_guard < boost::mutex > lock(entry->mutex);
+
+    if (entry->series and entry->mtime == mtime and entry->size == size) {
+        return entry->series;
+    }
+
+    std::vector < fs::path > binaries(binaryPaths(path));
+    boost::shared_ptr < TimeSeries > series(new TimeSeries());
+    bool mapped = false;
+
+    for (std::size_t i = 0; not mapped and i < binaries.size(); ++i) {
+        mapped = series->mPimpl->map(binaries[i], path.string(), mtime,
+                                     size);
+    }
+
+    if (not mapped) {
+        TimeSeriesSource source;
+        readSource(path.string(), &source);
+
+        for (std::size_t i = 0; not mapped and i < binaries.size(); ++i) {
+            mapped = writeBinary(binaries[i], path.string(), source, mtime,
+                                 size) and
+                series->mPimpl->map(binaries[i], path.string(), mtime, size);
+        }
+    }
+
+    if (not mapped) {
+        throw utils::FileError(fmt(
+                _("TimeSeries: failed to write the binary file of `%1%'"))
+            % filepath);
+    }
+
+    entry->series = series;
+    entry->mtime = mtime;
+    entry->size = size;
+
+    return entry->series;
+}
+
+void TimeSeriesCache::clear()
+{
+    TimeSeriesTable& table(timeSeriesTable());
+    boost::lock_guard < boost::mutex > lock(table.mutex);
+
+    table.entries.clear();
+}
+
+std::size_t TimeSeriesCache::size()
+{
+    TimeSeriesTable& table(timeSeriesTable());
+    boost::lock_guard < boost::mutex > lock(table.mutex);
+
+    return table.entries.size();
+}
+
+}} // namespace vle utils
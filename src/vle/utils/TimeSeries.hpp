@@ -0,0 +1,207 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef VLE_UTILS_TIMESERIES_HPP
+#define VLE_UTILS_TIMESERIES_HPP 1
+
+#include <vle/DllDefines.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <vector>
+
+namespace vle { namespace utils {
+
+/**
+ * A read-only table of forcing data (weather, inputs etc.) indexed by time.
+ * The values are stored by columns in a memory mapped file, the first
+ * column is the time and is sorted. An instance is shared by all the
+ * models and threads of the process, use the TimeSeriesCache to get one.
+ *
+ * @code
+ * // in the constructor of a model:
+ * mWeather = getTimeSeries("weather.csv");
+ * mRain = mWeather->column("rain");
+ *
+ * // in a transition function:
+ * double rain = mWeather->value(mRain, time.getValue());
+ * double temperature = mWeather->interpolate(
+ *     mWeather->column("temperature"), time.getValue());
+ * @endcode
+ */
+class VLE_API TimeSeries
+{
+public:
+    ~TimeSeries();
+
+    /**
+     * Get the number of rows of the table.
+     *
+     * @return The number of rows.
+     */
+    std::size_t rows() const;
+
+    /**
+     * Get the number of columns of the table, the time included.
+     *
+     * @return The number of columns.
+     */
+    std::size_t columns() const;
+
+    /**
+     * Get the names of the columns from the header of the file.
+     *
+     * @return The names of the columns.
+     */
+    const std::vector < std::string >& names() const;
+
+    /**
+     * Get the index of a column.
+     *
+     * @param name The name of the column.
+     * @return The index of the column.
+     * @throw utils::ArgError if the column does not exist.
+     */
+    std::size_t column(const std::string& name) const;
+
+    /**
+     * Get the values of a column. The array of rows() values stays valid
+     * while the TimeSeries exists.
+     *
+     * @param column The index of the column.
+     * @return A pointer to the first value.
+     * @throw utils::ArgError if the column does not exist.
+     */
+    const double* data(std::size_t column) const;
+
+    /**
+     * Get the time of a row.
+     *
+     * @param row The index of the row.
+     * @return The value of the first column.
+     * @throw utils::ArgError if the row does not exist.
+     */
+    double time(std::size_t row) const;
+
+    /**
+     * Find, with a binary search, the last row whose time is lower or
+     * equal to @c time. The first row is returned for a time before the
+     * beginning of the table.
+     *
+     * @param time The time to find.
+     * @return The index of the row.
+     * @throw utils::ArgError if the table is empty.
+     */
+    std::size_t find(double time) const;
+
+    /**
+     * Get the value of a column at a time, the values are constant between
+     * two rows.
+     *
+     * @param column The index of the column.
+     * @param time The time.
+     * @return The value of the row find(time).
+     * @throw utils::ArgError if the column does not exist or if the table
+     * is empty.
+     */
+    double value(std::size_t column, double time) const;
+
+    /**
+     * Get the value of a column at a time, linearly interpolated between
+     * two rows. The first and the last values are used outside the table.
+     *
+     * @param column The index of the column.
+     * @param time The time.
+     * @return The interpolated value.
+     * @throw utils::ArgError if the column does not exist or if the table
+     * is empty.
+     */
+    double interpolate(std::size_t column, double time) const;
+
+private:
+    TimeSeries(const TimeSeries&);
+    TimeSeries& operator=(const TimeSeries&);
+
+    TimeSeries();
+
+    friend class TimeSeriesCache;
+
+    class Pimpl;
+    Pimpl *mPimpl;
+};
+
+/**
+ * A cache of the forcing data files shared by all the models, simulations
+ * and threads of the process.
+ *
+ * The source is a text file: a header line with the names of the columns
+ * then a line per row, separated by commas, semicolons or tabulations. The
+ * empty lines and the lines starting with a @c # are ignored. The cells
+ * that are not numbers are read as NaN.
+ *
+ * The source is converted once into a binary file @c source.vlets,
+ * written next to the source or in the @c cache directory of the VLE home
+ * if the package is read-only. This file records the path, the
+ * modification time and the size of the source, it is rebuilt when they
+ * change and is mapped in memory: the values are not copied and the pages
+ * are shared with the other processes.
+ */
+class VLE_API TimeSeriesCache
+{
+public:
+    typedef boost::shared_ptr < const TimeSeries > TimeSeriesPtr;
+
+    /**
+     * Get the time series of a file. This function is thread-safe.
+     *
+     * @param filepath The source file.
+     * @return A shared pointer to the read-only time series.
+     * @throw utils::FileError if the file can not be read or converted.
+     */
+    static TimeSeriesPtr get(const std::string& filepath);
+
+    /**
+     * Forget all the time series. The mapped files still used are released
+     * by their last user.
+     */
+    static void clear();
+
+    /**
+     * Get the number of files in the cache.
+     *
+     * @return The number of files.
+     */
+    static std::size_t size();
+
+private:
+    TimeSeriesCache();
+};
+
+}} // namespace vle utils
+
+#endif
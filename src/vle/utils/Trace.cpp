@@ -25,6 +25,7 @@
  */
 
 
+
 #include <iostream>
 #include <fstream>
 #include <locale>
@@ -32,11 +33,218 @@
 #include <vle/utils/i18n.hpp>
 #include <vle/utils/Path.hpp>
 #include <vle/utils/DateTime.hpp>
+#include <boost/format.hpp>
 #include <boost/thread.hpp>
+#include <algorithm>
 
 
 namespace vle { namespace utils {
 
+/*
+ * The utils::TraceRecord source.
+ */
+
+TraceRecord& TraceRecord::operator%(double value)
+{
+    m_arguments.push_back(Argument());
+    m_arguments.back().type = Argument::REAL;
+    m_arguments.back().real = value;
+
+    return *this;
+}
+
+TraceRecord& TraceRecord::operator%(int value)
+{
+    return (*this) % static_cast < long >(value);
+}
+
+TraceRecord& TraceRecord::operator%(long value)
+{
+    m_arguments.push_back(Argument());
+    m_arguments.back().type = Argument::INTEGER;
+    m_arguments.back().integer = value;
+
+    return *this;
+}
+
+TraceRecord& TraceRecord::operator%(unsigned int value)
+{
+    return (*this) % static_cast < unsigned long >(value);
+}
+
+TraceRecord& TraceRecord::operator%(unsigned long value)
+{
+    m_arguments.push_back(Argument());
+    m_arguments.back().type = Argument::UNSIGNED;
+    m_arguments.back().uinteger = value;
+
+    return *this;
+}
+
+TraceRecord& TraceRecord::operator%(const std::string& value)
+{
+    m_arguments.push_back(Argument());
+    m_arguments.back().type = Argument::STRING;
+    m_arguments.back().string = value;
+
+    return *this;
+}
+
+TraceRecord& TraceRecord::operator%(const char* value)
+{
+    return (*this) % std::string(value ? value : "");
+}
+
+std::string TraceRecord::str() const
+{
+    if (m_arguments.empty()) {
+        return m_format;
+    }
+
+    try {
+        boost::format f(m_format);
+
+        for (std::vector < Argument >::const_iterator it =
+                 m_arguments.begin(); it != m_arguments.end(); ++it) {
+            switch (it->type) {
+            case Argument::REAL:
+                f % it->real;
+                break;
+            case Argument::INTEGER:
+                f % it->integer;
+                break;
+            case Argument::UNSIGNED:
+                f % it->uinteger;
+                break;
+            case Argument::STRING:
+                f % it->string;
+                break;
+            }
+        }
+
+        return f.str();
+    } catch (const std::exception& e) {
+        return m_format + " (" + e.what() + ")";
+    }
+}
+
+namespace {
+
+/*
+ * Number of messages of a thread buffer which wakes up the writer thread
+ * before its period.
+ */
+const std::size_t trace_buffer_threshold = 1024;
+
+/*
+ * Number of messages of a thread buffer which makes the sending thread write
+ * the buffers itself, to bound the memory when the writer thread can not
+ * follow.
+ */
+const std::size_t trace_buffer_limit = 64 * 1024;
+
+/*
+ * The period of the writer thread in milliseconds.
+ */
+const long trace_period = 50;
+
+struct Record
+{
+    Record(TraceLevelOptions level)
+        : level(level), record(std::string())
+    {}
+
+    TraceLevelOptions level;
+    TraceRecord record;
+};
+
+/*
+ * The messages sent by a thread. Only the sending thread and the writer
+ * lock the mutex, the file is used only by the writer.
+ */
+struct ThreadBuffer
+{
+    ThreadBuffer()
+        : file(0), alive(true)
+    {}
+
+    ~ThreadBuffer()
+    {
+        delete file;
+    }
+
+    boost::mutex mutex;
+    std::vector < Record > records;
+    std::ofstream* file;
+    bool alive;
+};
+
+/*
+ * The list of the buffers of all the threads. Like the buffers, it is
+ * allocated once and never destroyed: messages can be sent by static
+ * destructors and after Trace::kill().
+ */
+struct Registry
+{
+    boost::mutex mutex;
+    std::vector < ThreadBuffer* > buffers;
+};
+
+Registry& registry()
+{
+    static Registry* registry = new Registry();
+
+    return *registry;
+}
+
+#if defined(__GNUC__)
+__thread ThreadBuffer* local_buffer = 0;
+#endif
+
+/*
+ * Called at the end of a thread: the buffer is destroyed by the writer when
+ * its last messages are written.
+ */
+void releaseThreadBuffer(ThreadBuffer* buffer)
+{
+#if defined(__GNUC__)
+    local_buffer = 0;
+#endif
+
+    boost::lock_guard < boost::mutex > lock(buffer->mutex);
+    buffer->alive = false;
+}
+
+ThreadBuffer& threadBuffer()
+{
+#if defined(__GNUC__)
+    if (local_buffer) {
+        return *local_buffer;
+    }
+#endif
+
+    static boost::thread_specific_ptr < ThreadBuffer >* buffers =
+        new boost::thread_specific_ptr < ThreadBuffer >(releaseThreadBuffer);
+
+    ThreadBuffer* buffer = buffers->get();
+    if (not buffer) {
+        buffer = new ThreadBuffer();
+        buffers->reset(buffer);
+
+        Registry& reg = registry();
+        boost::lock_guard < boost::mutex > lock(reg.mutex);
+        reg.buffers.push_back(buffer);
+    }
+
+#if defined(__GNUC__)
+    local_buffer = buffer;
+#endif
+
+    return *buffer;
+}
+
+} // anonymous namespace
+
 /*
  * The utils::Trace::Pimpl source.
  */
@@ -52,15 +260,54 @@ class Trace::Pimpl
         }
     }
 
+    /*
+     * The writer thread: writes the buffers every trace_period milliseconds
+     * or when a buffer is full.
+     */
+    void run()
+    {
+        for (;;) {
+            {
+                boost::unique_lock < boost::mutex > lock(mWakeMutex);
+
+                if (not mStop and not mWakeup) {
+                    mWake.timed_wait(lock, boost::posix_time::milliseconds(
+                            trace_period));
+                }
+
+                if (mStop) {
+                    return;
+                }
+
+                mWakeup = false;
+            }
+
+            boost::mutex::scoped_lock lock(mMutex);
+            write();
+        }
+    }
+
 public:
     Pimpl()
         : mFilename(), mStream(&std::cerr), mWarnings(0),
-          mLevel(TRACE_LEVEL_ALWAYS), mType(TRACE_STREAM_STANDARD_ERROR)
+          mLevel(TRACE_LEVEL_ALWAYS), mType(TRACE_STREAM_STANDARD_ERROR),
+          mWakeup(false), mStop(false)
     {
+        mWriter = new boost::thread(&Trace::Pimpl::run, this);
     }
 
     ~Pimpl()
     {
+        {
+            boost::lock_guard < boost::mutex > lock(mWakeMutex);
+            mStop = true;
+        }
+        mWake.notify_one();
+        mWriter->join();
+        delete mWriter;
+
+        write();
+
         if (mType == TRACE_STREAM_FILE) {
             delete mStream;
         }
@@ -73,6 +320,7 @@ public:
         if (not tmp->is_open()) {
             delete tmp;
         } else {
+            write();
             cleanup__();
 
             mFilename.assign(filename);
@@ -85,6 +333,7 @@ public:
 
     void setStandardOutput()
     {
+        write();
         cleanup__();
 
         mStream = &std::cout;
@@ -93,23 +342,129 @@ public:
 
     void setStandardError()
     {
+        write();
         cleanup__();
 
         mStream = &std::cerr;
         mType = TRACE_STREAM_STANDARD_ERROR;
     }
 
+    void setThreadLogFile(const std::string& filename)
+    {
+        std::ofstream* tmp = new std::ofstream(filename.c_str());
+
+        if (not tmp->is_open()) {
+            delete tmp;
+        } else {
+            ThreadBuffer& buffer = threadBuffer();
+
+            write();
+            delete buffer.file;
+            buffer.file = tmp;
+            (*buffer.file) << _("Start log at ") <<
+                utils::DateTime::currentDate() << "\n\n" << std::flush;
+        }
+    }
+
+    void resetThreadLogFile()
+    {
+        ThreadBuffer& buffer = threadBuffer();
+
+        write();
+        delete buffer.file;
+        buffer.file = 0;
+    }
+
     std::string getLogFile() const
     {
         return mFilename;
     }
 
-    void send(const std::string& str, TraceLevelOptions level)
+    /*
+     * Append a message to the buffer of the calling thread. Only the mutex
+     * of the buffer is locked and the writer thread is woken up only if the
+     * buffer is full. If the writer thread is too late, the calling thread
+     * writes the buffers.
+     */
+    void send(const TraceRecord& record, TraceLevelOptions level)
     {
-        if (mStream) {
-            (*mStream) << "---" << str << std::endl;
-            if (level != utils::TRACE_LEVEL_ALWAYS) {
-                mWarnings++;
+        ThreadBuffer& buffer = threadBuffer();
+        std::size_t size;
+
+        {
+            boost::lock_guard < boost::mutex > lock(buffer.mutex);
+
+            buffer.records.push_back(Record(level));
+            buffer.records.back().record = record;
+            size = buffer.records.size();
+        }
+
+        if (size == trace_buffer_threshold) {
+            {
+                boost::lock_guard < boost::mutex > lock(mWakeMutex);
+                mWakeup = true;
+            }
+            mWake.notify_one();
+        } else if (size >= trace_buffer_limit) {
+            boost::mutex::scoped_lock lock(mMutex);
+            write();
+        }
+    }
+
+    /*
+     * Write the messages of all the buffers into their destination and
+     * destroy the buffers of the finished threads. The mutex must be locked.
+     */
+    void write()
+    {
+        std::vector < ThreadBuffer* > buffers, finished;
+        std::vector < Record > records;
+
+        {
+            Registry& reg = registry();
+            boost::lock_guard < boost::mutex > lock(reg.mutex);
+            buffers = reg.buffers;
+        }
+
+        for (std::vector < ThreadBuffer* >::iterator it = buffers.begin();
+             it != buffers.end(); ++it) {
+            bool alive;
+
+            {
+                boost::lock_guard < boost::mutex > lock((*it)->mutex);
+                records.swap((*it)->records);
+                alive = (*it)->alive;
+            }
+
+            std::ostream* out = (*it)->file ? (*it)->file : mStream;
+
+            if (out and not records.empty()) {
+                for (std::vector < Record >::const_iterator jt =
+                         records.begin(); jt != records.end(); ++jt) {
+                    (*out) << "---" << jt->record.str() << '\n';
+                    if (jt->level != utils::TRACE_LEVEL_ALWAYS) {
+                        mWarnings++;
+                    }
+                }
+                out->flush();
+            }
+
+            records.clear();
+
+            if (not alive) {
+                finished.push_back(*it);
+            }
+        }
+
+        if (not finished.empty()) {
+            Registry& reg = registry();
+            boost::lock_guard < boost::mutex > lock(reg.mutex);
+
+            for (std::vector < ThreadBuffer* >::iterator it =
+                     finished.begin(); it != finished.end(); ++it) {
+                reg.buffers.erase(std::find(reg.buffers.begin(),
+                                            reg.buffers.end(), *it));
+                delete *it;
             }
         }
     }
@@ -157,6 +512,39 @@ public:
                                    function before using macro or
                                    utils::Trace API. */
 
+    static bool mKilled;        /**< Trace::kill() was called and the
+                                   singleton must not be restarted
+                                   implicitly. */
+
+    /*
+     * Return the singleton, build it on the first use. After Trace::kill()
+     * the singleton is not rebuilt: a new writer thread would never be
+     * joined and its messages would be lost. Only an explicit Trace::init()
+     * restarts it.
+     */
+    static Pimpl* instance()
+    {
+        if (not mTrace and not mKilled) {
+            mTrace = new Pimpl();
+        }
+
+        return mTrace;
+    }
+
+    /*
+     * Write a message sent after Trace::kill() directly into the standard
+     * error, the messages of the other levels are dropped.
+     */
+    static void sendKilled(const TraceRecord& record, TraceLevelOptions level)
+    {
+        if (level == TRACE_LEVEL_ALWAYS) {
+            Registry& reg = registry();
+            boost::lock_guard < boost::mutex > lock(reg.mutex);
+
+            std::cerr << "---" << record.str() << '\n' << std::flush;
+        }
+    }
+
 private:
     std::string mFilename;      /**< The current filename of the singleton. */
 
@@ -165,17 +553,29 @@ private:
     size_t mWarnings;           /**< Number of warning since the singleton
                                    exists. */
 
-    TraceLevelOptions mLevel;   /**< The current level of the
-                                 * singleton. */
+    volatile TraceLevelOptions mLevel; /**< The current level of the
+                                        * singleton, read without lock. */
 
     TraceStreamType mType;      /**< The current stream. */
 
-    boost::mutex mMutex;        /**< Store the instance of the mutex
-                                  to implement a thread-safe single
-                                  design pattern. */
+    boost::mutex mMutex;        /**< Protects the streams and the
+                                  counters, locked by the writer
+                                  thread. */
+
+    boost::thread* mWriter;     /**< The thread which writes the
+                                  buffers. */
+
+    boost::mutex mWakeMutex;    /**< Protects mWakeup and mStop. */
+
+    boost::condition_variable mWake;
+
+    bool mWakeup;               /**< A buffer is full. */
+
+    bool mStop;                 /**< The writer thread must stop. */
 };
 
 Trace::Pimpl* Trace::Pimpl::mTrace = 0;
+bool Trace::Pimpl::mKilled = false;
 
 /*
  * the utils::Trace source.
@@ -183,13 +583,14 @@ Trace::Pimpl* Trace::Pimpl::mTrace = 0;
 
 void Trace::init()
 {
-    if (not Trace::Pimpl::mTrace) {
-        Trace::Pimpl::mTrace = new Trace::Pimpl();
-    }
+    Trace::Pimpl::mKilled = false;
+    Trace::Pimpl::instance();
 }
 
 void Trace::kill()
 {
+    Trace::Pimpl::mKilled = true;
+
 	if (Trace::Pimpl::mTrace) {
 		delete Trace::Pimpl::mTrace;
 		Trace::Pimpl::mTrace = 0;
@@ -198,8 +599,8 @@ void Trace::kill()
 
 std::string Trace::getLogFile()
 {
-    if (not Trace::Pimpl::mTrace) {
-        Trace::init();
+    if (not Pimpl::instance()) {
+        return std::string();
     }
 
     boost::mutex::scoped_lock lock(Trace::Pimpl::mTrace->getMutex());
@@ -209,8 +610,8 @@ std::string Trace::getLogFile()
 
 void Trace::setLogFile(const std::string& filename)
 {
-    if (not Trace::Pimpl::mTrace) {
-        Trace::init();
+    if (not Pimpl::instance()) {
+        return;
     }
 
     boost::mutex::scoped_lock lock(Trace::Pimpl::mTrace->getMutex());
@@ -220,8 +621,8 @@ void Trace::setLogFile(const std::string& filename)
 
 void Trace::setStandardOutput()
 {
-    if (not Trace::Pimpl::mTrace) {
-        Trace::init();
+    if (not Pimpl::instance()) {
+        return;
     }
 
     boost::mutex::scoped_lock lock(Trace::Pimpl::mTrace->getMutex());
@@ -231,8 +632,8 @@ void Trace::setStandardOutput()
 
 void Trace::setStandardError()
 {
-    if (not Trace::Pimpl::mTrace) {
-        Trace::init();
+    if (not Pimpl::instance()) {
+        return;
     }
 
     boost::mutex::scoped_lock lock(Trace::Pimpl::mTrace->getMutex());
@@ -242,24 +643,65 @@ void Trace::setStandardError()
 
 void Trace::send(const std::string& str, TraceLevelOptions level)
 {
-    if (not Trace::Pimpl::mTrace) {
-        Trace::init();
+    if (not Pimpl::instance()) {
+        Pimpl::sendKilled(TraceRecord(str), level);
+        return;
+    }
+
+    Pimpl::mTrace->send(TraceRecord(str), level);
+}
+
+void Trace::send(const boost::format& str, TraceLevelOptions level)
+{
+    if (not Pimpl::instance()) {
+        Pimpl::sendKilled(TraceRecord(str.str()), level);
+        return;
+    }
+
+    Pimpl::mTrace->send(TraceRecord(str.str()), level);
+}
+
+void Trace::send(const TraceRecord& record, TraceLevelOptions level)
+{
+    if (not Pimpl::instance()) {
+        Pimpl::sendKilled(record, level);
+        return;
+    }
+
+    Pimpl::mTrace->send(record, level);
+}
+
+void Trace::flush()
+{
+    if (not Pimpl::instance()) {
+        return;
     }
 
     boost::mutex::scoped_lock lock(Trace::Pimpl::mTrace->getMutex());
 
-    Pimpl::mTrace->send(str, level);
+    Pimpl::mTrace->write();
 }
 
-void Trace::send(const boost::format& str, TraceLevelOptions level)
+void Trace::setThreadLogFile(const std::string& filename)
 {
-    if (not Trace::Pimpl::mTrace) {
-        Trace::init();
+    if (not Pimpl::instance()) {
+        return;
     }
 
     boost::mutex::scoped_lock lock(Trace::Pimpl::mTrace->getMutex());
 
-    Pimpl::mTrace->send(str.str(), level);
+    Pimpl::mTrace->setThreadLogFile(filename);
+}
+
+void Trace::resetThreadLogFile()
+{
+    if (not Pimpl::instance()) {
+        return;
+    }
+
+    boost::mutex::scoped_lock lock(Trace::Pimpl::mTrace->getMutex());
+
+    Pimpl::mTrace->resetThreadLogFile();
 }
 
 std::string Trace::getDefaultLogFilename()
@@ -274,8 +716,8 @@ std::string Trace::getLogFilename(const std::string& filename)
 
 TraceStreamType Trace::getType()
 {
-    if (not Trace::Pimpl::mTrace) {
-        Trace::init();
+    if (not Pimpl::instance()) {
+        return TRACE_STREAM_STANDARD_ERROR;
     }
 
     boost::mutex::scoped_lock lock(Trace::Pimpl::mTrace->getMutex());
@@ -285,8 +727,8 @@ TraceStreamType Trace::getType()
 
 TraceLevelOptions Trace::getLevel()
 {
-    if (not Trace::Pimpl::mTrace) {
-        Trace::init();
+    if (not Pimpl::instance()) {
+        return TRACE_LEVEL_ALWAYS;
     }
 
     boost::mutex::scoped_lock lock(Trace::Pimpl::mTrace->getMutex());
@@ -296,8 +738,8 @@ TraceLevelOptions Trace::getLevel()
 
 void Trace::setLevel(TraceLevelOptions level)
 {
-    if (not Trace::Pimpl::mTrace) {
-        Trace::init();
+    if (not Pimpl::instance()) {
+        return;
     }
 
     boost::mutex::scoped_lock lock(Trace::Pimpl::mTrace->getMutex());
@@ -307,34 +749,34 @@ void Trace::setLevel(TraceLevelOptions level)
 
 bool Trace::isInLevel(TraceLevelOptions level)
 {
-    if (not Trace::Pimpl::mTrace) {
-        Trace::init();
+    if (not Pimpl::instance()) {
+        return level == TRACE_LEVEL_ALWAYS;
     }
 
-    boost::mutex::scoped_lock lock(Trace::Pimpl::mTrace->getMutex());
-
     return Pimpl::mTrace->isInLevel(level);
 }
 
 bool Trace::haveWarning()
 {
-    if (not Trace::Pimpl::mTrace) {
-        Trace::init();
+    if (not Pimpl::instance()) {
+        return false;
     }
 
     boost::mutex::scoped_lock lock(Trace::Pimpl::mTrace->getMutex());
 
+    Pimpl::mTrace->write();
     return Pimpl::mTrace->haveWarning();
 }
 
 size_t Trace::warnings()
 {
-    if (not Trace::Pimpl::mTrace) {
-        Trace::init();
+    if (not Pimpl::instance()) {
+        return 0;
     }
 
     boost::mutex::scoped_lock lock(Trace::Pimpl::mTrace->getMutex());
 
+    Pimpl::mTrace->write();
     return Pimpl::mTrace->warnings();
 }
 
@@ -30,7 +30,9 @@
 
 #include <vle/DllDefines.hpp>
 #include <boost/format/format_fwd.hpp>
+#include <sstream>
 #include <string>
+#include <vector>
 
 namespace vle { namespace utils {
 
@@ -54,6 +56,68 @@ enum TraceStreamType
     TRACE_STREAM_FILE      /**< Use a specific file to log */
 };
 
+/**
+ * A log message whose formatting is deferred. The arguments are stored in
+ * binary form and the message is built with boost::format by the thread
+ * which writes the log, not by the thread which sends it. Without argument,
+ * the format is sent verbatim.
+ *
+ * @code
+ * TraceDevs(utils::TraceRecord(_("%1$20.10g %2% [DEVS] init")) % time %
+ *           getName());
+ * @endcode
+ */
+class VLE_API TraceRecord
+{
+public:
+    explicit TraceRecord(const std::string& format)
+        : m_format(format)
+    {}
+
+    TraceRecord& operator%(double value);
+    TraceRecord& operator%(int value);
+    TraceRecord& operator%(long value);
+    TraceRecord& operator%(unsigned int value);
+    TraceRecord& operator%(unsigned long value);
+    TraceRecord& operator%(const std::string& value);
+    TraceRecord& operator%(const char* value);
+
+    /**
+     * Other types are converted into string with their stream operator when
+     * they are appended.
+     */
+    template < typename T >
+    TraceRecord& operator%(const T& value)
+    {
+        std::ostringstream out;
+        out << value;
+        return (*this) % out.str();
+    }
+
+    /**
+     * Build the message.
+     *
+     * @return The formatted message, or the format and an error if the
+     * arguments do not match the format.
+     */
+    std::string str() const;
+
+private:
+    struct Argument
+    {
+        enum Type { REAL, INTEGER, UNSIGNED, STRING };
+
+        Type type;
+        double real;
+        long integer;
+        unsigned long uinteger;
+        std::string string;
+    };
+
+    std::string m_format;
+    std::vector < Argument > m_arguments;
+};
+
 /**
  * A logging class to send information into a file. We define two types of
  * macros to simplify the calls of this function. In NDEBUG mode (cflags
@@ -77,6 +141,11 @@ enum TraceStreamType
  *     utils::Trace::kill();
  * }
  * @endcode
+ *
+ * The messages are appended to a buffer owned by the sending thread and a
+ * background thread writes the buffers into the log: threads never wait for
+ * each other or for the output stream to send a message. Use the
+ * Trace::flush() function to wait for the messages already sent.
  */
 class VLE_API Trace
 {
@@ -87,7 +156,10 @@ public:
     static void init();
 
     /**
-     * Delete Trace object instantiate from function Trace::init().
+     * Delete Trace object instantiate from function Trace::init(). The
+     * Trace is not rebuilt by the next messages: they are written into
+     * the standard error (TRACE_LEVEL_ALWAYS) or dropped until the next
+     * call to Trace::init().
      */
     static void kill();
 
@@ -135,6 +207,36 @@ public:
     static void send(const boost::format& str,
                      TraceLevelOptions level = TRACE_LEVEL_ALWAYS);
 
+    /**
+     * Send a message to the log file. The message is formatted by the
+     * background thread.
+     *
+     * @param record The message to send.
+     * @param level The Level of the message.
+     */
+    static void send(const TraceRecord& record,
+                     TraceLevelOptions level = TRACE_LEVEL_ALWAYS);
+
+    /**
+     * Wait until all the messages sent are written.
+     */
+    static void flush();
+
+    /**
+     * Send the messages of the calling thread to a specific file instead of
+     * the current log, for instance to avoid the interleaving of the traces
+     * of concurrent simulations. The messages already sent are written into
+     * the previous destination.
+     *
+     * @param filename The filename of the log of the thread.
+     */
+    static void setThreadLogFile(const std::string& filename);
+
+    /**
+     * Send the messages of the calling thread to the current log.
+     */
+    static void resetThreadLogFile();
+
     /**
      * Return the default log file position. $VLE_HOME/vle.log under Unix
      * system, %VLE_HOME%/vle.log under Win32.
@@ -177,7 +279,8 @@ public:
 
     /**
      * Return true if the specified level is between [ALWAYS, current
-     * level].
+     * level]. This function does not lock and can be used before each
+     * message.
      *
      * @param level the specified level to test.
      *
@@ -26,14 +26,23 @@
 
 #include <boost/filesystem.hpp>
 #include <boost/version.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <vle/utils/Archive.hpp>
 #include <vle/utils/Path.hpp>
+#include <vle/utils/details/ParallelGzip.hpp>
 #include <vle/utils/i18n.hpp>
 #include <vle/utils/Exception.hpp>
+#include <algorithm>
 #include <ostream>
 #include <fstream>
 #include <archive.h>
 #include <archive_entry.h>
 #include <fcntl.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include <cerrno>
 #include <cstring>
 #include <list>
 #include <vector>
@@ -99,8 +108,10 @@ static void extract_archive(const char *filename, const char *output)
     a = archive_read_new();
 #if ARCHIVE_VERSION_NUMBER < 4000000
     archive_read_support_compression_bzip2(a);
+    archive_read_support_compression_gzip(a);
 #else
     archive_read_support_filter_bzip2(a);
+    archive_read_support_filter_gzip(a);
 #endif
     archive_read_support_format_tar(a);
 
@@ -440,6 +451,252 @@ static void create_archive(const char *filepath, const char *tarfile)
 //#endif
 //}
 
+class Archive::Pimpl
+{
+public:
+    Pimpl(const std::string& tarfile, uint32_t jobs)
+        : mTarfile(tarfile), mGzip(tarfile, jobs), mArchive(0)
+    {
+        mArchive = archive_write_new();
+#if ARCHIVE_VERSION_NUMBER < 4000000
+        archive_write_set_compression_none(mArchive);
+#else
+        archive_write_add_filter_none(mArchive);
+#endif
+        archive_write_set_format_pax_restricted(mArchive);
+
+        if (archive_write_open(mArchive, this, NULL, &Pimpl::writeCallback,
+                               &Pimpl::closeCallback) != ARCHIVE_OK) {
+            std::string msg = error();
+            release();
+            throw utils::FileError(msg);
+        }
+    }
+
+    ~Pimpl()
+    {
+        release();
+    }
+
+    /**
+     * The libarchive write callback: append the tar stream to the gzip
+     * file.
+     */
+    static ssize_t writeCallback(struct archive *a, void *data,
+                                 const void *buffer, size_t length)
+    {
+        try {
+            static_cast < Pimpl* >(data)->mGzip.write(buffer, length);
+        } catch (const std::exception& e) {
+            archive_set_error(a, EIO, "%s", e.what());
+            return -1;
+        }
+
+        return length;
+    }
+
+    static int closeCallback(struct archive * /* a */, void * /* data */)
+    {
+        return ARCHIVE_OK;
+    }
+
+    std::string error() const
+    {
+        const char *msg = mArchive ? archive_error_string(mArchive) : 0;
+
+        return (fmt(_("compress failure: %1%: %2%")) % mTarfile %
+                (msg ? msg : _("unknown error"))).str();
+    }
+
+    void release()
+    {
+        if (mArchive) {
+#if ARCHIVE_VERSION_NUMBER < 4000000
+            archive_write_finish(mArchive);
+#else
+            archive_write_free(mArchive);
+#endif
+            mArchive = 0;
+        }
+    }
+
+    void add(const std::string& filepath, const std::string& name)
+    {
+        namespace fs = boost::filesystem;
+
+        struct stat st;
+
+        if (not mArchive) {
+            throw utils::FileError(
+                fmt(_("compress failure: %1% is closed")) % mTarfile);
+        }
+
+#ifdef _WIN32
+        if (::stat(filepath.c_str(), &st)) {
+#else
+        /* The symbolic links are stored as links, they are not followed
+         * and a cycle does not recurse forever. */
+        if (::lstat(filepath.c_str(), &st)) {
+#endif
+            throw utils::FileError(
+                fmt(_("compress failure: `%1%': %2%")) % filepath %
+                std::strerror(errno));
+        }
+
+        struct archive_entry *entry = archive_entry_new();
+        archive_entry_copy_stat(entry, &st);
+        archive_entry_set_pathname(entry, name.c_str());
+
+#ifndef _WIN32
+        if (S_ISLNK(st.st_mode)) {
+            try {
+                archive_entry_copy_symlink(entry,
+                                           readLink(filepath).c_str());
+            } catch (...) {
+                archive_entry_free(entry);
+                throw;
+            }
+        }
+#endif
+
+        if (not S_ISREG(st.st_mode)) {
+            archive_entry_set_size(entry, 0);
+        }
+
+        int r = archive_write_header(mArchive, entry);
+        archive_entry_free(entry);
+
+        if (r != ARCHIVE_OK) {
+            throw utils::FileError(error());
+        }
+
+        if (S_ISREG(st.st_mode)) {
+            copy(filepath);
+        } else if (S_ISDIR(st.st_mode)) {
+            std::vector < std::string > children;
+
+            for (fs::directory_iterator it(filepath), end; it != end; ++it) {
+#if BOOST_VERSION > 104500
+                children.push_back(it->path().filename().string());
+#else
+                children.push_back(it->path().filename());
+#endif
+            }
+
+            std::sort(children.begin(), children.end());
+
+            for (std::vector < std::string >::const_iterator it =
+                     children.begin(); it != children.end(); ++it) {
+                add((fs::path(filepath) / *it).string(),
+                    name + '/' + *it);
+            }
+        }
+    }
+
+#ifndef _WIN32
+    static std::string readLink(const std::string& filepath)
+    {
+        std::vector < char > target(256);
+
+        for (;;) {
+            ssize_t len = ::readlink(filepath.c_str(), &target[0],
+                                     target.size());
+
+            if (len < 0) {
+                throw utils::FileError(
+                    fmt(_("compress failure: `%1%': %2%")) % filepath %
+                    std::strerror(errno));
+            }
+
+            if (static_cast < std::size_t >(len) < target.size()) {
+                return std::string(&target[0], len);
+            }
+
+            target.resize(target.size() * 2);
+        }
+    }
+#endif
+
+    void copy(const std::string& filepath)
+    {
+        char buff[65536];
+        int fd = ::open(filepath.c_str(), O_RDONLY);
+
+        if (fd < 0) {
+            throw utils::FileError(
+                fmt(_("compress failure: `%1%': %2%")) % filepath %
+                std::strerror(errno));
+        }
+
+        ssize_t len;
+        while ((len = ::read(fd, buff, sizeof(buff))) > 0) {
+            if (archive_write_data(mArchive, buff, len) < 0) {
+                ::close(fd);
+                throw utils::FileError(error());
+            }
+        }
+
+        if (len < 0) {
+            int err = errno;
+            ::close(fd);
+            throw utils::FileError(
+                fmt(_("compress failure: `%1%': %2%")) % filepath %
+                std::strerror(err));
+        }
+
+        ::close(fd);
+    }
+
+    void close()
+    {
+        if (mArchive) {
+            int r = archive_write_close(mArchive);
+            std::string msg = r == ARCHIVE_OK ? std::string() : error();
+
+            release();
+            mGzip.close();
+
+            if (not msg.empty()) {
+                throw utils::FileError(msg);
+            }
+        }
+    }
+
+    std::string mTarfile;
+    ParallelGzip mGzip;
+    struct archive *mArchive;
+};
+
+Archive::Archive(const std::string& tarfile, uint32_t jobs)
+    : mPimpl(new Archive::Pimpl(tarfile, jobs))
+{
+}
+
+Archive::~Archive()
+{
+    try {
+        mPimpl->close();
+    } catch (...) {
+    }
+
+    delete mPimpl;
+}
+
+void Archive::add(const std::string& filepath)
+{
+    mPimpl->add(filepath, filepath);
+}
+
+void Archive::add(const std::string& filepath, const std::string& name)
+{
+    mPimpl->add(filepath, name);
+}
+
+void Archive::close()
+{
+    mPimpl->close();
+}
+
 void Path::compress(const std::string& filepath,
                     const std::string& compressedfilepath)
 {
@@ -449,7 +706,14 @@ void Path::compress(const std::string& filepath,
     fs::path path(filepath);
 
     if (fs::exists(path)) {
-        create_archive(filepath.c_str(), compressedfilepath.c_str());
+        if (boost::algorithm::ends_with(compressedfilepath, ".gz") or
+            boost::algorithm::ends_with(compressedfilepath, ".tgz")) {
+            Archive archive(compressedfilepath);
+            archive.add(filepath);
+            archive.close();
+        } else {
+            create_archive(filepath.c_str(), compressedfilepath.c_str());
+        }
     }
 }
 
@@ -0,0 +1,197 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <vle/utils/details/Md5.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace vle { namespace utils {
+
+namespace {
+
+const boost::uint32_t md5_sines[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a,
+    0xa8304613, 0xfd469501, 0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+    0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821, 0xf61e2562, 0xc040b340,
+    0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8,
+    0x676f02d9, 0x8d2a4c8a, 0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+    0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70, 0x289b7ec6, 0xeaa127fa,
+    0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92,
+    0xffeff47d, 0x85845dd1, 0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+    0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391 };
+
+const unsigned int md5_shifts[64] = {
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21 };
+
+inline boost::uint32_t rotate(boost::uint32_t x, unsigned int n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+} // anonymous namespace
+
+Md5::Md5()
+    : m_size(0)
+{
+    m_state[0] = 0x67452301;
+    m_state[1] = 0xefcdab89;
+    m_state[2] = 0x98badcfe;
+    m_state[3] = 0x10325476;
+}
+
+void Md5::update(const void *data, std::size_t size)
+{
+    const unsigned char *bytes = static_cast < const unsigned char* >(data);
+    std::size_t used = static_cast < std::size_t >(m_size % 64);
+
+    m_size += size;
+
+    if (used) {
+        std::size_t fill = std::min(size, 64 - used);
+
+        std::memcpy(m_buffer + used, bytes, fill);
+        bytes += fill;
+        size -= fill;
+
+        if (used + fill < 64) {
+            return;
+        }
+        transform(m_buffer);
+    }
+
+    for (; size >= 64; bytes += 64, size -= 64) {
+        transform(bytes);
+    }
+
+    std::memcpy(m_buffer, bytes, size);
+}
+
+std::string Md5::hexdigest()
+{
+    static const char hex[] = "0123456789abcdef";
+    unsigned char padding[72] = { 0x80 };
+    boost::uint64_t bits = m_size * 8;
+    std::size_t used = static_cast < std::size_t >(m_size % 64);
+    std::size_t length = (used < 56) ? 56 - used : 120 - used;
+
+    for (int i = 0; i < 8; ++i) {
+        padding[length + i] = static_cast < unsigned char >(bits >> (8 * i));
+    }
+    update(padding, length + 8);
+
+    std::string result(32, '0');
+    for (int i = 0; i < 16; ++i) {
+        unsigned char byte = static_cast < unsigned char >(
+            m_state[i / 4] >> (8 * (i % 4)));
+
+        result[2 * i] = hex[byte >> 4];
+        result[2 * i + 1] = hex[byte & 0x0f];
+    }
+
+    return result;
+}
+
+void Md5::transform(const unsigned char *block)
+{
+    boost::uint32_t x[16];
+
+    for (int i = 0; i < 16; ++i) {
+        x[i] = static_cast < boost::uint32_t >(block[4 * i]) |
+            static_cast < boost::uint32_t >(block[4 * i + 1]) << 8 |
+            static_cast < boost::uint32_t >(block[4 * i + 2]) << 16 |
+            static_cast < boost::uint32_t >(block[4 * i + 3]) << 24;
+    }
+
+    boost::uint32_t a = m_state[0], b = m_state[1], c = m_state[2],
+                    d = m_state[3];
+
+    for (unsigned int i = 0; i < 64; ++i) {
+        boost::uint32_t f;
+        unsigned int g;
+
+        if (i < 16) {
+            f = (b & c) | (~b & d);
+            g = i;
+        } else if (i < 32) {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) % 16;
+        } else if (i < 48) {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) % 16;
+        } else {
+            f = c ^ (b | ~d);
+            g = (7 * i) % 16;
+        }
+
+        boost::uint32_t tmp = d;
+        d = c;
+        c = b;
+        b = b + rotate(a + f + md5_sines[i] + x[g], md5_shifts[i]);
+        a = tmp;
+    }
+
+    m_state[0] += a;
+    m_state[1] += b;
+    m_state[2] += c;
+    m_state[3] += d;
+}
+
+std::string md5sum(const std::string& filepath)
+{
+    std::ifstream file(filepath.c_str(), std::ios::in | std::ios::binary);
+
+    if (not file) {
+        throw utils::FileError(fmt(_("Md5: can not open file `%1%'")) %
+                               filepath);
+    }
+
+    Md5 md5;
+    char buffer[8192];
+
+    while (file.read(buffer, sizeof(buffer)) or file.gcount() > 0) {
+        md5.update(buffer, static_cast < std::size_t >(file.gcount()));
+    }
+
+    if (file.bad()) {
+        throw utils::FileError(fmt(_("Md5: can not read file `%1%'")) %
+                               filepath);
+    }
+
+    return md5.hexdigest();
+}
+
+}} // namespace vle utils
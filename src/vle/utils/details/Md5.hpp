@@ -0,0 +1,91 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef VLE_UTILS_DETAILS_MD5_HPP
+#define VLE_UTILS_DETAILS_MD5_HPP
+
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <string>
+
+namespace vle { namespace utils {
+
+/**
+ * A MD5 message digest (RFC 1321) used to check the files downloaded by the
+ * @c RemoteManager against the @c md5sum field of the packages.
+ *
+ * @code
+ * Md5 md5;
+ * md5.update(buffer, size);
+ * std::string sum = md5.hexdigest(); // 32 lowercase hexadecimal digits.
+ * @endcode
+ */
+class Md5
+{
+public:
+    Md5();
+
+    /**
+     * Add bytes to the message.
+     *
+     * @param data The bytes to add.
+     * @param size The number of bytes.
+     */
+    void update(const void *data, std::size_t size);
+
+    /**
+     * Finish the message and return the digest. The object can not be
+     * updated after this call.
+     *
+     * @return The digest as 32 lowercase hexadecimal digits.
+     */
+    std::string hexdigest();
+
+private:
+    void transform(const unsigned char *block);
+
+    boost::uint32_t m_state[4];
+    boost::uint64_t m_size;
+    unsigned char m_buffer[64];
+};
+
+/**
+ * Compute the MD5 digest of a file.
+ *
+ * @param filepath The file to read.
+ *
+ * @throw utils::FileError if the file can not be read.
+ *
+ * @return The digest as 32 lowercase hexadecimal digits.
+ */
+std::string md5sum(const std::string& filepath);
+
+}} // namespace vle utils
+
+#endif /* VLE_UTILS_DETAILS_MD5_HPP */
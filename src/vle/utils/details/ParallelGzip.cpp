@@ -0,0 +1,312 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#if defined _WIN32 || defined __CYGWIN__
+# define BOOST_THREAD_USE_LIB
+# define BOOST_THREAD_DONT_USE_CHRONO
+#endif
+
+#include <vle/utils/details/ParallelGzip.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <vector>
+#include <zlib.h>
+
+namespace vle { namespace utils {
+
+/**
+ * Compress a block into a complete gzip member.
+ *
+ * @return An empty string on success, the zlib error otherwise.
+ */
+static std::string deflateBlock(const std::vector < char >& in,
+                                std::vector < char > *out)
+{
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+
+    /* 15 + 16: the largest window with a gzip header and trailer. */
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        return stream.msg ? stream.msg : "deflateInit2";
+    }
+
+    out->resize(deflateBound(&stream, in.size()) + 32);
+
+    stream.next_in = in.empty() ? Z_NULL :
+        reinterpret_cast < Bytef* >(const_cast < char* >(&in[0]));
+    stream.avail_in = in.size();
+    stream.next_out = reinterpret_cast < Bytef* >(&(*out)[0]);
+    stream.avail_out = out->size();
+
+    int ret = deflate(&stream, Z_FINISH);
+    std::string error;
+
+    if (ret != Z_STREAM_END) {
+        error = stream.msg ? stream.msg : "deflate";
+    }
+
+    out->resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return error;
+}
+
+class ParallelGzip::Pimpl
+{
+public:
+    struct Block
+    {
+        uint64_t index;
+        std::vector < char > data;
+    };
+
+    /**
+     * The @c Worker is a boost thread functor which compresses the blocks
+     * of the queue.
+     */
+    struct Worker
+    {
+        Pimpl *pimpl;
+
+        Worker(Pimpl *pimpl)
+            : pimpl(pimpl)
+        {
+        }
+
+        void operator()() const
+        {
+            pimpl->work();
+        }
+    };
+
+    Pimpl(const std::string& filename, uint32_t jobs, std::size_t blocksize)
+        : mFilename(filename),
+          mFile(filename.c_str(), std::ios::out | std::ios::binary |
+                std::ios::trunc),
+          mJobs(jobs ? jobs : std::max(boost::thread::hardware_concurrency(),
+                                       1u)),
+          mBlockSize(std::max(blocksize, (std::size_t)1)),
+          mSubmitted(0), mWritten(0), mWriting(false), mClosing(false),
+          mClosed(false)
+    {
+        if (not mFile) {
+            throw FileError(fmt(_("Gzip: failed to open `%1%'")) % filename);
+        }
+
+        mBuffer.reserve(mBlockSize);
+
+        for (uint32_t i = 0; i < mJobs; ++i) {
+            mThreads.create_thread(Worker(this));
+        }
+    }
+
+    ~Pimpl()
+    {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    void write(const char *data, std::size_t size)
+    {
+        while (size > 0) {
+            std::size_t len = std::min(size, mBlockSize - mBuffer.size());
+
+            mBuffer.insert(mBuffer.end(), data, data + len);
+            data += len;
+            size -= len;
+
+            if (mBuffer.size() == mBlockSize) {
+                submit();
+            }
+        }
+    }
+
+    /**
+     * Push the current buffer into the queue. Wait while too many blocks
+     * are compressed or wait to be written to bound the memory.
+     */
+    void submit()
+    {
+        boost::mutex::scoped_lock lock(mMutex);
+
+        while (mSubmitted - mWritten >= 2 * mJobs and mError.empty()) {
+            mCondition.wait(lock);
+        }
+
+        if (not mError.empty()) {
+            throw FileError(fmt(_("Gzip: `%1%': %2%")) % mFilename % mError);
+        }
+
+        mQueue.push_back(Block());
+        mQueue.back().index = mSubmitted++;
+        mQueue.back().data.swap(mBuffer);
+        mBuffer.reserve(mBlockSize);
+
+        mCondition.notify_all();
+    }
+
+    void close()
+    {
+        if (mClosed) {
+            return;
+        }
+        mClosed = true;
+
+        try {
+            if (not mBuffer.empty() or mSubmitted == 0) {
+                submit();
+            }
+        } catch (...) {
+        }
+
+        {
+            boost::mutex::scoped_lock lock(mMutex);
+            mClosing = true;
+            mCondition.notify_all();
+        }
+
+        mThreads.join_all();
+        mFile.close();
+
+        if (not mError.empty()) {
+            throw FileError(fmt(_("Gzip: `%1%': %2%")) % mFilename % mError);
+        }
+    }
+
+    /**
+     * Compress the blocks of the queue. The thread which compresses the
+     * next block to write writes all the following compressed blocks.
+     */
+    void work()
+    {
+        boost::mutex::scoped_lock lock(mMutex);
+
+        for (;;) {
+            while (mQueue.empty() and not mClosing) {
+                mCondition.wait(lock);
+            }
+
+            if (mQueue.empty()) {
+                return;
+            }
+
+            Block block;
+            block.index = mQueue.front().index;
+            block.data.swap(mQueue.front().data);
+            mQueue.pop_front();
+
+            lock.unlock();
+            std::vector < char > compressed;
+            std::string error = deflateBlock(block.data, &compressed);
+            lock.lock();
+
+            if (not error.empty() and mError.empty()) {
+                mError = error;
+            }
+
+            mDone[block.index].swap(compressed);
+
+            if (not mWriting) {
+                mWriting = true;
+
+                std::map < uint64_t, std::vector < char > >::iterator it;
+                while ((it = mDone.find(mWritten)) != mDone.end()) {
+                    std::vector < char > data;
+                    data.swap(it->second);
+                    mDone.erase(it);
+
+                    lock.unlock();
+                    if (not data.empty()) {
+                        mFile.write(&data[0], data.size());
+                    }
+                    lock.lock();
+
+                    if (not mFile and mError.empty()) {
+                        mError = _("write failure");
+                    }
+                    mWritten++;
+                }
+
+                mWriting = false;
+            }
+
+            mCondition.notify_all();
+        }
+    }
+
+    std::string mFilename;
+    std::ofstream mFile;
+    uint32_t mJobs;
+    std::size_t mBlockSize;
+    std::vector < char > mBuffer;
+    std::deque < Block > mQueue;
+    std::map < uint64_t, std::vector < char > > mDone;
+    uint64_t mSubmitted;
+    uint64_t mWritten;
+    bool mWriting;
+    bool mClosing;
+    bool mClosed;
+    std::string mError;
+    boost::mutex mMutex;
+    boost::condition_variable mCondition;
+    boost::thread_group mThreads;
+};
+
+ParallelGzip::ParallelGzip(const std::string& filename, uint32_t jobs,
+                           std::size_t blocksize)
+    : mPimpl(new ParallelGzip::Pimpl(filename, jobs, blocksize))
+{
+}
+
+ParallelGzip::~ParallelGzip()
+{
+    delete mPimpl;
+}
+
+void ParallelGzip::write(const void *data, std::size_t size)
+{
+    mPimpl->write(static_cast < const char* >(data), size);
+}
+
+void ParallelGzip::close()
+{
+    mPimpl->close();
+}
+
+}} // namespace vle utils
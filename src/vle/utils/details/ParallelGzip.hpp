@@ -0,0 +1,98 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_UTILS_DETAILS_PARALLELGZIP_HPP
+#define VLE_UTILS_DETAILS_PARALLELGZIP_HPP
+
+#include <vle/utils/Types.hpp>
+#include <cstddef>
+#include <string>
+
+namespace vle { namespace utils {
+
+/**
+ * A gzip file compressed by a pool of threads. The data are cut into blocks
+ * compressed independently and written in order as gzip members: the
+ * concatenation is a valid gzip file (RFC 1952) read by gzip, tar or
+ * libarchive.
+ *
+ * @code
+ * ParallelGzip gz("output.gz", 4);
+ * gz.write(buffer, size);
+ * gz.close();
+ * @endcode
+ */
+class ParallelGzip
+{
+public:
+    /**
+     * Create or truncate the gzip file.
+     *
+     * @param filename The gzip file to write.
+     * @param jobs The number of compression threads, 0 uses the number of
+     * processors.
+     * @param blocksize The size of the uncompressed blocks.
+     * @throw utils::FileError if the file can not be opened.
+     */
+    ParallelGzip(const std::string& filename, uint32_t jobs = 0,
+                 std::size_t blocksize = 1u << 20);
+
+    /**
+     * Close the file if @c close was not called. The errors are lost.
+     */
+    ~ParallelGzip();
+
+    /**
+     * Append bytes to the file. The call blocks when too many blocks wait
+     * to be compressed.
+     *
+     * @param data The bytes to append.
+     * @param size The number of bytes.
+     * @throw utils::FileError if a previous block failed.
+     */
+    void write(const void *data, std::size_t size);
+
+    /**
+     * Compress the last block, wait the end of the threads and close the
+     * file.
+     *
+     * @throw utils::FileError if a block can not be compressed or written.
+     */
+    void close();
+
+private:
+    ParallelGzip(const ParallelGzip&);
+    ParallelGzip& operator=(const ParallelGzip&);
+
+    class Pimpl;
+    Pimpl *mPimpl;
+};
+
+}} // namespace vle utils
+
+#endif
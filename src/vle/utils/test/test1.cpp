@@ -34,6 +34,7 @@
 #include <boost/test/floating_point_comparison.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/config.hpp>
+#include <boost/thread.hpp>
 #include <stdexcept>
 #include <limits>
 #include <fstream>
@@ -48,8 +49,11 @@
 #include <vle/utils/DateTime.hpp>
 #include <vle/utils/Package.hpp>
 #include <vle/utils/Path.hpp>
+#include <vle/utils/Philox.hpp>
 #include <vle/utils/Rand.hpp>
+#include <vle/utils/Symbol.hpp>
 #include <vle/utils/Tools.hpp>
+#include <vle/utils/Trace.hpp>
 #include <vle/vle.hpp>
 
 using namespace vle;
@@ -248,6 +252,168 @@ BOOST_AUTO_TEST_CASE(test_normal)
                         (double)szmax, 1.0, 10);
 }
 
+BOOST_AUTO_TEST_CASE(test_fill)
+{
+    const std::size_t szmax(1000);
+    std::vector < double > n1(szmax, 0), n2(szmax, 0);
+
+    vle::utils::Rand r1(123456789), r2(123456789);
+
+    r1.fillUniform(&n1[0], szmax);
+    for (std::size_t i = 0; i < szmax; ++i) {
+        n2[i] = r2.getDouble();
+    }
+    BOOST_REQUIRE(n1 == n2);
+
+    r1.fillNormal(&n1[0], szmax, 1.0, 1.0);
+    BOOST_REQUIRE_CLOSE(std::accumulate(n1.begin(), n1.end(), 0.0) /
+                        (double)szmax, 1.0, 10);
+}
+
+BOOST_AUTO_TEST_CASE(test_philox)
+{
+    {
+        /* Known answers of the Random123 distribution. */
+        const uint32_t ctr1[4] = { 0, 0, 0, 0 };
+        const uint32_t key1[2] = { 0, 0 };
+        const uint32_t ctr2[4] = { 0xffffffff, 0xffffffff, 0xffffffff,
+            0xffffffff };
+        const uint32_t key2[2] = { 0xffffffff, 0xffffffff };
+        const uint32_t ctr3[4] = { 0x243f6a88, 0x85a308d3, 0x13198a2e,
+            0x03707344 };
+        const uint32_t key3[2] = { 0xa4093822, 0x299f31d0 };
+        uint32_t out[4];
+
+        vle::utils::Philox::block(ctr1, key1, out);
+        BOOST_REQUIRE_EQUAL(out[0], 0x6627e8d5u);
+        BOOST_REQUIRE_EQUAL(out[1], 0xe169c58du);
+        BOOST_REQUIRE_EQUAL(out[2], 0xbc57ac4cu);
+        BOOST_REQUIRE_EQUAL(out[3], 0x9b00dbd8u);
+
+        vle::utils::Philox::block(ctr2, key2, out);
+        BOOST_REQUIRE_EQUAL(out[0], 0x408f276du);
+        BOOST_REQUIRE_EQUAL(out[1], 0x41c83b0eu);
+        BOOST_REQUIRE_EQUAL(out[2], 0xa20bc7c6u);
+        BOOST_REQUIRE_EQUAL(out[3], 0x6d5451fdu);
+
+        vle::utils::Philox::block(ctr3, key3, out);
+        BOOST_REQUIRE_EQUAL(out[0], 0xd16cfe09u);
+        BOOST_REQUIRE_EQUAL(out[1], 0x94fdccebu);
+        BOOST_REQUIRE_EQUAL(out[2], 0x5001e420u);
+        BOOST_REQUIRE_EQUAL(out[3], 0x24126ea1u);
+    }
+
+    {
+        /* The batched functions give the same sequence as the scalar ones,
+         * whatever the position in the stream. */
+        const std::size_t szmax(1000);
+        std::vector < uint32_t > v1(szmax), v2(szmax);
+        std::vector < double > d1(szmax), d2(szmax);
+        vle::utils::Philox r1(12345), r2(12345);
+
+        r1();
+        r2();
+        r1.fill(&v1[0], szmax);
+        for (std::size_t i = 0; i < szmax; ++i) {
+            v2[i] = r2();
+        }
+        BOOST_REQUIRE(v1 == v2);
+        BOOST_REQUIRE_EQUAL(r1.position(), r2.position());
+        BOOST_REQUIRE_EQUAL(r1.position(), szmax + 1);
+
+        r1.fillUniform(&d1[0], szmax);
+        for (std::size_t i = 0; i < szmax; ++i) {
+            d2[i] = r2.getDouble();
+            BOOST_REQUIRE(d2[i] >= 0.0 and d2[i] < 1.0);
+        }
+        BOOST_REQUIRE(d1 == d2);
+        BOOST_REQUIRE_CLOSE(std::accumulate(d1.begin(), d1.end(), 0.0) /
+                            (double)szmax, 0.5, 10);
+
+        r1.fillNormal(&d1[0], szmax - 1, 1.0, 1.0);
+        BOOST_REQUIRE_CLOSE(std::accumulate(d1.begin(), d1.end() - 1, 0.0) /
+                            (double)(szmax - 1), 1.0, 10);
+    }
+
+    {
+        /* Jump ahead and streams. */
+        vle::utils::Philox r1(42), r2(42);
+
+        for (int i = 0; i < 1003; ++i) {
+            r1();
+        }
+        r2.discard(1000);
+        r2.discard(3);
+        BOOST_REQUIRE_EQUAL(r1(), r2());
+
+        vle::utils::Philox s1(r1.split(1)), s2(r1.split(2)), s3(r2.split(1));
+        BOOST_REQUIRE_EQUAL(s1.key(), r1.key());
+        BOOST_REQUIRE_EQUAL(s1.stream(), 1u);
+        BOOST_REQUIRE_EQUAL(s1.position(), 0u);
+        BOOST_REQUIRE_EQUAL(s1(), s3());
+        BOOST_REQUIRE(s1() != s2());
+    }
+
+    {
+        /* Keys derived from the experiment seed, the model name and the
+         * replicate index. */
+        using vle::utils::Philox;
+
+        BOOST_REQUIRE_EQUAL(Philox::derive(1, "top:A", 0),
+                            Philox::derive(1, "top:A", 0));
+        BOOST_REQUIRE(Philox::derive(1, "top:A", 0) !=
+                      Philox::derive(2, "top:A", 0));
+        BOOST_REQUIRE(Philox::derive(1, "top:A", 0) !=
+                      Philox::derive(1, "top:B", 0));
+        BOOST_REQUIRE(Philox::derive(1, "top:A", 0) !=
+                      Philox::derive(1, "top:A", 1));
+    }
+
+    {
+        /* Philox works with the boost distributions. */
+        vle::utils::Philox r(123456789);
+        boost::uniform_int < > distrib(0, 10);
+        boost::variate_generator < vle::utils::Philox&,
+            boost::uniform_int < > > gen(r, distrib);
+        std::vector < uint32_t > vec(1000);
+
+        vle::utils::generate(vec.begin(), vec.end(), gen);
+        BOOST_REQUIRE_CLOSE(((double)std::accumulate(vec.begin(), vec.end(),
+                                                     (uint32_t)0)) / 1000.0,
+                            5.0, 10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_symbol)
+{
+    using vle::utils::Symbol;
+
+    Symbol a("out"), b(std::string("out")), c("in"), d;
+
+    BOOST_REQUIRE(a == b);
+    BOOST_REQUIRE(&a.str() == &b.str());
+    BOOST_REQUIRE(a != c);
+    BOOST_REQUIRE(c < a);
+    BOOST_REQUIRE(not (a < b));
+    BOOST_REQUIRE(d.empty());
+    BOOST_REQUIRE(d == Symbol(""));
+
+    BOOST_REQUIRE(a == "out");
+    BOOST_REQUIRE(std::string("in") == c);
+    BOOST_REQUIRE_EQUAL(std::string("p:") + a, "p:out");
+    BOOST_REQUIRE_EQUAL(a.size(), 3u);
+
+    std::size_t count = Symbol::count();
+    Symbol e("out");
+    BOOST_REQUIRE_EQUAL(Symbol::count(), count);
+    Symbol f("a symbol used only by test_symbol");
+    BOOST_REQUIRE_EQUAL(Symbol::count(), count + 1);
+
+    std::ostringstream out;
+    out << e << f;
+    BOOST_REQUIRE_EQUAL(out.str(), "outa symbol used only by test_symbol");
+}
+
 BOOST_AUTO_TEST_CASE(date_time)
 {
     BOOST_REQUIRE_EQUAL(vle::utils::DateTime::year((2451545)),
@@ -426,3 +592,111 @@ BOOST_AUTO_TEST_CASE(test_format_copy)
                         "\"1\", \"2\", \"3\", \"4\", \"5\", \"6\", \"7\", "
                         "\"8\", \"9\";");
 }
+
+static std::size_t countLines(const std::string& filename,
+                              const std::string& pattern)
+{
+    std::ifstream in(filename.c_str());
+    std::string line;
+    std::size_t result = 0;
+
+    while (std::getline(in, line)) {
+        if (line.find(pattern) != std::string::npos) {
+            result++;
+        }
+    }
+
+    return result;
+}
+
+struct TraceSender
+{
+    TraceSender(int id, bool threadlog)
+        : id(id), threadlog(threadlog)
+    {}
+
+    void operator()()
+    {
+        if (threadlog) {
+            vle::utils::Trace::setThreadLogFile("trace_thread.log");
+        }
+
+        for (int i = 0; i < 5000; ++i) {
+            TraceModel(vle::utils::TraceRecord("sender %1% message %2% %3%")
+                       % id % i % 0.5);
+        }
+
+        if (threadlog) {
+            vle::utils::Trace::resetThreadLogFile();
+        }
+    }
+
+    int id;
+    bool threadlog;
+};
+
+BOOST_AUTO_TEST_CASE(test_trace)
+{
+    namespace vu = vle::utils;
+
+    BOOST_REQUIRE_EQUAL(vu::TraceRecord("verbatim 100%").str(),
+                        "verbatim 100%");
+    BOOST_REQUIRE_EQUAL((vu::TraceRecord("%1% %2% %3% %4%") % 1 % -2l %
+                         3.5 % "four").str(), "1 -2 3.5 four");
+    BOOST_REQUIRE_EQUAL((vu::TraceRecord("%1$5.2f|%2%") % 3.14159 %
+                         std::string("pi")).str(), " 3.14|pi");
+
+    vu::TraceLevelOptions level = vu::Trace::getLevel();
+    vu::Trace::setLevel(vu::TRACE_LEVEL_MODEL);
+    vu::Trace::setLogFile("trace.log");
+    BOOST_REQUIRE_EQUAL(vu::Trace::getType(), vu::TRACE_STREAM_FILE);
+
+    std::size_t warnings = vu::Trace::warnings();
+
+    {
+        boost::thread_group gp;
+        for (int i = 0; i < 4; ++i) {
+            gp.create_thread(TraceSender(i, i == 0));
+        }
+        gp.join_all();
+    }
+
+    TraceDevs("not in level");
+    vu::Trace::flush();
+
+    BOOST_REQUIRE_EQUAL(countLines("trace.log", "sender 0 "), 0u);
+    BOOST_REQUIRE_EQUAL(countLines("trace.log", " 0.5"), 15000u);
+    BOOST_REQUIRE_EQUAL(countLines("trace.log", "sender 3 message 4999 0.5"),
+                        1u);
+    BOOST_REQUIRE_EQUAL(countLines("trace.log", "not in level"), 0u);
+    BOOST_REQUIRE_EQUAL(countLines("trace_thread.log", "sender 0 "), 5000u);
+    BOOST_REQUIRE_EQUAL(vu::Trace::warnings(), warnings + 20000);
+
+    vu::Trace::setStandardError();
+    vu::Trace::setLevel(level);
+    std::remove("trace.log");
+    std::remove("trace_thread.log");
+}
+
+BOOST_AUTO_TEST_CASE(test_trace_kill)
+{
+    namespace vu = vle::utils;
+
+    vu::TraceLevelOptions level = vu::Trace::getLevel();
+    vu::Trace::setLogFile("trace.log");
+    vu::Trace::kill();
+
+    TraceAlways("after kill");
+    TraceModel("after kill");
+    vu::Trace::setLogFile("trace_kill.log");
+    vu::Trace::flush();
+    BOOST_REQUIRE(vu::Trace::getLogFile().empty());
+    BOOST_REQUIRE(not vu::Trace::isInLevel(vu::TRACE_LEVEL_MODEL));
+    BOOST_REQUIRE_EQUAL(countLines("trace.log", "after kill"), 0u);
+    BOOST_REQUIRE(not std::ifstream("trace_kill.log").is_open());
+
+    vu::Trace::init();
+    vu::Trace::setLevel(level);
+    BOOST_REQUIRE(vu::Trace::getLogFile().empty());
+    std::remove("trace.log");
+}
@@ -49,14 +49,18 @@
 #include <numeric>
 #include <vle/utils/i18n.hpp>
 #include <vle/utils/Algo.hpp>
+#include <vle/utils/Archive.hpp>
 #include <vle/utils/DateTime.hpp>
+#include <vle/utils/Exception.hpp>
 #include <vle/utils/Package.hpp>
+#include <vle/utils/PackageBuilder.hpp>
 #include <vle/utils/Path.hpp>
 #include <vle/utils/Rand.hpp>
 #include <vle/utils/Trace.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/RemoteManager.hpp>
 #include <vle/utils/DownloadManager.hpp>
+#include <vle/utils/details/Md5.hpp>
 #include <vle/vle.hpp>
 
 using namespace vle;
@@ -492,6 +496,150 @@ BOOST_AUTO_TEST_CASE(remote_package_read_write)
     }
 }
 
+/**
+ * Build the archive of a package into a mirror directory and return the
+ * description of the package pointing to the archive.
+ */
+static utils::PackageId build_mirror_package(const fs::path& mirror,
+                                             const std::string& name,
+                                             const std::string& depends)
+{
+    utils::PackageId pkg;
+
+    pkg.size = 0;
+    pkg.name = name;
+    pkg.distribution = "mirror";
+    pkg.maintainer = "me";
+    pkg.description = "mirror package";
+    pkg.url = "file://" + (mirror / (name + ".tar.bz2")).string();
+    pkg.md5sum = "none";
+    pkg.tags.push_back("mirror");
+    pkg.major = 1;
+    pkg.minor = 0;
+    pkg.patch = 0;
+
+    if (not depends.empty()) {
+        utils::PackageLinkId dep = { depends, -1, -1, -1,
+                                     utils::PACKAGE_OPERATOR_EQUAL };
+        pkg.depends.push_back(dep);
+    }
+
+    fs::path src(mirror / "src" / name);
+    fs::create_directories(src);
+    {
+        std::ofstream ofs((src / "Description.txt").string().c_str());
+        ofs << pkg;
+    }
+
+    fs::current_path(mirror / "src");
+    utils::Path::path().compress(name,
+                                 (mirror / (name + ".tar.bz2")).string());
+    pkg.md5sum = utils::md5sum((mirror / (name + ".tar.bz2")).string());
+
+    return pkg;
+}
+
+BOOST_AUTO_TEST_CASE(remote_package_mirror)
+{
+    fs::path current(fs::current_path());
+    fs::path mirror(utils::Path::path().getHomeFile("mirror"));
+    fs::path cache(utils::Path::path().getHomeFile("cache"));
+    fs::path binaries(utils::Path::path().getBinaryPackagesDir());
+    fs::create_directories(mirror);
+    fs::create_directories(binaries);
+
+    utils::Packages pkgs;
+    pkgs.push_back(build_mirror_package(mirror, "mirror-c", ""));
+    pkgs.push_back(build_mirror_package(mirror, "mirror-b", "mirror-c"));
+    pkgs.push_back(build_mirror_package(mirror, "mirror-a", "mirror-b"));
+    pkgs.push_back(build_mirror_package(mirror, "mirror-bad", ""));
+    pkgs.back().md5sum = "0123456789abcdef0123456789abcdef";
+
+    {
+        std::ofstream ofs(
+            utils::RemoteManager::getRemotePackageFilename().c_str());
+
+        for (utils::Packages::const_iterator it = pkgs.begin();
+             it != pkgs.end(); ++it) {
+            ofs << *it;
+        }
+    }
+
+    {
+        utils::RemoteManager rmt;
+        utils::Packages results;
+        std::ostringstream out;
+
+        rmt.start(utils::REMOTE_MANAGER_INSTALL, "mirror-a", &out);
+        rmt.join();
+        rmt.getResult(&results);
+
+        BOOST_REQUIRE(not rmt.hasError());
+        BOOST_REQUIRE_EQUAL(results.size(), 3u);
+        BOOST_REQUIRE_EQUAL(results[0].name, "mirror-c");
+        BOOST_REQUIRE_EQUAL(results[1].name, "mirror-b");
+        BOOST_REQUIRE_EQUAL(results[2].name, "mirror-a");
+
+        for (int i = 0; i < 3; ++i) {
+            BOOST_REQUIRE(out.str().find(
+                    (fmt("Download `%1%': ok") % pkgs[i].url).str()) !=
+                std::string::npos);
+            BOOST_REQUIRE(fs::exists(binaries / pkgs[i].name /
+                                     "Description.txt"));
+            BOOST_REQUIRE(fs::exists(cache / pkgs[i].md5sum));
+        }
+
+        out.str(std::string());
+        rmt.start(utils::REMOTE_MANAGER_INSTALL, "mirror-bad", &out);
+        rmt.join();
+
+        BOOST_REQUIRE(rmt.hasError());
+        BOOST_REQUIRE(out.str().find("bad md5sum") != std::string::npos);
+        BOOST_REQUIRE(not fs::exists(binaries / "mirror-bad"));
+        BOOST_REQUIRE(not fs::exists(cache / pkgs[3].md5sum));
+
+        rmt.start(utils::REMOTE_MANAGER_INSTALL, "mirror-unknown", &out);
+        rmt.join();
+        BOOST_REQUIRE(rmt.hasError());
+
+        rmt.start(utils::REMOTE_MANAGER_SEARCH, "mirror.*", NULL);
+        rmt.join();
+        rmt.getResult(&results);
+        BOOST_REQUIRE(not rmt.hasError());
+        BOOST_REQUIRE_EQUAL(results.size(), 4u);
+    }
+
+    /* The archive of mirror-c is only available in the cache now. */
+    fs::remove(mirror / "mirror-c.tar.bz2");
+    fs::path sources(utils::Path::path().getHomeFile("sources"));
+    fs::create_directories(sources);
+    fs::current_path(sources);
+
+    {
+        utils::RemoteManager rmt;
+        std::ostringstream out;
+
+        rmt.start(utils::REMOTE_MANAGER_SOURCE, "mirror-c", &out);
+        rmt.join();
+
+        BOOST_REQUIRE(not rmt.hasError());
+        BOOST_REQUIRE(out.str().find("Cache `mirror-c': ok") !=
+                      std::string::npos);
+        BOOST_REQUIRE(out.str().find("Download") == std::string::npos);
+        BOOST_REQUIRE(fs::exists(sources / "mirror-c" / "Description.txt"));
+
+        fs::remove(cache / pkgs[0].md5sum);
+        fs::remove_all(sources / "mirror-c");
+        rmt.start(utils::REMOTE_MANAGER_SOURCE, "mirror-c", &out);
+        rmt.join();
+
+        BOOST_REQUIRE(rmt.hasError());
+        BOOST_REQUIRE(not fs::exists(sources / "mirror-c"));
+    }
+
+    fs::current_path(current);
+}
+
 BOOST_AUTO_TEST_CASE(test_compress_filepath)
 {
     std::string filepath;
@@ -549,3 +697,94 @@ BOOST_AUTO_TEST_CASE(test_compress_filepath)
 
     BOOST_REQUIRE(fs::exists(fs::path(tmpfile)));
 }
+
+BOOST_AUTO_TEST_CASE(test_package_builder_order)
+{
+#if BOOST_VERSION > 104500
+    fs::path tmp = fs::temp_directory_path();
+    tmp /= fs::unique_path("%%%%-%%%%-%%%%-%%%%");
+#else
+    fs::path tmp = get_temporary_path();
+    tmp /= "builder";
+#endif
+
+    fs::create_directory(tmp);
+    fs::current_path(tmp);
+
+    const char *names[3] = { "top", "middle", "bottom" };
+    const char *depends[3] = { "middle, bottom", "bottom", "" };
+
+    for (int i = 0; i < 3; ++i) {
+        vle::utils::Package pkg(names[i]);
+        pkg.create();
+
+        std::ofstream desc(pkg.getFile("Description.txt",
+                                       vle::utils::PKG_SOURCE).c_str());
+        desc << "Package: " << names[i] << "\n"
+             << "Version: 1.0.0\n"
+             << "Depends: " << depends[i] << "\n"
+             << "Build-Depends:\n"
+             << "Conflicts:\n"
+             << "Maintainer: me\n"
+             << "Description: test\n"
+             << " .\n"
+             << "Tags: test\n"
+             << "Url: http://www.vle-project.org\n"
+             << "Size: 0\n"
+             << "MD5sum: xxxx\n";
+    }
+
+    std::ostringstream out;
+    vle::utils::PackageBuilder builder(2, out, out);
+    builder.add("top");
+
+    std::vector < std::string > order = builder.order();
+    BOOST_REQUIRE_EQUAL(order.size(), 3u);
+    BOOST_REQUIRE_EQUAL(order[0], "bottom");
+    BOOST_REQUIRE_EQUAL(order[1], "middle");
+    BOOST_REQUIRE_EQUAL(order[2], "top");
+    BOOST_REQUIRE(builder.installed().empty());
+
+    BOOST_REQUIRE_THROW(builder.add("unknown"), vle::utils::ArgError);
+}
+
+BOOST_AUTO_TEST_CASE(test_archive_gzip)
+{
+#if BOOST_VERSION > 104500
+    fs::path tmp = fs::temp_directory_path();
+    tmp /= fs::unique_path("%%%%-%%%%-%%%%-%%%%");
+#else
+    fs::path tmp = get_temporary_path();
+    tmp /= "archive";
+#endif
+
+    fs::create_directories(tmp / "src" / "sub");
+    fs::create_directories(tmp / "dst");
+    fs::current_path(tmp);
+
+    {
+        std::ofstream a("src/a.txt");
+        for (int i = 0; i < 100000; ++i) {
+            a << i << ' ' << i * 0.5 << '\n';
+        }
+
+        std::ofstream b("src/sub/b.txt");
+        b << "b\n";
+    }
+
+    {
+        vle::utils::Archive archive("src.tar.gz", 4);
+        archive.add("src");
+        archive.add("src/sub/b.txt", "c.txt");
+        archive.close();
+    }
+
+    BOOST_REQUIRE(fs::exists("src.tar.gz"));
+    BOOST_REQUIRE_NO_THROW(utils::Path::path().decompress(
+            (tmp / "src.tar.gz").string(), (tmp / "dst").string()));
+
+    BOOST_REQUIRE_EQUAL(fs::file_size(tmp / "dst" / "src" / "a.txt"),
+                        fs::file_size(tmp / "src" / "a.txt"));
+    BOOST_REQUIRE(fs::exists(tmp / "dst" / "src" / "sub" / "b.txt"));
+    BOOST_REQUIRE(fs::exists(tmp / "dst" / "c.txt"));
+}
@@ -32,8 +32,14 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/auto_unit_test.hpp>
 #include <boost/test/floating_point_comparison.hpp>
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <fstream>
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/Parser.hpp>
+#include <vle/utils/TimeSeries.hpp>
+#include <vle/utils/Path.hpp>
 #include <vle/vle.hpp>
 
 using namespace vle;
@@ -84,3 +90,193 @@ BOOST_AUTO_TEST_CASE(ParserStr)
         BOOST_REQUIRE_EQUAL(r.first++->second, "3");
     }
 }
+
+BOOST_AUTO_TEST_CASE(ParserFlat)
+{
+    std::istringstream in(str);
+    vle::utils::Parser parser(in, true);
+
+    const vle::utils::Block& block = parser.root().getBlock("test");
+    BOOST_REQUIRE(block.reals.empty());
+    BOOST_REQUIRE_EQUAL(block.strings.size(), 3);
+
+    const std::vector < double >& a = block.getReals("a");
+    BOOST_REQUIRE_EQUAL(a.size(), 3);
+    BOOST_REQUIRE_EQUAL(a[0], 1);
+    BOOST_REQUIRE_EQUAL(a[1], 2);
+    BOOST_REQUIRE_EQUAL(a[2], 3);
+
+    BOOST_REQUIRE_THROW(block.getReals("b"), vle::utils::ParseError);
+}
+
+/*
+ * Write the content into a gzip member made of one stored deflate block.
+ */
+static void writeGzip(const std::string& filename, const std::string& content)
+{
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    const unsigned char header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff };
+    out.write(reinterpret_cast < const char* >(header), sizeof(header));
+
+    unsigned int len = content.size();
+    out.put(1);
+    out.put(len & 0xff);
+    out.put((len >> 8) & 0xff);
+    out.put(~len & 0xff);
+    out.put((~len >> 8) & 0xff);
+    out.write(content.data(), content.size());
+
+    boost::crc_32_type crc;
+    crc.process_bytes(content.data(), content.size());
+    unsigned int trailer[2] = { crc.checksum(), len };
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            out.put((trailer[i] >> (8 * j)) & 0xff);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ParserCacheFile)
+{
+    std::string plain = vle::utils::Path::buildTemp("vle_parser_test.dat");
+    std::string gzip = vle::utils::Path::buildTemp("vle_parser_test.dat.gz");
+
+    {
+        std::ofstream out(plain.c_str());
+        out << str;
+    }
+    writeGzip(gzip, "test { a = 4, 5; }\n");
+
+    vle::utils::ParserCache::BlockPtr first =
+        vle::utils::ParserCache::get(plain);
+    vle::utils::ParserCache::BlockPtr second =
+        vle::utils::ParserCache::get(plain);
+    BOOST_REQUIRE(first == second);
+    BOOST_REQUIRE_EQUAL(first->getBlock("test").getReals("a").size(), 3);
+
+    vle::utils::ParserCache::BlockPtr compressed =
+        vle::utils::ParserCache::get(gzip);
+    const std::vector < double >& a =
+        compressed->getBlock("test").getReals("a");
+    BOOST_REQUIRE_EQUAL(a.size(), 2);
+    BOOST_REQUIRE_EQUAL(a[0], 4);
+    BOOST_REQUIRE_EQUAL(a[1], 5);
+
+    {
+        std::ofstream out(plain.c_str());
+        out << "test { a = 6; }\n";
+    }
+
+    vle::utils::ParserCache::BlockPtr third =
+        vle::utils::ParserCache::get(plain);
+    BOOST_REQUIRE(third != first);
+    BOOST_REQUIRE_EQUAL(third->getBlock("test").getReals("a").size(), 1);
+    BOOST_REQUIRE_EQUAL(first->getBlock("test").getReals("a").size(), 3);
+
+    BOOST_REQUIRE_EQUAL(vle::utils::ParserCache::size(), 2);
+    vle::utils::ParserCache::clear();
+    BOOST_REQUIRE_EQUAL(vle::utils::ParserCache::size(), 0);
+
+    BOOST_REQUIRE_THROW(vle::utils::ParserCache::get(
+            vle::utils::Path::buildTemp("vle_parser_missing.dat")),
+        vle::utils::FileError);
+}
+
+BOOST_AUTO_TEST_CASE(TimeSeriesFile)
+{
+    std::string csv = vle::utils::Path::buildTemp("vle_timeseries_test.csv");
+    std::string binary = csv + ".vlets";
+
+    {
+        std::ofstream out(csv.c_str());
+        out << "# daily weather\n"
+            << "time;rain;temperature\n"
+            << "0;1.5;10\n"
+            << "1;0;12\n"
+            << "\n"
+            << "3;NA;16\n";
+    }
+    std::remove(binary.c_str());
+
+    vle::utils::TimeSeriesCache::TimeSeriesPtr first =
+        vle::utils::TimeSeriesCache::get(csv);
+    BOOST_REQUIRE(vle::utils::Path::existFile(binary));
+    BOOST_REQUIRE(first == vle::utils::TimeSeriesCache::get(csv));
+
+    BOOST_REQUIRE_EQUAL(first->rows(), 3);
+    BOOST_REQUIRE_EQUAL(first->columns(), 3);
+    BOOST_REQUIRE_EQUAL(first->names()[1], "rain");
+    BOOST_REQUIRE_THROW(first->column("wind"), vle::utils::ArgError);
+
+    std::size_t rain = first->column("rain");
+    std::size_t temperature = first->column("temperature");
+    BOOST_REQUIRE_EQUAL(first->data(temperature)[1], 12);
+    BOOST_REQUIRE_EQUAL(first->time(2), 3);
+    BOOST_REQUIRE_THROW(first->time(3), vle::utils::ArgError);
+    BOOST_REQUIRE_EQUAL(first->find(-1), 0);
+    BOOST_REQUIRE_EQUAL(first->find(1), 1);
+    BOOST_REQUIRE_EQUAL(first->find(2.5), 1);
+    BOOST_REQUIRE_EQUAL(first->find(10), 2);
+    BOOST_REQUIRE_EQUAL(first->value(rain, 0.5), 1.5);
+    BOOST_REQUIRE(first->value(rain, 3) != first->value(rain, 3));
+    BOOST_REQUIRE_CLOSE(first->interpolate(temperature, 2), 14, 1e-10);
+    BOOST_REQUIRE_EQUAL(first->interpolate(temperature, -1), 10);
+    BOOST_REQUIRE_EQUAL(first->interpolate(temperature, 5), 16);
+
+    {
+        /* The binary file of another source with the same modification
+         * time and size is not used. */
+        std::string other = vle::utils::Path::buildTemp(
+            "vle_timeseries_other.csv");
+        {
+            std::ofstream out(other.c_str());
+            out << "# daily weather\n"
+                << "time;rain;temperature\n"
+                << "0;9.5;90\n"
+                << "1;9;92\n"
+                << "\n"
+                << "3;NA;96\n";
+        }
+        boost::filesystem::last_write_time(
+            other, boost::filesystem::last_write_time(csv));
+        boost::filesystem::copy_file(
+            binary, other + ".vlets",
+            boost::filesystem::copy_option::overwrite_if_exists);
+
+        BOOST_REQUIRE_EQUAL(vle::utils::TimeSeriesCache::get(other)->data(
+                temperature)[1], 92);
+    }
+
+    vle::utils::TimeSeriesCache::clear();
+    BOOST_REQUIRE_EQUAL(vle::utils::TimeSeriesCache::size(), 0);
+
+    vle::utils::TimeSeriesCache::TimeSeriesPtr mapped =
+        vle::utils::TimeSeriesCache::get(csv);
+    BOOST_REQUIRE(mapped != first);
+    BOOST_REQUIRE_EQUAL(mapped->rows(), 3);
+    BOOST_REQUIRE_EQUAL(mapped->data(temperature)[2], 16);
+
+    {
+        std::ofstream out(csv.c_str());
+        out << "time,rain\n"
+            << "0,2\n";
+    }
+
+    vle::utils::TimeSeriesCache::TimeSeriesPtr updated =
+        vle::utils::TimeSeriesCache::get(csv);
+    BOOST_REQUIRE_EQUAL(updated->columns(), 2);
+    BOOST_REQUIRE_EQUAL(updated->value(1, 10), 2);
+    BOOST_REQUIRE_EQUAL(first->data(temperature)[2], 16);
+
+    {
+        std::ofstream out(csv.c_str());
+        out << "time,rain\n"
+            << "1,2\n"
+            << "0,3\n";
+    }
+
+    BOOST_REQUIRE_THROW(vle::utils::TimeSeriesCache::get(csv),
+                        vle::utils::FileError);
+
+    vle::utils::TimeSeriesCache::clear();
+}
@@ -0,0 +1,703 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <vle/value/Binary.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/value/XML.hpp>
+#include <vle/value/Null.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <boost/cstdint.hpp>
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace vle { namespace value {
+
+const unsigned int BinaryWriter::version = 1;
+
+namespace {
+
+const char binaryMagic[4] = { 'V', 'L', 'E', 'B' };
+const boost::uint32_t binaryByteOrder = 0x01020304;
+
+/* Tag of a null pointer (in a value::Matrix cell for instance), the other
+ * tags are the value::Value::type. */
+const boost::uint8_t binaryNullPointer = 0xff;
+
+/* The bulk arrays of doubles are aligned on this boundary. */
+const std::size_t binaryAlignment = sizeof(double);
+
+/* The BinaryWriter gives its buffer to the output stream above this
+ * size. */
+const std::size_t binaryFlushSize = 64 * 1024;
+
+/* The BinaryReader refills a buffer of at least this size from the input
+ * stream. */
+const std::size_t binaryReadSize = 64 * 1024;
+
+/* Maximum number of cells reserved by a value::Matrix, a bigger size comes
+ * from a corrupted stream. */
+const boost::uint64_t binaryMaxCells = UINT64_C(1) << 28;
+
+} // anonymous namespace
+
+/*
+ * BinaryWriter
+ */
+
+class BinaryWriter::Pimpl
+{
+public:
+    Pimpl(std::ostream& out)
+        : mOut(out), mFlushed(0)
+    {
+        mBuffer.reserve(binaryFlushSize);
+        putRaw(binaryMagic, sizeof(binaryMagic));
+        put(static_cast < boost::uint32_t >(BinaryWriter::version));
+        put(binaryByteOrder);
+    }
+
+    void putValue(const Value* val)
+    {
+        if (not val) {
+            put(binaryNullPointer);
+            return;
+        }
+
+        put(static_cast < boost::uint8_t >(val->getType()));
+
+        switch (val->getType()) {
+        case Value::BOOLEAN:
+            put(static_cast < boost::uint8_t >(toBoolean(*val) ? 1 : 0));
+            break;
+        case Value::INTEGER:
+            put(static_cast < boost::int32_t >(toInteger(*val)));
+            break;
+        case Value::DOUBLE:
+            put(toDouble(*val));
+            break;
+        case Value::STRING:
+            putString(toString(*val));
+            break;
+        case Value::XMLTYPE:
+            putString(toXml(*val));
+            break;
+        case Value::NIL:
+            break;
+        case Value::SET: {
+            const VectorValue& lst(toSet(*val));
+            putSize(lst.size());
+            for (VectorValue::const_iterator it = lst.begin();
+                 it != lst.end(); ++it) {
+                putValue(*it);
+            }
+            break;
+        }
+        case Value::MAP: {
+            const MapValue& lst(toMap(*val));
+            putSize(lst.size());
+            for (MapValue::const_iterator it = lst.begin();
+                 it != lst.end(); ++it) {
+                putKey(it->first);
+                putValue(it->second);
+            }
+            break;
+        }
+        case Value::TUPLE: {
+            const TupleValue& lst(toTuple(*val));
+            putSize(lst.size());
+            putDoubles(lst.empty() ? 0 : &lst[0], lst.size());
+            break;
+        }
+        case Value::TABLE: {
+            const Table& table(toTableValue(*val));
+            putSize(table.width());
+            putSize(table.height());
+            putDoubles(table.value().data(), table.value().num_elements());
+            break;
+        }
+        case Value::MATRIX: {
+            const Matrix& matrix(toMatrixValue(*val));
+            putSize(matrix.columns());
+            putSize(matrix.rows());
+            putSize(matrix.matrix().shape()[0]);
+            putSize(matrix.matrix().shape()[1]);
+            putSize(matrix.resizeColumn());
+            putSize(matrix.resizeRow());
+            for (Matrix::size_type i = 0; i < matrix.columns(); ++i) {
+                for (Matrix::size_type j = 0; j < matrix.rows(); ++j) {
+                    putValue(matrix.matrix()[i][j]);
+                }
+            }
+            break;
+        }
+        }
+
+        if (mBuffer.size() >= binaryFlushSize) {
+            write();
+        }
+    }
+
+    void flush()
+    {
+        write();
+        mOut.flush();
+
+        if (not mOut) {
+            throw utils::FileError(_("Binary value: cannot write the stream"));
+        }
+    }
+
+private:
+    typedef std::map < std::string, boost::uint64_t > KeyIndex;
+
+    std::ostream& mOut;
+    std::string mBuffer;
+    boost::uint64_t mFlushed;
+    KeyIndex mKeys;
+
+    void write()
+    {
+        if (not mBuffer.empty()) {
+            mOut.write(mBuffer.data(), mBuffer.size());
+            mFlushed += mBuffer.size();
+            mBuffer.clear();
+        }
+    }
+
+    void putRaw(const void* data, std::size_t size)
+    {
+        mBuffer.append(static_cast < const char* >(data), size);
+    }
+
+    template < typename T >
+        void put(const T& x)
+    {
+        putRaw(&x, sizeof(T));
+    }
+
+    /* Unsigned LEB128: seven bits per byte, the high bit is set on all the
+     * bytes but the last. */
+    void putSize(boost::uint64_t x)
+    {
+        while (x >= 0x80) {
+            mBuffer.push_back(static_cast < char >((x & 0x7f) | 0x80));
+            x >>= 7;
+        }
+        mBuffer.push_back(static_cast < char >(x));
+    }
+
+    void putString(const std::string& str)
+    {
+        putSize(str.size());
+        putRaw(str.data(), str.size());
+    }
+
+    /* A key already written is replaced by (index * 2 + 1), a new key is
+     * written as (size * 2) followed by its characters. */
+    void putKey(const std::string& key)
+    {
+        std::pair < KeyIndex::iterator, bool > r =
+            mKeys.insert(KeyIndex::value_type(key, mKeys.size()));
+
+        if (r.second) {
+            putSize(static_cast < boost::uint64_t >(key.size()) * 2);
+            putRaw(key.data(), key.size());
+        } else {
+            putSize(r.first->second * 2 + 1);
+        }
+    }
+
+    void putDoubles(const double* x, std::size_t size)
+    {
+        std::size_t padding = (mFlushed + mBuffer.size()) % binaryAlignment;
+        if (padding) {
+            mBuffer.append(binaryAlignment - padding, '\0');
+        }
+
+        if (size) {
+            putRaw(x, size * sizeof(double));
+        }
+    }
+};
+
+BinaryWriter::BinaryWriter(std::ostream& out)
+    : mPimpl(new BinaryWriter::Pimpl(out))
+{
+}
+
+BinaryWriter::~BinaryWriter()
+{
+    try {
+        mPimpl->flush();
+    } catch (...) {
+    }
+
+    delete mPimpl;
+}
+
+void BinaryWriter::write(const Value& value)
+{
+    mPimpl->putValue(&value);
+}
+
+void BinaryWriter::write(const Value* value)
+{
+    mPimpl->putValue(value);
+}
+
+void BinaryWriter::flush()
+{
+    mPimpl->flush();
+}
+
+std::string BinaryWriter::encode(const Value& value)
+{
+    std::ostringstream out(std::ios::out | std::ios::binary);
+
+    {
+        BinaryWriter writer(out);
+        writer.write(value);
+        writer.flush();
+    }
+
+    return out.str();
+}
+
+/*
+ * BinaryReader
+ */
+
+class BinaryReader::Pimpl
+{
+public:
+    Pimpl(const char* buffer, std::size_t size)
+        : mPos(buffer), mEnd(buffer + size), mIn(0), mOffset(0)
+    {
+        getHeader();
+    }
+
+    Pimpl(std::istream& in)
+        : mPos(0), mEnd(0), mIn(&in), mOffset(0)
+    {
+        getHeader();
+    }
+
+    bool eof()
+    {
+        if (mPos != mEnd) {
+            return false;
+        }
+
+        return not mIn or mIn->peek() == std::char_traits < char >::eof();
+    }
+
+    Value::type peek()
+    {
+        need(1);
+
+        boost::uint8_t type = static_cast < boost::uint8_t >(*mPos);
+        if (type == binaryNullPointer) {
+            return Value::NIL;
+        }
+
+        if (type > Value::MATRIX) {
+            throw utils::FileError(fmt(_(
+                        "Binary value: unknown value type %1%")) %
+                static_cast < int >(type));
+        }
+
+        return static_cast < Value::type >(type);
+    }
+
+    Value* getValue()
+    {
+        boost::uint8_t type = get < boost::uint8_t >();
+
+        switch (type) {
+        case binaryNullPointer:
+            return 0;
+        case Value::BOOLEAN:
+            return new Boolean(get < boost::uint8_t >() != 0);
+        case Value::INTEGER:
+            return new Integer(get < boost::int32_t >());
+        case Value::DOUBLE:
+            return new Double(get < double >());
+        case Value::STRING:
+            return new String(getString());
+        case Value::XMLTYPE:
+            return new Xml(getString());
+        case Value::NIL:
+            return new Null();
+        case Value::SET: {
+            std::auto_ptr < Set > result(new Set());
+            boost::uint64_t size = getSize();
+            if (not mIn) {
+                need(size);
+                result->value().reserve(size);
+            }
+            for (boost::uint64_t i = 0; i < size; ++i) {
+                result->add(getValue());
+            }
+            return result.release();
+        }
+        case Value::MAP: {
+            std::auto_ptr < Map > result(new Map());
+            boost::uint64_t size = getSize();
+            for (boost::uint64_t i = 0; i < size; ++i) {
+                const std::string& key(getKey());
+                result->add(key, getValue());
+            }
+            return result.release();
+        }
+        case Value::TUPLE: {
+            boost::uint64_t size = getSize();
+            const char* data = getDoubles(size);
+            Tuple* result = new Tuple(size);
+            if (size) {
+                std::memcpy(&result->value()[0], data, size * sizeof(double));
+            }
+            return result;
+        }
+        case Value::TABLE: {
+            boost::uint64_t width = getSize();
+            boost::uint64_t height = getSize();
+            const char* data = getDoubles(area(width, height));
+            Table* result = new Table(width, height);
+            if (width and height) {
+                std::memcpy(result->value().data(), data,
+                            width * height * sizeof(double));
+            }
+            return result;
+        }
+        case Value::MATRIX: {
+            boost::uint64_t columns = getSize();
+            boost::uint64_t rows = getSize();
+            boost::uint64_t columnmax = getSize();
+            boost::uint64_t rowmax = getSize();
+            boost::uint64_t stepcol = getSize();
+            boost::uint64_t steprow = getSize();
+            if (columns > columnmax or rows > rowmax or
+                area(columnmax, rowmax) > binaryMaxCells) {
+                throw utils::FileError(_("Binary value: bad matrix size"));
+            }
+            if (not mIn) {
+                need(area(columns, rows));
+            }
+            std::auto_ptr < Matrix > result(
+                new Matrix(columns, rows, columnmax, rowmax, stepcol,
+                           steprow));
+            for (boost::uint64_t i = 0; i < columns; ++i) {
+                for (boost::uint64_t j = 0; j < rows; ++j) {
+                    result->set(i, j, getValue());
+                }
+            }
+            return result.release();
+        }
+        default:
+            throw utils::FileError(fmt(_(
+                        "Binary value: unknown value type %1%")) %
+                static_cast < int >(type));
+        }
+    }
+
+    const double* getArray(std::size_t* width, std::size_t* height)
+    {
+        boost::uint8_t type = get < boost::uint8_t >();
+        boost::uint64_t size;
+
+        if (type == Value::TUPLE) {
+            size = getSize();
+            *width = size;
+            *height = 1;
+        } else if (type == Value::TABLE) {
+            boost::uint64_t columns = getSize();
+            boost::uint64_t rows = getSize();
+            size = area(columns, rows);
+            *width = columns;
+            *height = rows;
+        } else {
+            throw utils::FileError(fmt(_(
+                        "Binary value: type %1% is not a tuple or a table")) %
+                static_cast < int >(type));
+        }
+
+        const char* data = getDoubles(size);
+
+        if (reinterpret_cast < std::size_t >(data) % sizeof(double)) {
+            mScratch.resize(size);
+            if (size) {
+                std::memcpy(&mScratch[0], data, size * sizeof(double));
+            }
+            return size ? &mScratch[0] : 0;
+        }
+
+        return reinterpret_cast < const double* >(data);
+    }
+
+private:
+    const char* mPos;
+    const char* mEnd;
+    std::istream* mIn;
+    std::vector < char > mData;
+    boost::uint64_t mOffset;
+    std::deque < std::string > mKeys;
+    std::vector < double > mScratch;
+
+    /* Ensure that @e size bytes are available after mPos. In stream mode,
+     * the remaining bytes are moved to the beginning of the buffer and the
+     * buffer is refilled: the missing bytes are read, then the bytes
+     * already available in the stream. The buffer grows with the bytes
+     * really read, so a corrupted size ends with a truncated stream. */
+    void need(boost::uint64_t size)
+    {
+        std::size_t remaining = mEnd - mPos;
+
+        if (remaining >= size) {
+            return;
+        }
+
+        if (not mIn) {
+            throw utils::FileError(_("Binary value: truncated buffer"));
+        }
+
+        if (size > mData.max_size()) {
+            throw utils::FileError(_("Binary value: bad size"));
+        }
+
+        if (remaining and mPos != &mData[0]) {
+            std::memmove(&mData[0], mPos, remaining);
+        }
+
+        if (mData.size() < binaryReadSize) {
+            mData.resize(binaryReadSize);
+        }
+
+        std::size_t end = remaining;
+        while (end < size) {
+            if (end == mData.size()) {
+                mData.resize(std::min(static_cast < boost::uint64_t >(
+                            mData.size()) * 2, size));
+            }
+
+            std::size_t missing = std::min(static_cast < boost::uint64_t >(
+                    mData.size()), size) - end;
+
+            mIn->read(&mData[end], missing);
+            if (static_cast < std::size_t >(mIn->gcount()) != missing) {
+                throw utils::FileError(_("Binary value: truncated stream"));
+            }
+            end += missing;
+        }
+
+        if (end < mData.size()) {
+            std::streamsize available = mIn->readsome(&mData[end],
+                                                      mData.size() - end);
+            if (available > 0) {
+                end += available;
+            }
+        }
+
+        mPos = &mData[0];
+        mEnd = mPos + end;
+    }
+
+    static boost::uint64_t area(boost::uint64_t width,
+                                boost::uint64_t height)
+    {
+        if (height and width > (~static_cast < boost::uint64_t >(0)) /
+            height) {
+            throw utils::FileError(_("Binary value: bad array size"));
+        }
+
+        return width * height;
+    }
+
+    void skip(std::size_t size)
+    {
+        mPos += size;
+        mOffset += size;
+    }
+
+    template < typename T >
+        T get()
+    {
+        T x;
+        need(sizeof(T));
+        std::memcpy(&x, mPos, sizeof(T));
+        skip(sizeof(T));
+        return x;
+    }
+
+    boost::uint64_t getSize()
+    {
+        boost::uint64_t result = 0;
+
+        for (unsigned int shift = 0; shift < 64; shift += 7) {
+            boost::uint8_t byte = get < boost::uint8_t >();
+            result |= static_cast < boost::uint64_t >(byte & 0x7f) << shift;
+            if (not (byte & 0x80)) {
+                return result;
+            }
+        }
+
+        throw utils::FileError(_("Binary value: bad size"));
+    }
+
+    std::string getString()
+    {
+        boost::uint64_t size = getSize();
+        need(size);
+        std::string result(mPos, size);
+        skip(size);
+        return result;
+    }
+
+    const std::string& getKey()
+    {
+        boost::uint64_t id = getSize();
+
+        if (id & 1) {
+            id >>= 1;
+            if (id >= mKeys.size()) {
+                throw utils::FileError(fmt(_(
+                            "Binary value: unknown key %1%")) % id);
+            }
+            return mKeys[id];
+        }
+
+        id >>= 1;
+        need(id);
+        mKeys.push_back(std::string(mPos, id));
+        skip(id);
+        return mKeys.back();
+    }
+
+    /* Skip the alignment padding and return the address of @e size
+     * doubles. */
+    const char* getDoubles(boost::uint64_t size)
+    {
+        std::size_t padding = mOffset % binaryAlignment;
+        if (padding) {
+            need(binaryAlignment - padding);
+            skip(binaryAlignment - padding);
+        }
+
+        if (size > (~static_cast < boost::uint64_t >(0)) / sizeof(double)) {
+            throw utils::FileError(_("Binary value: bad array size"));
+        }
+
+        need(size * sizeof(double));
+        const char* result = mPos;
+        skip(size * sizeof(double));
+        return result;
+    }
+
+    void getHeader()
+    {
+        need(sizeof(binaryMagic));
+        if (std::memcmp(mPos, binaryMagic, sizeof(binaryMagic))) {
+            throw utils::FileError(_("Binary value: bad magic number"));
+        }
+        skip(sizeof(binaryMagic));
+
+        boost::uint32_t version = get < boost::uint32_t >();
+        if (version != BinaryWriter::version) {
+            throw utils::FileError(fmt(_(
+                        "Binary value: unsupported version %1%")) % version);
+        }
+
+        if (get < boost::uint32_t >() != binaryByteOrder) {
+            throw utils::FileError(_("Binary value: bad byte order"));
+        }
+    }
+};
+
+BinaryReader::BinaryReader(const char* buffer, std::size_t size)
+    : mPimpl(new BinaryReader::Pimpl(buffer, size))
+{
+}
+
+BinaryReader::BinaryReader(std::istream& in)
+    : mPimpl(new BinaryReader::Pimpl(in))
+{
+}
+
+BinaryReader::~BinaryReader()
+{
+    delete mPimpl;
+}
+
+bool BinaryReader::eof()
+{
+    return mPimpl->eof();
+}
+
+Value::type BinaryReader::peek()
+{
+    return mPimpl->peek();
+}
+
+Value* BinaryReader::read()
+{
+    return mPimpl->getValue();
+}
+
+const double* BinaryReader::readDoubles(std::size_t* width,
+                                        std::size_t* height)
+{
+    return mPimpl->getArray(width, height);
+}
+
+Value* BinaryReader::decode(const std::string& buffer)
+{
+    BinaryReader reader(buffer.data(), buffer.size());
+    std::auto_ptr < Value > result(reader.read());
+
+    if (not reader.eof()) {
+        throw utils::FileError(_("Binary value: trailing data"));
+    }
+
+    return result.release();
+}
+
+}} // namespace vle value
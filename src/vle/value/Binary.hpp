@@ -0,0 +1,212 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef VLE_VALUE_BINARY_HPP
+#define VLE_VALUE_BINARY_HPP 1
+
+#include <vle/value/Value.hpp>
+#include <vle/DllDefines.hpp>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <cstddef>
+
+namespace vle { namespace value {
+
+/**
+ * @brief BinaryWriter encodes value::Value trees into a compact binary
+ * stream to exchange condition sets and results between processes or to
+ * checkpoint models. The stream starts with a header (magic, format
+ * version and byte order) followed by any number of values:
+ * - the scalars are stored in their native representation,
+ * - the sizes are variable-length integers,
+ * - the keys of the value::Map are stored once per stream, later
+ *   occurrences are references,
+ * - the doubles of the value::Tuple and value::Table are copied in bulk
+ *   and aligned on 8 bytes from the start of the stream.
+ *
+ * The encoding uses the byte order of the writer: the reader refuses a
+ * stream written with another byte order.
+ *
+ * @code
+ * std::ofstream out("results.bin", std::ios::binary);
+ * value::BinaryWriter writer(out);
+ * writer.write(*map);
+ * writer.write(*set);
+ * writer.flush();
+ * @endcode
+ */
+class VLE_API BinaryWriter
+{
+public:
+    /**
+     * @brief Build a BinaryWriter and write the header of the stream.
+     * @param out The output stream, opened in binary mode.
+     */
+    BinaryWriter(std::ostream& out);
+
+    /**
+     * @brief Flush the pending data into the output stream.
+     */
+    ~BinaryWriter();
+
+    /**
+     * @brief Encode a value::Value tree.
+     * @param value The value to write.
+     */
+    void write(const Value& value);
+
+    /**
+     * @brief Encode a value::Value tree or a null pointer.
+     * @param value The value to write, can be NULL.
+     */
+    void write(const Value* value);
+
+    /**
+     * @brief Write the pending data into the output stream and flush it.
+     * @throw utils::FileError if the output stream fails.
+     */
+    void flush();
+
+    /**
+     * @brief Encode a value::Value tree into a string, with its header.
+     * @param value The value to write.
+     * @return The binary representation.
+     */
+    static std::string encode(const Value& value);
+
+    /**
+     * @brief The version of the binary format.
+     */
+    static const unsigned int version;
+
+private:
+    BinaryWriter(const BinaryWriter&);
+    BinaryWriter& operator=(const BinaryWriter&);
+
+    class Pimpl;
+    Pimpl* mPimpl;
+};
+
+/**
+ * @brief BinaryReader decodes the values written by a BinaryWriter from a
+ * buffer or from an input stream. When it reads from a buffer, the doubles
+ * of the value::Tuple and value::Table can be accessed in place with
+ * readDoubles(): the writer aligns them on 8 bytes from the start of the
+ * stream.
+ *
+ * @code
+ * value::BinaryReader reader(buffer, size);
+ * while (not reader.eof()) {
+ *     if (reader.peek() == value::Value::TABLE) {
+ *         std::size_t width, height;
+ *         const double* data = reader.readDoubles(&width, &height);
+ *         ...
+ *     } else {
+ *         value::Value* val = reader.read();
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+class VLE_API BinaryReader
+{
+public:
+    /**
+     * @brief Build a BinaryReader on a buffer and read the header. The
+     * buffer is not copied and must live longer than the reader.
+     * @param buffer The buffer to read.
+     * @param size The size of the buffer.
+     * @throw utils::FileError if the header is not valid.
+     */
+    BinaryReader(const char* buffer, std::size_t size);
+
+    /**
+     * @brief Build a BinaryReader on an input stream and read the header.
+     * @param in The input stream, opened in binary mode.
+     * @throw utils::FileError if the header is not valid.
+     */
+    BinaryReader(std::istream& in);
+
+    ~BinaryReader();
+
+    /**
+     * @brief Check if all the values are read.
+     * @return true if the end of the buffer or stream is reached.
+     */
+    bool eof();
+
+    /**
+     * @brief Get the type of the next value without decoding it.
+     * @return The type of the next value, Value::NIL for a null pointer.
+     * @throw utils::FileError if the stream is at end or corrupted.
+     */
+    Value::type peek();
+
+    /**
+     * @brief Decode the next value.
+     * @return A new value::Value or NULL if a null pointer was written.
+     * @throw utils::FileError if the stream is truncated or corrupted.
+     */
+    Value* read();
+
+    /**
+     * @brief Decode the next value, which must be a value::Tuple or a
+     * value::Table, without building it. When the reader uses a buffer
+     * aligned on 8 bytes, the returned pointer references the buffer
+     * itself, otherwise it is valid until the next read.
+     * @param width [out] The number of elements of the Tuple or the width of
+     * the Table.
+     * @param height [out] 1 for a Tuple, the height of the Table.
+     * @return A pointer to the width * height doubles in the row-major
+     * order of the value::Table.
+     * @throw utils::FileError if the next value is not a Tuple or a Table.
+     */
+    const double* readDoubles(std::size_t* width, std::size_t* height);
+
+    /**
+     * @brief Decode a value::Value tree from a string built by
+     * BinaryWriter::encode.
+     * @param buffer The binary representation.
+     * @return A new value::Value.
+     * @throw utils::FileError if the buffer is not valid.
+     */
+    static Value* decode(const std::string& buffer);
+
+private:
+    BinaryReader(const BinaryReader&);
+    BinaryReader& operator=(const BinaryReader&);
+
+    class Pimpl;
+    Pimpl* mPimpl;
+};
+
+}} // namespace vle value
+
+#endif
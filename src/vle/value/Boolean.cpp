@@ -26,17 +26,22 @@
 
 
 #include <vle/value/Boolean.hpp>
+#include <vle/value/Text.hpp>
 
 namespace vle { namespace value {
 
 void Boolean::writeFile(std::ostream& out) const
 {
-    out << m_value;
+    TextWriter writer(out);
+
+    writer.put(m_value);
 }
 
 void Boolean::writeString(std::ostream& out) const
 {
-    out << m_value;
+    TextWriter writer(out);
+
+    writer.put(m_value);
 }
 
 void Boolean::writeXml(std::ostream& out) const
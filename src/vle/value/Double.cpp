@@ -26,38 +26,32 @@
 
 
 #include <vle/value/Double.hpp>
-#include <iomanip>
+#include <vle/value/Text.hpp>
+#include <limits>
 
 namespace vle { namespace value {
 
 void Double::writeFile(std::ostream& out) const
 {
-    std::streamsize old = out.precision();
+    TextWriter writer(out);
 
-    out << std::setprecision(std::numeric_limits < double >::digits10)
-        << m_value;
-
-    out.precision(old);
+    writer.put(m_value, std::numeric_limits < double >::digits10);
 }
 
 void Double::writeString(std::ostream& out) const
 {
-    std::streamsize old = out.precision();
-
-    out << std::setprecision(std::numeric_limits < double >::digits10)
-        << m_value;
+    TextWriter writer(out);
 
-    out.precision(old);
+    writer.put(m_value, std::numeric_limits < double >::digits10);
 }
 
 void Double::writeXml(std::ostream& out) const
 {
-    std::streamsize old = out.precision();
-
-    out << std::setprecision(std::numeric_limits < double >::digits10)
-        << "<double>" << m_value << "</double>";
+    TextWriter writer(out);
 
-    out.precision(old);
+    writer.put("<double>");
+    writer.put(m_value, std::numeric_limits < double >::digits10);
+    writer.put("</double>");
 }
 
 }} // namespace vle value
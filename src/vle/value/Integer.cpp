@@ -26,41 +26,31 @@
 
 
 #include <vle/value/Integer.hpp>
-#include <iomanip>
-#include <limits>
+#include <vle/value/Text.hpp>
 
 namespace vle { namespace value {
 
 void Integer::writeFile(std::ostream& out) const
 {
-    std::streamsize old = out.precision();
+    TextWriter writer(out);
 
-    out << std::setprecision(std::numeric_limits < int32_t >::digits10)
-        << m_value;
-
-    out.precision(old);
+    writer.put(m_value);
 }
 
 void Integer::writeString(std::ostream& out) const
 {
-    std::streamsize old = out.precision();
-
-    out << std::setprecision(std::numeric_limits < int32_t >::digits10)
-        << m_value;
+    TextWriter writer(out);
 
-    out.precision(old);
+    writer.put(m_value);
 }
 
 void Integer::writeXml(std::ostream& out) const
 {
-    std::streamsize old = out.precision();
-
-    out << "<integer>"
-        << std::setprecision(std::numeric_limits < int32_t >::digits10)
-        << m_value
-        << "</integer>";
+    TextWriter writer(out);
 
-    out.precision(old);
+    writer.put("<integer>");
+    writer.put(m_value);
+    writer.put("</integer>");
 }
 
 }} // namespace vle value
@@ -0,0 +1,679 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <vle/value/Kernel.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || __GNUC__ > 4 || \
+     (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+# define VLE_VALUE_KERNEL_X86 1
+# include <immintrin.h>
+# define VLE_VALUE_KERNEL_TARGET(x) __attribute__((target(x)))
+#endif
+
+namespace vle { namespace value { namespace kernel {
+
+namespace {
+
+/* Number of partial results of the reductions. Each implementation must
+ * accumulate x[i] into the lane i % lanes to return the same bits. */
+const std::size_t lanes = 16;
+
+/* Combine the partial sums with a pairwise tree. */
+inline double reduceLanes(double* acc)
+{
+    for (std::size_t width = lanes / 2; width > 0; width /= 2) {
+        for (std::size_t j = 0; j < width; ++j) {
+            acc[j] = acc[2 * j] + acc[2 * j + 1];
+        }
+    }
+    return acc[0];
+}
+
+inline void reduceMinMax(const double* lower, const double* upper,
+                         double* min, double* max)
+{
+    for (std::size_t j = 0; j < lanes; ++j) {
+        *min = lower[j] < *min ? lower[j] : *min;
+        *max = upper[j] > *max ? upper[j] : *max;
+    }
+}
+
+/*
+ * Portable loops.
+ */
+
+double sumStrided(const double* x, std::size_t n, std::ptrdiff_t incx)
+{
+    double acc[lanes] = { 0.0 };
+    std::size_t i = 0;
+
+    for (; i + lanes <= n; i += lanes) {
+        for (std::size_t j = 0; j < lanes; ++j) {
+            acc[j] += x[(i + j) * incx];
+        }
+    }
+
+    double result = reduceLanes(acc);
+    for (; i < n; ++i) {
+        result += x[i * incx];
+    }
+    return result;
+}
+
+double dotStrided(const double* x, std::ptrdiff_t incx, const double* y,
+                  std::ptrdiff_t incy, std::size_t n)
+{
+    double acc[lanes] = { 0.0 };
+    std::size_t i = 0;
+
+    for (; i + lanes <= n; i += lanes) {
+        for (std::size_t j = 0; j < lanes; ++j) {
+            acc[j] += x[(i + j) * incx] * y[(i + j) * incy];
+        }
+    }
+
+    double result = reduceLanes(acc);
+    for (; i < n; ++i) {
+        result += x[i * incx] * y[i * incy];
+    }
+    return result;
+}
+
+double sumScalar(const double* x, std::size_t n)
+{
+    return sumStrided(x, n, 1);
+}
+
+double dotScalar(const double* x, const double* y, std::size_t n)
+{
+    return dotStrided(x, 1, y, 1, n);
+}
+
+void minmaxScalar(const double* x, std::size_t n, double* min, double* max)
+{
+    double lower[lanes], upper[lanes];
+    std::size_t i = 0;
+
+    std::fill(lower, lower + lanes, x[0]);
+    std::fill(upper, upper + lanes, x[0]);
+
+    for (; i + lanes <= n; i += lanes) {
+        for (std::size_t j = 0; j < lanes; ++j) {
+            lower[j] = x[i + j] < lower[j] ? x[i + j] : lower[j];
+            upper[j] = x[i + j] > upper[j] ? x[i + j] : upper[j];
+        }
+    }
+
+    *min = x[0];
+    *max = x[0];
+    reduceMinMax(lower, upper, min, max);
+    for (; i < n; ++i) {
+        *min = x[i] < *min ? x[i] : *min;
+        *max = x[i] > *max ? x[i] : *max;
+    }
+}
+
+void axpyScalar(double a, const double* x, double* y, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        y[i] += a * x[i];
+    }
+}
+
+void scaleScalar(double a, double* x, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] *= a;
+    }
+}
+
+void addScalar(const double* x, const double* y, double* z, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        z[i] = x[i] + y[i];
+    }
+}
+
+void subScalar(const double* x, const double* y, double* z, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        z[i] = x[i] - y[i];
+    }
+}
+
+void mulScalar(const double* x, const double* y, double* z, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        z[i] = x[i] * y[i];
+    }
+}
+
+void fillScalar(double* x, std::size_t n, double value)
+{
+    std::fill(x, x + n, value);
+}
+
+#ifdef VLE_VALUE_KERNEL_X86
+
+/*
+ * SSE2, eight registers of two lanes for the reductions.
+ */
+
+VLE_VALUE_KERNEL_TARGET("sse2")
+double sumSse2(const double* x, std::size_t n)
+{
+    __m128d acc[lanes / 2];
+    std::size_t i = 0;
+
+    for (std::size_t j = 0; j < lanes / 2; ++j) {
+        acc[j] = _mm_setzero_pd();
+    }
+
+    for (; i + lanes <= n; i += lanes) {
+        for (std::size_t j = 0; j < lanes / 2; ++j) {
+            acc[j] = _mm_add_pd(acc[j], _mm_loadu_pd(x + i + 2 * j));
+        }
+    }
+
+    double partial[lanes];
+    for (std::size_t j = 0; j < lanes / 2; ++j) {
+        _mm_storeu_pd(partial + 2 * j, acc[j]);
+    }
+
+    double result = reduceLanes(partial);
+    for (; i < n; ++i) {
+        result += x[i];
+    }
+    return result;
+}
+
+VLE_VALUE_KERNEL_TARGET("sse2")
+double dotSse2(const double* x, const double* y, std::size_t n)
+{
+    __m128d acc[lanes / 2];
+    std::size_t i = 0;
+
+    for (std::size_t j = 0; j < lanes / 2; ++j) {
+        acc[j] = _mm_setzero_pd();
+    }
+
+    for (; i + lanes <= n; i += lanes) {
+        for (std::size_t j = 0; j < lanes / 2; ++j) {
+            acc[j] = _mm_add_pd(acc[j],
+                                _mm_mul_pd(_mm_loadu_pd(x + i + 2 * j),
+                                           _mm_loadu_pd(y + i + 2 * j)));
+        }
+    }
+
+    double partial[lanes];
+    for (std::size_t j = 0; j < lanes / 2; ++j) {
+        _mm_storeu_pd(partial + 2 * j, acc[j]);
+    }
+
+    double result = reduceLanes(partial);
+    for (; i < n; ++i) {
+        result += x[i] * y[i];
+    }
+    return result;
+}
+
+VLE_VALUE_KERNEL_TARGET("sse2")
+void minmaxSse2(const double* x, std::size_t n, double* min, double* max)
+{
+    __m128d lower[lanes / 2], upper[lanes / 2];
+    std::size_t i = 0;
+
+    for (std::size_t j = 0; j < lanes / 2; ++j) {
+        lower[j] = upper[j] = _mm_set1_pd(x[0]);
+    }
+
+    /* _mm_min_pd(a, b) returns a < b ? a : b, as the portable loops. */
+    for (; i + lanes <= n; i += lanes) {
+        for (std::size_t j = 0; j < lanes / 2; ++j) {
+            __m128d v = _mm_loadu_pd(x + i + 2 * j);
+            lower[j] = _mm_min_pd(v, lower[j]);
+            upper[j] = _mm_max_pd(v, upper[j]);
+        }
+    }
+
+    double partialLower[lanes], partialUpper[lanes];
+    for (std::size_t j = 0; j < lanes / 2; ++j) {
+        _mm_storeu_pd(partialLower + 2 * j, lower[j]);
+        _mm_storeu_pd(partialUpper + 2 * j, upper[j]);
+    }
+
+    *min = x[0];
+    *max = x[0];
+    reduceMinMax(partialLower, partialUpper, min, max);
+    for (; i < n; ++i) {
+        *min = x[i] < *min ? x[i] : *min;
+        *max = x[i] > *max ? x[i] : *max;
+    }
+}
+
+VLE_VALUE_KERNEL_TARGET("sse2")
+void axpySse2(double a, const double* x, double* y, std::size_t n)
+{
+    const __m128d factor = _mm_set1_pd(a);
+    std::size_t i = 0;
+
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i),
+                                        _mm_mul_pd(factor,
+                                                   _mm_loadu_pd(x + i))));
+    }
+    axpyScalar(a, x + i, y + i, n - i);
+}
+
+VLE_VALUE_KERNEL_TARGET("sse2")
+void scaleSse2(double a, double* x, std::size_t n)
+{
+    const __m128d factor = _mm_set1_pd(a);
+    std::size_t i = 0;
+
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(x + i, _mm_mul_pd(factor, _mm_loadu_pd(x + i)));
+    }
+    scaleScalar(a, x + i, n - i);
+}
+
+VLE_VALUE_KERNEL_TARGET("sse2")
+void addSse2(const double* x, const double* y, double* z, std::size_t n)
+{
+    std::size_t i = 0;
+
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(z + i, _mm_add_pd(_mm_loadu_pd(x + i),
+                                        _mm_loadu_pd(y + i)));
+    }
+    addScalar(x + i, y + i, z + i, n - i);
+}
+
+VLE_VALUE_KERNEL_TARGET("sse2")
+void subSse2(const double* x, const double* y, double* z, std::size_t n)
+{
+    std::size_t i = 0;
+
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(z + i, _mm_sub_pd(_mm_loadu_pd(x + i),
+                                        _mm_loadu_pd(y + i)));
+    }
+    subScalar(x + i, y + i, z + i, n - i);
+}
+
+VLE_VALUE_KERNEL_TARGET("sse2")
+void mulSse2(const double* x, const double* y, double* z, std::size_t n)
+{
+    std::size_t i = 0;
+
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(z + i, _mm_mul_pd(_mm_loadu_pd(x + i),
+                                        _mm_loadu_pd(y + i)));
+    }
+    mulScalar(x + i, y + i, z + i, n - i);
+}
+
+VLE_VALUE_KERNEL_TARGET("sse2")
+void fillSse2(double* x, std::size_t n, double value)
+{
+    const __m128d v = _mm_set1_pd(value);
+    std::size_t i = 0;
+
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(x + i, v);
+    }
+    fillScalar(x + i, n - i, value);
+}
+
+/*
+ * AVX, four registers of four lanes for the reductions. The double
+ * precision operations do not need AVX2.
+ */
+
+VLE_VALUE_KERNEL_TARGET("avx")
+double sumAvx(const double* x, std::size_t n)
+{
+    __m256d acc[lanes / 4];
+    std::size_t i = 0;
+
+    for (std::size_t j = 0; j < lanes / 4; ++j) {
+        acc[j] = _mm256_setzero_pd();
+    }
+
+    for (; i + lanes <= n; i += lanes) {
+        for (std::size_t j = 0; j < lanes / 4; ++j) {
+            acc[j] = _mm256_add_pd(acc[j], _mm256_loadu_pd(x + i + 4 * j));
+        }
+    }
+
+    double partial[lanes];
+    for (std::size_t j = 0; j < lanes / 4; ++j) {
+        _mm256_storeu_pd(partial + 4 * j, acc[j]);
+    }
+
+    double result = reduceLanes(partial);
+    for (; i < n; ++i) {
+        result += x[i];
+    }
+    return result;
+}
+
+VLE_VALUE_KERNEL_TARGET("avx")
+double dotAvx(const double* x, const double* y, std::size_t n)
+{
+    __m256d acc[lanes / 4];
+    std::size_t i = 0;
+
+    for (std::size_t j = 0; j < lanes / 4; ++j) {
+        acc[j] = _mm256_setzero_pd();
+    }
+
+    for (; i + lanes <= n; i += lanes) {
+        for (std::size_t j = 0; j < lanes / 4; ++j) {
+            acc[j] = _mm256_add_pd(
+                acc[j], _mm256_mul_pd(_mm256_loadu_pd(x + i + 4 * j),
+                                      _mm256_loadu_pd(y + i + 4 * j)));
+        }
+    }
+
+    double partial[lanes];
+    for (std::size_t j = 0; j < lanes / 4; ++j) {
+        _mm256_storeu_pd(partial + 4 * j, acc[j]);
+    }
+
+    double result = reduceLanes(partial);
+    for (; i < n; ++i) {
+        result += x[i] * y[i];
+    }
+    return result;
+}
+
+VLE_VALUE_KERNEL_TARGET("avx")
+void minmaxAvx(const double* x, std::size_t n, double* min, double* max)
+{
+    __m256d lower[lanes / 4], upper[lanes / 4];
+    std::size_t i = 0;
+
+    for (std::size_t j = 0; j < lanes / 4; ++j) {
+        lower[j] = upper[j] = _mm256_set1_pd(x[0]);
+    }
+
+    for (; i + lanes <= n; i += lanes) {
+        for (std::size_t j = 0; j < lanes / 4; ++j) {
+            __m256d v = _mm256_loadu_pd(x + i + 4 * j);
+            lower[j] = _mm256_min_pd(v, lower[j]);
+            upper[j] = _mm256_max_pd(v, upper[j]);
+        }
+    }
+
+    double partialLower[lanes], partialUpper[lanes];
+    for (std::size_t j = 0; j < lanes / 4; ++j) {
+        _mm256_storeu_pd(partialLower + 4 * j, lower[j]);
+        _mm256_storeu_pd(partialUpper + 4 * j, upper[j]);
+    }
+
+    *min = x[0];
+    *max = x[0];
+    reduceMinMax(partialLower, partialUpper, min, max);
+    for (; i < n; ++i) {
+        *min = x[i] < *min ? x[i] : *min;
+        *max = x[i] > *max ? x[i] : *max;
+    }
+}
+
+VLE_VALUE_KERNEL_TARGET("avx")
+void axpyAvx(double a, const double* x, double* y, std::size_t n)
+{
+    const __m256d factor = _mm256_set1_pd(a);
+    std::size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(y + i,
+                         _mm256_add_pd(_mm256_loadu_pd(y + i),
+                                       _mm256_mul_pd(factor,
+                                                     _mm256_loadu_pd(x + i))));
+    }
+    axpyScalar(a, x + i, y + i, n - i);
+}
+
+VLE_VALUE_KERNEL_TARGET("avx")
+void scaleAvx(double a, double* x, std::size_t n)
+{
+    const __m256d factor = _mm256_set1_pd(a);
+    std::size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(x + i, _mm256_mul_pd(factor,
+                                              _mm256_loadu_pd(x + i)));
+    }
+    scaleScalar(a, x + i, n - i);
+}
+
+VLE_VALUE_KERNEL_TARGET("avx")
+void addAvx(const double* x, const double* y, double* z, std::size_t n)
+{
+    std::size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(z + i, _mm256_add_pd(_mm256_loadu_pd(x + i),
+                                              _mm256_loadu_pd(y + i)));
+    }
+    addScalar(x + i, y + i, z + i, n - i);
+}
+
+VLE_VALUE_KERNEL_TARGET("avx")
+void subAvx(const double* x, const double* y, double* z, std::size_t n)
+{
+    std::size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(z + i, _mm256_sub_pd(_mm256_loadu_pd(x + i),
+                                              _mm256_loadu_pd(y + i)));
+    }
+    subScalar(x + i, y + i, z + i, n - i);
+}
+
+VLE_VALUE_KERNEL_TARGET("avx")
+void mulAvx(const double* x, const double* y, double* z, std::size_t n)
+{
+    std::size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(z + i, _mm256_mul_pd(_mm256_loadu_pd(x + i),
+                                              _mm256_loadu_pd(y + i)));
+    }
+    mulScalar(x + i, y + i, z + i, n - i);
+}
+
+VLE_VALUE_KERNEL_TARGET("avx")
+void fillAvx(double* x, std::size_t n, double value)
+{
+    const __m256d v = _mm256_set1_pd(value);
+    std::size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(x + i, v);
+    }
+    fillScalar(x + i, n - i, value);
+}
+
+#endif
+
+struct Kernels
+{
+    double (*sum)(const double*, std::size_t);
+    double (*dot)(const double*, const double*, std::size_t);
+    void (*minmax)(const double*, std::size_t, double*, double*);
+    void (*axpy)(double, const double*, double*, std::size_t);
+    void (*scale)(double, double*, std::size_t);
+    void (*add)(const double*, const double*, double*, std::size_t);
+    void (*sub)(const double*, const double*, double*, std::size_t);
+    void (*mul)(const double*, const double*, double*, std::size_t);
+    void (*fill)(double*, std::size_t, double);
+};
+
+/* Indexed by the kernel::Implementation. */
+const Kernels kernels[] = {
+    { sumScalar, dotScalar, minmaxScalar, axpyScalar, scaleScalar,
+        addScalar, subScalar, mulScalar, fillScalar },
+#ifdef VLE_VALUE_KERNEL_X86
+    { sumSse2, dotSse2, minmaxSse2, axpySse2, scaleSse2, addSse2, subSse2,
+        mulSse2, fillSse2 },
+    { sumAvx, dotAvx, minmaxAvx, axpyAvx, scaleAvx, addAvx, subAvx, mulAvx,
+        fillAvx }
+#endif
+};
+
+bool available(Implementation impl)
+{
+    switch (impl) {
+    case SCALAR:
+        return true;
+#ifdef VLE_VALUE_KERNEL_X86
+    case SSE2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+    case AVX:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx");
+#endif
+    default:
+        return false;
+    }
+}
+
+Implementation detect()
+{
+    if (available(AVX)) {
+        return AVX;
+    } else if (available(SSE2)) {
+        return SSE2;
+    }
+    return SCALAR;
+}
+
+/* The selection is made at the first call of a kernel. */
+const Kernels*& current()
+{
+    static const Kernels* selected = &kernels[detect()];
+
+    return selected;
+}
+
+} // anonymous namespace
+
+Implementation implementation()
+{
+    return static_cast < Implementation >(current() - kernels);
+}
+
+bool isAvailable(Implementation impl)
+{
+    return available(impl);
+}
+
+void select(Implementation impl)
+{
+    if (not available(impl)) {
+        throw utils::ArgError(fmt(
+                _("Numeric kernel: implementation %1% is not available")) %
+            impl);
+    }
+
+    current() = &kernels[impl];
+}
+
+double sum(const double* x, std::size_t n)
+{
+    return current()->sum(x, n);
+}
+
+double dot(const double* x, const double* y, std::size_t n)
+{
+    return current()->dot(x, y, n);
+}
+
+double sum(const double* x, std::size_t n, std::ptrdiff_t incx)
+{
+    return incx == 1 ? current()->sum(x, n) : sumStrided(x, n, incx);
+}
+
+double dot(const double* x, std::ptrdiff_t incx, const double* y,
+           std::ptrdiff_t incy, std::size_t n)
+{
+    return incx == 1 and incy == 1 ? current()->dot(x, y, n) :
+        dotStrided(x, incx, y, incy, n);
+}
+
+void minmax(const double* x, std::size_t n, double* min, double* max)
+{
+    current()->minmax(x, n, min, max);
+}
+
+void axpy(double a, const double* x, double* y, std::size_t n)
+{
+    current()->axpy(a, x, y, n);
+}
+
+void scale(double a, double* x, std::size_t n)
+{
+    current()->scale(a, x, n);
+}
+
+void add(const double* x, const double* y, double* z, std::size_t n)
+{
+    current()->add(x, y, z, n);
+}
+
+void sub(const double* x, const double* y, double* z, std::size_t n)
+{
+    current()->sub(x, y, z, n);
+}
+
+void mul(const double* x, const double* y, double* z, std::size_t n)
+{
+    current()->mul(x, y, z, n);
+}
+
+void fill(double* x, std::size_t n, double value)
+{
+    current()->fill(x, n, value);
+}
+
+void copy(const double* x, double* y, std::size_t n)
+{
+    std::memmove(y, x, n * sizeof(double));
+}
+
+}}} // namespace vle value kernel
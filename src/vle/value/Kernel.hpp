@@ -0,0 +1,192 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef VLE_VALUE_KERNEL_HPP
+#define VLE_VALUE_KERNEL_HPP 1
+
+#include <vle/DllDefines.hpp>
+#include <cstddef>
+
+namespace vle { namespace value { namespace kernel {
+
+/**
+ * @brief The numeric kernels work on contiguous arrays of doubles, ie. the
+ * storage of a value::Tuple or a column of a value::Table. The first call
+ * selects the fastest implementation supported by the processor (AVX or
+ * SSE2 on x86 processors, portable loops otherwise).
+ *
+ * The reductions accumulate sixteen partial results combined in a fixed
+ * order, so all the implementations return the same bits. This is not the
+ * result of a sequential loop for sum() and dot(), and it is lost if the
+ * library is built with floating point contraction (-ffp-contract=fast with
+ * a FMA processor) or -ffast-math.
+ */
+enum Implementation
+{
+    SCALAR, /**< Portable loops. */
+    SSE2, /**< 128 bits registers. */
+    AVX /**< 256 bits registers. */
+};
+
+/**
+ * @brief Get the implementation used by the kernels.
+ * @return The implementation.
+ */
+VLE_API Implementation implementation();
+
+/**
+ * @brief Check if an implementation is available on this processor.
+ * @param impl The implementation to check.
+ * @return true if the implementation can be selected.
+ */
+VLE_API bool isAvailable(Implementation impl);
+
+/**
+ * @brief Force the implementation of the kernels, to compare them in the
+ * unit tests and the benchmarks. This function is not thread-safe.
+ * @param impl The implementation to use.
+ * @throw utils::ArgError if the implementation is not available.
+ */
+VLE_API void select(Implementation impl);
+
+/**
+ * @brief Compute the sum of x[0..n[.
+ * @param x The array.
+ * @param n The number of elements.
+ * @return The sum, 0.0 if n is null.
+ */
+VLE_API double sum(const double* x, std::size_t n);
+
+/**
+ * @brief Compute the dot product of x[0..n[ and y[0..n[.
+ * @param x The first array.
+ * @param y The second array.
+ * @param n The number of elements.
+ * @return The dot product, 0.0 if n is null.
+ */
+VLE_API double dot(const double* x, const double* y, std::size_t n);
+
+/**
+ * @brief Compute the sum of x[0], x[incx], ..., x[(n - 1) * incx] with
+ * the same order of additions than sum(x, n).
+ * @param x The array.
+ * @param n The number of elements.
+ * @param incx The distance between two elements.
+ * @return The sum, 0.0 if n is null.
+ */
+VLE_API double sum(const double* x, std::size_t n, std::ptrdiff_t incx);
+
+/**
+ * @brief Compute the dot product of x[0], x[incx], ..., x[(n - 1) * incx]
+ * and y[0], y[incy], ..., y[(n - 1) * incy] with the same order of
+ * operations than dot(x, y, n).
+ * @param x The first array.
+ * @param incx The distance between two elements of x.
+ * @param y The second array.
+ * @param incy The distance between two elements of y.
+ * @param n The number of elements.
+ * @return The dot product, 0.0 if n is null.
+ */
+VLE_API double dot(const double* x, std::ptrdiff_t incx, const double* y,
+                   std::ptrdiff_t incy, std::size_t n);
+
+/**
+ * @brief Compute the minimum and the maximum of x[0..n[. The NaN of
+ * x[1..n[ are ignored.
+ * @param x The array.
+ * @param n The number of elements, must be greater than 0.
+ * @param min [out] The minimum.
+ * @param max [out] The maximum.
+ */
+VLE_API void minmax(const double* x, std::size_t n, double* min,
+                    double* max);
+
+/**
+ * @brief Compute y[i] = y[i] + a * x[i].
+ * @param a The factor.
+ * @param x The input array.
+ * @param y The input and output array.
+ * @param n The number of elements.
+ */
+VLE_API void axpy(double a, const double* x, double* y, std::size_t n);
+
+/**
+ * @brief Compute x[i] = a * x[i].
+ * @param a The factor.
+ * @param x The input and output array.
+ * @param n The number of elements.
+ */
+VLE_API void scale(double a, double* x, std::size_t n);
+
+/**
+ * @brief Compute z[i] = x[i] + y[i]. z can be x or y.
+ * @param x The first array.
+ * @param y The second array.
+ * @param z The output array.
+ * @param n The number of elements.
+ */
+VLE_API void add(const double* x, const double* y, double* z, std::size_t n);
+
+/**
+ * @brief Compute z[i] = x[i] - y[i]. z can be x or y.
+ * @param x The first array.
+ * @param y The second array.
+ * @param z The output array.
+ * @param n The number of elements.
+ */
+VLE_API void sub(const double* x, const double* y, double* z, std::size_t n);
+
+/**
+ * @brief Compute z[i] = x[i] * y[i]. z can be x or y.
+ * @param x The first array.
+ * @param y The second array.
+ * @param z The output array.
+ * @param n The number of elements.
+ */
+VLE_API void mul(const double* x, const double* y, double* z, std::size_t n);
+
+/**
+ * @brief Assign value to x[0..n[.
+ * @param x The output array.
+ * @param n The number of elements.
+ * @param value The value to assign.
+ */
+VLE_API void fill(double* x, std::size_t n, double value);
+
+/**
+ * @brief Copy x[0..n[ into y[0..n[. The arrays can overlap.
+ * @param x The input array.
+ * @param y The output array.
+ * @param n The number of elements.
+ */
+VLE_API void copy(const double* x, double* y, std::size_t n);
+
+}}} // namespace vle value kernel
+
+#endif
@@ -36,6 +36,8 @@ namespace vle { namespace value {
 Map::Map(const Map& orig)
     : Value(orig)
 {
+    m_value.reserve(orig.size());
+
     for (const_iterator it = orig.begin(); it != orig.end(); ++it) {
         if ((*it).second) {
             m_value.insert(std::make_pair((*it).first,
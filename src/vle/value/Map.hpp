@@ -38,14 +38,208 @@
 #include <vle/value/Tuple.hpp>
 #include <vle/value/XML.hpp>
 #include <vle/DllDefines.hpp>
-#include <map>
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 namespace vle { namespace value {
 
 /**
- * @brief Define a list of Value in a dictionnary.
+ * @brief Define a list of Value in a dictionnary. The MapValue stores the
+ * pairs (name, value) into a vector sorted by name: lookups are binary
+ * searches into a contiguous memory and the iteration order is the
+ * lexicographic order of the names, like a std::map. The interface is a
+ * subset of the std::map one but, like a std::vector, insert and erase
+ * invalidate the iterators.
  */
-typedef std::map < std::string, Value* > MapValue;
+class VLE_API MapValue
+{
+public:
+    typedef std::string key_type;
+    typedef Value* mapped_type;
+
+    /**
+     * @brief The (name, value) pair of the MapValue. Like the
+     * std::pair < const std::string, Value* > of a std::map, the name can
+     * not be changed through the iterators: it would break the order of
+     * the vector. Unlike it, the pairs can be assigned so the vector can
+     * move them.
+     */
+    class value_type
+    {
+    public:
+        value_type(const std::string& name, Value* value)
+            : m_name(name), first(m_name), second(value)
+        {}
+
+        value_type(const std::pair < std::string, Value* >& value)
+            : m_name(value.first), first(m_name), second(value.second)
+        {}
+
+        value_type(const value_type& other)
+            : m_name(other.m_name), first(m_name), second(other.second)
+        {}
+
+        value_type& operator=(const value_type& other)
+        {
+            m_name = other.m_name;
+            second = other.second;
+            return *this;
+        }
+
+    private:
+        std::string m_name;
+
+    public:
+        const std::string& first;
+        Value* second;
+    };
+
+    typedef std::vector < value_type > container_type;
+    typedef container_type::size_type size_type;
+    typedef container_type::iterator iterator;
+    typedef container_type::const_iterator const_iterator;
+    typedef container_type::reverse_iterator reverse_iterator;
+    typedef container_type::const_reverse_iterator const_reverse_iterator;
+
+    MapValue()
+    {}
+
+    inline iterator begin() { return m_value.begin(); }
+    inline const_iterator begin() const { return m_value.begin(); }
+    inline iterator end() { return m_value.end(); }
+    inline const_iterator end() const { return m_value.end(); }
+    inline reverse_iterator rbegin() { return m_value.rbegin(); }
+    inline const_reverse_iterator rbegin() const { return m_value.rbegin(); }
+    inline reverse_iterator rend() { return m_value.rend(); }
+    inline const_reverse_iterator rend() const { return m_value.rend(); }
+
+    inline bool empty() const { return m_value.empty(); }
+    inline size_type size() const { return m_value.size(); }
+    inline void clear() { m_value.clear(); }
+    inline void reserve(size_type size) { m_value.reserve(size); }
+    inline void swap(MapValue& other) { m_value.swap(other.m_value); }
+
+    /**
+     * @brief Get the first element which name is not less than @e key.
+     * @param key The name to search.
+     * @return An iterator or end().
+     */
+    inline iterator lower_bound(const std::string& key)
+    { return std::lower_bound(begin(), end(), key, KeyCompare()); }
+
+    inline const_iterator lower_bound(const std::string& key) const
+    { return std::lower_bound(begin(), end(), key, KeyCompare()); }
+
+    inline iterator upper_bound(const std::string& key)
+    { return std::upper_bound(begin(), end(), key, KeyCompare()); }
+
+    inline const_iterator upper_bound(const std::string& key) const
+    { return std::upper_bound(begin(), end(), key, KeyCompare()); }
+
+    /**
+     * @brief Find the pair with the name @e key. Small maps, the most common
+     * ones, are scanned linearly: comparing the sizes before the characters
+     * is cheaper than the lexicographic comparisons of a binary search.
+     * @param key The name to search.
+     * @return An iterator or end().
+     */
+    inline iterator find(const std::string& key)
+    {
+        if (m_value.size() <= linear_search_limit) {
+            for (iterator it = begin(); it != end(); ++it) {
+                if (it->first == key) {
+                    return it;
+                }
+            }
+            return end();
+        }
+
+        iterator it = lower_bound(key);
+        return (it == end() or key < it->first) ? end() : it;
+    }
+
+    inline const_iterator find(const std::string& key) const
+    {
+        if (m_value.size() <= linear_search_limit) {
+            for (const_iterator it = begin(); it != end(); ++it) {
+                if (it->first == key) {
+                    return it;
+                }
+            }
+            return end();
+        }
+
+        const_iterator it = lower_bound(key);
+        return (it == end() or key < it->first) ? end() : it;
+    }
+
+    inline size_type count(const std::string& key) const
+    { return find(key) == end() ? 0 : 1; }
+
+    /**
+     * @brief Insert the pair if its name does not exist. Names inserted in
+     * increasing order (like the XML parser does) are appended in constant
+     * time.
+     * @param value The pair to insert.
+     * @return A pair of an iterator to the element with the same name and
+     * true if the element was inserted.
+     */
+    std::pair < iterator, bool > insert(const value_type& value)
+    {
+        if (m_value.empty()) {
+            m_value.reserve(initial_capacity);
+        }
+
+        if (m_value.empty() or m_value.back().first < value.first) {
+            m_value.push_back(value);
+            return std::make_pair(end() - 1, true);
+        }
+
+        iterator it = lower_bound(value.first);
+        if (it != end() and not (value.first < it->first)) {
+            return std::make_pair(it, false);
+        }
+
+        return std::make_pair(m_value.insert(it, value), true);
+    }
+
+    Value*& operator[](const std::string& key)
+    { return insert(value_type(key, (Value*)0)).first->second; }
+
+    inline iterator erase(iterator it)
+    { return m_value.erase(it); }
+
+    inline iterator erase(iterator first, iterator last)
+    { return m_value.erase(first, last); }
+
+    size_type erase(const std::string& key)
+    {
+        iterator it = find(key);
+
+        if (it == end()) {
+            return 0;
+        }
+
+        m_value.erase(it);
+        return 1;
+    }
+
+private:
+    static const size_type linear_search_limit = 16;
+    static const size_type initial_capacity = 4;
+
+    struct KeyCompare
+    {
+        bool operator()(const value_type& a, const std::string& b) const
+        { return a.first < b; }
+
+        bool operator()(const std::string& a, const value_type& b) const
+        { return a < b.first; }
+    };
+
+    container_type m_value;
+};
 
 /**
  * @brief Map Value a container to a pair of std::string, Value pointer. The
@@ -193,13 +387,12 @@ public:
      */
     void set(const std::string& name, Value* value)
     {
-        iterator it = find(name);
+        std::pair < iterator, bool > r =
+            m_value.insert(value_type(name, value));
 
-        if (it != end()) {
-            delete it->second;
-            it->second = value;
-        } else {
-            m_value.insert(std::make_pair(name, value));
+        if (not r.second) {
+            delete r.first->second;
+            r.first->second = value;
         }
     }
 
@@ -212,15 +405,7 @@ public:
      */
     void set(const std::string& name, const Value* value)
     {
-        Value* clone = (value) ? value->clone() : (value::Value*)0;
-        iterator it = find(name);
-
-        if (it != end()) {
-            delete it->second;
-            it->second = clone;
-        } else {
-            m_value.insert(std::make_pair(name, clone));
-        }
+        set(name, (value) ? value->clone() : (value::Value*)0);
     }
 
     /**
@@ -231,14 +416,7 @@ public:
      */
     void set(const std::string& name, const Value& value)
     {
-        iterator it = find(name);
-
-        if (it != end()) {
-            delete it->second;
-            it->second = value.clone();
-        } else {
-            m_value.insert(std::make_pair(name, value.clone()));
-        }
+        set(name, value.clone());
     }
 
     /**
@@ -312,15 +490,15 @@ public:
     Value* give(const std::string& name);
 
     /**
-     * @brief Get an access to the std::map.
-     * @return a reference to the set::map.
+     * @brief Get an access to the MapValue.
+     * @return a reference to the MapValue.
      */
     inline MapValue& value()
     { return m_value; }
 
     /**
-     * @brief Get a constant access to the std::map.
-     * @return a reference to the const std::map.
+     * @brief Get a constant access to the MapValue.
+     * @return a reference to the const MapValue.
      */
     inline const MapValue& value() const
     { return m_value; }
@@ -338,7 +516,7 @@ public:
     { return m_value.empty(); }
 
     /**
-     * Return the number of element in the @c std::map.
+     * Return the number of element in the @c MapValue.
      *
      * @return An integer [0..MAX_SIZE_T];
      */
@@ -145,6 +145,17 @@ Map& Matrix::addMap(const size_type& column, const size_type& row)
     return *tmp;
 }
 
+Value* Matrix::give(const size_type& column, const size_type& row)
+{
+    if (not (column < m_nbcol and row < m_nbrow)) {
+        throw utils::ArgError(_("Matrix: bad access"));
+    }
+
+    Value* result = m_matrix[column][row];
+    m_matrix[column][row] = 0;
+    return result;
+}
+
 Matrix& Matrix::addMatrix(const size_type& column, const size_type& row)
 {
     value::Matrix* tmp = new value::Matrix();
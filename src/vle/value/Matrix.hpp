@@ -389,6 +389,16 @@ public:
         return m_matrix[column][row];
     }
 
+    /**
+     * @brief Get the pointer of the Value at the cell (column, row) and
+     * give its ownership to the caller. The cell is assigned to NULL.
+     * @param column The column.
+     * @param row The row.
+     * @return A pointer to the Value, NULL if the cell is empty.
+     * @throw utils::ArgError if bad access to the matrix.
+     */
+    Value* give(const size_type& column, const size_type& row);
+
     /**
      * @brief Set the last cell to the specificed value. The value is
      * cloned.
@@ -0,0 +1,196 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <vle/value/Slice.hpp>
+#include <vle/value/Kernel.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+
+namespace vle { namespace value {
+
+namespace {
+
+void checkSize(const ConstSlice& x, const ConstSlice& y)
+{
+    if (x.size() != y.size()) {
+        throw utils::ArgError(fmt(
+                _("Slice: bad size %1%, expected %2%")) % y.size() %
+            x.size());
+    }
+}
+
+void checkEmpty(const ConstSlice& x)
+{
+    if (x.empty()) {
+        throw utils::ArgError(_("Slice: empty slice"));
+    }
+}
+
+void minmax(const ConstSlice& x, double* min, double* max)
+{
+    if (x.contiguous()) {
+        kernel::minmax(x.data(), x.size(), min, max);
+    } else {
+        *min = x[0];
+        *max = x[0];
+        for (ConstSlice::size_type i = 1; i < x.size(); ++i) {
+            *min = x[i] < *min ? x[i] : *min;
+            *max = x[i] > *max ? x[i] : *max;
+        }
+    }
+}
+
+} // anonymous namespace
+
+/*
+ * ConstSlice
+ */
+
+double ConstSlice::sum() const
+{
+    return kernel::sum(m_data, m_size, m_stride);
+}
+
+double ConstSlice::dot(const ConstSlice& x) const
+{
+    checkSize(*this, x);
+
+    return kernel::dot(m_data, m_stride, x.m_data, x.m_stride, m_size);
+}
+
+double ConstSlice::min() const
+{
+    double min, max;
+
+    checkEmpty(*this);
+    minmax(*this, &min, &max);
+    return min;
+}
+
+double ConstSlice::max() const
+{
+    double min, max;
+
+    checkEmpty(*this);
+    minmax(*this, &min, &max);
+    return max;
+}
+
+/*
+ * Slice
+ */
+
+void Slice::fill(double value) const
+{
+    if (contiguous()) {
+        kernel::fill(data(), m_size, value);
+    } else {
+        for (size_type i = 0; i < m_size; ++i) {
+            (*this)[i] = value;
+        }
+    }
+}
+
+void Slice::copy(const ConstSlice& x) const
+{
+    checkSize(*this, x);
+
+    if (contiguous() and x.contiguous()) {
+        kernel::copy(x.data(), data(), m_size);
+    } else {
+        for (size_type i = 0; i < m_size; ++i) {
+            (*this)[i] = x[i];
+        }
+    }
+}
+
+void Slice::scale(double a) const
+{
+    if (contiguous()) {
+        kernel::scale(a, data(), m_size);
+    } else {
+        for (size_type i = 0; i < m_size; ++i) {
+            (*this)[i] *= a;
+        }
+    }
+}
+
+void Slice::axpy(double a, const ConstSlice& x) const
+{
+    checkSize(*this, x);
+
+    if (contiguous() and x.contiguous()) {
+        kernel::axpy(a, x.data(), data(), m_size);
+    } else {
+        for (size_type i = 0; i < m_size; ++i) {
+            (*this)[i] += a * x[i];
+        }
+    }
+}
+
+void Slice::add(const ConstSlice& x) const
+{
+    checkSize(*this, x);
+
+    if (contiguous() and x.contiguous()) {
+        kernel::add(data(), x.data(), data(), m_size);
+    } else {
+        for (size_type i = 0; i < m_size; ++i) {
+            (*this)[i] += x[i];
+        }
+    }
+}
+
+void Slice::sub(const ConstSlice& x) const
+{
+    checkSize(*this, x);
+
+    if (contiguous() and x.contiguous()) {
+        kernel::sub(data(), x.data(), data(), m_size);
+    } else {
+        for (size_type i = 0; i < m_size; ++i) {
+            (*this)[i] -= x[i];
+        }
+    }
+}
+
+void Slice::mul(const ConstSlice& x) const
+{
+    checkSize(*this, x);
+
+    if (contiguous() and x.contiguous()) {
+        kernel::mul(data(), x.data(), data(), m_size);
+    } else {
+        for (size_type i = 0; i < m_size; ++i) {
+            (*this)[i] *= x[i];
+        }
+    }
+}
+
+}} // namespace vle value
@@ -0,0 +1,231 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef VLE_VALUE_SLICE_HPP
+#define VLE_VALUE_SLICE_HPP 1
+
+#include <vle/DllDefines.hpp>
+#include <cstddef>
+
+namespace vle { namespace value {
+
+/**
+ * @brief A ConstSlice is a read-only view on doubles stored with a constant
+ * stride: a part of a value::Tuple or a row or a column of a value::Table.
+ * The reductions use the numeric kernels of value/Kernel.hpp when the
+ * stride is 1 and return the same result for a strided slice.
+ *
+ * @code
+ * value::Table& table = value::toTableValue(*val);
+ * double total = table.column(0).sum();
+ * double dot = table.row(1).dot(table.row(2));
+ * @endcode
+ */
+class VLE_API ConstSlice
+{
+public:
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    /**
+     * @brief Build an empty ConstSlice.
+     */
+    ConstSlice()
+        : m_data(0), m_size(0), m_stride(1)
+    {}
+
+    /**
+     * @brief Build a ConstSlice on the doubles data[0], data[stride], ...,
+     * data[(size - 1) * stride].
+     * @param data The first double.
+     * @param size The number of doubles.
+     * @param stride The distance between two doubles.
+     */
+    ConstSlice(const double* data, size_type size, difference_type stride = 1)
+        : m_data(data), m_size(size), m_stride(stride)
+    {}
+
+    inline const double* data() const
+    { return m_data; }
+
+    inline size_type size() const
+    { return m_size; }
+
+    inline difference_type stride() const
+    { return m_stride; }
+
+    inline bool empty() const
+    { return m_size == 0; }
+
+    /**
+     * @brief Check if the doubles are adjacent in memory.
+     * @return true if the stride is 1.
+     */
+    inline bool contiguous() const
+    { return m_stride == 1; }
+
+    /**
+     * @brief Get the double at the specified index. Be careful, the index
+     * is not tested.
+     * @param i The index of the double.
+     * @return A constant reference to the double.
+     */
+    inline const double& operator[](size_type i) const
+    { return m_data[static_cast < difference_type >(i) * m_stride]; }
+
+    /**
+     * @brief Compute the sum of the doubles.
+     * @return The sum, 0.0 if the slice is empty.
+     */
+    double sum() const;
+
+    /**
+     * @brief Compute the dot product with another slice.
+     * @param x The other slice.
+     * @return The dot product.
+     * @throw utils::ArgError if the sizes are different.
+     */
+    double dot(const ConstSlice& x) const;
+
+    /**
+     * @brief Get the minimum of the doubles.
+     * @return The minimum.
+     * @throw utils::ArgError if the slice is empty.
+     */
+    double min() const;
+
+    /**
+     * @brief Get the maximum of the doubles.
+     * @return The maximum.
+     * @throw utils::ArgError if the slice is empty.
+     */
+    double max() const;
+
+protected:
+    const double*   m_data;
+    size_type       m_size;
+    difference_type m_stride;
+};
+
+/**
+ * @brief A Slice is a ConstSlice which can modify the doubles. The
+ * operations are applied in place and the Slice does not own the doubles:
+ * a Slice on a value::Tuple is invalid after a resize of the Tuple.
+ *
+ * @code
+ * value::Tuple& position = value::toTupleValue(*val);
+ * position.slice().axpy(timestep, speed.slice());
+ * table.row(0).fill(0.0);
+ * @endcode
+ */
+class VLE_API Slice : public ConstSlice
+{
+public:
+    /**
+     * @brief Build an empty Slice.
+     */
+    Slice()
+    {}
+
+    /**
+     * @brief Build a Slice on the doubles data[0], data[stride], ...,
+     * data[(size - 1) * stride].
+     * @param data The first double.
+     * @param size The number of doubles.
+     * @param stride The distance between two doubles.
+     */
+    Slice(double* data, size_type size, difference_type stride = 1)
+        : ConstSlice(data, size, stride)
+    {}
+
+    inline double* data() const
+    { return const_cast < double* >(m_data); }
+
+    /**
+     * @brief Get the double at the specified index. Be careful, the index
+     * is not tested.
+     * @param i The index of the double.
+     * @return A reference to the double.
+     */
+    inline double& operator[](size_type i) const
+    { return data()[static_cast < difference_type >(i) * m_stride]; }
+
+    /**
+     * @brief Assign a value to all the doubles.
+     * @param value The value to assign.
+     */
+    void fill(double value) const;
+
+    /**
+     * @brief Copy the doubles of another slice. The slices must not
+     * overlap, except if they are equal.
+     * @param x The slice to copy.
+     * @throw utils::ArgError if the sizes are different.
+     */
+    void copy(const ConstSlice& x) const;
+
+    /**
+     * @brief Multiply all the doubles by a factor.
+     * @param a The factor.
+     */
+    void scale(double a) const;
+
+    /**
+     * @brief Add a * x[i] to each double.
+     * @param a The factor.
+     * @param x The slice to add.
+     * @throw utils::ArgError if the sizes are different.
+     */
+    void axpy(double a, const ConstSlice& x) const;
+
+    /**
+     * @brief Add x[i] to each double.
+     * @param x The slice to add.
+     * @throw utils::ArgError if the sizes are different.
+     */
+    void add(const ConstSlice& x) const;
+
+    /**
+     * @brief Subtract x[i] to each double.
+     * @param x The slice to subtract.
+     * @throw utils::ArgError if the sizes are different.
+     */
+    void sub(const ConstSlice& x) const;
+
+    /**
+     * @brief Multiply each double by x[i].
+     * @param x The slice to multiply.
+     * @throw utils::ArgError if the sizes are different.
+     */
+    void mul(const ConstSlice& x) const;
+};
+
+}} // namespace vle value
+
+#endif
@@ -26,6 +26,7 @@
 
 
 #include <vle/value/Table.hpp>
+#include <vle/value/Text.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
@@ -35,44 +36,53 @@ namespace vle { namespace value {
 
 void Table::writeFile(std::ostream& out) const
 {
+    TextWriter writer(out);
+
     for (index j = 0; j < m_height; ++j) {
         for (index i = 0; i < m_width; ++i) {
-            out << m_value[i][j] << " ";
+            writer.put(m_value[i][j]);
+            writer.put(' ');
         }
-        out << "\n";
+        writer.put('\n');
     }
 }
 
 void Table::writeString(std::ostream& out) const
 {
-    out << "(";
+    TextWriter writer(out);
+
+    writer.put('(');
 
     for (index j = 0; j < m_height; ++j) {
-        out << "(";
+        writer.put('(');
         for (index i = 0; i < m_width; ++i) {
-            out << m_value[i][j];
+            writer.put(m_value[i][j]);
             if (i + 1 < m_width) {
-                out << ",";
+                writer.put(',');
             }
         }
         if (j + 1 < m_height) {
-            out << "),";
+            writer.put("),");
         } else {
-            out << ")";
+            writer.put(')');
         }
     }
-    out << ")";
+    writer.put(')');
 }
 
 void Table::writeXml(std::ostream& out) const
 {
     out << "<table width=\"" << m_width << "\" height=\"" << m_height << "\" >";
+
+    TextWriter writer(out);
+
     for (index j = 0; j < m_height; ++j) {
         for (index i = 0; i < m_width; ++i) {
-            out << m_value[i][j] << " ";
+            writer.put(m_value[i][j]);
+            writer.put(' ');
         }
     }
-    out << "</table>";
+    writer.put("</table>");
 }
 
 void Table::fill(const std::string& str)
@@ -118,5 +128,49 @@ void Table::fill(const std::string& str)
     }
 }
 
+Slice Table::column(const index& x)
+{
+    if (x < 0 or x >= m_width) {
+        throw utils::ArgError(fmt(
+                _("Table: bad column %1% of a table of width %2%")) % x %
+            m_width);
+    }
+
+    return Slice(m_value.data() + x * m_height, m_height);
+}
+
+ConstSlice Table::column(const index& x) const
+{
+    if (x < 0 or x >= m_width) {
+        throw utils::ArgError(fmt(
+                _("Table: bad column %1% of a table of width %2%")) % x %
+            m_width);
+    }
+
+    return ConstSlice(m_value.data() + x * m_height, m_height);
+}
+
+Slice Table::row(const index& y)
+{
+    if (y < 0 or y >= m_height) {
+        throw utils::ArgError(fmt(
+                _("Table: bad row %1% of a table of height %2%")) % y %
+            m_height);
+    }
+
+    return Slice(m_value.data() + y, m_width, m_height);
+}
+
+ConstSlice Table::row(const index& y) const
+{
+    if (y < 0 or y >= m_height) {
+        throw utils::ArgError(fmt(
+                _("Table: bad row %1% of a table of height %2%")) % y %
+            m_height);
+    }
+
+    return ConstSlice(m_value.data() + y, m_width, m_height);
+}
+
 }} // namespace vle value
 
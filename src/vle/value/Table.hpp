@@ -29,6 +29,7 @@
 #define VLE_VALUE_TABLE_HPP 1
 
 #include <vle/value/Value.hpp>
+#include <vle/value/Slice.hpp>
 #include <vle/DllDefines.hpp>
 #include <boost/multi_array.hpp>
 
@@ -255,6 +256,74 @@ public:
      */
     void fill(const std::string& str);
 
+    /**
+     * @brief Get a view on all the reals of the TableValue, column after
+     * column.
+     *
+     * @return A Slice, invalid after a resize of the TableValue.
+     */
+    inline Slice slice()
+    { return Slice(m_value.data(), m_value.num_elements()); }
+
+    /**
+     * @brief Get a constant view on all the reals of the TableValue, column
+     * after column.
+     *
+     * @return A ConstSlice, invalid after a resize of the TableValue.
+     */
+    inline ConstSlice slice() const
+    { return ConstSlice(m_value.data(), m_value.num_elements()); }
+
+    /**
+     * @brief Get a view on the height reals of a column. The reals of a
+     * column are contiguous and use the vectorised kernels.
+     * @code
+     * value::Table& grid = value::toTableValue(*val);
+     * grid.column(x).axpy(dt, flux.column(x));
+     * @endcode
+     *
+     * @param x the index of the column.
+     *
+     * @return A Slice, invalid after a resize of the TableValue.
+     *
+     * @throw utils::ArgError if x is not a valid column.
+     */
+    Slice column(const index& x);
+
+    /**
+     * @brief Get a constant view on the height reals of a column.
+     *
+     * @param x the index of the column.
+     *
+     * @return A ConstSlice, invalid after a resize of the TableValue.
+     *
+     * @throw utils::ArgError if x is not a valid column.
+     */
+    ConstSlice column(const index& x) const;
+
+    /**
+     * @brief Get a view on the width reals of a row. The stride of the Slice
+     * is the height of the TableValue.
+     *
+     * @param y the index of the row.
+     *
+     * @return A Slice, invalid after a resize of the TableValue.
+     *
+     * @throw utils::ArgError if y is not a valid row.
+     */
+    Slice row(const index& y);
+
+    /**
+     * @brief Get a constant view on the width reals of a row.
+     *
+     * @param y the index of the row.
+     *
+     * @return A ConstSlice, invalid after a resize of the TableValue.
+     *
+     * @throw utils::ArgError if y is not a valid row.
+     */
+    ConstSlice row(const index& y) const;
+
 private:
     TableValue      m_value;
     index           m_width;
@@ -0,0 +1,719 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <vle/value/Text.hpp>
+#include <boost/cstdint.hpp>
+#include <algorithm>
+#include <cctype>
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace vle { namespace value {
+
+namespace {
+
+/* Index of the round-trip flag in the std::ios_base::iword array. */
+int roundTripIndex()
+{
+    static const int index = std::ios_base::xalloc();
+
+    return index;
+}
+
+/* Replace the decimal point of the C library locale, used by snprintf, with
+ * a dot. Return the new size of the string. */
+int fixDecimalPoint(char* str, int size, const char* point)
+{
+    char* found = std::strstr(str, point);
+
+    if (found) {
+        std::size_t length = std::strlen(point);
+
+        *found = '.';
+        if (length > 1) {
+            std::memmove(found + 1, found + length,
+                         str + size + 1 - (found + length));
+            size -= length - 1;
+        }
+    }
+
+    return size;
+}
+
+#if defined(__SIZEOF_INT128__)
+# define VLE_VALUE_TEXT_EXACT 1
+
+/*
+ * Exact conversion of the doubles into decimal digits with the 128 bits
+ * integers of GCC and clang. A double is m * 2^q, value * 10^F is computed
+ * as a fraction and rounded to the nearest integer, ties to even, as the
+ * printf of the GNU C library. The functions give up (and the caller uses
+ * snprintf) if the integers do not fit 128 bits.
+ */
+
+__extension__ typedef unsigned __int128 uint128;
+
+const boost::uint64_t powers5[] = {
+    UINT64_C(1), UINT64_C(5), UINT64_C(25), UINT64_C(125), UINT64_C(625),
+    UINT64_C(3125), UINT64_C(15625), UINT64_C(78125), UINT64_C(390625),
+    UINT64_C(1953125), UINT64_C(9765625), UINT64_C(48828125),
+    UINT64_C(244140625), UINT64_C(1220703125), UINT64_C(6103515625),
+    UINT64_C(30517578125), UINT64_C(152587890625), UINT64_C(762939453125),
+    UINT64_C(3814697265625), UINT64_C(19073486328125),
+    UINT64_C(95367431640625), UINT64_C(476837158203125),
+    UINT64_C(2384185791015625), UINT64_C(11920928955078125),
+    UINT64_C(59604644775390625), UINT64_C(298023223876953125),
+    UINT64_C(1490116119384765625), UINT64_C(7450580596923828125) };
+
+const boost::uint64_t powers10[] = {
+    UINT64_C(1), UINT64_C(10), UINT64_C(100), UINT64_C(1000),
+    UINT64_C(10000), UINT64_C(100000), UINT64_C(1000000),
+    UINT64_C(10000000), UINT64_C(100000000), UINT64_C(1000000000),
+    UINT64_C(10000000000), UINT64_C(100000000000),
+    UINT64_C(1000000000000), UINT64_C(10000000000000),
+    UINT64_C(100000000000000), UINT64_C(1000000000000000),
+    UINT64_C(10000000000000000), UINT64_C(100000000000000000),
+    UINT64_C(1000000000000000000), UINT64_C(10000000000000000000) };
+
+const int maxPower5 = 27;
+const int maxDigits = 19;
+
+int bitLength(uint128 x)
+{
+    int result = 0;
+
+    if (x >> 64) {
+        x >>= 64;
+        result = 64;
+    }
+    boost::uint64_t low = static_cast < boost::uint64_t >(x);
+
+    return low ? result + 64 - __builtin_clzll(low) : result;
+}
+
+/*
+ * Compute N, the integer nearest to m * 2^q * 10^F. If roundtrip is not
+ * null, it is set to true if N * 10^-F reads back as m * 2^q, ie. if N is in
+ * the rounding interval of the double. Return false if the integers
+ * overflow.
+ */
+bool scale(boost::uint64_t m, int q, int F, uint128* N, bool* roundtrip)
+{
+    if (F > maxPower5 or F < -maxPower5) {
+        return false;
+    }
+
+    const int s = q + F;
+    uint128 num = m;
+    boost::uint64_t divisor = 1; /* 5^-F */
+    int shift = 0; /* 2^-s */
+
+    if (F >= 0) {
+        num *= powers5[F];
+    } else {
+        divisor = powers5[-F];
+    }
+
+    if (s >= 0) {
+        if (s >= 128 - bitLength(num)) {
+            return false;
+        }
+        num <<= s;
+    } else {
+        shift = -s;
+    }
+
+    /* num / (divisor * 2^shift) is rounded into quotient, distance is the
+     * difference between the quotient and the fraction in unit of
+     * 1 / (divisor * 2^shift) when divisor or shift is 1. */
+    uint128 quotient, distance;
+    bool up, exact;
+
+    if (shift >= 120) {
+        /* num < 2^116 and the fraction is lower than 1/2. */
+        quotient = 0;
+        up = false;
+        exact = false;
+        distance = num;
+    } else if (divisor == 1) {
+        const uint128 rest = num & ((uint128(1) << shift) - 1);
+        const uint128 half = shift ? uint128(1) << (shift - 1) : 0;
+
+        quotient = num >> shift;
+        exact = rest == 0;
+        up = shift and (rest > half or (rest == half and (quotient & 1)));
+        distance = up ? (uint128(1) << shift) - rest : rest;
+    } else {
+        const uint128 high = num >> shift;
+        const uint128 low = num & ((uint128(1) << shift) - 1);
+        const boost::uint64_t rest = static_cast < boost::uint64_t >(
+            high % divisor);
+
+        quotient = high / divisor;
+        exact = rest == 0 and low == 0;
+
+        /* Compare the fraction (rest + low / 2^shift) / divisor to 1/2. */
+        const uint128 twice = uint128(rest) * 2 + (shift ? low >>
+                                                   (shift - 1) : 0);
+        const bool sticky = shift > 1 and
+            (low & ((uint128(1) << (shift - 1)) - 1));
+
+        up = twice > divisor or (twice == divisor and
+                                 (sticky or (quotient & 1)));
+        distance = up ? divisor - rest : rest;
+    }
+
+    if (up) {
+        ++quotient;
+    }
+    *N = quotient;
+
+    if (roundtrip) {
+        /* The half of the rounding interval is 5^F / 2 (F >= 0, s < 0) or
+         * 2^s / 2 (F < 0, s >= 0) in the previous units. It is 1 / 2 in
+         * unit of 1 / (divisor * 2^shift) if F < 0 and s < 0: only the
+         * exact N reads back. The interval is halved under the powers of
+         * two and includes its bounds if m is even. */
+        const bool lower = not up and not exact;
+        const bool power2 = m == (UINT64_C(1) << 52) and q > -1074;
+        const int factor = (lower and power2) ? 4 : 2;
+        uint128 bound;
+
+        if (exact) {
+            *roundtrip = true;
+            return true;
+        } else if (shift >= 120 or (F < 0 and s < 0)) {
+            *roundtrip = false;
+            return true;
+        } else if (F >= 0) {
+            bound = powers5[F];
+        } else {
+            if (s >= 126) {
+                return false;
+            }
+            bound = uint128(1) << s;
+        }
+
+        if (distance >> 120) {
+            *roundtrip = false;
+        } else {
+            distance *= factor;
+            *roundtrip = distance < bound or (distance == bound and
+                                              not (m & 1));
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Compute the precision significant digits N of value = m * 2^q and the
+ * decimal exponent X of the first digit: value ~ N * 10^(X - precision + 1).
+ */
+bool significant(boost::uint64_t m, int q, int precision,
+                 boost::uint64_t* N, int* X, bool* roundtrip)
+{
+    if (m == 0) {
+        *N = 0;
+        *X = 0;
+        if (roundtrip) {
+            *roundtrip = true;
+        }
+        return true;
+    }
+
+    /* floor(log10(2^E)) is the first digit or the previous one. */
+    const int E = q + bitLength(m) - 1;
+    int x = (E * 78913) >> 18;
+
+    for (int retry = 0; retry < 3; ++retry) {
+        uint128 result;
+
+        if (not scale(m, q, precision - 1 - x, &result, roundtrip)) {
+            return false;
+        }
+        if (result >= powers10[precision]) {
+            ++x;
+        } else if (result < powers10[precision - 1]) {
+            --x;
+        } else {
+            *N = static_cast < boost::uint64_t >(result);
+            *X = x;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+char* writeDigits(char* str, boost::uint64_t value)
+{
+    char digits[24];
+    char* it = digits + sizeof(digits);
+
+    do {
+        *--it = static_cast < char >('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    std::size_t length = digits + sizeof(digits) - it;
+    std::memcpy(str, it, length);
+    return str + length;
+}
+
+char* writeWideDigits(char* str, uint128 value)
+{
+    if (value >> 64) {
+        /* Write the 19 last digits after the others. */
+        char* it = writeWideDigits(str, value / powers10[maxDigits]);
+        char digits[24];
+        char* end = writeDigits(digits, static_cast < boost::uint64_t >(
+                value % powers10[maxDigits]));
+        const int length = end - digits;
+
+        std::memset(it, '0', maxDigits - length);
+        std::memcpy(it + maxDigits - length, digits, length);
+        return it + maxDigits;
+    }
+
+    return writeDigits(str, static_cast < boost::uint64_t >(value));
+}
+
+/*
+ * Write the decimal N * 10^-decimals (fixed) or N * 10^(X - decimals)
+ * (exponent notation) and remove the trailing zeros of the %g conversion.
+ * Return -1 if the result may not fit in the size bytes of str.
+ */
+int writeDecimal(char* str, int size, bool negative, uint128 N, int X,
+                 int decimals, bool fixed, bool strip, bool showpoint,
+                 bool showpos, bool uppercase)
+{
+    char digits[48];
+    const int length = writeWideDigits(digits, N) - digits;
+    char* it = str;
+
+    /* sign, point and exponent around the digits and the decimals */
+    if (std::max(length, decimals + 1) + 8 > size) {
+        return -1;
+    }
+
+    if (negative) {
+        *it++ = '-';
+    } else if (showpos) {
+        *it++ = '+';
+    }
+
+    const char* fraction;
+    int leading = 0; /* zeros before the digits of the fraction */
+    int available; /* digits of the fraction */
+
+    if (not fixed) {
+        *it++ = digits[0];
+        fraction = digits + 1;
+        available = length - 1;
+    } else if (N == 0) {
+        *it++ = '0';
+        fraction = digits;
+        leading = decimals;
+        available = 0;
+    } else if (length <= decimals) {
+        *it++ = '0';
+        fraction = digits;
+        leading = decimals - length;
+        available = length;
+    } else {
+        std::memcpy(it, digits, length - decimals);
+        it += length - decimals;
+        fraction = digits + length - decimals;
+        available = decimals;
+    }
+
+    int trailing = decimals - leading - available; /* zeros after */
+
+    if (strip) {
+        while (available > 0 and fraction[available - 1] == '0') {
+            --available;
+        }
+        if (available == 0) {
+            leading = 0;
+        }
+        trailing = 0;
+    }
+
+    if (leading + available + trailing > 0 or showpoint) {
+        *it++ = '.';
+        std::memset(it, '0', leading);
+        it += leading;
+        std::memcpy(it, fraction, available);
+        it += available;
+        std::memset(it, '0', trailing);
+        it += trailing;
+    }
+
+    if (not fixed) {
+        *it++ = uppercase ? 'E' : 'e';
+        *it++ = X < 0 ? '-' : '+';
+        const int absolute = X < 0 ? -X : X;
+        if (absolute < 10) {
+            *it++ = '0';
+        }
+        it = writeDigits(it, absolute);
+    }
+
+    return it - str;
+}
+
+/* Split a finite double into m * 2^q. */
+bool decompose(double value, boost::uint64_t* m, int* q, bool* negative)
+{
+    boost::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const int exponent = static_cast < int >((bits >> 52) & 0x7ff);
+
+    *negative = bits >> 63;
+    *m = bits & ((UINT64_C(1) << 52) - 1);
+
+    if (exponent == 0x7ff) {
+        return false;
+    } else if (exponent == 0) {
+        *q = -1074;
+    } else {
+        *m |= UINT64_C(1) << 52;
+        *q = exponent - 1075;
+    }
+    return true;
+}
+
+/*
+ * Write value as snprintf with a %f, %e or %g conversion into the size
+ * bytes of str. Return the length of the string or -1 if the value can not
+ * be converted with the 128 bits integers or does not fit in str.
+ */
+int formatExact(char* str, int size, double value, char conversion,
+                int precision, bool showpoint, bool showpos, bool uppercase)
+{
+    boost::uint64_t m, N;
+    int q, X = 0;
+    bool negative;
+
+    if (not decompose(value, &m, &q, &negative)) {
+        return -1;
+    }
+
+    if (conversion == 'f') {
+        uint128 fixed = 0;
+
+        if (m != 0 and not scale(m, q, precision, &fixed, 0)) {
+            return -1;
+        }
+        return writeDecimal(str, size, negative, fixed, 0, precision, true,
+                            false, showpoint, showpos, uppercase);
+    }
+
+    const int digits = conversion == 'e' ? precision + 1 :
+        (precision == 0 ? 1 : precision);
+
+    if (digits > maxDigits or not significant(m, q, digits, &N, &X, 0)) {
+        return -1;
+    }
+
+    if (conversion == 'e') {
+        return writeDecimal(str, size, negative, N, X, precision, false,
+                            false, showpoint, showpos, uppercase);
+    }
+
+    const bool fixed = X >= -4 and X < digits;
+
+    return writeDecimal(str, size, negative, N, X,
+                        fixed ? digits - 1 - X : digits - 1, fixed,
+                        not showpoint, showpoint, showpos, uppercase);
+}
+
+/*
+ * Write the shortest %.15g, %.16g or %.17g representation of value which
+ * reads back as value into the size bytes of str. Return -1 if the value
+ * can not be converted with the 128 bits integers.
+ */
+int formatRoundTrip(char* str, int size, double value, bool showpos)
+{
+    boost::uint64_t m, N;
+    int q, X;
+    bool negative, roundtrip;
+
+    if (not decompose(value, &m, &q, &negative)) {
+        return -1;
+    }
+
+    for (int digits = 15; digits <= 17; ++digits) {
+        if (not significant(m, q, digits, &N, &X, &roundtrip)) {
+            return -1;
+        }
+
+        if (roundtrip or digits == 17) {
+            const bool fixed = X >= -4 and X < digits;
+
+            return writeDecimal(str, size, negative, N, X,
+                                fixed ? digits - 1 - X : digits - 1, fixed,
+                                true, false, showpos, false);
+        }
+    }
+
+    return -1;
+}
+
+#endif
+
+} // anonymous namespace
+
+TextWriter::TextWriter(std::ostream& out)
+    : m_out(out), m_precision(out.precision()),
+    m_roundtrip(isRoundTrip(out)), m_showpos(out.flags() & std::ios::showpos),
+    m_boolalpha(out.flags() & std::ios::boolalpha),
+    m_showpoint(out.flags() & std::ios::showpoint),
+    m_uppercase(out.flags() & std::ios::uppercase), m_point(0), m_size(0)
+{
+    /* The same conversion as std::num_put for the floating point types. */
+    std::ios::fmtflags flags = out.flags();
+    std::ios::fmtflags floatfield = flags & std::ios::floatfield;
+    char* it = m_format;
+
+    *it++ = '%';
+    if (flags & std::ios::showpos) {
+        *it++ = '+';
+    }
+    if (flags & std::ios::showpoint) {
+        *it++ = '#';
+    }
+
+    if (floatfield == std::ios::fixed) {
+        m_conversion = 'f';
+    } else if (floatfield == std::ios::scientific) {
+        m_conversion = 'e';
+    } else {
+        m_conversion = 'g';
+    }
+
+    *it++ = '.';
+    *it++ = '*';
+    *it++ = m_uppercase ? static_cast < char >(std::toupper(m_conversion)) :
+        m_conversion;
+    *it = '\0';
+}
+
+TextWriter::~TextWriter()
+{
+    try {
+        flush();
+    } catch (...) {
+    }
+}
+
+void TextWriter::put(const char* str)
+{
+    std::size_t length = std::strlen(str);
+
+    if (m_size + length > bufferSize) {
+        flush();
+        if (length > bufferSize) {
+            m_out.write(str, length);
+            return;
+        }
+    }
+
+    std::memcpy(m_buffer + m_size, str, length);
+    m_size += length;
+}
+
+void TextWriter::put(const std::string& str)
+{
+    if (m_size + str.size() > bufferSize) {
+        flush();
+        if (str.size() > bufferSize) {
+            m_out.write(str.data(), str.size());
+            return;
+        }
+    }
+
+    std::memcpy(m_buffer + m_size, str.data(), str.size());
+    m_size += str.size();
+}
+
+void TextWriter::put(double value)
+{
+    putReal(value, m_precision);
+}
+
+void TextWriter::put(double value, int precision)
+{
+    putReal(value, precision);
+}
+
+void TextWriter::put(int32_t value)
+{
+    put(static_cast < long >(value));
+}
+
+void TextWriter::put(long value)
+{
+    if (value < 0) {
+        putInteger(-static_cast < unsigned long >(value), '-');
+    } else {
+        putInteger(static_cast < unsigned long >(value), m_showpos ? '+' : 0);
+    }
+}
+
+void TextWriter::put(unsigned long value)
+{
+    putInteger(value, 0);
+}
+
+void TextWriter::put(bool value)
+{
+    if (m_boolalpha) {
+        put(value ? "true" : "false");
+    } else {
+        put(static_cast < long >(value));
+    }
+}
+
+void TextWriter::flush()
+{
+    if (m_size) {
+        m_out.write(m_buffer, m_size);
+        m_size = 0;
+    }
+}
+
+void TextWriter::setRoundTrip(std::ostream& out, bool roundtrip)
+{
+    out.iword(roundTripIndex()) = roundtrip;
+}
+
+bool TextWriter::isRoundTrip(std::ostream& out)
+{
+    return out.iword(roundTripIndex());
+}
+
+void TextWriter::putReal(double value, int precision)
+{
+    if (m_size + realSize > bufferSize) {
+        flush();
+    }
+
+    char* str = m_buffer + m_size;
+    std::size_t available = bufferSize - m_size;
+    int size;
+
+#ifdef VLE_VALUE_TEXT_EXACT
+    size = m_roundtrip ? formatRoundTrip(str, realSize, value, m_showpos) :
+        formatExact(str, realSize, value, m_conversion, precision,
+                    m_showpoint, m_showpos, m_uppercase);
+
+    if (size >= 0) {
+        m_size += size;
+        return;
+    }
+#endif
+
+    if (m_roundtrip) {
+        /* The decimal representations of 15 significant digits or less are
+         * preserved by the doubles, the others need at most 17 digits. */
+        const char* format = m_showpos ? "%+.*g" : "%.*g";
+
+        for (int digits = 15; ; ++digits) {
+            size = snprintf(str, available, format, digits, value);
+            if (digits == 17 or value != value or
+                std::strtod(str, 0) == value) {
+                break;
+            }
+        }
+    } else {
+        size = snprintf(str, available, m_format, precision, value);
+
+        if (size >= 0 and static_cast < std::size_t >(size) >= available) {
+            /* A big real in fixed notation or a big precision. */
+            std::vector < char > big(size + 1);
+
+            snprintf(&big[0], big.size(), m_format, precision, value);
+            m_point = std::localeconv()->decimal_point;
+            if (*m_point and std::strcmp(m_point, ".")) {
+                size = fixDecimalPoint(&big[0], size, m_point);
+            }
+            flush();
+            m_out.write(&big[0], size);
+            return;
+        }
+    }
+
+    if (size < 0) {
+        m_out.setstate(std::ios::failbit);
+        return;
+    }
+
+    if (not m_point) {
+        m_point = std::localeconv()->decimal_point;
+        if (not m_point or not *m_point) {
+            m_point = ".";
+        }
+    }
+
+    if (std::strcmp(m_point, ".")) {
+        size = fixDecimalPoint(str, size, m_point);
+    }
+    m_size += size;
+}
+
+void TextWriter::putInteger(unsigned long value, char sign)
+{
+    char digits[24];
+    char* it = digits + sizeof(digits);
+
+    do {
+        *--it = static_cast < char >('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    if (sign) {
+        *--it = sign;
+    }
+
+    std::size_t length = digits + sizeof(digits) - it;
+
+    if (m_size + length > bufferSize) {
+        flush();
+    }
+    std::memcpy(m_buffer + m_size, it, length);
+    m_size += length;
+}
+
+}} // namespace vle value
@@ -0,0 +1,194 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef VLE_VALUE_TEXT_HPP
+#define VLE_VALUE_TEXT_HPP 1
+
+#include <vle/utils/Types.hpp>
+#include <vle/DllDefines.hpp>
+#include <ostream>
+#include <string>
+#include <cstddef>
+
+namespace vle { namespace value {
+
+/**
+ * @brief TextWriter formats the reals, integers and strings of the value
+ * writers (writeFile, writeString and writeXml) into a character buffer
+ * given to the output stream in big blocks. The format is read once from
+ * the stream (precision, fixed, scientific, showpoint, showpos, uppercase
+ * and boolalpha) and the output is the same as the std::ostream operators,
+ * except the decimal point which is always a dot. The reals are converted
+ * with exact integer arithmetic when the compiler provides 128 bits
+ * integers, with snprintf otherwise.
+ *
+ * In the round-trip mode, enabled with setRoundTrip(), the reals are
+ * written with the shortest %g representation (at most 17 digits) which
+ * reads back to the same double; the precision and the floatfield of the
+ * stream are ignored.
+ *
+ * @code
+ * void Tuple::writeFile(std::ostream& out) const
+ * {
+ *     TextWriter writer(out);
+ *     for (const_iterator it = begin(); it != end(); ++it) {
+ *         writer.put(*it);
+ *         writer.put(' ');
+ *     }
+ * }
+ * @endcode
+ */
+class VLE_API TextWriter
+{
+public:
+    /**
+     * @brief Build a TextWriter and read the format of the stream.
+     * @param out The output stream.
+     */
+    TextWriter(std::ostream& out);
+
+    /**
+     * @brief Give the pending characters to the stream.
+     */
+    ~TextWriter();
+
+    /**
+     * @brief Write a character.
+     * @param c The character to write.
+     */
+    void put(char c)
+    {
+        if (m_size == bufferSize) {
+            flush();
+        }
+        m_buffer[m_size++] = c;
+    }
+
+    /**
+     * @brief Write a null-terminated string.
+     * @param str The string to write.
+     */
+    void put(const char* str);
+
+    /**
+     * @brief Write a string.
+     * @param str The string to write.
+     */
+    void put(const std::string& str);
+
+    /**
+     * @brief Write a real with the precision of the stream.
+     * @param value The real to write.
+     */
+    void put(double value);
+
+    /**
+     * @brief Write a real with the specified precision.
+     * @param value The real to write.
+     * @param precision The precision to use instead of the stream one.
+     */
+    void put(double value, int precision);
+
+    /**
+     * @brief Write an integer in decimal notation.
+     * @param value The integer to write.
+     */
+    void put(int32_t value);
+
+    /**
+     * @brief Write an integer in decimal notation.
+     * @param value The integer to write.
+     */
+    void put(long value);
+
+    /**
+     * @brief Write an unsigned integer in decimal notation.
+     * @param value The integer to write.
+     */
+    void put(unsigned long value);
+
+    /**
+     * @brief Write a boolean as 1 or 0, or true or false if the boolalpha
+     * flag of the stream is set.
+     * @param value The boolean to write.
+     */
+    void put(bool value);
+
+    /**
+     * @brief Give the pending characters to the stream.
+     */
+    void flush();
+
+    /**
+     * @brief Enable or disable the round-trip mode of the reals written
+     * into a stream, disabled by default.
+     * @code
+     * std::ofstream file("exact.vpz");
+     * value::TextWriter::setRoundTrip(file, true);
+     * vpz.write(file);
+     * @endcode
+     * @param out The output stream.
+     * @param roundtrip true to write the reals exactly.
+     */
+    static void setRoundTrip(std::ostream& out, bool roundtrip);
+
+    /**
+     * @brief Check if the round-trip mode is enabled for a stream.
+     * @param out The output stream.
+     * @return true if the reals are written exactly.
+     */
+    static bool isRoundTrip(std::ostream& out);
+
+private:
+    TextWriter(const TextWriter&);
+    TextWriter& operator=(const TextWriter&);
+
+    void putReal(double value, int precision);
+
+    void putInteger(unsigned long value, char sign);
+
+    enum { bufferSize = 4096, realSize = 64, formatSize = 8 };
+
+    std::ostream&   m_out;
+    int             m_precision;
+    bool            m_roundtrip;
+    bool            m_showpos;
+    bool            m_boolalpha;
+    bool            m_showpoint;
+    bool            m_uppercase;
+    char            m_conversion;
+    const char*     m_point;
+    char            m_format[formatSize];
+    std::size_t     m_size;
+    char            m_buffer[bufferSize];
+};
+
+}} // namespace vle value
+
+#endif
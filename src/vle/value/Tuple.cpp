@@ -26,6 +26,7 @@
 
 
 #include <vle/value/Tuple.hpp>
+#include <vle/value/Text.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
@@ -35,36 +36,42 @@ namespace vle { namespace value {
 
 void Tuple::writeFile(std::ostream& out) const
 {
+    TextWriter writer(out);
+
     for (const_iterator it = m_value.begin(); it != m_value.end(); ++it) {
         if (it != m_value.begin()) {
-            out << " ";
+            writer.put(' ');
         }
-        out << *it;
+        writer.put(*it);
     }
 }
 
 void Tuple::writeString(std::ostream& out) const
 {
-    out << "(";
+    TextWriter writer(out);
+
+    writer.put('(');
     for (const_iterator it = m_value.begin(); it != m_value.end(); ++it) {
         if (it != m_value.begin()) {
-            out << ",";
+            writer.put(',');
         }
-        out << *it;
+        writer.put(*it);
     }
-    out << ")";
+    writer.put(')');
 }
 
 void Tuple::writeXml(std::ostream& out) const
 {
-    out << "<tuple>";
+    TextWriter writer(out);
+
+    writer.put("<tuple>");
     for (const_iterator it = m_value.begin(); it != m_value.end(); ++it) {
         if (it != m_value.begin()) {
-            out << " ";
+            writer.put(' ');
         }
-        out << *it;
+        writer.put(*it);
     }
-    out << "</tuple>";
+    writer.put("</tuple>");
 }
 
 void Tuple::fill(const std::string& str)
@@ -95,5 +102,28 @@ void Tuple::fill(const std::string& str)
     }
 }
 
+Slice Tuple::slice(const size_type& begin, const size_type& end)
+{
+    if (begin > end or end > m_value.size()) {
+        throw utils::ArgError(fmt(
+                _("Tuple: bad slice [%1%, %2%[ of a tuple of size %3%")) %
+            begin % end % m_value.size());
+    }
+
+    return Slice(m_value.empty() ? 0 : &m_value[0] + begin, end - begin);
+}
+
+ConstSlice Tuple::slice(const size_type& begin, const size_type& end) const
+{
+    if (begin > end or end > m_value.size()) {
+        throw utils::ArgError(fmt(
+                _("Tuple: bad slice [%1%, %2%[ of a tuple of size %3%")) %
+            begin % end % m_value.size());
+    }
+
+    return ConstSlice(m_value.empty() ? 0 : &m_value[0] + begin,
+                      end - begin);
+}
+
 }} // namespace vle value
 
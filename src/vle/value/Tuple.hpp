@@ -29,6 +29,7 @@
 #define VLE_VALUE_TUPLE_HPP 1
 
 #include <vle/value/Value.hpp>
+#include <vle/value/Slice.hpp>
 #include <vle/DllDefines.hpp>
 #include <vector>
 
@@ -225,6 +226,44 @@ public:
      */
     void fill(const std::string& str);
 
+    /**
+     * @brief Get a view on all the reals of the TupleValue to use the bulk
+     * operations (sum, axpy, fill etc.).
+     * @code
+     * value::Tuple& speed = value::toTupleValue(*val);
+     * speed.slice().scale(0.5);
+     * @endcode
+     * @return A Slice, invalid after a resize of the TupleValue.
+     */
+    inline Slice slice()
+    { return Slice(m_value.empty() ? 0 : &m_value[0], m_value.size()); }
+
+    /**
+     * @brief Get a constant view on all the reals of the TupleValue.
+     * @return A ConstSlice, invalid after a resize of the TupleValue.
+     */
+    inline ConstSlice slice() const
+    { return ConstSlice(m_value.empty() ? 0 : &m_value[0], m_value.size()); }
+
+    /**
+     * @brief Get a view on the reals [begin, end[ of the TupleValue.
+     * @param begin The index of the first real.
+     * @param end The index after the last real.
+     * @return A Slice, invalid after a resize of the TupleValue.
+     * @throw utils::ArgError if begin > end or end > size().
+     */
+    Slice slice(const size_type& begin, const size_type& end);
+
+    /**
+     * @brief Get a constant view on the reals [begin, end[ of the
+     * TupleValue.
+     * @param begin The index of the first real.
+     * @param end The index after the last real.
+     * @return A ConstSlice, invalid after a resize of the TupleValue.
+     * @throw utils::ArgError if begin > end or end > size().
+     */
+    ConstSlice slice(const size_type& begin, const size_type& end) const;
+
 private:
     TupleValue              m_value;
 };
@@ -37,15 +37,215 @@
 #include <vle/value/XML.hpp>
 #include <vle/value/Null.hpp>
 #include <vle/value/Matrix.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
 #include <sstream>
+#include <new>
 
 namespace vle { namespace value {
 
 #ifndef NDEBUG
-unsigned long int Value::allocated = 0;
-unsigned long int Value::deallocated = 0;
+boost::detail::atomic_count Value::allocated(0);
+boost::detail::atomic_count Value::deallocated(0);
 #endif
 
+namespace {
+
+/*
+ * The Value allocator: blocks of 16, 32, 48 and 64 bytes are stored into
+ * free lists. Each thread owns a cache of free lists, the process owns a
+ * depot which receives the free blocks of the exited threads and the
+ * surplus of the caches. Memory chunks are never given back to the system,
+ * so a block allocated by a thread can be released by another one.
+ */
+
+const std::size_t pool_granularity = 16;
+const std::size_t pool_classes = 4;
+const std::size_t pool_chunk_blocks = 256;
+const std::size_t pool_cache_limit = 4 * pool_chunk_blocks;
+
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+struct FreeList
+{
+    FreeList()
+        : head(0), size(0)
+    {}
+
+    void push(void* ptr)
+    {
+        FreeBlock* block = static_cast < FreeBlock* >(ptr);
+        block->next = head;
+        head = block;
+        size++;
+    }
+
+    void* pop()
+    {
+        FreeBlock* block = head;
+        head = block->next;
+        size--;
+        return block;
+    }
+
+    /**
+     * Move at most @e number blocks from this list to the @e dst list.
+     */
+    void move(FreeList& dst, std::size_t number)
+    {
+        while (head and number--) {
+            dst.push(pop());
+        }
+    }
+
+    FreeBlock* head;
+    std::size_t size;
+};
+
+struct Depot
+{
+    boost::mutex mutex;
+    FreeList lists[pool_classes];
+};
+
+struct ThreadCache
+{
+    FreeList lists[pool_classes];
+};
+
+/*
+ * The depot and the thread specific pointer are allocated once and never
+ * destroyed: values can be released by static destructors.
+ */
+
+#if defined(__GNUC__)
+/*
+ * The boost::thread_specific_ptr lookup costs more than a malloc call, GCC
+ * compilers use a native thread local pointer to find the cache.
+ */
+__thread ThreadCache* local_cache = 0;
+#endif
+
+Depot& depot()
+{
+    static Depot* depot = new Depot();
+
+    return *depot;
+}
+
+void releaseThreadCache(ThreadCache* cache)
+{
+#if defined(__GNUC__)
+    local_cache = 0;
+#endif
+
+    {
+        Depot& dpt = depot();
+        boost::lock_guard < boost::mutex > lock(dpt.mutex);
+
+        for (std::size_t i = 0; i < pool_classes; ++i) {
+            cache->lists[i].move(dpt.lists[i], cache->lists[i].size);
+        }
+    }
+
+    delete cache;
+}
+
+ThreadCache& threadCache()
+{
+#if defined(__GNUC__)
+    if (local_cache) {
+        return *local_cache;
+    }
+#endif
+
+    static boost::thread_specific_ptr < ThreadCache >* caches =
+        new boost::thread_specific_ptr < ThreadCache >(releaseThreadCache);
+
+    ThreadCache* cache = caches->get();
+    if (not cache) {
+        cache = new ThreadCache();
+        caches->reset(cache);
+    }
+
+#if defined(__GNUC__)
+    local_cache = cache;
+#endif
+
+    return *cache;
+}
+
+void refill(FreeList& list, std::size_t sizeclass)
+{
+    {
+        Depot& dpt = depot();
+        boost::lock_guard < boost::mutex > lock(dpt.mutex);
+
+        dpt.lists[sizeclass].move(list, pool_chunk_blocks);
+    }
+
+    if (not list.head) {
+        const std::size_t blocksize = (sizeclass + 1) * pool_granularity;
+        char* chunk = static_cast < char* >(
+            ::operator new(blocksize * pool_chunk_blocks));
+
+        for (std::size_t i = pool_chunk_blocks; i > 0; --i) {
+            list.push(chunk + (i - 1) * blocksize);
+        }
+    }
+}
+
+void spill(FreeList& list, std::size_t sizeclass)
+{
+    Depot& dpt = depot();
+    boost::lock_guard < boost::mutex > lock(dpt.mutex);
+
+    list.move(dpt.lists[sizeclass], list.size - pool_chunk_blocks);
+}
+
+} // anonymous namespace
+
+void* Value::operator new(std::size_t size)
+{
+    if (size == 0 or size > pool_classes * pool_granularity) {
+        return ::operator new(size);
+    }
+
+    const std::size_t sizeclass = (size - 1) / pool_granularity;
+    FreeList& list = threadCache().lists[sizeclass];
+
+    if (not list.head) {
+        refill(list, sizeclass);
+    }
+
+    return list.pop();
+}
+
+void Value::operator delete(void* ptr, std::size_t size)
+{
+    if (not ptr) {
+        return;
+    }
+
+    if (size == 0 or size > pool_classes * pool_granularity) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    const std::size_t sizeclass = (size - 1) / pool_granularity;
+    FreeList& list = threadCache().lists[sizeclass];
+
+    list.push(ptr);
+
+    if (list.size > pool_cache_limit) {
+        spill(list, sizeclass);
+    }
+}
+
 std::string Value::writeToFile() const
 {
     std::ostringstream out;
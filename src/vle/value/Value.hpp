@@ -32,6 +32,8 @@
 #include <vle/utils/Types.hpp>
 #include <vle/utils/Exception.hpp>
 #include <vle/DllDefines.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <cstddef>
 
 namespace vle { namespace value {
 
@@ -55,8 +57,8 @@ namespace vle { namespace value {
     {
     public:
 #ifndef NDEBUG
-        static unsigned long int allocated;
-        static unsigned long int deallocated;
+        static boost::detail::atomic_count allocated;
+        static boost::detail::atomic_count deallocated;
 #endif
 
         enum type { BOOLEAN, INTEGER, DOUBLE, STRING, SET, MAP, TUPLE, TABLE,
@@ -72,7 +74,7 @@ namespace vle { namespace value {
 	Value()
         {
 #ifndef NDEBUG
-            Value::allocated++;
+            ++Value::allocated;
 #endif
         }
 
@@ -83,7 +85,7 @@ namespace vle { namespace value {
         Value(const Value& /* value */)
         {
 #ifndef NDEBUG
-            Value::allocated++;
+            ++Value::allocated;
 #endif
         }
 
@@ -93,10 +95,29 @@ namespace vle { namespace value {
 	virtual ~Value()
         {
 #ifndef NDEBUG
-            Value::deallocated++;
+            ++Value::deallocated;
 #endif
         }
 
+        /**
+         * @brief Allocate the memory of a Value. Small values (Boolean,
+         * Integer, Double, Null, Set, Map etc.) are taken from per-thread
+         * free lists ordered by size class, bigger values are allocated with
+         * the global operator new. A block can be released by any thread.
+         * @param size The size of the object to allocate.
+         * @return A pointer to an uninitialized memory block.
+         * @throw std::bad_alloc if memory is exhausted.
+         */
+        static void* operator new(std::size_t size);
+
+        /**
+         * @brief Give back the memory of a Value to the free list of the
+         * current thread.
+         * @param ptr The memory block to release.
+         * @param size The size of the destroyed object.
+         */
+        static void operator delete(void* ptr, std::size_t size);
+
         ///
         //// Abstract functions
         ///
@@ -34,20 +34,33 @@
 #include <boost/test/floating_point_comparison.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/utility.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/format.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/type_traits/is_const.hpp>
 #include <stdexcept>
 #include <limits>
+#include <clocale>
+#include <cstring>
+#include <iomanip>
+#include <cmath>
 #include <fstream>
+#include <sstream>
 #include <functional>
+#include <vector>
 #include <vle/value/Value.hpp>
+#include <vle/value/Binary.hpp>
 #include <vle/value/Boolean.hpp>
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
+#include <vle/value/Kernel.hpp>
 #include <vle/value/Map.hpp>
 #include <vle/value/Matrix.hpp>
 #include <vle/value/Null.hpp>
 #include <vle/value/Set.hpp>
 #include <vle/value/String.hpp>
 #include <vle/value/Table.hpp>
+#include <vle/value/Text.hpp>
 #include <vle/value/Tuple.hpp>
 #include <vle/value/Value.hpp>
 #include <vle/value/XML.hpp>
@@ -249,6 +262,518 @@ BOOST_AUTO_TEST_CASE(check_matrix)
     BOOST_REQUIRE_EQUAL(value::toInteger(*mx->value()[0][0]), 10);
     BOOST_REQUIRE_EQUAL(value::toInteger(*cpy->value()[0][0]), 20);
 
+    value::Value* given = cpy->give(0, 0);
+    BOOST_REQUIRE_EQUAL(value::toInteger(given), 20);
+    BOOST_REQUIRE(not cpy->get(0, 0));
+    BOOST_REQUIRE_THROW(cpy->give(101, 0), utils::ArgError);
+    delete given;
+
     delete(mx);
     delete(cpy);
 }
+
+struct ReleaseValues
+{
+    std::vector < value::Value* >* values;
+
+    ReleaseValues(std::vector < value::Value* >* values)
+        : values(values)
+    {}
+
+    void operator()()
+    {
+        for (std::size_t i = 0; i < values->size(); ++i) {
+            delete (*values)[i];
+        }
+        values->clear();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(check_pool)
+{
+    std::vector < value::Value* > values;
+
+    for (int i = 0; i < 10000; ++i) {
+        values.push_back(value::Double::create(i));
+        values.push_back(value::Integer::create(i));
+        values.push_back(value::Boolean::create(i % 2));
+        values.push_back(value::String::create("pool"));
+    }
+
+    for (int i = 0; i < 10000; ++i) {
+        BOOST_REQUIRE_EQUAL(value::toDouble(values[4 * i]), (double)i);
+        BOOST_REQUIRE_EQUAL(value::toInteger(values[4 * i + 1]), i);
+        BOOST_REQUIRE_EQUAL(value::toBoolean(values[4 * i + 2]), i % 2 == 1);
+        BOOST_REQUIRE_EQUAL(value::toString(values[4 * i + 3]), "pool");
+    }
+
+    /* Values allocated by this thread are released by another one. */
+    ReleaseValues releaser(&values);
+    boost::thread release(releaser);
+    release.join();
+    BOOST_REQUIRE(values.empty());
+
+    value::Map* map = value::Map::create();
+    for (int i = 0; i < 10000; ++i) {
+        map->addDouble(boost::lexical_cast < std::string >(i), i);
+    }
+    BOOST_REQUIRE_EQUAL(map->size(), (value::Map::size_type)10000);
+    BOOST_REQUIRE_EQUAL(map->getDouble("9999"), 9999.0);
+    delete map;
+}
+
+BOOST_AUTO_TEST_CASE(check_map_order)
+{
+    value::Map* map = value::Map::create();
+
+    map->addInt("c", 3);
+    map->addInt("a", 1);
+    map->addInt("d", 4);
+    map->addInt("b", 2);
+    map->addInt("a", 10);
+
+    BOOST_REQUIRE_EQUAL(map->size(), (value::Map::size_type)4);
+    BOOST_REQUIRE_EQUAL(map->getInt("a"), 10);
+    BOOST_REQUIRE_EQUAL(map->writeToXml(),
+                        "<map><key name=\"a\"><integer>10</integer></key>"
+                        "<key name=\"b\"><integer>2</integer></key>"
+                        "<key name=\"c\"><integer>3</integer></key>"
+                        "<key name=\"d\"><integer>4</integer></key></map>");
+
+    value::MapValue& values = map->value();
+    BOOST_REQUIRE(values.find("e") == values.end());
+    BOOST_REQUIRE_EQUAL(values.count("c"), (value::MapValue::size_type)1);
+
+    values["e"] = value::Integer::create(5);
+    BOOST_REQUIRE_EQUAL(values.rbegin()->first, "e");
+
+    value::Value* removed = map->give("c");
+    BOOST_REQUIRE_EQUAL(value::toInteger(removed), 3);
+    delete removed;
+    BOOST_REQUIRE(not map->exist("c"));
+    BOOST_REQUIRE_THROW(map->get("c"), utils::ArgError);
+
+    value::Map* cpy = dynamic_cast < value::Map* >(map->clone());
+    BOOST_REQUIRE_EQUAL(cpy->writeToString(), map->writeToString());
+    BOOST_REQUIRE_EQUAL(cpy->writeToString(),
+                        "(a, 10) (b, 2) (d, 4) (e, 5)");
+
+    delete cpy;
+    delete map;
+}
+
+template < typename T > bool isConst(T&)
+{
+    return boost::is_const < T >::value;
+}
+
+BOOST_AUTO_TEST_CASE(check_map_const_key)
+{
+    value::Map map;
+
+    for (int i = 99; i >= 0; --i) {
+        map.addInt((boost::format("key%1$03d") % i).str(), i);
+    }
+
+    BOOST_REQUIRE(isConst(map.begin()->first));
+    BOOST_REQUIRE(isConst(map.value().rbegin()->first));
+
+    int i = 0;
+    for (value::Map::const_iterator it = map.begin(); it != map.end();
+         ++it, ++i) {
+        BOOST_REQUIRE_EQUAL(it->first, (boost::format("key%1$03d") %
+                                        i).str());
+        BOOST_REQUIRE_EQUAL(value::toInteger(it->second), i);
+    }
+    BOOST_REQUIRE_EQUAL(i, 100);
+
+    value::Map cpy(map);
+    delete map.give("key050");
+    BOOST_REQUIRE_EQUAL(map.value().find("key051")->first, "key051");
+    BOOST_REQUIRE_EQUAL(cpy.value().find("key050")->first, "key050");
+    BOOST_REQUIRE_EQUAL(cpy.value().rbegin()->first, "key099");
+}
+
+BOOST_AUTO_TEST_CASE(check_binary)
+{
+    value::Map* map = value::Map::create();
+    map->addBoolean("boolean", true);
+    map->addInt("integer", -17);
+    map->addDouble("double", 0.1);
+    map->addString("string", std::string("a string\0with a null", 20));
+    map->addXml("xml", "<xml></xml>");
+    map->addNull("null");
+    map->addTuple("tuple", 5, 1.5);
+    map->addTable("table", 3, 2);
+    map->getTable("table").get(2, 1) = 42.0;
+
+    value::Set& set = map->addSet("set");
+    for (int i = 0; i < 3; ++i) {
+        value::Map* mp = value::Map::create();
+        mp->addInt("x", i);
+        mp->addInt("y", -i);
+        set.add(mp);
+    }
+
+    value::Matrix& mx = map->addMatrix("matrix");
+    mx.addColumn();
+    mx.addRow();
+    mx.add(0, 0, value::Double::create(3.0));
+
+    std::string buffer = value::BinaryWriter::encode(*map);
+    value::Value* result = value::BinaryReader::decode(buffer);
+
+    BOOST_REQUIRE(result);
+    BOOST_REQUIRE_EQUAL(result->writeToXml(), map->writeToXml());
+    BOOST_REQUIRE_EQUAL(value::toMapValue(result)->getTable("table").get(2, 1),
+                        42.0);
+    BOOST_REQUIRE_EQUAL(value::toMapValue(result)->getString("string"),
+                        std::string("a string\0with a null", 20));
+    BOOST_REQUIRE(buffer.size() < map->writeToXml().size());
+
+    BOOST_REQUIRE_THROW(value::BinaryReader::decode(
+            buffer.substr(0, buffer.size() - 1)), utils::FileError);
+    BOOST_REQUIRE_THROW(value::BinaryReader::decode(
+            "VLEX" + buffer.substr(4)), utils::FileError);
+
+    delete result;
+    delete map;
+}
+
+BOOST_AUTO_TEST_CASE(check_binary_stream)
+{
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+
+    {
+        value::BinaryWriter writer(stream);
+        writer.write(value::Integer(1));
+        writer.write((const value::Value*)0);
+        writer.write(value::Tuple(1000, 2.0));
+        for (int i = 0; i < 1000; ++i) {
+            value::Map mp;
+            mp.addDouble("time", i);
+            mp.addDouble("value", i * 0.5);
+            writer.write(mp);
+        }
+        writer.write(value::Table(10, 20));
+    }
+
+    std::string buffer(stream.str());
+
+    {
+        value::BinaryReader reader(stream);
+        value::Value* val = reader.read();
+        BOOST_REQUIRE_EQUAL(value::toInteger(val), 1);
+        delete val;
+
+        BOOST_REQUIRE(not reader.read());
+
+        std::size_t width, height;
+        const double* data = reader.readDoubles(&width, &height);
+        BOOST_REQUIRE_EQUAL(width, (std::size_t)1000);
+        BOOST_REQUIRE_EQUAL(height, (std::size_t)1);
+        BOOST_REQUIRE_EQUAL(data[999], 2.0);
+
+        for (int i = 0; i < 1000; ++i) {
+            BOOST_REQUIRE_EQUAL(reader.peek(), value::Value::MAP);
+            value::Value* mp = reader.read();
+            BOOST_REQUIRE_EQUAL(value::toMapValue(mp)->getDouble("value"),
+                                i * 0.5);
+            delete mp;
+        }
+
+        val = reader.read();
+        BOOST_REQUIRE_EQUAL(value::toTableValue(val)->width(), 10);
+        BOOST_REQUIRE_EQUAL(value::toTableValue(val)->height(), 20);
+        delete val;
+        BOOST_REQUIRE(reader.eof());
+    }
+
+    {
+        /* std::string buffers are aligned: the doubles are read in place. */
+        value::BinaryReader reader(buffer.data(), buffer.size());
+        delete reader.read();
+        delete reader.read();
+
+        std::size_t width, height;
+        const double* data = reader.readDoubles(&width, &height);
+        const char* address = reinterpret_cast < const char* >(data);
+        BOOST_REQUIRE(address > buffer.data() and
+                      address < buffer.data() + buffer.size());
+        BOOST_REQUIRE_EQUAL(data[0], 2.0);
+        BOOST_REQUIRE_THROW(reader.readDoubles(&width, &height),
+                            utils::FileError);
+    }
+
+    {
+        /* A corrupted size is a truncated stream, not a huge allocation. */
+        std::string header(buffer.substr(0, 12));
+        std::istringstream string(header + static_cast < char >(
+                value::Value::STRING) + "\xff\xff\xff\xff\xff\xff\xff\x3f"
+            "short");
+        value::BinaryReader reader(string);
+        BOOST_REQUIRE_THROW(reader.read(), utils::FileError);
+
+        std::istringstream matrix(header + static_cast < char >(
+                value::Value::MATRIX) + "\x01\x01\xff\xff\xff\x7f"
+            "\xff\xff\xff\x7f\x01\x01");
+        value::BinaryReader matrixreader(matrix);
+        BOOST_REQUIRE_THROW(matrixreader.read(), utils::FileError);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(check_kernel)
+{
+    std::vector < double > x(1003), y(1003);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        x[i] = std::sin(i * 0.1) * 1000.0;
+        y[i] = 1.0 / (i + 1.0);
+    }
+    x[500] = -2000.0;
+    x[731] = 3000.0;
+
+    const value::kernel::Implementation impls[] = { value::kernel::SCALAR,
+        value::kernel::SSE2, value::kernel::AVX };
+    const value::kernel::Implementation selected(
+        value::kernel::implementation());
+
+    BOOST_REQUIRE(value::kernel::isAvailable(value::kernel::SCALAR));
+
+    value::kernel::select(value::kernel::SCALAR);
+    double sum = value::kernel::sum(&x[0], x.size());
+    double dot = value::kernel::dot(&x[0], &y[0], x.size());
+    double naive = 0.0;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        naive += x[i];
+    }
+    BOOST_REQUIRE_CLOSE(sum, naive, 1e-9);
+
+    for (std::size_t k = 0; k < 3; ++k) {
+        if (not value::kernel::isAvailable(impls[k])) {
+            BOOST_REQUIRE_THROW(value::kernel::select(impls[k]),
+                                utils::ArgError);
+            continue;
+        }
+
+        value::kernel::select(impls[k]);
+        BOOST_REQUIRE_EQUAL(value::kernel::implementation(), impls[k]);
+
+        /* Same bits whatever the implementation and the stride. */
+        BOOST_REQUIRE_EQUAL(value::kernel::sum(&x[0], x.size()), sum);
+        BOOST_REQUIRE_EQUAL(value::kernel::dot(&x[0], &y[0], x.size()), dot);
+        BOOST_REQUIRE_EQUAL(value::kernel::sum(&x[0], 0), 0.0);
+        BOOST_REQUIRE_EQUAL(value::kernel::sum(&x[0], 3),
+                            (x[0] + x[1]) + x[2]);
+
+        double min, max;
+        value::kernel::minmax(&x[1], x.size() - 1, &min, &max);
+        BOOST_REQUIRE_EQUAL(min, -2000.0);
+        BOOST_REQUIRE_EQUAL(max, 3000.0);
+
+        std::vector < double > z(x.size());
+        value::kernel::add(&x[0], &y[0], &z[0], z.size());
+        BOOST_REQUIRE_EQUAL(z[1002], x[1002] + y[1002]);
+        value::kernel::sub(&z[0], &y[0], &z[0], z.size());
+        value::kernel::mul(&z[0], &y[0], &z[0], z.size());
+        BOOST_REQUIRE_EQUAL(z[1001], (x[1001] + y[1001] - y[1001]) * y[1001]);
+        value::kernel::fill(&z[0], z.size(), 2.0);
+        value::kernel::axpy(0.5, &x[0], &z[0], z.size());
+        BOOST_REQUIRE_EQUAL(z[1002], 2.0 + 0.5 * x[1002]);
+        value::kernel::scale(3.0, &z[1], z.size() - 1);
+        BOOST_REQUIRE_EQUAL(z[0], 2.0 + 0.5 * x[0]);
+        BOOST_REQUIRE_EQUAL(z[7], (2.0 + 0.5 * x[7]) * 3.0);
+    }
+
+    value::kernel::select(selected);
+
+    std::vector < double > strided(x.size() * 3);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        strided[i * 3] = x[i];
+    }
+    BOOST_REQUIRE_EQUAL(value::kernel::sum(&strided[0], x.size(), 3), sum);
+}
+
+BOOST_AUTO_TEST_CASE(check_slice)
+{
+    value::Tuple tuple(10);
+    for (value::Tuple::size_type i = 0; i < tuple.size(); ++i) {
+        tuple[i] = i;
+    }
+
+    BOOST_REQUIRE_EQUAL(tuple.slice().sum(), 45.0);
+    BOOST_REQUIRE_EQUAL(tuple.slice(2, 5).sum(), 9.0);
+    BOOST_REQUIRE_EQUAL(tuple.slice(2, 5).min(), 2.0);
+    BOOST_REQUIRE_EQUAL(tuple.slice(2, 5).max(), 4.0);
+    BOOST_REQUIRE_EQUAL(tuple.slice(3, 3).sum(), 0.0);
+    BOOST_REQUIRE_THROW(tuple.slice(3, 3).min(), utils::ArgError);
+    BOOST_REQUIRE_THROW(tuple.slice(5, 11), utils::ArgError);
+    BOOST_REQUIRE_THROW(tuple.slice(5, 4), utils::ArgError);
+
+    tuple.slice(0, 5).axpy(2.0, tuple.slice(5, 10));
+    BOOST_REQUIRE_EQUAL(tuple[0], 10.0);
+    BOOST_REQUIRE_EQUAL(tuple[4], 4.0 + 18.0);
+    BOOST_REQUIRE_EQUAL(tuple[5], 5.0);
+    BOOST_REQUIRE_THROW(tuple.slice(0, 5).add(tuple.slice(5, 9)),
+                        utils::ArgError);
+
+    value::Table table(3, 4);
+    for (value::Table::index x = 0; x < table.width(); ++x) {
+        for (value::Table::index y = 0; y < table.height(); ++y) {
+            table.get(x, y) = x * 10 + y;
+        }
+    }
+
+    BOOST_REQUIRE_EQUAL(table.column(1).size(), 4);
+    BOOST_REQUIRE(table.column(1).contiguous());
+    BOOST_REQUIRE_EQUAL(table.column(1).sum(), 10.0 + 11.0 + 12.0 + 13.0);
+    BOOST_REQUIRE_EQUAL(table.row(2).size(), 3);
+    BOOST_REQUIRE(not table.row(2).contiguous());
+    BOOST_REQUIRE_EQUAL(table.row(2).sum(), 2.0 + 12.0 + 22.0);
+    BOOST_REQUIRE_EQUAL(table.row(2).max(), 22.0);
+    BOOST_REQUIRE_EQUAL(table.row(0).dot(table.row(1)),
+                        0.0 * 1.0 + 10.0 * 11.0 + 20.0 * 21.0);
+    BOOST_REQUIRE_THROW(table.column(3), utils::ArgError);
+    BOOST_REQUIRE_THROW(table.row(-1), utils::ArgError);
+
+    table.row(3).copy(table.row(0));
+    BOOST_REQUIRE_EQUAL(table.get(2, 3), 20.0);
+    table.row(3).sub(table.row(0));
+    BOOST_REQUIRE_EQUAL(table.row(3).max(), 0.0);
+    table.column(0).fill(1.0);
+    table.column(0).mul(table.column(2));
+    BOOST_REQUIRE_EQUAL(table.get(0, 1), 21.0);
+    table.slice().scale(2.0);
+    BOOST_REQUIRE_EQUAL(table.get(2, 1), 42.0);
+    BOOST_REQUIRE_EQUAL(table.slice().size(), 12);
+
+    const value::Table& ctable(table);
+    BOOST_REQUIRE_EQUAL(ctable.column(2).sum(), table.column(2).sum());
+    value::ConstSlice view(table.row(1));
+    BOOST_REQUIRE_EQUAL(view[2], 42.0);
+}
+
+BOOST_AUTO_TEST_CASE(check_text)
+{
+    const double reals[] = { 0.0, -0.0, 1.0, -2.5, 0.1, 1.0 / 3.0, 1e-20,
+        123456789.125, 1e300, -4.94e-324, 1e15, 1e16, 2.0 / 3.0 * 1e-5 };
+    const std::size_t nb = sizeof(reals) / sizeof(reals[0]);
+
+    value::Tuple tuple;
+    for (std::size_t i = 0; i < nb; ++i) {
+        tuple.add(reals[i]);
+    }
+
+    /* Same characters as the std::ostream operators. */
+    for (int mode = 0; mode < 4; ++mode) {
+        std::ostringstream expected, result;
+        if (mode == 1) {
+            expected << std::showpoint << std::fixed << std::setprecision(15);
+            result << std::showpoint << std::fixed << std::setprecision(15);
+        } else if (mode == 2) {
+            expected << std::scientific << std::uppercase << std::showpos;
+            result << std::scientific << std::uppercase << std::showpos;
+        } else if (mode == 3) {
+            expected << std::setprecision(17);
+            result << std::setprecision(17);
+        }
+
+        expected << "<tuple>";
+        for (std::size_t i = 0; i < nb; ++i) {
+            expected << (i ? " " : "") << reals[i];
+        }
+        expected << "</tuple>" << 42 << -7 << true;
+
+        tuple.writeXml(result);
+        value::Integer(42).writeFile(result);
+        value::Integer(-7).writeFile(result);
+        value::Boolean(true).writeFile(result);
+
+        BOOST_REQUIRE_EQUAL(result.str(), expected.str());
+    }
+
+    /* Pseudo-random doubles. */
+    boost::uint64_t seed = 12345;
+    for (int i = 0; i < 3000; ++i) {
+        seed = seed * UINT64_C(6364136223846793005) +
+            UINT64_C(1442695040888963407);
+        double real;
+        if (i % 2) {
+            boost::uint64_t bits = seed;
+            std::memcpy(&real, &bits, sizeof(real));
+        } else {
+            real = static_cast < double >(seed >> 20) /
+                static_cast < double >(1 << (i % 30));
+        }
+
+        std::ostringstream expected, result;
+        for (int mode = 0; mode < 2; ++mode) {
+            if (mode == 1) {
+                expected << std::showpoint << std::fixed
+                    << std::setprecision(15);
+                result << std::showpoint << std::fixed
+                    << std::setprecision(15);
+            }
+            expected << real << ' ';
+            value::TextWriter writer(result);
+            writer.put(real);
+            writer.put(' ');
+            writer.put(real, 17);
+            writer.flush();
+            expected << std::setprecision(17) << real;
+        }
+        BOOST_REQUIRE_EQUAL(result.str(), expected.str());
+    }
+
+    /* Big precisions do not fit in the slot of a real. */
+    for (int precision = 60; precision <= 5000; precision *= 3) {
+        std::ostringstream expected, result;
+        expected << std::fixed << std::setprecision(precision);
+        result << std::fixed << std::setprecision(precision);
+        expected << 0.0 << ' ' << -0.0 << ' ' << 0.5;
+        value::TextWriter writer(result);
+        writer.put(0.0);
+        writer.put(' ');
+        writer.put(-0.0);
+        writer.put(' ');
+        writer.put(0.5);
+        writer.flush();
+        BOOST_REQUIRE_EQUAL(result.str(), expected.str());
+    }
+
+    {
+        std::ostringstream expected, result;
+        expected << std::setprecision(15) << 0.1 << 1e-20;
+        value::Double(0.1).writeString(result);
+        value::Double(1e-20).writeString(result);
+        BOOST_REQUIRE_EQUAL(result.str(), expected.str());
+    }
+
+    /* The round-trip mode reads back the same doubles, whatever the locale
+     * of the C library. */
+    const char* locales[] = { "fr_FR.UTF-8", "de_DE.UTF-8", "fr_FR", 0 };
+    for (const char** it = locales; *it; ++it) {
+        if (std::setlocale(LC_ALL, *it)) {
+            break;
+        }
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    BOOST_REQUIRE(not value::TextWriter::isRoundTrip(out));
+    value::TextWriter::setRoundTrip(out, true);
+    BOOST_REQUIRE(value::TextWriter::isRoundTrip(out));
+    tuple.writeFile(out);
+
+    std::setlocale(LC_ALL, "C");
+
+    std::istringstream in(out.str());
+    in.imbue(std::locale::classic());
+    for (std::size_t i = 0; i < nb; ++i) {
+        double real;
+        in >> real;
+        BOOST_REQUIRE(not in.fail());
+        BOOST_REQUIRE_EQUAL(real, reals[i]);
+    }
+    BOOST_REQUIRE(out.str().find("0.1 ") != std::string::npos);
+    BOOST_REQUIRE(out.str().find(',') == std::string::npos);
+}
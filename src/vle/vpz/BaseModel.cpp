@@ -27,14 +27,44 @@
 
 #include <vle/vpz/CoupledModel.hpp>
 #include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/LatticeModel.hpp>
+#include <vle/vpz/ClassModel.hpp>
 #include <vle/utils/Exception.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <algorithm>
+#include <list>
 #include <stack>
 
 namespace vle { namespace vpz {
 
+typedef std::stack < std::pair < ModelPortList*, BaseModel* > >
+    ModelPortStack;
+
+/*
+ * If the port of the model is stored into a class instance (the instance
+ * itself for the internal ports, its parent otherwise), push the
+ * connections of the class, translated to the instance, after the
+ * connections of the port. The lists are kept by shared until the end of
+ * the traversal.
+ */
+static void pushClassConnections(ModelPortStack& stack,
+                                 std::list < ModelPortList >& shared,
+                                 BaseModel* model, const CoupledModel* scope,
+                                 const std::string& port,
+                                 ClassModel::PortType type)
+{
+    if (scope and scope->isClass()) {
+        shared.push_back(ModelPortList());
+        static_cast < const ClassModel* >(scope)->getClassConnections(
+            model, port, type, shared.back());
+
+        if (shared.back().size() > 0) {
+            stack.push(std::make_pair(&shared.back(), model));
+        }
+    }
+}
+
 BaseModel::BaseModel(const std::string& name, CoupledModel* parent) :
     m_parent(parent),
     m_x(-1),
@@ -80,9 +110,17 @@ void BaseModel::swap(BaseModel& mdl)
 void BaseModel::getAtomicModelsSource(const std::string& portname,
                                   ModelPortList& result)
 {
-    std::stack < std::pair < ModelPortList*, BaseModel* > > stack;
+    ModelPortStack stack;
+    std::list < ModelPortList > shared;
 
     stack.push(std::make_pair(&getInPort(portname), this));
+    pushClassConnections(stack, shared, this, m_parent, portname,
+                         ClassModel::INPUT);
+
+    if (m_parent and m_parent->isLattice()) {
+        static_cast < const LatticeModel* >(m_parent)->getNeighbourSources(
+            this, portname, result);
+    }
 
     while (not stack.empty()) {
         ModelPortList* top = stack.top().first;
@@ -101,9 +139,14 @@ void BaseModel::getAtomicModelsSource(const std::string& portname,
                 if (cpled == source->getParent()) {
                     stack.push(std::make_pair(
                             &cpled->getInPort(port), mdl));
+                    pushClassConnections(stack, shared, cpled,
+                                         cpled->getParent(), port,
+                                         ClassModel::INPUT);
                 } else {
                     stack.push(std::make_pair(
                             &cpled->getInternalOutPort(port), mdl));
+                    pushClassConnections(stack, shared, cpled, cpled, port,
+                                         ClassModel::INTERNAL_OUTPUT);
                 }
             }
         }
@@ -113,9 +156,17 @@ void BaseModel::getAtomicModelsSource(const std::string& portname,
 void BaseModel::getAtomicModelsTarget(const std::string& portname,
                                   ModelPortList& result)
 {
-    std::stack < std::pair < ModelPortList*, BaseModel* > > stack;
+    ModelPortStack stack;
+    std::list < ModelPortList > shared;
 
     stack.push(std::make_pair(&getOutPort(portname), this));
+    pushClassConnections(stack, shared, this, m_parent, portname,
+                         ClassModel::OUTPUT);
+
+    if (m_parent and m_parent->isLattice()) {
+        static_cast < const LatticeModel* >(m_parent)->getNeighbourTargets(
+            this, portname, result);
+    }
 
     while (not stack.empty()) {
         ModelPortList* top = stack.top().first;
@@ -134,9 +185,14 @@ void BaseModel::getAtomicModelsTarget(const std::string& portname,
                 if (cpled == source->getParent()) {
                     stack.push(std::make_pair(
                             &cpled->getOutPort(port), mdl));
+                    pushClassConnections(stack, shared, cpled,
+                                         cpled->getParent(), port,
+                                         ClassModel::OUTPUT);
                 } else {
                     stack.push(std::make_pair(
                             &cpled->getInternalInPort(port), mdl));
+                    pushClassConnections(stack, shared, cpled, cpled, port,
+                                         ClassModel::INTERNAL_INPUT);
                 }
             }
         }
@@ -152,7 +208,8 @@ void BaseModel::rename(BaseModel* mdl, const std::string& newname)
 
     CoupledModel* parent = mdl->getParent();
     if (parent) {
-        ModelList::iterator it = parent->getModelList().find(mdl->getName());
+        ModelList::iterator it = parent->getModelList().find(
+            mdl->getNameSymbol());
 
         if (it == parent->getModelList().end()) {
             throw utils::DevsGraphError(
@@ -165,12 +222,12 @@ void BaseModel::rename(BaseModel* mdl, const std::string& newname)
 		      _("Coupled model %1% already has submodel %2%"))
 		  % parent->getName() % newname);
 	} else {
-	    mdl->m_name.assign(newname);
+	    mdl->m_name = newname;
 	    parent->getModelList().erase(it);
 	    parent->addModel(mdl);
 	}
     } else {
-        mdl->m_name.assign(newname);
+        mdl->m_name = newname;
     }
 }
 
@@ -687,7 +744,7 @@ void BaseModel::getAtomicModelList(BaseModel* model,
 
 bool BaseModel::isInList(const ModelList& lst, BaseModel* m)
 {
-    return lst.find(m->getName()) != lst.end();
+    return lst.find(m->getNameSymbol()) != lst.end();
 }
 
 BaseModel::BaseModel() :
@@ -29,6 +29,7 @@
 #define VLE_VPZ_BASEMODEL_HPP
 
 #include <vle/vpz/ModelPortList.hpp>
+#include <vle/utils/Symbol.hpp>
 #include <vle/DllDefines.hpp>
 #include <ostream>
 #include <vector>
@@ -42,11 +43,20 @@ namespace vle { namespace vpz {
     class AtomicModel;
     class CoupledModel;
 
-    typedef std::map < std::string, ModelPortList > ConnectionList;
+    /**
+     * @brief The ports of a model and their connections. The port names are
+     * interned, the map is used with std::string keys as before.
+     */
+    typedef std::map < utils::Symbol, ModelPortList > ConnectionList;
     typedef std::set < std::string > PortList;
     typedef std::vector < AtomicModel * > AtomicModelVector;
     typedef std::vector < CoupledModel* > CoupledModelVector;
-    typedef std::map < std::string, BaseModel* > ModelList;
+
+    /**
+     * @brief The children of a coupled model. The model names are interned,
+     * the map is used with std::string keys as before.
+     */
+    typedef std::map < utils::Symbol, BaseModel* > ModelList;
 
     /**
      * @brief The DEVS model base class.
@@ -90,6 +100,21 @@ namespace vle { namespace vpz {
         virtual bool isCoupled() const
         { return false; }
 
+        /**
+         * @brief Return true if this is LatticeModel. Default is false.
+         * @return true if Model is a lattice, false otherwise.
+         */
+        virtual bool isLattice() const
+        { return false; }
+
+        /**
+         * @brief Return true if this is a ClassModel sharing the
+         * connections of its class. Default is false.
+         * @return true if Model is a class instance, false otherwise.
+         */
+        virtual bool isClass() const
+        { return false; }
+
         /**
          * Find a model, atomic or coupled, with a specified name.
          * @param name model name to search.
@@ -138,6 +163,14 @@ namespace vle { namespace vpz {
          * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
         inline const std::string& getName() const
+        { return m_name.str(); }
+
+        /**
+         * @brief Get the interned name of the model, the key of the model in
+         * the ModelList of its parent.
+         * @return The name of the model.
+         */
+        inline const utils::Symbol& getNameSymbol() const
         { return m_name; }
 
         /**
@@ -558,7 +591,7 @@ namespace vle { namespace vpz {
 
         BaseModel& operator=(const BaseModel& mdl);
 
-        std::string     m_name;
+        utils::Symbol   m_name;
     };
 
 }} // namespace vle vpz
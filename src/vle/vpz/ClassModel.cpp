@@ -0,0 +1,180 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+
+#include <vle/vpz/ClassModel.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/utils/Exception.hpp>
+
+namespace vle { namespace vpz {
+
+ClassModel::ClassModel(const std::string& name, CoupledModel* parent,
+                       const CoupledModel* classmodel)
+    : CoupledModel(name, parent), m_class(classmodel)
+{
+    if (not classmodel) {
+        if (parent) {
+            parent->detachModel(this);
+        }
+
+        throw utils::DevsGraphError(fmt(
+                _("Class model `%1%': no model to instantiate")) % name);
+    }
+
+    setPosition(classmodel->x(), classmodel->y());
+    setSize(classmodel->width(), classmodel->height());
+
+    for (ConnectionList::const_iterator it =
+         classmodel->getInputPortList().begin();
+         it != classmodel->getInputPortList().end(); ++it) {
+        addInputPort(it->first);
+    }
+
+    for (ConnectionList::const_iterator it =
+         classmodel->getOutputPortList().begin();
+         it != classmodel->getOutputPortList().end(); ++it) {
+        addOutputPort(it->first);
+    }
+
+    for (ModelList::const_iterator it = classmodel->getModelList().begin();
+         it != classmodel->getModelList().end(); ++it) {
+        const BaseModel* child = it->second;
+
+        if (child->isCoupled() and not child->isLattice() and
+            not child->isClass()) {
+            new ClassModel(child->getName(), this,
+                           static_cast < const CoupledModel* >(child));
+        } else {
+            addModel(child->clone());
+        }
+    }
+}
+
+ClassModel::ClassModel(const ClassModel& mdl)
+    : CoupledModel(mdl), m_class(mdl.m_class)
+{
+}
+
+void ClassModel::writeXML(std::ostream& out) const
+{
+    if (m_class) {
+        ClassModel mdl(*this);
+        mdl.expand();
+        mdl.CoupledModel::writeXML(out);
+    } else {
+        CoupledModel::writeXML(out);
+    }
+}
+
+void ClassModel::getClassConnections(const BaseModel* model,
+                                     const std::string& port, PortType type,
+                                     ModelPortList& result) const
+{
+    if (not m_class) {
+        return;
+    }
+
+    const BaseModel* mdl = m_class;
+    if (model != this) {
+        ModelList::const_iterator it =
+            m_class->getModelList().find(model->getNameSymbol());
+
+        if (it == m_class->getModelList().end()) {
+            return;
+        }
+        mdl = it->second;
+    }
+
+    const ConnectionList* cnts;
+    switch (type) {
+    case INPUT:
+        cnts = &mdl->getInputPortList();
+        break;
+    case OUTPUT:
+        cnts = &mdl->getOutputPortList();
+        break;
+    case INTERNAL_INPUT:
+        cnts = &m_class->getInternalInputPortList();
+        break;
+    default:
+        cnts = &m_class->getInternalOutputPortList();
+        break;
+    }
+
+    ConnectionList::const_iterator it = cnts->find(port);
+    if (it == cnts->end()) {
+        return;
+    }
+
+    for (ModelPortList::const_iterator jt = it->second.begin();
+         jt != it->second.end(); ++jt) {
+        if (jt->first == m_class) {
+            result.add(const_cast < ClassModel* >(this), jt->second);
+        } else {
+            ModelList::const_iterator kt =
+                getModelList().find(jt->first->getNameSymbol());
+
+            if (kt != getModelList().end()) {
+                result.add(kt->second, jt->second);
+            }
+        }
+    }
+}
+
+void ClassModel::expand()
+{
+    if (not m_class) {
+        return;
+    }
+
+    expandPorts(this, getInternalInputPortList(), INTERNAL_INPUT);
+    expandPorts(this, getInternalOutputPortList(), INTERNAL_OUTPUT);
+
+    for (ModelList::iterator it = getModelList().begin();
+         it != getModelList().end(); ++it) {
+        expandPorts(it->second, it->second->getInputPortList(), INPUT);
+        expandPorts(it->second, it->second->getOutputPortList(), OUTPUT);
+    }
+
+    m_class = 0;
+}
+
+void ClassModel::expandPorts(const BaseModel* model, ConnectionList& ports,
+                             PortType type) const
+{
+    for (ConnectionList::iterator it = ports.begin(); it != ports.end();
+         ++it) {
+        ModelPortList lst;
+
+        getClassConnections(model, it->first, type, lst);
+        it->second.merge(lst);
+    }
+}
+
+}} // namespace vle vpz
@@ -0,0 +1,146 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef VLE_VPZ_CLASSMODEL_HPP
+#define VLE_VPZ_CLASSMODEL_HPP
+
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/DllDefines.hpp>
+#include <string>
+
+namespace vle { namespace vpz {
+
+    /**
+     * @brief An instance of a coupled model of a vpz::Class. The instance
+     * owns its ports and a copy of the children of the class but not the
+     * connections between them: they are read from the coupled model of
+     * the class, shared by all the instances, and translated to the models
+     * of the instance by their names when the targets of a port are
+     * computed (see BaseModel::getAtomicModelsTarget).
+     *
+     * The coupled children of the class are instantiated as ClassModel
+     * too, the atomic and lattice children are cloned. The model of the
+     * class must not be modified or deleted while the instance shares its
+     * connections. The structural changes of an instance start with
+     * expand() which copies the connections of the class into the
+     * instance.
+     *
+     * @code
+     * const vpz::CoupledModel* cls = ...; // the model of the vpz::Class.
+     * vpz::ClassModel* instance = new vpz::ClassModel("i1", top, cls);
+     * @endcode
+     */
+    class VLE_API ClassModel : public CoupledModel
+    {
+    public:
+        /**
+         * @brief The connection lists of the models: the input and output
+         * ports of a child, the internal input and output ports of the
+         * instance.
+         */
+        enum PortType { INPUT, OUTPUT, INTERNAL_INPUT, INTERNAL_OUTPUT };
+
+        /**
+         * @brief Build an instance of the coupled model of a class.
+         * @param name The name of the instance.
+         * @param parent The parent of the instance, can be null.
+         * @param classmodel The coupled model of the class.
+         * @throw utils::DevsGraphError if classmodel is null.
+         */
+        ClassModel(const std::string& name, CoupledModel* parent,
+                   const CoupledModel* classmodel);
+
+        ClassModel(const ClassModel& mdl);
+
+        virtual BaseModel* clone() const
+        { return new ClassModel(*this); }
+
+        virtual ~ClassModel() {}
+
+        /**
+         * @brief Return true while the instance shares the connections of
+         * its class.
+         * @return true if expand() was not called.
+         */
+        virtual bool isClass() const { return m_class != 0; }
+
+        /**
+         * @brief Write the instance as a coupled model with explicit
+         * connections.
+         * @param out output stream.
+         */
+        void writeXML(std::ostream& out) const;
+
+        /**
+         * @brief Get the coupled model of the class.
+         * @return The model of the class or null after expand().
+         */
+        const CoupledModel* classModel() const { return m_class; }
+
+        /**
+         * @brief Get the connections of the class for a port of the
+         * instance or of one of its children, translated to the models of
+         * the instance. The connections stored into the ports of the
+         * instance are not added.
+         * @param model The instance for INTERNAL_INPUT and INTERNAL_OUTPUT,
+         * a child of the instance otherwise.
+         * @param port The name of the port.
+         * @param type The connection list of the port.
+         * @param result The list to fill.
+         */
+        void getClassConnections(const BaseModel* model,
+                                 const std::string& port, PortType type,
+                                 ModelPortList& result) const;
+
+        /**
+         * @brief Copy the connections of the class into the ports of the
+         * instance and of its children and stop sharing them. The coupled
+         * children stay instances of their class.
+         */
+        void expand();
+
+    private:
+        ClassModel& operator=(const ClassModel& mdl);
+
+        /**
+         * @brief Merge the connections of the class into the ports of a
+         * model of the instance.
+         * @param model The instance or one of its children.
+         * @param ports The ports of the model to fill.
+         * @param type The connection list of the ports.
+         */
+        void expandPorts(const BaseModel* model, ConnectionList& ports,
+                         PortType type) const;
+
+        const CoupledModel* m_class;
+    };
+
+}} // namespace vle vpz
+
+#endif
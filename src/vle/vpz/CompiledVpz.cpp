@@ -0,0 +1,1112 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <vle/vpz/CompiledVpz.hpp>
+#include <vle/vpz/Vpz.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/LatticeModel.hpp>
+#include <vle/vpz/ClassModel.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/value/XML.hpp>
+#include <vle/value/Null.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <boost/cstdint.hpp>
+#include <fstream>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <vector>
+
+#ifdef _WIN32
+# include <iterator>
+#else
+# include <sys/types.h>
+# include <sys/stat.h>
+# include <sys/mman.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+namespace vle { namespace vpz {
+
+const unsigned int CompiledVpz::version = 3;
+
+namespace {
+
+const char compiledMagic[8] = { 'V', 'L', 'E', 'C', 'V', 'P', 'Z', '\0' };
+const boost::uint32_t compiledByteOrder = 0x01020304;
+
+/* Tag of a null pointer in a value::Matrix cell, the other tags are the
+ * value::Value::type. */
+const boost::uint8_t compiledNullPointer = 0xff;
+
+enum CompiledModelType { COMPILED_ATOMIC, COMPILED_COUPLED, COMPILED_LATTICE };
+
+/**
+ * @brief Build the body of the compiled file and the table of the interned
+ * strings. The body references each string by its index in the table.
+ */
+class CompiledWriter
+{
+public:
+    void putProject(const Project& project)
+    {
+        putString(project.author());
+        putString(project.date());
+        putString(project.version());
+        putInt(project.instance());
+
+        putDynamics(project.dynamics());
+        putClasses(project.classes());
+
+        const BaseModel* mdl = project.model().model();
+        putByte(mdl ? 1 : 0);
+        if (mdl) {
+            putModel(mdl);
+        }
+
+        putExperiment(project.experiment());
+    }
+
+    void flush(std::ostream& out) const
+    {
+        out.write(compiledMagic, sizeof(compiledMagic));
+        writeRaw(out, static_cast < boost::uint32_t >(CompiledVpz::version));
+        writeRaw(out, compiledByteOrder);
+        writeRaw(out, static_cast < boost::uint32_t >(m_strings.size()));
+
+        for (std::vector < const std::string* >::const_iterator it =
+             m_strings.begin(); it != m_strings.end(); ++it) {
+            writeRaw(out, static_cast < boost::uint32_t >((*it)->size()));
+            out.write((*it)->data(), (*it)->size());
+        }
+
+        out.write(m_body.data(), m_body.size());
+    }
+
+private:
+    typedef std::map < std::string, boost::uint32_t > StringIndex;
+
+    std::string m_body;
+    StringIndex m_index;
+    std::vector < const std::string* > m_strings;
+
+    template < typename T >
+        static void writeRaw(std::ostream& out, const T& x)
+    { out.write(reinterpret_cast < const char* >(&x), sizeof(T)); }
+
+    template < typename T >
+        void putRaw(const T& x)
+    { m_body.append(reinterpret_cast < const char* >(&x), sizeof(T)); }
+
+    void putByte(boost::uint8_t x) { putRaw(x); }
+    void putInt(boost::int32_t x) { putRaw(x); }
+    void putSize(std::size_t x) { putRaw(static_cast < boost::uint32_t >(x)); }
+    void putDouble(double x) { putRaw(x); }
+
+    void putDoubles(const double* x, std::size_t size)
+    {
+        putSize(size);
+        if (size) {
+            m_body.append(reinterpret_cast < const char* >(x),
+                          size * sizeof(double));
+        }
+    }
+
+    void putString(const std::string& str)
+    {
+        std::pair < StringIndex::iterator, bool > r =
+            m_index.insert(StringIndex::value_type(str, m_strings.size()));
+
+        if (r.second) {
+            m_strings.push_back(&r.first->first);
+        }
+
+        putRaw(r.first->second);
+    }
+
+    /* Reserve a counter in the body to be filled when the number of
+     * elements is known. */
+    std::string::size_type reserveSize()
+    {
+        std::string::size_type pos = m_body.size();
+        putSize(0);
+        return pos;
+    }
+
+    void patchSize(std::string::size_type pos, std::size_t size)
+    {
+        boost::uint32_t x = size;
+        std::memcpy(&m_body[pos], &x, sizeof(x));
+    }
+
+    void putValue(const value::Value* val)
+    {
+        if (not val) {
+            putByte(compiledNullPointer);
+            return;
+        }
+
+        putByte(val->getType());
+
+        switch (val->getType()) {
+        case value::Value::BOOLEAN:
+            putByte(value::toBoolean(*val) ? 1 : 0);
+            break;
+        case value::Value::INTEGER:
+            putInt(value::toInteger(*val));
+            break;
+        case value::Value::DOUBLE:
+            putDouble(value::toDouble(*val));
+            break;
+        case value::Value::STRING:
+            putString(value::toString(*val));
+            break;
+        case value::Value::XMLTYPE:
+            putString(value::toXml(*val));
+            break;
+        case value::Value::NIL:
+            break;
+        case value::Value::SET: {
+            const value::VectorValue& lst(value::toSet(*val));
+            putSize(lst.size());
+            for (value::VectorValue::const_iterator it = lst.begin();
+                 it != lst.end(); ++it) {
+                putValue(*it);
+            }
+            break;
+        }
+        case value::Value::MAP: {
+            const value::MapValue& lst(value::toMap(*val));
+            putSize(lst.size());
+            for (value::MapValue::const_iterator it = lst.begin();
+                 it != lst.end(); ++it) {
+                putString(it->first);
+                putValue(it->second);
+            }
+            break;
+        }
+        case value::Value::TUPLE: {
+            const value::TupleValue& lst(value::toTuple(*val));
+            putDoubles(lst.empty() ? 0 : &lst[0], lst.size());
+            break;
+        }
+        case value::Value::TABLE: {
+            const value::Table& table(value::toTableValue(*val));
+            putSize(table.width());
+            putSize(table.height());
+            putDoubles(table.value().data(), table.value().num_elements());
+            break;
+        }
+        case value::Value::MATRIX: {
+            const value::Matrix& matrix(value::toMatrixValue(*val));
+            putSize(matrix.columns());
+            putSize(matrix.rows());
+            putSize(matrix.matrix().shape()[0]);
+            putSize(matrix.matrix().shape()[1]);
+            putSize(matrix.resizeColumn());
+            putSize(matrix.resizeRow());
+            for (value::Matrix::size_type i = 0; i < matrix.columns(); ++i) {
+                for (value::Matrix::size_type j = 0; j < matrix.rows(); ++j) {
+                    putValue(matrix.matrix()[i][j]);
+                }
+            }
+            break;
+        }
+        }
+    }
+
+    void putPorts(const ConnectionList& ports)
+    {
+        putSize(ports.size());
+        for (ConnectionList::const_iterator it = ports.begin();
+             it != ports.end(); ++it) {
+            putString(it->first);
+        }
+    }
+
+    void putModel(const BaseModel* mdl)
+    {
+        putByte(mdl->isAtomic() ? COMPILED_ATOMIC :
+                mdl->isLattice() ? COMPILED_LATTICE : COMPILED_COUPLED);
+        putString(mdl->getName());
+
+        if (mdl->isLattice()) {
+            const LatticeModel* lattice =
+                static_cast < const LatticeModel* >(mdl);
+            putSize(lattice->rows());
+            putSize(lattice->columns());
+        }
+
+        putInt(mdl->x());
+        putInt(mdl->y());
+        putInt(mdl->width());
+        putInt(mdl->height());
+        putPorts(mdl->getInputPortList());
+        putPorts(mdl->getOutputPortList());
+
+        if (mdl->isAtomic()) {
+            const AtomicModel* atom = static_cast < const AtomicModel* >(mdl);
+
+            putSize(atom->conditions().size());
+            for (std::vector < std::string >::const_iterator it =
+                 atom->conditions().begin(); it != atom->conditions().end();
+                 ++it) {
+                putString(*it);
+            }
+            putString(atom->dynamics());
+            putString(atom->observables());
+        } else if (mdl->isClass()) {
+            /* the connections shared with the class are written into the
+             * instance. */
+            ClassModel instance(*static_cast < const ClassModel* >(mdl));
+            instance.expand();
+            putCoupledModel(&instance);
+        } else {
+            putCoupledModel(static_cast < const CoupledModel* >(mdl));
+
+            if (mdl->isLattice()) {
+                putLatticeModel(static_cast < const LatticeModel* >(mdl));
+            }
+        }
+    }
+
+    void putCoupledModel(const CoupledModel* cpl)
+    {
+        const ModelList& models(cpl->getModelList());
+
+        putSize(models.size());
+        for (ModelList::const_iterator it = models.begin();
+             it != models.end(); ++it) {
+            putModel(it->second);
+        }
+
+        std::string::size_type pos = reserveSize();
+        std::size_t nb = 0;
+        const ConnectionList& outputs(cpl->getInternalOutputPortList());
+        for (ConnectionList::const_iterator it = outputs.begin();
+             it != outputs.end(); ++it) {
+            for (ModelPortList::const_iterator jt = it->second.begin();
+                 jt != it->second.end(); ++jt, ++nb) {
+                putString(jt->first->getName());
+                putString(jt->second);
+                putString(it->first);
+            }
+        }
+        patchSize(pos, nb);
+
+        pos = reserveSize();
+        nb = 0;
+        const ConnectionList& inputs(cpl->getInternalInputPortList());
+        for (ConnectionList::const_iterator it = inputs.begin();
+             it != inputs.end(); ++it) {
+            for (ModelPortList::const_iterator jt = it->second.begin();
+                 jt != it->second.end(); ++jt, ++nb) {
+                putString(it->first);
+                putString(jt->first->getName());
+                putString(jt->second);
+            }
+        }
+        patchSize(pos, nb);
+
+        pos = reserveSize();
+        nb = 0;
+        for (ModelList::const_iterator it = models.begin();
+             it != models.end(); ++it) {
+            const ConnectionList& cnts(it->second->getOutputPortList());
+            for (ConnectionList::const_iterator jt = cnts.begin();
+                 jt != cnts.end(); ++jt) {
+                for (ModelPortList::const_iterator kt = jt->second.begin();
+                     kt != jt->second.end(); ++kt) {
+                    if (kt->first != cpl) {
+                        putString(it->second->getName());
+                        putString(jt->first);
+                        putString(kt->first->getName());
+                        putString(kt->second);
+                        ++nb;
+                    }
+                }
+            }
+        }
+        patchSize(pos, nb);
+    }
+
+    /* The connections between the cells are not expanded: the stencil and
+     * the positions of the cells are stored. */
+    void putLatticeModel(const LatticeModel* lattice)
+    {
+        putByte(lattice->wrapRows() ? 1 : 0);
+        putByte(lattice->wrapColumns() ? 1 : 0);
+
+        const LatticeModel::Stencil& stencil(lattice->stencil());
+        putSize(stencil.size());
+        for (LatticeModel::Stencil::const_iterator it = stencil.begin();
+             it != stencil.end(); ++it) {
+            putInt(it->row);
+            putInt(it->column);
+            putString(it->output);
+            putString(it->input);
+        }
+
+        std::string::size_type pos = reserveSize();
+        std::size_t nb = 0;
+        for (unsigned int i = 0; i < lattice->rows(); ++i) {
+            for (unsigned int j = 0; j < lattice->columns(); ++j) {
+                const AtomicModel* cell = lattice->cell(i, j);
+                if (cell) {
+                    putSize(lattice->index(i, j));
+                    putString(cell->getName());
+                    ++nb;
+                }
+            }
+        }
+        patchSize(pos, nb);
+
+        const LatticeModel::Fields& fields(lattice->fields());
+        putSize(fields.size());
+        for (LatticeModel::Fields::const_iterator it = fields.begin();
+             it != fields.end(); ++it) {
+            putString(it->first);
+            putDoubles(&it->second[0], it->second.size());
+        }
+    }
+
+    void putDynamics(const Dynamics& dynamics)
+    {
+        putSize(dynamics.dynamiclist().size());
+        for (Dynamics::const_iterator it = dynamics.begin();
+             it != dynamics.end(); ++it) {
+            putString(it->second.name());
+            putString(it->second.package());
+            putString(it->second.library());
+            putString(it->second.language());
+            putByte(it->second.isPermanent() ? 1 : 0);
+        }
+    }
+
+    void putClasses(const Classes& classes)
+    {
+        putSize(classes.list().size());
+        for (Classes::const_iterator it = classes.begin();
+             it != classes.end(); ++it) {
+            putString(it->second.name());
+            putByte(it->second.model() ? 1 : 0);
+            if (it->second.model()) {
+                putModel(it->second.model());
+            }
+        }
+    }
+
+    void putExperiment(const Experiment& experiment)
+    {
+        putString(experiment.name());
+        putDouble(experiment.duration());
+        putDouble(experiment.begin());
+        putString(experiment.combination());
+        putRaw(static_cast < boost::uint32_t >(experiment.seed()));
+
+        const Conditions& conditions(experiment.conditions());
+        putSize(conditions.conditionlist().size());
+        for (Conditions::const_iterator it = conditions.begin();
+             it != conditions.end(); ++it) {
+            putString(it->second.name());
+            putByte(it->second.isPermanent() ? 1 : 0);
+            putSize(it->second.conditionvalues().size());
+            for (Condition::const_iterator jt = it->second.begin();
+                 jt != it->second.end(); ++jt) {
+                putString(jt->first);
+                putValue(jt->second);
+            }
+        }
+
+        const Views& views(experiment.views());
+        const Outputs& outputs(views.outputs());
+        putSize(outputs.outputlist().size());
+        for (Outputs::const_iterator it = outputs.begin();
+             it != outputs.end(); ++it) {
+            putString(it->second.name());
+            putByte(it->second.format());
+            putString(it->second.location());
+            putString(it->second.plugin());
+            putString(it->second.package());
+            putValue(it->second.data());
+        }
+
+        const Observables& observables(views.observables());
+        putSize(observables.observablelist().size());
+        for (Observables::const_iterator it = observables.begin();
+             it != observables.end(); ++it) {
+            putString(it->second.name());
+            putByte(it->second.isPermanent() ? 1 : 0);
+            putSize(it->second.observableportlist().size());
+            for (Observable::const_iterator jt = it->second.begin();
+                 jt != it->second.end(); ++jt) {
+                putString(jt->second.name());
+                putSize(jt->second.viewnamelist().size());
+                for (ObservablePort::const_iterator kt = jt->second.begin();
+                     kt != jt->second.end(); ++kt) {
+                    putString(*kt);
+                }
+            }
+        }
+
+        putSize(views.viewlist().size());
+        for (Views::const_iterator it = views.begin(); it != views.end();
+             ++it) {
+            putString(it->second.name());
+            putByte(it->second.type());
+            putString(it->second.output());
+            putDouble(it->second.timestep());
+            putString(it->second.data());
+        }
+    }
+};
+
+/**
+ * @brief Rebuild a vpz::Project from a compiled buffer. Each access to the
+ * buffer is bounds-checked.
+ */
+class CompiledReader
+{
+public:
+    CompiledReader(const char* buffer, std::size_t size)
+        : m_pos(buffer), m_end(buffer + size)
+    {}
+
+    void getHeader()
+    {
+        need(sizeof(compiledMagic));
+        if (std::memcmp(m_pos, compiledMagic, sizeof(compiledMagic))) {
+            throw utils::FileError(_("Compiled vpz: bad magic number"));
+        }
+        m_pos += sizeof(compiledMagic);
+
+        boost::uint32_t version = getRaw < boost::uint32_t >();
+        if (version != CompiledVpz::version) {
+            throw utils::FileError(fmt(_(
+                        "Compiled vpz: unsupported version %1%")) % version);
+        }
+
+        if (getRaw < boost::uint32_t >() != compiledByteOrder) {
+            throw utils::FileError(_("Compiled vpz: bad byte order"));
+        }
+
+        boost::uint32_t size = getSize();
+        m_strings.reserve(size);
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            boost::uint32_t len = getSize();
+            need(len);
+            m_strings.push_back(std::string(m_pos, len));
+            m_pos += len;
+        }
+    }
+
+    void getProject(Project& project)
+    {
+        const std::string& author(getString());
+        if (not author.empty()) {
+            project.setAuthor(author);
+        }
+        project.setDate(getString());
+        project.setVersion(getString());
+        project.setInstance(getInt());
+
+        getDynamics(project.dynamics());
+        getClasses(project.classes());
+
+        if (getByte()) {
+            project.model().setModel(getModel(0));
+        }
+
+        getExperiment(project.experiment());
+
+        if (m_pos != m_end) {
+            throw utils::FileError(_("Compiled vpz: trailing data"));
+        }
+    }
+
+private:
+    const char* m_pos;
+    const char* m_end;
+    std::vector < std::string > m_strings;
+
+    void need(boost::uint64_t size) const
+    {
+        if (static_cast < boost::uint64_t >(m_end - m_pos) < size) {
+            throw utils::FileError(_("Compiled vpz: truncated file"));
+        }
+    }
+
+    template < typename T >
+        T getRaw()
+    {
+        T x;
+        need(sizeof(T));
+        std::memcpy(&x, m_pos, sizeof(T));
+        m_pos += sizeof(T);
+        return x;
+    }
+
+    boost::uint8_t getByte() { return getRaw < boost::uint8_t >(); }
+    boost::int32_t getInt() { return getRaw < boost::int32_t >(); }
+    boost::uint32_t getSize() { return getRaw < boost::uint32_t >(); }
+    double getDouble() { return getRaw < double >(); }
+
+    void getDoubles(double* x, std::size_t size)
+    {
+        need(size * sizeof(double));
+        if (size) {
+            std::memcpy(x, m_pos, size * sizeof(double));
+            m_pos += size * sizeof(double);
+        }
+    }
+
+    const std::string& getString()
+    {
+        boost::uint32_t id = getSize();
+        if (id >= m_strings.size()) {
+            throw utils::FileError(fmt(_(
+                        "Compiled vpz: unknown string %1%")) % id);
+        }
+        return m_strings[id];
+    }
+
+    value::Value* getValue()
+    {
+        boost::uint8_t type = getByte();
+
+        switch (type) {
+        case compiledNullPointer:
+            return 0;
+        case value::Value::BOOLEAN:
+            return new value::Boolean(getByte());
+        case value::Value::INTEGER:
+            return new value::Integer(getInt());
+        case value::Value::DOUBLE:
+            return new value::Double(getDouble());
+        case value::Value::STRING:
+            return new value::String(getString());
+        case value::Value::XMLTYPE:
+            return new value::Xml(getString());
+        case value::Value::NIL:
+            return new value::Null();
+        case value::Value::SET: {
+            value::Set* result = new value::Set();
+            try {
+                boost::uint32_t size = getSize();
+                need(size);
+                result->value().reserve(size);
+                for (boost::uint32_t i = 0; i < size; ++i) {
+                    result->add(getValue());
+                }
+            } catch (...) {
+                delete result;
+                throw;
+            }
+            return result;
+        }
+        case value::Value::MAP: {
+            value::Map* result = new value::Map();
+            try {
+                boost::uint32_t size = getSize();
+                for (boost::uint32_t i = 0; i < size; ++i) {
+                    const std::string& key(getString());
+                    result->add(key, getValue());
+                }
+            } catch (...) {
+                delete result;
+                throw;
+            }
+            return result;
+        }
+        case value::Value::TUPLE: {
+            boost::uint32_t size = getSize();
+            need(size * sizeof(double));
+            value::Tuple* result = new value::Tuple(size);
+            getDoubles(size ? &result->value()[0] : 0, size);
+            return result;
+        }
+        case value::Value::TABLE: {
+            boost::uint32_t width = getSize();
+            boost::uint32_t height = getSize();
+            boost::uint32_t size = getSize();
+            if (static_cast < boost::uint64_t >(width) * height != size) {
+                throw utils::FileError(_("Compiled vpz: bad table size"));
+            }
+            need(size * sizeof(double));
+            value::Table* result = new value::Table(width, height);
+            getDoubles(result->value().data(), size);
+            return result;
+        }
+        case value::Value::MATRIX: {
+            boost::uint32_t columns = getSize();
+            boost::uint32_t rows = getSize();
+            boost::uint32_t columnmax = getSize();
+            boost::uint32_t rowmax = getSize();
+            boost::uint32_t stepcol = getSize();
+            boost::uint32_t steprow = getSize();
+            need(static_cast < boost::uint64_t >(columns) * rows);
+            value::Matrix* result = new value::Matrix(columns, rows,
+                                                      columnmax, rowmax,
+                                                      stepcol, steprow);
+            try {
+                for (boost::uint32_t i = 0; i < columns; ++i) {
+                    for (boost::uint32_t j = 0; j < rows; ++j) {
+                        result->set(i, j, getValue());
+                    }
+                }
+            } catch (...) {
+                delete result;
+                throw;
+            }
+            return result;
+        }
+        default:
+            throw utils::FileError(fmt(_(
+                        "Compiled vpz: unknown value type %1%")) %
+                static_cast < int >(type));
+        }
+    }
+
+    void getPorts(BaseModel* mdl, bool input)
+    {
+        boost::uint32_t size = getSize();
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            if (input) {
+                mdl->addInputPort(getString());
+            } else {
+                mdl->addOutputPort(getString());
+            }
+        }
+    }
+
+    BaseModel* getModel(CoupledModel* parent)
+    {
+        boost::uint8_t type = getByte();
+        const std::string& name(getString());
+        BaseModel* mdl;
+
+        if (type == COMPILED_ATOMIC) {
+            mdl = new AtomicModel(name, parent);
+        } else if (type == COMPILED_COUPLED) {
+            mdl = new CoupledModel(name, parent);
+        } else if (type == COMPILED_LATTICE) {
+            boost::uint32_t rows = getSize();
+            boost::uint32_t columns = getSize();
+            if (rows == 0 or columns == 0 or
+                static_cast < boost::uint64_t >(rows) * columns >
+                std::numeric_limits < unsigned int >::max()) {
+                throw utils::FileError(fmt(_(
+                            "Compiled vpz: bad lattice size %1%x%2%")) %
+                    rows % columns);
+            }
+            mdl = new LatticeModel(name, parent, rows, columns);
+        } else {
+            throw utils::FileError(fmt(_(
+                        "Compiled vpz: unknown model type %1%")) %
+                static_cast < int >(type));
+        }
+
+        try {
+            mdl->setX(getInt());
+            mdl->setY(getInt());
+            mdl->setWidth(getInt());
+            mdl->setHeight(getInt());
+            getPorts(mdl, true);
+            getPorts(mdl, false);
+
+            if (type == COMPILED_ATOMIC) {
+                AtomicModel* atom = static_cast < AtomicModel* >(mdl);
+                boost::uint32_t size = getSize();
+                for (boost::uint32_t i = 0; i < size; ++i) {
+                    atom->addCondition(getString());
+                }
+                atom->setDynamics(getString());
+                atom->setObservables(getString());
+            } else {
+                getCoupledModel(static_cast < CoupledModel* >(mdl));
+
+                if (type == COMPILED_LATTICE) {
+                    getLatticeModel(static_cast < LatticeModel* >(mdl));
+                }
+            }
+        } catch (...) {
+            if (not parent) {
+                delete mdl;
+            }
+            throw;
+        }
+
+        return mdl;
+    }
+
+    void getCoupledModel(CoupledModel* cpl)
+    {
+        boost::uint32_t size = getSize();
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            getModel(cpl);
+        }
+
+        size = getSize();
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            const std::string& src(getString());
+            const std::string& portsrc(getString());
+            const std::string& portdst(getString());
+            cpl->addOutputConnection(src, portsrc, portdst);
+        }
+
+        size = getSize();
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            const std::string& portsrc(getString());
+            const std::string& dst(getString());
+            const std::string& portdst(getString());
+            cpl->addInputConnection(portsrc, dst, portdst);
+        }
+
+        size = getSize();
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            const std::string& src(getString());
+            const std::string& portsrc(getString());
+            const std::string& dst(getString());
+            const std::string& portdst(getString());
+            cpl->addInternalConnection(src, portsrc, dst, portdst);
+        }
+    }
+
+    void getLatticeModel(LatticeModel* lattice)
+    {
+        bool wraprows = getByte();
+        bool wrapcolumns = getByte();
+        lattice->setWrap(wraprows, wrapcolumns);
+
+        boost::uint32_t size = getSize();
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            boost::int32_t row = getInt();
+            boost::int32_t column = getInt();
+            const std::string& output(getString());
+            const std::string& input(getString());
+            lattice->addNeighbour(row, column, output, input);
+        }
+
+        size = getSize();
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            boost::uint32_t idx = getSize();
+            const std::string& name(getString());
+            BaseModel* cell = lattice->getModel(name);
+
+            if (idx >= lattice->size() or not cell or
+                not cell->isAtomic()) {
+                throw utils::FileError(fmt(_(
+                            "Compiled vpz: bad cell `%1%' in lattice `%2%'"))
+                    % name % lattice->getName());
+            }
+
+            lattice->setCell(idx / lattice->columns(),
+                             idx % lattice->columns(),
+                             static_cast < AtomicModel* >(cell));
+        }
+
+        size = getSize();
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            const std::string& name(getString());
+            boost::uint32_t nb = getSize();
+            if (nb != lattice->size()) {
+                throw utils::FileError(fmt(_(
+                            "Compiled vpz: bad field `%1%' in lattice `%2%'"))
+                    % name % lattice->getName());
+            }
+            getDoubles(lattice->addField(name), nb);
+        }
+    }
+
+    void getDynamics(Dynamics& dynamics)
+    {
+        boost::uint32_t size = getSize();
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            Dynamic dyn(getString());
+            dyn.setPackage(getString());
+            dyn.setLibrary(getString());
+            dyn.setLanguage(getString());
+            dyn.permanent(getByte());
+            dynamics.add(dyn);
+        }
+    }
+
+    void getClasses(Classes& classes)
+    {
+        boost::uint32_t size = getSize();
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            Class& cls = classes.add(getString());
+            if (getByte()) {
+                cls.setModel(getModel(0));
+            }
+        }
+    }
+
+    void getExperiment(Experiment& experiment)
+    {
+        const std::string& name(getString());
+        if (not name.empty()) {
+            experiment.setName(name);
+        }
+        experiment.setDuration(getDouble());
+        experiment.setBegin(getDouble());
+        const std::string& combination(getString());
+        if (not combination.empty()) {
+            experiment.setCombination(combination);
+        }
+        experiment.setSeed(getRaw < boost::uint32_t >());
+
+        boost::uint32_t size = getSize();
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            Condition& cnd = experiment.conditions().add(
+                Condition(getString()));
+            cnd.permanent(getByte());
+
+            boost::uint32_t ports = getSize();
+            for (boost::uint32_t j = 0; j < ports; ++j) {
+                const std::string& port(getString());
+                value::Value* val = getValue();
+                if (not val or val->getType() != value::Value::SET) {
+                    delete val;
+                    throw utils::FileError(fmt(_(
+                                "Compiled vpz: bad values of port '%1%'")) %
+                        port);
+                }
+
+                cnd.add(port);
+                value::VectorValue& lst(value::toSet(*val));
+                for (value::VectorValue::iterator it = lst.begin();
+                     it != lst.end(); ++it) {
+                    cnd.addValueToPort(port, *it);
+                    *it = 0;
+                }
+                delete val;
+            }
+        }
+
+        Views& views(experiment.views());
+        size = getSize();
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            const std::string& name(getString());
+            boost::uint8_t format = getByte();
+            const std::string& location(getString());
+            const std::string& plugin(getString());
+            const std::string& package(getString());
+
+            Output& output = (format == Output::LOCAL) ?
+                views.addLocalStreamOutput(name, location, plugin, package) :
+                views.addDistantStreamOutput(name, location, plugin, package);
+            output.setData(getValue());
+        }
+
+        size = getSize();
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            Observable& obs = views.addObservable(getString());
+            obs.permanent(getByte());
+
+            boost::uint32_t ports = getSize();
+            for (boost::uint32_t j = 0; j < ports; ++j) {
+                ObservablePort& port = obs.add(getString());
+                boost::uint32_t nbviews = getSize();
+                for (boost::uint32_t k = 0; k < nbviews; ++k) {
+                    port.add(getString());
+                }
+            }
+        }
+
+        size = getSize();
+        for (boost::uint32_t i = 0; i < size; ++i) {
+            const std::string& name(getString());
+            boost::uint8_t type = getByte();
+            const std::string& output(getString());
+            double timestep = getDouble();
+
+            if (type > View::FINISH) {
+                throw utils::FileError(fmt(_(
+                            "Compiled vpz: unknown view type %1%")) %
+                    static_cast < int >(type));
+            }
+
+            View& view = views.add(View(name, static_cast < View::Type >(type),
+                                        output, timestep));
+            view.setData(getString());
+        }
+    }
+};
+
+/**
+ * @brief A read-only view of a whole file. On POSIX systems the file is
+ * mapped into memory, otherwise it is read into a buffer.
+ */
+class CompiledFile
+{
+public:
+    CompiledFile(const std::string& filename)
+        : m_data(0), m_size(0)
+    {
+#ifdef _WIN32
+        std::ifstream in(filename.c_str(), std::ios::binary);
+        if (not in) {
+            throw utils::FileError(fmt(_(
+                        "Compiled vpz: cannot open file '%1%'")) % filename);
+        }
+        m_buffer.assign(std::istreambuf_iterator < char >(in),
+                        std::istreambuf_iterator < char >());
+        m_size = m_buffer.size();
+        m_data = m_buffer.empty() ? 0 : &m_buffer[0];
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd == -1) {
+            throw utils::FileError(fmt(_(
+                        "Compiled vpz: cannot open file '%1%'")) % filename);
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) == -1) {
+            ::close(fd);
+            throw utils::FileError(fmt(_(
+                        "Compiled vpz: cannot stat file '%1%'")) % filename);
+        }
+
+        m_size = st.st_size;
+        if (m_size) {
+            void* data = ::mmap(0, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                throw utils::FileError(fmt(_(
+                            "Compiled vpz: cannot map file '%1%'")) %
+                    filename);
+            }
+            m_data = static_cast < const char* >(data);
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~CompiledFile()
+    {
+#ifndef _WIN32
+        if (m_data) {
+            ::munmap(const_cast < char* >(m_data), m_size);
+        }
+#endif
+    }
+
+    const char* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    CompiledFile(const CompiledFile&);
+    CompiledFile& operator=(const CompiledFile&);
+
+    const char* m_data;
+    std::size_t m_size;
+#ifdef _WIN32
+    std::vector < char > m_buffer;
+#endif
+};
+
+} // anonymous namespace
+
+bool CompiledVpz::isCompiled(const std::string& filename)
+{
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    char buffer[sizeof(compiledMagic)];
+
+    in.read(buffer, sizeof(buffer));
+
+    return in.gcount() == sizeof(buffer) and
+        isCompiled(buffer, sizeof(buffer));
+}
+
+bool CompiledVpz::isCompiled(const char* buffer, std::size_t size)
+{
+    return size >= sizeof(compiledMagic) and
+        std::memcmp(buffer, compiledMagic, sizeof(compiledMagic)) == 0;
+}
+
+void CompiledVpz::write(const Vpz& vpz, const std::string& filename)
+{
+    std::ofstream out(filename.c_str(), std::ios::binary);
+
+    if (out.fail() or out.bad()) {
+        throw utils::FileError(fmt(_(
+                "Compiled vpz: cannot open file '%1%' for writing")) %
+            filename);
+    }
+
+    write(vpz, out);
+
+    if (out.fail() or out.bad()) {
+        throw utils::FileError(fmt(_(
+                "Compiled vpz: cannot write file '%1%'")) % filename);
+    }
+}
+
+void CompiledVpz::write(const Vpz& vpz, std::ostream& out)
+{
+    CompiledWriter writer;
+
+    writer.putProject(vpz.project());
+    writer.flush(out);
+}
+
+void CompiledVpz::read(Vpz& vpz, const std::string& filename)
+{
+    CompiledFile file(filename);
+
+    read(vpz, file.data(), file.size());
+}
+
+void CompiledVpz::read(Vpz& vpz, const char* buffer, std::size_t size)
+{
+    CompiledReader reader(buffer, size);
+
+    reader.getHeader();
+
+    try {
+        reader.getProject(vpz.project());
+    } catch (...) {
+        delete vpz.project().model().model();
+        vpz.project().model().setModel(0);
+        throw;
+    }
+}
+
+}} // namespace vle vpz
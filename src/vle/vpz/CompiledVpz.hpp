@@ -0,0 +1,127 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_VPZ_COMPILEDVPZ_HPP
+#define VLE_VPZ_COMPILEDVPZ_HPP
+
+#include <vle/DllDefines.hpp>
+#include <string>
+#include <ostream>
+#include <cstddef>
+
+namespace vle { namespace vpz {
+
+    class Vpz;
+
+    /**
+     * @brief The vpz::CompiledVpz class reads and writes a binary
+     * representation of a fully parsed vpz::Vpz (project, structures,
+     * dynamics, classes and experiment). All the names are stored once in
+     * a string table and the numeric contents of the value::Tuple and
+     * value::Table are stored as raw arrays. The vpz::LatticeModel are
+     * stored with their stencil and the positions of their cells, without
+     * expanding the connections between the cells. Loading such a file
+     * avoids the XML parser and maps the file into memory.
+     *
+     * The file is only readable on the same byte order and by the same
+     * format version that wrote it: it is a cache of the XML source, not a
+     * replacement.
+     *
+     * @code
+     * vpz::Vpz vpz("huge.vpz");
+     * vpz::CompiledVpz::write(vpz, "huge.vpzc");
+     *
+     * vpz::Vpz fast("huge.vpzc"); // detected and loaded by the constructor.
+     * @endcode
+     */
+    class VLE_API CompiledVpz
+    {
+    public:
+        /**
+         * @brief Check if the file starts with the compiled vpz magic.
+         * @param filename The file to check.
+         * @return true if the file is a compiled vpz, false otherwise or if
+         * the file cannot be read.
+         */
+        static bool isCompiled(const std::string& filename);
+
+        /**
+         * @brief Check if the buffer starts with the compiled vpz magic.
+         * @param buffer The buffer to check.
+         * @param size The size of the buffer.
+         * @return true if the buffer is a compiled vpz.
+         */
+        static bool isCompiled(const char* buffer, std::size_t size);
+
+        /**
+         * @brief Write the compiled representation of the vpz into the
+         * specified file.
+         * @param vpz The vpz::Vpz to compile.
+         * @param filename The output file.
+         * @throw utils::FileError if the file cannot be written.
+         */
+        static void write(const Vpz& vpz, const std::string& filename);
+
+        /**
+         * @brief Write the compiled representation of the vpz into the
+         * output stream. The stream must be opened in binary mode.
+         * @param vpz The vpz::Vpz to compile.
+         * @param out The output stream.
+         */
+        static void write(const Vpz& vpz, std::ostream& out);
+
+        /**
+         * @brief Read a compiled vpz file using a memory mapping of the file.
+         * The vpz::Vpz must be empty.
+         * @param vpz The output parameter.
+         * @param filename The file to read.
+         * @throw utils::FileError if the file cannot be opened or if it is
+         * not a valid compiled vpz.
+         */
+        static void read(Vpz& vpz, const std::string& filename);
+
+        /**
+         * @brief Read a compiled vpz from a buffer. The vpz::Vpz must be
+         * empty.
+         * @param vpz The output parameter.
+         * @param buffer The buffer to read.
+         * @param size The size of the buffer.
+         * @throw utils::FileError if the buffer is not a valid compiled vpz.
+         */
+        static void read(Vpz& vpz, const char* buffer, std::size_t size);
+
+        /**
+         * @brief The version of the binary format. Incremented each time the
+         * layout changes.
+         */
+        static const unsigned int version;
+    };
+
+}} // namespace vle vpz
+
+#endif
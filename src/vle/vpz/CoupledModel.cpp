@@ -59,18 +59,31 @@ CoupledModel::CoupledModel(const CoupledModel& mdl) :
 
     std::for_each(m_modelList.begin(), m_modelList.end(), CloneModel(this));
 
-    copyConnection(mdl.m_internalInputList, m_internalInputList);
-    copyConnection(mdl.m_internalOutputList, m_internalOutputList);
+    ModelMap models;
+    models.reserve(m_modelList.size() + 1);
+    models.push_back(ModelMap::value_type(&mdl, this));
 
     ModelList::const_iterator it = mdl.getModelList().begin();
     ModelList::iterator jt = m_modelList.begin();
+    while (it != mdl.getModelList().end()) {
+        models.push_back(ModelMap::value_type(it->second, jt->second));
+        ++it;
+        ++jt;
+    }
+    std::sort(models.begin(), models.end());
+
+    copyConnection(mdl.m_internalInputList, m_internalInputList, models);
+    copyConnection(mdl.m_internalOutputList, m_internalOutputList, models);
+
+    it = mdl.getModelList().begin();
+    jt = m_modelList.begin();
     while (it != mdl.getModelList().end()) {
         const BaseModel* src = it->second;
         BaseModel* dst = jt->second;
-        copyInternalConnection(src->getInputPortList(),
-                               dst->getInputPortList(), mdl, *this);
-        copyInternalConnection(src->getOutputPortList(),
-                               dst->getOutputPortList(), mdl, *this);
+        copyConnection(src->getInputPortList(), dst->getInputPortList(),
+                       models);
+        copyConnection(src->getOutputPortList(), dst->getOutputPortList(),
+                       models);
         ++it;
         ++jt;
     }
@@ -726,7 +739,7 @@ void CoupledModel::addModel(BaseModel* model)
     }
 
     model->setParent(this);
-    m_modelList[model->getName()] = model;
+    m_modelList[model->getNameSymbol()] = model;
 }
 
 void CoupledModel::addModel(BaseModel* model, const std::string& name)
@@ -767,8 +780,9 @@ CoupledModel* CoupledModel::addCoupledModel(const std::string& name)
 
 void CoupledModel::delModel(BaseModel* model)
 {
-    ModelList::iterator it = m_modelList.find(model->getName());
+    ModelList::iterator it = m_modelList.find(model->getNameSymbol());
     if (it != m_modelList.end()) {
+        forgetModel(model);
         delAllConnection(model);
         m_modelList.erase(it);
         delete model;
@@ -777,6 +791,10 @@ void CoupledModel::delModel(BaseModel* model)
 
 void CoupledModel::delAllModel()
 {
+    for (ModelList::iterator it = m_modelList.begin();
+         it != m_modelList.end(); ++it) {
+        forgetModel(it->second);
+    }
     std::for_each(m_modelList.begin(), m_modelList.end(), DeleteModel(this));
     m_modelList.clear();
 }
@@ -792,7 +810,7 @@ void CoupledModel::attachModel(BaseModel* model)
         model->getParent()->detachModel(model);
     }
 
-    m_modelList[model->getName()] = model;
+    m_modelList[model->getNameSymbol()] = model;
     model->setParent(this);
 }
 
@@ -803,8 +821,9 @@ void CoupledModel::attachModels(ModelList& models)
 
 void CoupledModel::detachModel(BaseModel* model)
 {
-    ModelList::iterator it = m_modelList.find(model->getName());
+    ModelList::iterator it = m_modelList.find(model->getNameSymbol());
     if (it != m_modelList.end()) {
+        forgetModel(it->second);
         it->second->setParent(0);
         m_modelList.erase(it);
     } else {
@@ -1064,43 +1083,9 @@ const ModelPortList& CoupledModel::getInternalOutPort(
     return it->second;
 }
 
-void CoupledModel::copyInternalConnection(const ConnectionList& src,
-                                          ConnectionList& dst,
-                                          const BaseModel& parentSrc,
-                                          BaseModel& parentDst)
-{
-    assert(src.size() == dst.size());
-
-    ConnectionList::const_iterator it = src.begin();
-    ConnectionList::iterator jt = dst.begin();
-
-    while (it != src.end()) {
-        copyInternalPort(it->second, jt->second, parentSrc, parentDst);
-        ++it;
-        ++jt;
-    }
-}
-
-void CoupledModel::copyInternalPort(const ModelPortList& src,
-                                    ModelPortList& dst,
-                                    const BaseModel& parentSrc,
-                                    BaseModel& parentDst)
-{
-    typedef ModelPortList::const_iterator const_iterator;
-
-    for (const_iterator it = src.begin(); it != src.end(); ++it) {
-        if (it->first == &parentSrc) {
-            dst.add(&parentDst, it->second);
-        } else {
-            BaseModel* dstmodel = findModel(it->first->getName());
-            assert(dstmodel);
-            dst.add(dstmodel, it->second);
-        }
-    }
-}
-
 void CoupledModel::copyConnection(const ConnectionList& src,
-                                  ConnectionList& dst)
+                                  ConnectionList& dst,
+                                  const ModelMap& models)
 {
     assert(src.size() == dst.size());
 
@@ -1108,21 +1093,29 @@ void CoupledModel::copyConnection(const ConnectionList& src,
     ConnectionList::iterator jt = dst.begin();
 
     while (it != src.end()) {
-        copyPort(it->second, jt->second);
+        copyPort(it->second, jt->second, models);
         ++it;
         ++jt;
     }
 }
 
-void CoupledModel::copyPort(const ModelPortList& src, ModelPortList& dst)
+void CoupledModel::copyPort(const ModelPortList& src, ModelPortList& dst,
+                            const ModelMap& models)
 {
     typedef ModelPortList::const_iterator const_iterator;
 
+    ModelPortList::Values values;
+    values.reserve(src.size());
+
     for (const_iterator it = src.begin(); it != src.end(); ++it) {
-        BaseModel* dstmodel = findModel(it->first->getName());
-        assert(dstmodel);
-        dst.add(dstmodel, it->second);
+        ModelMap::const_iterator jt = std::lower_bound(
+            models.begin(), models.end(),
+            ModelMap::value_type(it->first, (BaseModel*)0));
+        assert(jt != models.end() and jt->first == it->first);
+        values.push_back(ModelPortList::value_type(jt->second, it->second));
     }
+
+    dst.assign(values);
 }
 
 CoupledModel::ModelConnections CoupledModel::saveInputConnections(
@@ -752,47 +752,44 @@ namespace vle { namespace vpz {
 	 */
 	virtual void purgeConditions(const std::set < std::string >& conditionlist);
 
+    protected:
+        /**
+         * @brief Called when a model leaves the children of this coupled
+         * model (deleted or detached) to let the subclasses forget it.
+         * @param model The model to forget.
+         */
+        virtual void forgetModel(BaseModel* /* model */) {}
+
     private:
         void delConnection(BaseModel* src, const std::string& portSrc,
                            BaseModel* dst, const std::string& portDst);
 
         /**
-         * @brief Copy input and output connections list from src to dst. dst.
-         * @param src The source of the copy.
-         * @param dst The destination of the copy.
-         */
-        void copyConnection(const ConnectionList& src, ConnectionList& dst);
-
-        /**
-         * @brief Copy the connection from ModelPortList src to the
-         * ModelPortList dst.
-         * @param src The source of the copy.
-         * @param dst The destination of the copy.
+         * @brief The association of the models of a coupled model with the
+         * models of its copy, sorted by the source models.
          */
-        void copyPort(const ModelPortList& src, ModelPortList& dst);
+        typedef std::vector < std::pair < const BaseModel*, BaseModel* > >
+            ModelMap;
 
         /**
-         * @brief Copy internal connections list from src to dst.
+         * @brief Copy input and output connections list from src to dst.
          * @param src The source of the copy.
          * @param dst The destination of the copy.
-         * @param parentSrc Parent of src's ConnectionList.
-         * @param parentDst Parent of dst's ConnectionList.
+         * @param models The models of the copy.
          */
-        void copyInternalConnection(const ConnectionList& src,
-                                    ConnectionList& dst,
-                                    const BaseModel& parentSrc,
-                                    BaseModel& parentDst);
+        static void copyConnection(const ConnectionList& src,
+                                   ConnectionList& dst,
+                                   const ModelMap& models);
 
         /**
          * @brief Copy the connection from ModelPortList src to the
          * ModelPortList dst.
          * @param src The source of the copy.
          * @param dst The destination of the copy.
-         * @param parentSrc Parent of src's ModelPortList.
-         * @param parentDst Parent of dst's ModelPortList.
+         * @param models The models of the copy.
          */
-        void copyInternalPort(const ModelPortList& src, ModelPortList& dst,
-                              const BaseModel& parentSrc, BaseModel& parentDst);
+        static void copyPort(const ModelPortList& src, ModelPortList& dst,
+                             const ModelMap& models);
 
         ModelList       m_modelList;
         ConnectionList  m_internalInputList;
@@ -26,23 +26,38 @@
 
 
 #include <vle/vpz/Experiment.hpp>
+#include <vle/value/Text.hpp>
 
 namespace vle { namespace vpz {
 
 void Experiment::write(std::ostream& out) const
 {
-    out << "<experiment "
-        << "name=\"" << m_name.c_str() << "\" "
-        << "duration=\"" << m_duration << "\" "
-        << "begin=\"" << m_begin << "\" ";
-
-    if (not m_combination.empty()) {
-        out << "combination=\"" << m_combination.c_str()
-            << "\" ";
+    {
+        value::TextWriter writer(out);
+
+        writer.put("<experiment name=\"");
+        writer.put(m_name.c_str());
+        writer.put("\" duration=\"");
+        writer.put(m_duration);
+        writer.put("\" begin=\"");
+        writer.put(m_begin);
+        writer.put("\" ");
+
+        if (not m_combination.empty()) {
+            writer.put("combination=\"");
+            writer.put(m_combination.c_str());
+            writer.put("\" ");
+        }
+
+        if (m_seed) {
+            writer.put("seed=\"");
+            writer.put(static_cast < unsigned long >(m_seed));
+            writer.put("\" ");
+        }
+
+        writer.put(" >\n");
     }
 
-    out << " >\n";
-
     m_conditions.write(out);
     m_views.write(out);
 
@@ -54,6 +69,7 @@ void Experiment::clear()
     m_name.clear();
     m_duration = 1.0;
     m_begin = 0;
+    m_seed = 0;
 
     m_conditions.clear();
     m_views.clear();
@@ -47,7 +47,7 @@ namespace vle { namespace vpz {
          * date at 0.0.
          */
         Experiment()
-            : m_duration(1.0), m_begin(0.0)
+            : m_duration(1.0), m_begin(0.0), m_seed(0)
         {}
 
         /**
@@ -195,11 +195,26 @@ namespace vle { namespace vpz {
         const std::string& combination() const
         { return m_combination; }
 
+        /**
+         * @brief Set the seed of the random generators of the simulation.
+         * @param seed The new seed.
+         */
+        void setSeed(uint32_t seed)
+        { m_seed = seed; }
+
+        /**
+         * @brief Get the seed of the random generators of the simulation.
+         * @return The seed, 0 by default.
+         */
+        uint32_t seed() const
+        { return m_seed; }
+
     private:
         std::string         m_name;
         double              m_duration;
         double              m_begin;
         std::string         m_combination;
+        uint32_t            m_seed;
         Conditions          m_conditions;
         Views               m_views;
     };
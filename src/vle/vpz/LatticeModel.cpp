@@ -0,0 +1,360 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <vle/vpz/LatticeModel.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/utils/Exception.hpp>
+
+namespace vle { namespace vpz {
+
+LatticeModel::LatticeModel(const std::string& name, CoupledModel* parent,
+                           unsigned int rows, unsigned int columns)
+    : CoupledModel(name, parent), m_rows(rows), m_columns(columns),
+    m_wraprows(false), m_wrapcolumns(false)
+{
+    if (rows == 0 or columns == 0) {
+        if (parent) {
+            parent->detachModel(this);
+        }
+
+        throw utils::DevsGraphError(fmt(
+                _("Lattice `%1%': bad size %2%x%3%")) % name % rows %
+            columns);
+    }
+
+    m_cells.resize(size(), 0);
+}
+
+LatticeModel::LatticeModel(const LatticeModel& mdl)
+    : CoupledModel(mdl), m_rows(mdl.m_rows), m_columns(mdl.m_columns),
+    m_wraprows(mdl.m_wraprows), m_wrapcolumns(mdl.m_wrapcolumns),
+    m_stencil(mdl.m_stencil), m_cells(mdl.size(), 0),
+    m_fields(mdl.m_fields)
+{
+    for (CellIndex::const_iterator it = mdl.m_index.begin();
+         it != mdl.m_index.end(); ++it) {
+        AtomicModel* cell = static_cast < AtomicModel* >(
+            getModel(it->first->getName()));
+
+        m_cells[it->second] = cell;
+        m_index[cell] = it->second;
+    }
+}
+
+void LatticeModel::writeXML(std::ostream& out) const
+{
+    out << "<model name=\"" << getName().c_str() << "\" "
+        << " type=\"coupled\" >\n";
+    writePortListXML(out);
+    out << "<submodels>\n";
+
+    for (ModelList::const_iterator it = getModelList().begin();
+         it != getModelList().end(); ++it) {
+        it->second->writeXML(out);
+    }
+    out << "</submodels>\n";
+
+    out << "<connections>\n";
+    writeConnections(out);
+
+    StringList lst;
+    getLatticeConnections(lst);
+    for (StringList::const_iterator it = lst.begin(); it != lst.end();
+         it += 4) {
+        out << "<connection type=\"internal\">\n"
+            << " <origin model=\"" << it->c_str() << "\" "
+            << "port=\"" << (it + 1)->c_str() << "\" />\n"
+            << " <destination model=\"" << (it + 2)->c_str()
+            << "\" port=\"" << (it + 3)->c_str() << "\" />\n"
+            << "</connection>\n";
+    }
+    out << "</connections>\n";
+    out << "</model>\n";
+}
+
+void LatticeModel::setNeighbourhood(Neighbourhood type, bool symmetricport)
+{
+    static const int offsets[8][2] = {
+        { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 },
+        { -1, -1 }, { -1, 1 }, { 1, -1 }, { 1, 1 } };
+    static const char* directions[8] = {
+        "N", "S", "W", "E", "NW", "NE", "SW", "SE" };
+    static const char* opposites[8] = {
+        "S", "N", "E", "W", "SE", "SW", "NE", "NW" };
+
+    m_stencil.clear();
+
+    if (type == LINEAR) {
+        addNeighbour(0, -1, symmetricport ? "L" : "out", "R");
+        addNeighbour(0, 1, symmetricport ? "R" : "out", "L");
+    } else {
+        int nb = (type == MOORE) ? 8 : 4;
+
+        for (int i = 0; i < nb; ++i) {
+            addNeighbour(offsets[i][0], offsets[i][1],
+                         symmetricport ? directions[i] : "out",
+                         opposites[i]);
+        }
+    }
+}
+
+void LatticeModel::addNeighbour(int row, int column,
+                                const std::string& output,
+                                const std::string& input)
+{
+    m_stencil.push_back(Neighbour(row, column, output, input));
+}
+
+AtomicModel* LatticeModel::addCell(unsigned int row, unsigned int column,
+                                   const std::string& name)
+{
+    checkCell(row, column);
+
+    AtomicModel* cell = addAtomicModel(name);
+    unsigned int idx = index(row, column);
+    m_cells[idx] = cell;
+    m_index[cell] = idx;
+
+    return cell;
+}
+
+void LatticeModel::setCell(unsigned int row, unsigned int column,
+                           AtomicModel* cell)
+{
+    checkCell(row, column);
+
+    if (not cell or cell->getParent() != this or
+        m_index.find(cell) != m_index.end()) {
+        throw utils::DevsGraphError(fmt(
+                _("Lattice `%1%': `%2%' can not be placed in (%3%, %4%)")) %
+            getName() % (cell ? cell->getName() : std::string()) % row %
+            column);
+    }
+
+    unsigned int idx = index(row, column);
+    m_cells[idx] = cell;
+    m_index[cell] = idx;
+}
+
+bool LatticeModel::findCell(const BaseModel* model, unsigned int& row,
+                            unsigned int& column) const
+{
+    CellIndex::const_iterator it = m_index.find(model);
+
+    if (it == m_index.end()) {
+        return false;
+    }
+
+    row = it->second / m_columns;
+    column = it->second % m_columns;
+    return true;
+}
+
+AtomicModel* LatticeModel::neighbour(unsigned int row, unsigned int column,
+                                     int drow, int dcolumn) const
+{
+    unsigned int idx;
+
+    return move(row, column, drow, dcolumn, idx) ? m_cells[idx] : 0;
+}
+
+void LatticeModel::getNeighbourTargets(const BaseModel* model,
+                                       const std::string& port,
+                                       ModelPortList& result) const
+{
+    unsigned int row, column, idx;
+
+    if (not findCell(model, row, column)) {
+        return;
+    }
+
+    for (Stencil::const_iterator it = m_stencil.begin();
+         it != m_stencil.end(); ++it) {
+        if (it->output == port and
+            move(row, column, it->row, it->column, idx)) {
+            AtomicModel* dst = m_cells[idx];
+
+            if (dst and dst->existInputPort(it->input)) {
+                result.add(dst, it->input);
+            }
+        }
+    }
+}
+
+void LatticeModel::getNeighbourSources(const BaseModel* model,
+                                       const std::string& port,
+                                       ModelPortList& result) const
+{
+    unsigned int row, column, idx;
+
+    if (not findCell(model, row, column)) {
+        return;
+    }
+
+    for (Stencil::const_iterator it = m_stencil.begin();
+         it != m_stencil.end(); ++it) {
+        if (it->input == port and
+            move(row, column, -it->row, -it->column, idx)) {
+            AtomicModel* src = m_cells[idx];
+
+            if (src and src->existOutputPort(it->output)) {
+                result.add(src, it->output);
+            }
+        }
+    }
+}
+
+void LatticeModel::getLatticeConnections(StringList& lst) const
+{
+    for (CellIndex::const_iterator it = m_index.begin();
+         it != m_index.end(); ++it) {
+        unsigned int row = it->second / m_columns;
+        unsigned int column = it->second % m_columns;
+        unsigned int idx;
+
+        for (Stencil::const_iterator jt = m_stencil.begin();
+             jt != m_stencil.end(); ++jt) {
+            if (it->first->existOutputPort(jt->output) and
+                move(row, column, jt->row, jt->column, idx) and
+                m_cells[idx] and m_cells[idx]->existInputPort(jt->input)) {
+                lst.push_back(it->first->getName());
+                lst.push_back(jt->output);
+                lst.push_back(m_cells[idx]->getName());
+                lst.push_back(jt->input);
+            }
+        }
+    }
+}
+
+double* LatticeModel::addField(const std::string& name, double value)
+{
+    if (existField(name)) {
+        throw utils::ArgError(fmt(
+                _("Lattice `%1%': field `%2%' already exists")) %
+            getName() % name);
+    }
+
+    std::vector < double >& field(m_fields[name]);
+    field.assign(size(), value);
+
+    return &field[0];
+}
+
+double* LatticeModel::field(const std::string& name)
+{
+    Fields::iterator it = m_fields.find(name);
+
+    if (it == m_fields.end()) {
+        throw utils::ArgError(fmt(
+                _("Lattice `%1%': unknown field `%2%'")) % getName() % name);
+    }
+
+    return &it->second[0];
+}
+
+const double* LatticeModel::field(const std::string& name) const
+{
+    Fields::const_iterator it = m_fields.find(name);
+
+    if (it == m_fields.end()) {
+        throw utils::ArgError(fmt(
+                _("Lattice `%1%': unknown field `%2%'")) % getName() % name);
+    }
+
+    return &it->second[0];
+}
+
+void LatticeModel::swapFields(const std::string& first,
+                              const std::string& second)
+{
+    Fields::iterator it = m_fields.find(first);
+    Fields::iterator jt = m_fields.find(second);
+
+    if (it == m_fields.end() or jt == m_fields.end()) {
+        throw utils::ArgError(fmt(
+                _("Lattice `%1%': unknown field `%2%' or `%3%'")) %
+            getName() % first % second);
+    }
+
+    it->second.swap(jt->second);
+}
+
+void LatticeModel::forgetModel(BaseModel* model)
+{
+    CellIndex::iterator it = m_index.find(model);
+
+    if (it != m_index.end()) {
+        m_cells[it->second] = 0;
+        m_index.erase(it);
+    }
+}
+
+void LatticeModel::checkCell(unsigned int row, unsigned int column) const
+{
+    if (row >= m_rows or column >= m_columns) {
+        throw utils::DevsGraphError(fmt(
+                _("Lattice `%1%': cell (%2%, %3%) out of the lattice")) %
+            getName() % row % column);
+    }
+
+    unsigned int idx = index(row, column);
+    if (m_cells[idx]) {
+        throw utils::DevsGraphError(fmt(
+                _("Lattice `%1%': cell (%2%, %3%) already used by `%4%'")) %
+            getName() % row % column % m_cells[idx]->getName());
+    }
+}
+
+bool LatticeModel::move(unsigned int row, unsigned int column, int drow,
+                        int dcolumn, unsigned int& idx) const
+{
+    long r = static_cast < long >(row) + drow;
+    long c = static_cast < long >(column) + dcolumn;
+    long rows = m_rows;
+    long columns = m_columns;
+
+    if (r < 0 or r >= rows) {
+        if (not m_wraprows) {
+            return false;
+        }
+        r = ((r % rows) + rows) % rows;
+    }
+
+    if (c < 0 or c >= columns) {
+        if (not m_wrapcolumns) {
+            return false;
+        }
+        c = ((c % columns) + columns) % columns;
+    }
+
+    idx = static_cast < unsigned int >(r * columns + c);
+    return true;
+}
+
+}} // namespace vle vpz
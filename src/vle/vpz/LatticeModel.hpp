@@ -0,0 +1,330 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef VLE_VPZ_LATTICEMODEL_HPP
+#define VLE_VPZ_LATTICEMODEL_HPP
+
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/DllDefines.hpp>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace vle { namespace vpz {
+
+    /**
+     * @brief A coupled model of atomic cells placed on a regular grid of
+     * rows and columns. The connections between the cells are not stored
+     * into the ports of the cells: they are computed from a stencil, a list
+     * of offsets (row, column) associated to an output port of the cell and
+     * an input port of the neighbour. The grid can wrap around on rows and
+     * columns (torus).
+     *
+     * The lattice can also store the state of the cells in fields, one
+     * array of double per field indexed by the position of the cells, to
+     * be read and written by the dynamics without messages.
+     *
+     * @code
+     * vpz::LatticeModel* lattice = new vpz::LatticeModel("grid", top, 10, 10);
+     * lattice->setNeighbourhood(vpz::LatticeModel::MOORE, false);
+     * lattice->setWrap(true, true);
+     *
+     * for (unsigned int i = 0; i < 10; ++i) {
+     *     for (unsigned int j = 0; j < 10; ++j) {
+     *         vpz::AtomicModel* cell = lattice->addCell(i, j, name(i, j));
+     *         cell->addOutputPort("out");
+     *         cell->addInputPort("N");
+     *         ...
+     *     }
+     * }
+     * @endcode
+     *
+     * The lattice is written into the vpz file as a coupled model with
+     * explicit connections. The compiled vpz stores the lattice itself: the
+     * geometry, the stencil, the positions of the cells and the fields.
+     */
+    class VLE_API LatticeModel : public CoupledModel
+    {
+    public:
+        /**
+         * @brief The predefined neighbourhoods: VON_NEUMANN for the four
+         * neighbours N, S, W and E, MOORE for the eight neighbours and
+         * LINEAR for the L and R neighbours of a lattice of one row.
+         */
+        enum Neighbourhood { VON_NEUMANN, MOORE, LINEAR };
+
+        /**
+         * @brief An element of the stencil: the cell sends the events of
+         * its output port to the input port of the cell at offset (row,
+         * column).
+         */
+        struct Neighbour
+        {
+            Neighbour(int row, int column, const std::string& output,
+                      const std::string& input)
+                : row(row), column(column), output(output), input(input)
+            {}
+
+            int row;
+            int column;
+            std::string output;
+            std::string input;
+        };
+
+        typedef std::vector < Neighbour > Stencil;
+        typedef std::map < std::string, std::vector < double > > Fields;
+
+        /**
+         * @brief Build an empty lattice without neighbour.
+         * @param name The name of the lattice.
+         * @param parent The parent of the lattice, can be null.
+         * @param rows The number of rows.
+         * @param columns The number of columns.
+         * @throw utils::DevsGraphError if rows or columns is null.
+         */
+        LatticeModel(const std::string& name, CoupledModel* parent,
+                     unsigned int rows, unsigned int columns);
+
+        LatticeModel(const LatticeModel& mdl);
+
+        virtual BaseModel* clone() const
+        { return new LatticeModel(*this); }
+
+        virtual ~LatticeModel() {}
+
+        /**
+         * @brief Return true, LatticeModel is a lattice.
+         * @return true.
+         */
+        virtual bool isLattice() const { return true; }
+
+        /**
+         * @brief Write the lattice as a coupled model with explicit
+         * connections.
+         * @param out output stream.
+         */
+        void writeXML(std::ostream& out) const;
+
+        ////
+        //// Geometry.
+        ////
+
+        unsigned int rows() const { return m_rows; }
+
+        unsigned int columns() const { return m_columns; }
+
+        unsigned int size() const { return m_rows * m_columns; }
+
+        unsigned int index(unsigned int row, unsigned int column) const
+        { return row * m_columns + column; }
+
+        /**
+         * @brief Replace the stencil with a predefined neighbourhood. With
+         * symmetric ports, the output port is the direction of the
+         * neighbour (N, NE, ...), otherwise all the neighbours listen the
+         * output port "out". The input port is the direction of the sender
+         * seen by the neighbour.
+         * @param type The neighbourhood.
+         * @param symmetricport true to use an output port per direction.
+         */
+        void setNeighbourhood(Neighbourhood type, bool symmetricport);
+
+        /**
+         * @brief Add an element to the stencil.
+         * @param row The row offset of the neighbour.
+         * @param column The column offset of the neighbour.
+         * @param output The output port of the cell.
+         * @param input The input port of the neighbour.
+         */
+        void addNeighbour(int row, int column, const std::string& output,
+                          const std::string& input);
+
+        void clearNeighbours() { m_stencil.clear(); }
+
+        const Stencil& stencil() const { return m_stencil; }
+
+        /**
+         * @brief Connect the first and the last rows, the first and the last
+         * columns.
+         * @param rows true to wrap around the rows.
+         * @param columns true to wrap around the columns.
+         */
+        void setWrap(bool rows, bool columns)
+        { m_wraprows = rows; m_wrapcolumns = columns; }
+
+        bool wrapRows() const { return m_wraprows; }
+
+        bool wrapColumns() const { return m_wrapcolumns; }
+
+        ////
+        //// Cells.
+        ////
+
+        /**
+         * @brief Build a new atomic model at the position (row, column).
+         * @param row The row of the cell.
+         * @param column The column of the cell.
+         * @param name The name of the atomic model.
+         * @return The new atomic model.
+         * @throw utils::DevsGraphError if the position is out of the
+         * lattice or already used or if the name already exists.
+         */
+        AtomicModel* addCell(unsigned int row, unsigned int column,
+                             const std::string& name);
+
+        /**
+         * @brief Place an atomic model of the lattice at the position
+         * (row, column).
+         * @param row The row of the cell.
+         * @param column The column of the cell.
+         * @param cell An atomic model of the lattice.
+         * @throw utils::DevsGraphError if the position is out of the
+         * lattice or already used or if the model is not a child of the
+         * lattice or is already a cell.
+         */
+        void setCell(unsigned int row, unsigned int column,
+                     AtomicModel* cell);
+
+        /**
+         * @brief Get the cell at the position (row, column).
+         * @return The atomic model or 0 if the position is empty.
+         */
+        AtomicModel* cell(unsigned int row, unsigned int column) const
+        { return m_cells[index(row, column)]; }
+
+        /**
+         * @brief Get the position of a cell.
+         * @param model The model to find.
+         * @param row The row of the cell.
+         * @param column The column of the cell.
+         * @return true if the model is a cell of this lattice.
+         */
+        bool findCell(const BaseModel* model, unsigned int& row,
+                      unsigned int& column) const;
+
+        /**
+         * @brief Get the cell at the offset (drow, dcolumn) of the position
+         * (row, column) according to the wrap options.
+         * @return The atomic model or 0 if the position is out of the
+         * lattice or empty.
+         */
+        AtomicModel* neighbour(unsigned int row, unsigned int column,
+                               int drow, int dcolumn) const;
+
+        /**
+         * @brief Append the cells and the input ports connected to the
+         * output port of the cell.
+         * @param model The source cell.
+         * @param port The output port.
+         * @param result The list to fill.
+         */
+        void getNeighbourTargets(const BaseModel* model,
+                                 const std::string& port,
+                                 ModelPortList& result) const;
+
+        /**
+         * @brief Append the cells and the output ports connected to the
+         * input port of the cell.
+         * @param model The destination cell.
+         * @param port The input port.
+         * @param result The list to fill.
+         */
+        void getNeighbourSources(const BaseModel* model,
+                                 const std::string& port,
+                                 ModelPortList& result) const;
+
+        /**
+         * @brief Return the implicit connections between the cells as
+         * 4-uples (modelsource, portsource, modeldestination,
+         * portdestination) like CoupledModel::getBasicConnections.
+         * @param lst The list to fill.
+         */
+        void getLatticeConnections(StringList& lst) const;
+
+        ////
+        //// State.
+        ////
+
+        /**
+         * @brief Add a field: an array of double, one per position.
+         * @param name The name of the field.
+         * @param value The initial value of the positions.
+         * @return A pointer to the first element of the field.
+         * @throw utils::ArgError if the field already exists.
+         */
+        double* addField(const std::string& name, double value = 0.0);
+
+        /**
+         * @brief Get a field.
+         * @param name The name of the field.
+         * @return A pointer to the first element of the field.
+         * @throw utils::ArgError if the field does not exist.
+         */
+        double* field(const std::string& name);
+
+        const double* field(const std::string& name) const;
+
+        bool existField(const std::string& name) const
+        { return m_fields.find(name) != m_fields.end(); }
+
+        /**
+         * @brief Exchange the contents of two fields, for instance the
+         * current and the next state of the cells, without copy.
+         * @throw utils::ArgError if a field does not exist.
+         */
+        void swapFields(const std::string& first, const std::string& second);
+
+        const Fields& fields() const { return m_fields; }
+
+    protected:
+        virtual void forgetModel(BaseModel* model);
+
+    private:
+        LatticeModel& operator=(const LatticeModel& mdl);
+
+        void checkCell(unsigned int row, unsigned int column) const;
+
+        bool move(unsigned int row, unsigned int column, int drow,
+                  int dcolumn, unsigned int& index) const;
+
+        typedef std::map < const BaseModel*, unsigned int > CellIndex;
+
+        unsigned int                 m_rows;
+        unsigned int                 m_columns;
+        bool                         m_wraprows;
+        bool                         m_wrapcolumns;
+        Stencil                      m_stencil;
+        std::vector < AtomicModel* > m_cells;
+        CellIndex                    m_index;
+        Fields                       m_fields;
+    };
+
+}} // namespace vle vpz
+
+#endif
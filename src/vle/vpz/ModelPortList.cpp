@@ -29,14 +29,40 @@
 #include <vle/vpz/BaseModel.hpp>
 #include <vle/utils/Exception.hpp>
 #include <vle/utils/i18n.hpp>
+#include <algorithm>
+#include <iterator>
 
 namespace vle { namespace vpz {
 
+namespace {
+
+/*
+ * Compare the models of the (model, port) to sort and search the vector by
+ * model only: std::stable_sort, std::upper_bound and std::merge keep the
+ * order of the ports of a model.
+ */
+struct CompareModel
+{
+    bool operator()(const ModelPortList::value_type& a,
+                    const ModelPortList::value_type& b) const
+    { return a.first < b.first; }
+
+    bool operator()(const ModelPortList::value_type& a,
+                    const BaseModel* b) const
+    { return a.first < b; }
+
+    bool operator()(const BaseModel* a,
+                    const ModelPortList::value_type& b) const
+    { return a < b.first; }
+};
+
+} // anonymous namespace
+
 ModelPortList::~ModelPortList()
 {
 }
 
-void ModelPortList::add(BaseModel *model, const std::string& portname)
+void ModelPortList::add(BaseModel *model, const utils::Symbol& portname)
 {
     if (not model) {
         throw utils::DevsGraphError(fmt(
@@ -44,7 +70,20 @@ void ModelPortList::add(BaseModel *model, const std::string& portname)
             portname);
     }
 
-    m_lst.insert(value_type(model, portname));
+    if (not m_lst.empty() and model < m_lst.back().first) {
+        m_sorted = false;
+    }
+
+    m_lst.push_back(value_type(model, portname));
+}
+
+void ModelPortList::assign(const Values& values)
+{
+    Values lst(values);
+
+    std::stable_sort(lst.begin(), lst.end(), CompareModel());
+    m_lst.swap(lst);
+    m_sorted = true;
 }
 
 void ModelPortList::remove(BaseModel *model, const std::string& portname)
@@ -55,49 +94,45 @@ void ModelPortList::remove(BaseModel *model, const std::string& portname)
             portname);
     }
 
-    std::pair < iterator, iterator > its = m_lst.equal_range(model);
-    iterator it = its.first;
-    iterator previous = its.first;
-
-    while (it != its.second) {
-	if (it->second == portname) {
-            if (it == previous) {
-                it++;
-                m_lst.erase(previous);
-                previous = it;
-            } else {
-                m_lst.erase(it);
-	        it = previous;
-	    }
-	} else {
-	    previous = it;
-	    it++;
-	}
+    std::pair < Values::iterator, Values::iterator > its = range(model);
+    Values::iterator it = its.first;
+
+    for (Values::iterator jt = its.first; jt != its.second; ++jt) {
+        if (jt->second != portname) {
+            *it++ = *jt;
+        }
     }
+
+    m_lst.erase(it, its.second);
+}
+
+void ModelPortList::erase(BaseModel* model)
+{
+    std::pair < Values::iterator, Values::iterator > its = range(model);
+
+    m_lst.erase(its.first, its.second);
 }
 
 void ModelPortList::merge(ModelPortList& lst)
 {
-    for (iterator it = lst.begin(); it != lst.end(); ++it) {
-        m_lst.insert(value_type(it->first, it->second));
-    }
+    Values result;
+
+    sort();
+    lst.sort();
+    result.reserve(m_lst.size() + lst.m_lst.size());
+    std::merge(m_lst.begin(), m_lst.end(), lst.m_lst.begin(),
+               lst.m_lst.end(), std::back_inserter(result), CompareModel());
+    m_lst.swap(result);
 }
 
 bool ModelPortList::exist(BaseModel *model, const std::string& portname) const
 {
-    std::pair < const_iterator, const_iterator > its(m_lst.equal_range(model));
-    for (const_iterator it = its.first; it != its.second; ++it) {
-        if (it->second == portname) {
-            return true;
-        }
-    }
-    return false;
+    return exist(const_cast < const BaseModel* >(model), portname);
 }
 
 bool ModelPortList::exist(const BaseModel *model, const std::string& portname) const
 {
-    std::pair < const_iterator, const_iterator > its;
-    its = m_lst.equal_range(const_cast < BaseModel *>(model));
+    std::pair < const_iterator, const_iterator > its = range(model);
     for (const_iterator it = its.first; it != its.second; ++it) {
         if (it->second == portname) {
             return true;
@@ -106,6 +141,30 @@ bool ModelPortList::exist(const BaseModel *model, const std::string& portname) c
     return false;
 }
 
+void ModelPortList::sortModels() const
+{
+    std::stable_sort(m_lst.begin(), m_lst.end(), CompareModel());
+    m_sorted = true;
+}
+
+std::pair < ModelPortList::Values::iterator, ModelPortList::Values::iterator >
+ModelPortList::range(const BaseModel* model)
+{
+    sort();
+
+    return std::equal_range(m_lst.begin(), m_lst.end(), model,
+                            CompareModel());
+}
+
+std::pair < ModelPortList::const_iterator, ModelPortList::const_iterator >
+ModelPortList::range(const BaseModel* model) const
+{
+    sort();
+
+    return std::equal_range(m_lst.begin(), m_lst.end(), model,
+                            CompareModel());
+}
+
 std::ostream& operator<<(std::ostream& out, const ModelPortList& lst)
 {
     ModelPortList::const_iterator it;
@@ -29,35 +29,57 @@
 #define VLE_GRAPH_MODELPORTLIST_HPP
 
 #include <vle/DllDefines.hpp>
+#include <vle/utils/Symbol.hpp>
 #include <string>
-#include <map>
+#include <vector>
 
 namespace vle { namespace vpz {
 
     class BaseModel;
 
+    /**
+     * @brief The list of the (model, port) linked to a port. The list is an
+     * array sorted by model, the ports of a model are kept in the order of
+     * their insertion. The port names are interned into utils::Symbol: an
+     * element is two pointers and the copy of a list is a copy of an array.
+     * The models added out of order are appended and the array is sorted
+     * by the next read: building the list of a port connected to n models
+     * costs n.log(n) whatever the order of their addresses.
+     */
     class VLE_API ModelPortList
     {
     public:
-        typedef std::multimap < BaseModel*, std::string > Values;
-        typedef Values::iterator iterator;
+        typedef std::pair < BaseModel*, utils::Symbol > value_type;
+        typedef std::vector < value_type > Values;
+        typedef Values::const_iterator iterator;
         typedef Values::const_iterator const_iterator;
         typedef Values::size_type size_type;
-        typedef Values::value_type value_type;
 
         ModelPortList()
+            : m_sorted(true)
         { }
 
         virtual ~ModelPortList();
 
         /**
          * @brief Add a new ModelPort to the vector. No check is
-         * performed is a connection already exist.
+         * performed is a connection already exist. Constant amortized
+         * complexity: the vector is sorted again by the next read if the
+         * model is not added in the order of the addresses.
          *
          * @param model The model to add.
          * @param portname The port of the model to add.
          */
-        void add(BaseModel* model, const std::string& portname);
+        void add(BaseModel* model, const utils::Symbol& portname);
+
+        /**
+         * @brief Replace the content of the vector with the ModelPort of
+         * the values. The values are sorted by model, the order of the
+         * ports of a model is kept. n.log(n) complexity.
+         *
+         * @param values The ModelPort to assign.
+         */
+        void assign(const Values& values);
 
         /**
          * @brief Remove a ModelPort from the vector. Linear complexity.
@@ -72,13 +94,13 @@ namespace vle { namespace vpz {
          *
          * @param model Model to be removed.
          */
-        void erase(BaseModel* model) { m_lst.erase(model); }
+        void erase(BaseModel* model);
 
         /**
          * @brief Remove all ModelPort from the vector. Linear
          * complexity.
          */
-        void clear() { m_lst.clear(); }
+        void clear() { m_lst.clear(); m_sorted = true; }
 
         /**
          * @brief Merge the vector from ModelPort vector. Linera
@@ -90,7 +112,7 @@ namespace vle { namespace vpz {
 
         /**
          * @brief Check if a ModelPort already exist in the vector.
-         * Linear complexity.
+         * Logarithmic complexity in the number of models.
          *
          * @param model The model to check.
          * @param portname The port of the model to check.
@@ -102,7 +124,7 @@ namespace vle { namespace vpz {
 
         /**
          * @brief Check if a ModelPort already exist in the vector.
-         * Linear complexity.
+         * Logarithmic complexity in the number of models.
          *
          * @param model The model to check.
          * @param portname The port of the model to check.
@@ -112,14 +134,29 @@ namespace vle { namespace vpz {
          */
         bool exist(const BaseModel* model, const std::string& portname) const;
 
-        inline iterator begin() { return m_lst.begin(); }
-        inline const_iterator begin() const { return m_lst.begin(); }
-        inline iterator end() { return m_lst.end(); }
-        inline const_iterator end() const { return m_lst.end(); }
+        inline const_iterator begin() const { sort(); return m_lst.begin(); }
+        inline const_iterator end() const { sort(); return m_lst.end(); }
         inline size_type size() const { return m_lst.size(); }
 
     private:
-        Values m_lst;
+        /**
+         * @brief Sort the vector by model if add() appended a model out of
+         * order. Like any modification of the list, the first read after
+         * add() must not be concurrent with other reads.
+         */
+        inline void sort() const { if (not m_sorted) sortModels(); }
+
+        void sortModels() const;
+
+        std::pair < Values::iterator, Values::iterator > range(
+            const BaseModel* model);
+
+        std::pair < const_iterator, const_iterator > range(
+            const BaseModel* model) const;
+
+        mutable Values m_lst;
+        mutable bool m_sorted;  /**< False if add() appended a model
+                                  out of order. */
     };
 
     std::ostream& operator<<(std::ostream& out, const ModelPortList& lst);
@@ -43,28 +43,218 @@
 #include <vle/value/Null.hpp>
 #include <vle/utils/i18n.hpp>
 #include <boost/cast.hpp>
-#include <boost/algorithm/string/trim.hpp>
-#include <boost/algorithm/string/split.hpp>
-#include <boost/algorithm/string/classification.hpp>
+#include <boost/cstdint.hpp>
 #include <libxml/SAX2.h>
 #include <libxml/parser.h>
+#include <cctype>
 #include <cerrno>
 #include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
 
 namespace vle { namespace vpz {
 
+namespace {
+
+inline bool isXmlSpace(char c)
+{
+    return c == ' ' or c == '\n' or c == '\t' or c == '\r';
+}
+
+inline bool isDigit(char c)
+{
+    return c >= '0' and c <= '9';
+}
+
+inline bool startsWith(const char* str, const char* end, const char* word)
+{
+    for (; *word; ++str, ++word) {
+        if (str == end or std::tolower(static_cast < unsigned char >(*str)) != *word) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Convert the real number at the beginning of [str, end) without using the
+ * global C locale: the decimal separator is always the '.' character. When
+ * the mantissa holds in 53 bits and the exponent is small, the result is
+ * computed exactly with two exact floating point numbers (the fast path of
+ * the Clinger's algorithm). The other numbers are read by a stream imbued
+ * with the classic locale. Return the first character after the number or
+ * str if no number is read.
+ */
+const char* readReal(const char* str, const char* end, double* result)
+{
+    static const double pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+        1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+        1e20, 1e21, 1e22 };
+
+    const char* it = str;
+    bool negative = false;
+
+    if (it != end and (*it == '-' or *it == '+')) {
+        negative = *it == '-';
+        ++it;
+    }
+
+    if (startsWith(it, end, "inf")) {
+        *result = negative ? -std::numeric_limits < double >::infinity() :
+            std::numeric_limits < double >::infinity();
+        return startsWith(it, end, "infinity") ? it + 8 : it + 3;
+    }
+
+    if (startsWith(it, end, "nan")) {
+        *result = std::numeric_limits < double >::quiet_NaN();
+        return it + 3;
+    }
+
+    boost::uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool exact = true;
+    bool found = false;
+
+    for (; it != end and isDigit(*it); ++it) {
+        found = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*it - '0');
+            if (mantissa) {
+                digits++;
+            }
+        } else {
+            exact = false;
+        }
+    }
+
+    if (it != end and *it == '.') {
+        for (++it; it != end and isDigit(*it); ++it) {
+            found = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*it - '0');
+                if (mantissa) {
+                    digits++;
+                }
+                exponent--;
+            } else if (*it != '0') {
+                exact = false;
+            }
+        }
+    }
+
+    if (not found) {
+        return str;
+    }
+
+    if (it != end and (*it == 'e' or *it == 'E')) {
+        const char* exp = it + 1;
+        bool negativeExp = false;
+
+        if (exp != end and (*exp == '-' or *exp == '+')) {
+            negativeExp = *exp == '-';
+            ++exp;
+        }
+
+        if (exp != end and isDigit(*exp)) {
+            int value = 0;
+            for (; exp != end and isDigit(*exp); ++exp) {
+                if (value < 100000) {
+                    value = value * 10 + (*exp - '0');
+                }
+            }
+            exponent += negativeExp ? -value : value;
+            it = exp;
+        }
+    }
+
+    while (mantissa and mantissa % 10 == 0) {
+        mantissa /= 10;
+        exponent++;
+    }
+
+    if (exact and mantissa == 0) {
+        *result = negative ? -0.0 : 0.0;
+        return it;
+    }
+
+    if (exact and mantissa <= (boost::uint64_t(1) << 53) and
+        exponent >= -22 and exponent <= 22) {
+        double value = static_cast < double >(mantissa);
+        value = exponent < 0 ? value / pow10[-exponent] :
+            value * pow10[exponent];
+        *result = negative ? -value : value;
+        return it;
+    }
+
+    std::istringstream in(std::string(str, it));
+    in.imbue(std::locale::classic());
+    in >> *result;
+
+    return in.fail() ? str : it;
+}
+
+/*
+ * Read the real numbers separated by XML white spaces directly from a
+ * character buffer. Like strtod, the characters which follow a real number
+ * in a token are ignored.
+ */
+class RealTokenizer
+{
+public:
+    RealTokenizer(const std::string& buffer)
+        : m_it(buffer.data()), m_end(buffer.data() + buffer.size())
+    {}
+
+    bool next(double* result)
+    {
+        while (m_it != m_end and isXmlSpace(*m_it)) {
+            ++m_it;
+        }
+
+        if (m_it == m_end) {
+            return false;
+        }
+
+        const char* token = m_it;
+        m_it = readReal(token, m_end, result);
+
+        if (m_it == token) {
+            while (m_it != m_end and not isXmlSpace(*m_it)) {
+                ++m_it;
+            }
+            throw utils::SaxParserError(fmt(
+                    _("error to convert '%1%' to double")) %
+                std::string(token, m_it));
+        }
+
+        while (m_it != m_end and not isXmlSpace(*m_it)) {
+            ++m_it;
+        }
+
+        return true;
+    }
+
+private:
+    const char* m_it;
+    const char* m_end;
+};
+
+} // anonymous namespace
+
 SaxParser::SaxParser(Vpz& vpz)
     : m_stop(false), m_vpzstack(vpz), m_vpz(vpz), m_isValue(false),
     m_isVPZ(false)
 {
     fillTagList();
-}
 
-void SaxParser::parseFile(const std::string& filename)
-{
-    setlocale(LC_ALL, "C");
+    /* The handler only provides the SAX1 callbacks (attributes are an array
+     * of null-terminated name/value strings), so it must not be declared with
+     * the XML_SAX2_MAGIC: recent libxml2 do not call the SAX1 callbacks of a
+     * SAX2 handler. */
     memset(&m_sax, 0, sizeof(xmlSAXHandler));
-    m_sax.initialized = XML_SAX2_MAGIC;
+    m_sax.initialized = 1;
     m_sax.startDocument = &SaxParser::onStartDocument;
     m_sax.endDocument = &SaxParser::onEndDocument;
     m_sax.startElement = &SaxParser::onStartElement;
@@ -74,7 +264,10 @@ void SaxParser::parseFile(const std::string& filename)
     m_sax.warning = &SaxParser::onWarning;
     m_sax.error = &SaxParser::onError;
     m_sax.fatalError = &SaxParser::onFatalError;
+}
 
+void SaxParser::parseFile(const std::string& filename)
+{
     if (xmlSAXUserParseFile(&m_sax, this, filename.c_str())) {
         if (m_error.empty()) {
             throw utils::SaxParserError(fmt(
@@ -91,24 +284,10 @@ void SaxParser::parseFile(const std::string& filename)
     }
 
     xmlMemoryDump();
-    setlocale(LC_ALL, "");
 }
 
 void SaxParser::parseMemory(const std::string& buffer)
 {
-    setlocale(LC_ALL, "C");
-    memset(&m_sax, 0, sizeof(xmlSAXHandler));
-    m_sax.initialized = XML_SAX2_MAGIC;
-    m_sax.startDocument = &SaxParser::onStartDocument;
-    m_sax.endDocument = &SaxParser::onEndDocument;
-    m_sax.startElement = &SaxParser::onStartElement;
-    m_sax.endElement = &SaxParser::onEndElement;
-    m_sax.characters = &SaxParser::onCharacters;
-    m_sax.cdataBlock = &SaxParser::onCDataBlock;
-    m_sax.warning = &SaxParser::onWarning;
-    m_sax.error = &SaxParser::onError;
-    m_sax.fatalError = &SaxParser::onFatalError;
-
     if (xmlSAXUserParseMemory(&m_sax, this, buffer.c_str(), buffer.size())) {
         if (m_error.empty()) {
             throw utils::SaxParserError(_("Error parsing memory"));
@@ -123,7 +302,6 @@ void SaxParser::parseMemory(const std::string& buffer)
                 _("Error when parsing memory: %1%")) % m_error);
     }
     xmlMemoryDump();
-    setlocale(LC_ALL, "");
 }
 
 void SaxParser::stopParser(const std::string& error)
@@ -205,9 +383,7 @@ void SaxParser::onCharacters(void* ctx, const xmlChar* ch, int len)
     SaxParser* sax = static_cast < SaxParser* >(ctx);
 
     if (not sax->isStopped()) {
-        std::string buf((const char*)ch, len);
-
-        sax->addToCharacters(buf);
+        sax->addToCharacters((const char*)ch, len);
     }
 }
 
@@ -217,9 +393,7 @@ void SaxParser::onCDataBlock(void* ctx, const xmlChar* value, int len)
     SaxParser* sax = static_cast < SaxParser* >(ctx);
 
     if (not sax->isStopped()) {
-        std::string buf((const char*)value, len);
-
-        sax->m_cdata.assign(buf);
+        sax->m_cdata.assign((const char*)value, len);
     }
 }
 
@@ -241,8 +415,6 @@ void SaxParser::onWarning(void* /* ctx */, const char *msg, ...)
 
 void SaxParser::onError(void* ctx, const char *msg, ...)
 {
-    setlocale(LC_ALL, "");
-
     SaxParser* sax = static_cast < SaxParser* >(ctx);
     char* buffer = new char[1024];
     memset(buffer, 0, 1024);
@@ -258,8 +430,6 @@ void SaxParser::onError(void* ctx, const char *msg, ...)
 
 void SaxParser::onFatalError(void* ctx, const char *msg, ...)
 {
-    setlocale(LC_ALL, "");
-
     SaxParser* sax = static_cast < SaxParser* >(ctx);
     char* buffer = new char[1024];
     memset(buffer, 0, 1024);
@@ -597,20 +767,11 @@ void SaxParser::onEndMap()
 void SaxParser::onEndTuple()
 {
     value::Tuple& tuple(m_valuestack.topValue()->toTuple());
+    RealTokenizer tokens(lastCharactersStored());
+    double x;
 
-    std::string cpy(lastCharactersStored());
-    boost::algorithm::trim(cpy);
-
-    std::vector < std::string > result;
-    boost::algorithm::split(result, cpy,
-                            boost::algorithm::is_any_of(" \n\t\r"));
-
-    for (std::vector < std::string >::iterator it = result.begin();
-         it != result.end(); ++it) {
-        boost::algorithm::trim(*it);
-        if (not (*it).empty()) {
-            tuple.add(xmlCharToDouble((const xmlChar*)((*it).c_str())));
-        }
+    while (tokens.next(&x)) {
+        tuple.add(x);
     }
 
     m_valuestack.popValue();
@@ -620,13 +781,6 @@ void SaxParser::onEndTable()
 {
     value::Table& table(m_valuestack.topValue()->toTable());
 
-    std::string cpy(lastCharactersStored());
-    boost::algorithm::trim(cpy);
-
-    std::vector < std::string > result;
-    boost::algorithm::split(result, cpy,
-                            boost::algorithm::is_any_of(" \n\t\r"));
-
     size_t size;
     try {
         size = boost::numeric_cast < size_t >(table.width() * table.height());
@@ -636,29 +790,29 @@ void SaxParser::onEndTable()
             table.width() % table.height());
     }
 
-    if (result.size() != size) {
-        throw utils::SaxParserError(
-            _("VPZ parser: bad height or width for number of real in table"));
-    }
-
+    RealTokenizer tokens(lastCharactersStored());
     value::Table::index i = 0;
     value::Table::index j = 0;
-    for (std::vector < std::string >::iterator it = result.begin(); it !=
-         result.end(); ++it) {
-        boost::algorithm::trim(*it);
-        if (not (*it).empty()) {
-            table.get(i, j) = xmlCharToDouble((const xmlChar*)((*it).c_str()));
-            if (i + 1 >= table.width()) {
-                i = 0;
-                if (j + 1 >= table.height()) {
-                    break;
-                } else {
-                    j++;
-                }
-            } else {
-                i++;
-            }
+    size_t nb = 0;
+    double x;
+
+    while (tokens.next(&x)) {
+        if (nb++ == size) {
+            break;
         }
+
+        table.get(i, j) = x;
+        if (i + 1 >= table.width()) {
+            i = 0;
+            j++;
+        } else {
+            i++;
+        }
+    }
+
+    if (nb != size) {
+        throw utils::SaxParserError(
+            _("VPZ parser: bad height or width for number of real in table"));
     }
 
     m_valuestack.popValue();
@@ -898,19 +1052,15 @@ unsigned long int xmlCharToUnsignedInt(const xmlChar* str)
 
 double xmlCharToDouble(const xmlChar* str)
 {
-    char* res = 0;
-
-    errno = 0;
-    double r = strtod((const char*)str, &res);
-    int err = errno;
+    const char* begin = (const char*)str;
+    const char* end = begin + std::strlen(begin);
+    double r;
 
-    if ((err == ERANGE and r == HUGE_VAL) or (err != 0 and r == 0)) {
-        throw utils::SaxParserError(fmt(
-                _("error to convert '%1%' to double: %2%")) % str %
-            strerror(err));
+    while (begin != end and isXmlSpace(*begin)) {
+        ++begin;
     }
 
-    if (res == (const char*)str) {
+    if (readReal(begin, end, &r) == begin) {
         throw utils::SaxParserError(fmt(
                 _("error to convert '%1%' to double")) % str);
     }
@@ -162,9 +162,10 @@ namespace vle { namespace vpz {
         /**
          * @brief Append characters to the last characters readed.
          * @param characters The characters to append.
+         * @param len The number of characters to append.
          */
-        void addToCharacters(const std::string& characters)
-        { m_lastCharacters.append(characters); }
+        void addToCharacters(const char* characters, std::size_t len)
+        { m_lastCharacters.append(characters, len); }
 
         /**
          * @brief Stop the parsing of the XML file.
@@ -377,7 +378,8 @@ namespace vle { namespace vpz {
     VLE_API unsigned long int xmlCharToUnsignedInt(const xmlChar* str);
 
     /**
-     * @brief Convert the xmlChar pointer to a double.
+     * @brief Convert the xmlChar pointer to a double. The conversion does not
+     * depend on the C locale: the decimal separator is always '.'.
      * @param str The constant xmlChar pointer to translate.
      * @throw utils::SaxParserError if the xmlChar can not be translated into a
      * double
@@ -26,6 +26,7 @@
 
 
 #include <vle/vpz/View.hpp>
+#include <vle/value/Text.hpp>
 #include <vle/utils/Exception.hpp>
 #include <vle/utils/i18n.hpp>
 
@@ -59,10 +60,14 @@ void View::write(std::ostream& out) const
     case View::EVENT:
         out << "type=\"event\"";
         break;
-    case View::TIMED:
-        out << "type=\"timed\" "
-            << "timestep=\"" << m_timestep << "\"";
+    case View::TIMED: {
+        value::TextWriter writer(out);
+
+        writer.put("type=\"timed\" timestep=\"");
+        writer.put(m_timestep);
+        writer.put('"');
         break;
+    }
     case View::FINISH:
         out << "type=\"finish\"";
         break;
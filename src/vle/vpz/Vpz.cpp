@@ -26,6 +26,7 @@
 
 
 #include <vle/vpz/Vpz.hpp>
+#include <vle/vpz/CompiledVpz.hpp>
 #include <fstream>
 #include <iomanip>
 #include <limits>
@@ -65,6 +66,12 @@ void Vpz::write(std::ostream& out) const
 void Vpz::parseFile(const std::string& filename)
 {
     m_filename.assign(filename);
+
+    if (CompiledVpz::isCompiled(filename)) {
+        CompiledVpz::read(*this, filename);
+        return;
+    }
+
     vpz::SaxParser saxparser(*this);
 
     try {
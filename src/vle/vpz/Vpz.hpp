@@ -51,7 +51,8 @@ namespace vle { namespace vpz {
         {}
 
         /**
-         * @brief Use the filename to build a Vpz XML file.
+         * @brief Use the filename to build a Vpz XML file. The file can be
+         * a XML file or a file produced by vpz::CompiledVpz.
          * @param filename The filename to open.
          * @throw utils::ArgError if an error occured during loading.
          */
@@ -72,7 +73,10 @@ namespace vle { namespace vpz {
         /**
          * @brief Write into the output stream the XML representation of this
          * class. It write first, the xml tag and doctype before writing the
-         * vpz::Project object.
+         * vpz::Project object. The reals are written in fixed notation with
+         * 15 digits or, if the round-trip mode of the stream is enabled
+         * with value::TextWriter::setRoundTrip, with the digits needed to
+         * read back the same doubles.
          * @param out The output parameter where send XML representation.
          */
         virtual void write(std::ostream& out) const;
@@ -85,7 +89,9 @@ namespace vle { namespace vpz {
         { return VLE_VPZ_VPZ; }
 
         /**
-         * @brief Open a VPZ file project.
+         * @brief Open a VPZ file project. If the file is a compiled vpz (see
+         * vpz::CompiledVpz), it is mapped into memory and read without the
+         * XML parser.
          * @param filename file to read.
          * @throw utils::ArgError if an error occured during loading.
          */
@@ -0,0 +1,589 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <vle/vpz/VpzWriter.hpp>
+#include <vle/vpz/BaseModel.hpp>
+#include <vle/vpz/Dynamics.hpp>
+#include <vle/vpz/Classes.hpp>
+#include <vle/vpz/Condition.hpp>
+#include <vle/vpz/Views.hpp>
+#include <vle/value/Value.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/version.hpp>
+#include <libxml/xmlIO.h>
+#include <streambuf>
+#include <iomanip>
+#include <limits>
+#include <vector>
+
+namespace vle { namespace vpz {
+
+namespace {
+
+/**
+ * A std::streambuf which sends its buffer to a libxml2 output buffer. The
+ * libxml2 output buffer compresses the data with gzip if asked, as the
+ * libxml2 reader of the vpz::SaxParser decompresses it.
+ */
+class XmlOutputStreamBuf : public std::streambuf
+{
+public:
+    XmlOutputStreamBuf(const std::string& filename, int compression)
+        : m_out(xmlOutputBufferCreateFilename(filename.c_str(), NULL,
+                                              compression)),
+        m_buffer(65536), m_error(false)
+    {
+        if (not m_out) {
+            throw utils::FileError(fmt(_(
+                    "VpzWriter: cannot open file '%1%' for writing"))
+                % filename);
+        }
+
+        setp(&m_buffer[0], &m_buffer[0] + m_buffer.size());
+    }
+
+    ~XmlOutputStreamBuf()
+    {
+        if (m_out) {
+            flushBuffer();
+            xmlOutputBufferClose(m_out);
+        }
+    }
+
+    /**
+     * Flush the buffer and close the libxml2 output buffer.
+     * @return false if an error occurred.
+     */
+    bool close()
+    {
+        bool success = flushBuffer();
+
+        if (xmlOutputBufferClose(m_out) < 0) {
+            success = false;
+        }
+        m_out = 0;
+
+        return success;
+    }
+
+protected:
+    virtual int_type overflow(int_type c)
+    {
+        if (not flushBuffer()) {
+            return traits_type::eof();
+        }
+
+        if (not traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+
+        return traits_type::not_eof(c);
+    }
+
+    virtual int sync()
+    {
+        return flushBuffer() ? 0 : -1;
+    }
+
+private:
+    bool flushBuffer()
+    {
+        int size = pptr() - pbase();
+
+        if (size > 0 and not m_error) {
+            if (xmlOutputBufferWrite(m_out, size, pbase()) < 0) {
+                m_error = true;
+            }
+        }
+        setp(&m_buffer[0], &m_buffer[0] + m_buffer.size());
+
+        return not m_error;
+    }
+
+    XmlOutputStreamBuf(const XmlOutputStreamBuf& other);
+    XmlOutputStreamBuf& operator=(const XmlOutputStreamBuf& other);
+
+    xmlOutputBufferPtr m_out;
+    std::vector < char > m_buffer;
+    bool m_error;
+};
+
+} // anonymous namespace
+
+class VpzWriter::Pimpl
+{
+public:
+    enum State {
+        STATE_DOCUMENT,     /**< Before the vle_project. */
+        STATE_PROJECT,      /**< Before the structures. */
+        STATE_STRUCTURES,   /**< Into the coupled models. */
+        STATE_DYNAMICS,     /**< After the structures. */
+        STATE_CLASSES,      /**< After the dynamics or the classes. */
+        STATE_EXPERIMENT,   /**< Into the experiment. */
+        STATE_CONDITION,    /**< Into a condition. */
+        STATE_VIEWS,        /**< After the views of the experiment. */
+        STATE_END,          /**< After the experiment. */
+        STATE_CLOSED        /**< After the vle_project. */
+    };
+
+    /**
+     * An opened coupled model: its name is used in the input and output
+     * connections, the boolean is true if the connections are opened.
+     */
+    typedef std::vector < std::pair < std::string, bool > > CoupledStack;
+
+    Pimpl(const std::string& filename, int compression)
+        : m_buf(new XmlOutputStreamBuf(filename, compression)),
+        m_file(m_buf), m_out(m_file), m_state(STATE_DOCUMENT),
+        m_conditions(false)
+    {
+        writeHeader();
+    }
+
+    Pimpl(std::ostream& out)
+        : m_buf(0), m_file(0), m_out(out), m_state(STATE_DOCUMENT),
+        m_conditions(false)
+    {
+        writeHeader();
+    }
+
+    ~Pimpl()
+    {
+        delete m_buf;
+    }
+
+    void writeHeader()
+    {
+        m_out << std::showpoint
+            << std::fixed
+            << std::setprecision(std::numeric_limits < double >::digits10)
+            << "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
+            << "<!DOCTYPE vle_project PUBLIC \"-//VLE TEAM//DTD Strict//EN\" "
+            << "\"http://www.vle-project.org/vle-"
+            << VLE_MAJOR_VERSION << "." << VLE_MINOR_VERSION << ".0.dtd\">\n";
+    }
+
+    void writePorts(const StringList& inputs, const StringList& outputs)
+    {
+        if (not inputs.empty()) {
+            m_out << "<in>\n";
+            for (StringList::const_iterator it = inputs.begin();
+                 it != inputs.end(); ++it) {
+                m_out << " <port name=\"" << it->c_str() << "\" />\n";
+            }
+            m_out << "</in>\n";
+        }
+
+        if (not outputs.empty()) {
+            m_out << "<out>\n";
+            for (StringList::const_iterator it = outputs.begin();
+                 it != outputs.end(); ++it) {
+                m_out << " <port name=\"" << it->c_str() << "\" />\n";
+            }
+            m_out << "</out>\n";
+        }
+    }
+
+    /**
+     * Check if a model can be written and open the structures if needed.
+     */
+    void beginModel(const std::string& name)
+    {
+        if (name.empty()) {
+            throw utils::ArgError(_("VpzWriter: empty model name"));
+        }
+
+        if (m_state == STATE_PROJECT) {
+            m_out << "<structures>\n";
+            m_state = STATE_STRUCTURES;
+        } else if (m_state != STATE_STRUCTURES or m_coupled.empty()) {
+            throw utils::ArgError(fmt(_(
+                    "VpzWriter: cannot write the model '%1%' here")) % name);
+        } else if (m_coupled.back().second) {
+            throw utils::ArgError(fmt(_(
+                    "VpzWriter: cannot write the model '%1%' after the "
+                    "connections of '%2%'")) % name % m_coupled.back().first);
+        }
+    }
+
+    /**
+     * Close the structures if the written model is the top model.
+     */
+    void endModel()
+    {
+        if (m_coupled.empty()) {
+            m_out << "</structures>\n";
+            m_state = STATE_DYNAMICS;
+        }
+    }
+
+    void beginConnection(const char* type)
+    {
+        if (m_state != STATE_STRUCTURES or m_coupled.empty()) {
+            throw utils::ArgError(_(
+                    "VpzWriter: connection outside a coupled model"));
+        }
+
+        if (not m_coupled.back().second) {
+            m_out << "</submodels>\n<connections>\n";
+            m_coupled.back().second = true;
+        }
+
+        m_out << "<connection type=\"" << type << "\">\n";
+    }
+
+    void beginConditions()
+    {
+        if (m_state != STATE_EXPERIMENT) {
+            throw utils::ArgError(_(
+                    "VpzWriter: condition outside an experiment"));
+        }
+
+        if (not m_conditions) {
+            m_out << "<conditions>\n";
+            m_conditions = true;
+        }
+    }
+
+    void endConditions()
+    {
+        if (m_conditions) {
+            m_out << "</conditions>\n";
+            m_conditions = false;
+        }
+    }
+
+    XmlOutputStreamBuf* m_buf;
+    std::ostream m_file;
+    std::ostream& m_out;
+    State m_state;
+    CoupledStack m_coupled;
+    bool m_conditions;
+};
+
+VpzWriter::VpzWriter(const std::string& filename, int compression)
+    : m_pimpl(new Pimpl(filename, compression))
+{
+}
+
+VpzWriter::VpzWriter(std::ostream& out)
+    : m_pimpl(new Pimpl(out))
+{
+}
+
+VpzWriter::~VpzWriter()
+{
+    delete m_pimpl;
+}
+
+void VpzWriter::beginProject(const std::string& author,
+                             const std::string& version,
+                             const std::string& date,
+                             int instance)
+{
+    if (m_pimpl->m_state != Pimpl::STATE_DOCUMENT) {
+        throw utils::ArgError(_("VpzWriter: project already opened"));
+    }
+
+    if (author.empty()) {
+        throw utils::ArgError(_("VpzWriter: empty author"));
+    }
+
+    m_pimpl->m_out << "<vle_project"
+        << " version=\"" << version.c_str() << "\""
+        << " date=\"" << date.c_str() << "\""
+        << " author=\"" << author.c_str() << "\"";
+
+    if (instance >= 0) {
+        m_pimpl->m_out << " instance=\"" << instance << "\"";
+    }
+
+    m_pimpl->m_out << ">\n";
+    m_pimpl->m_state = Pimpl::STATE_PROJECT;
+}
+
+void VpzWriter::beginCoupledModel(const std::string& name,
+                                  const StringList& inputs,
+                                  const StringList& outputs)
+{
+    m_pimpl->beginModel(name);
+
+    m_pimpl->m_out << "<model name=\"" << name.c_str() << "\" "
+        << "type=\"coupled\"  >\n";
+    m_pimpl->writePorts(inputs, outputs);
+    m_pimpl->m_out << "<submodels>\n";
+    m_pimpl->m_coupled.push_back(std::make_pair(name, false));
+}
+
+void VpzWriter::writeAtomicModel(const std::string& name,
+                                 const std::string& dynamics,
+                                 const StringList& conditions,
+                                 const std::string& observables,
+                                 const StringList& inputs,
+                                 const StringList& outputs)
+{
+    m_pimpl->beginModel(name);
+
+    m_pimpl->m_out << "<model name=\"" << name.c_str() << "\" "
+        << "type=\"atomic\" ";
+
+    if (not conditions.empty()) {
+        m_pimpl->m_out << "conditions=\"";
+
+        StringList::const_iterator it = conditions.begin();
+        while (it != conditions.end()) {
+            m_pimpl->m_out << it->c_str();
+            ++it;
+            if (it != conditions.end()) {
+                m_pimpl->m_out << ",";
+            }
+        }
+
+        m_pimpl->m_out << "\" ";
+    }
+
+    m_pimpl->m_out << "dynamics=\"" << dynamics.c_str() << "\" ";
+
+    if (not observables.empty()) {
+        m_pimpl->m_out << "observables=\"" << observables.c_str() << "\" ";
+    }
+
+    m_pimpl->m_out << ">\n";
+    m_pimpl->writePorts(inputs, outputs);
+    m_pimpl->m_out << "</model>\n";
+
+    m_pimpl->endModel();
+}
+
+void VpzWriter::writeModel(const BaseModel& model)
+{
+    m_pimpl->beginModel(model.getName());
+    model.write(m_pimpl->m_out);
+    m_pimpl->endModel();
+}
+
+void VpzWriter::writeInternalConnection(const std::string& src,
+                                        const std::string& srcport,
+                                        const std::string& dst,
+                                        const std::string& dstport)
+{
+    m_pimpl->beginConnection("internal");
+    m_pimpl->m_out << " <origin model=\"" << src.c_str() << "\" "
+        << "port=\"" << srcport.c_str() << "\" />\n"
+        << " <destination model=\"" << dst.c_str() << "\" "
+        << "port=\"" << dstport.c_str() << "\" />\n"
+        << "</connection>\n";
+}
+
+void VpzWriter::writeInputConnection(const std::string& port,
+                                     const std::string& dst,
+                                     const std::string& dstport)
+{
+    m_pimpl->beginConnection("input");
+    m_pimpl->m_out << " <origin model=\""
+        << m_pimpl->m_coupled.back().first.c_str() << "\" "
+        << "port=\"" << port.c_str() << "\" />\n"
+        << " <destination model=\"" << dst.c_str() << "\" "
+        << "port=\"" << dstport.c_str() << "\" />\n"
+        << "</connection>\n";
+}
+
+void VpzWriter::writeOutputConnection(const std::string& src,
+                                      const std::string& srcport,
+                                      const std::string& port)
+{
+    m_pimpl->beginConnection("output");
+    m_pimpl->m_out << " <origin model=\"" << src.c_str() << "\" "
+        << "port=\"" << srcport.c_str() << "\" />\n"
+        << " <destination model=\""
+        << m_pimpl->m_coupled.back().first.c_str() << "\" "
+        << "port=\"" << port.c_str() << "\" />\n"
+        << "</connection>\n";
+}
+
+void VpzWriter::endCoupledModel()
+{
+    if (m_pimpl->m_state != Pimpl::STATE_STRUCTURES or
+        m_pimpl->m_coupled.empty()) {
+        throw utils::ArgError(_("VpzWriter: no coupled model to close"));
+    }
+
+    if (m_pimpl->m_coupled.back().second) {
+        m_pimpl->m_out << "</connections>\n";
+    } else {
+        m_pimpl->m_out << "</submodels>\n<connections>\n</connections>\n";
+    }
+    m_pimpl->m_out << "</model>\n";
+
+    m_pimpl->m_coupled.pop_back();
+    m_pimpl->endModel();
+}
+
+void VpzWriter::writeDynamics(const Dynamics& dynamics)
+{
+    if (m_pimpl->m_state != Pimpl::STATE_DYNAMICS) {
+        throw utils::ArgError(_(
+                "VpzWriter: dynamics must follow the structures"));
+    }
+
+    dynamics.write(m_pimpl->m_out);
+    m_pimpl->m_state = Pimpl::STATE_CLASSES;
+}
+
+void VpzWriter::writeClasses(const Classes& classes)
+{
+    if (m_pimpl->m_state != Pimpl::STATE_DYNAMICS and
+        m_pimpl->m_state != Pimpl::STATE_CLASSES) {
+        throw utils::ArgError(_(
+                "VpzWriter: classes must follow the structures"));
+    }
+
+    classes.write(m_pimpl->m_out);
+    m_pimpl->m_state = Pimpl::STATE_CLASSES;
+}
+
+void VpzWriter::beginExperiment(const std::string& name,
+                                double duration,
+                                double begin,
+                                const std::string& combination)
+{
+    if (m_pimpl->m_state != Pimpl::STATE_DYNAMICS and
+        m_pimpl->m_state != Pimpl::STATE_CLASSES) {
+        throw utils::ArgError(_(
+                "VpzWriter: experiment must follow the structures"));
+    }
+
+    if (name.empty()) {
+        throw utils::ArgError(_("VpzWriter: empty experiment name"));
+    }
+
+    if (not combination.empty() and combination != "linear" and
+        combination != "total") {
+        throw utils::ArgError(fmt(_(
+                "VpzWriter: unknown combination '%1%'")) % combination);
+    }
+
+    m_pimpl->m_out << "<experiment "
+        << "name=\"" << name.c_str() << "\" "
+        << "duration=\"" << duration << "\" "
+        << "begin=\"" << begin << "\" ";
+
+    if (not combination.empty()) {
+        m_pimpl->m_out << "combination=\"" << combination.c_str() << "\" ";
+    }
+
+    m_pimpl->m_out << " >\n";
+    m_pimpl->m_state = Pimpl::STATE_EXPERIMENT;
+}
+
+void VpzWriter::beginCondition(const std::string& name)
+{
+    if (name.empty()) {
+        throw utils::ArgError(_("VpzWriter: empty condition name"));
+    }
+
+    m_pimpl->beginConditions();
+    m_pimpl->m_out << "<condition name=\"" << name.c_str() << "\" >\n";
+    m_pimpl->m_state = Pimpl::STATE_CONDITION;
+}
+
+void VpzWriter::writeConditionPort(const std::string& port,
+                                   const value::Value& value)
+{
+    if (m_pimpl->m_state != Pimpl::STATE_CONDITION) {
+        throw utils::ArgError(_("VpzWriter: port outside a condition"));
+    }
+
+    m_pimpl->m_out << " <port name=\"" << port.c_str() << "\" >\n";
+    value.writeXml(m_pimpl->m_out);
+    m_pimpl->m_out << "\n</port>\n";
+}
+
+void VpzWriter::endCondition()
+{
+    if (m_pimpl->m_state != Pimpl::STATE_CONDITION) {
+        throw utils::ArgError(_("VpzWriter: no condition to close"));
+    }
+
+    m_pimpl->m_out << "</condition>\n";
+    m_pimpl->m_state = Pimpl::STATE_EXPERIMENT;
+}
+
+void VpzWriter::writeCondition(const Condition& condition)
+{
+    m_pimpl->beginConditions();
+    condition.write(m_pimpl->m_out);
+}
+
+void VpzWriter::writeViews(const Views& views)
+{
+    if (m_pimpl->m_state != Pimpl::STATE_EXPERIMENT) {
+        throw utils::ArgError(_("VpzWriter: views outside an experiment"));
+    }
+
+    m_pimpl->endConditions();
+    views.write(m_pimpl->m_out);
+    m_pimpl->m_state = Pimpl::STATE_VIEWS;
+}
+
+void VpzWriter::endExperiment()
+{
+    if (m_pimpl->m_state != Pimpl::STATE_EXPERIMENT and
+        m_pimpl->m_state != Pimpl::STATE_VIEWS) {
+        throw utils::ArgError(_("VpzWriter: no experiment to close"));
+    }
+
+    m_pimpl->endConditions();
+    m_pimpl->m_out << "</experiment>\n";
+    m_pimpl->m_state = Pimpl::STATE_END;
+}
+
+void VpzWriter::close()
+{
+    if (m_pimpl->m_state != Pimpl::STATE_END) {
+        throw utils::ArgError(_(
+                "VpzWriter: cannot close an incomplete project"));
+    }
+
+    m_pimpl->m_out << "</vle_project>\n";
+    m_pimpl->m_out.flush();
+    m_pimpl->m_state = Pimpl::STATE_CLOSED;
+
+    if (m_pimpl->m_buf and not m_pimpl->m_buf->close()) {
+        throw utils::FileError(_("VpzWriter: cannot write the file"));
+    }
+
+    if (m_pimpl->m_out.fail()) {
+        throw utils::FileError(_("VpzWriter: cannot write the stream"));
+    }
+}
+
+}} // namespace vle vpz
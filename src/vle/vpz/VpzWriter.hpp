@@ -0,0 +1,288 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_VPZ_VPZWRITER_HPP
+#define VLE_VPZ_VPZWRITER_HPP
+
+#include <vle/DllDefines.hpp>
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace vle { namespace value {
+
+    class Value;
+
+}} // namespace vle value
+
+namespace vle { namespace vpz {
+
+    class BaseModel;
+    class Dynamics;
+    class Classes;
+    class Condition;
+    class Views;
+
+    /**
+     * @brief The vpz::VpzWriter writes a vpz file element by element
+     * without building the vpz::Vpz, the vpz::CoupledModel hierarchy nor
+     * the vpz::ModelPortList of the connections. Each call appends its XML
+     * to the output: the memory used by the writer only depends on the
+     * depth of the coupled models. It is intended for generators of huge
+     * models (grids, graphs) which cannot hold the whole vpz in memory.
+     *
+     * The order of the calls follows the order of the vpz document:
+     * structures, dynamics, classes and experiment. A call in a wrong state
+     * throws an utils::ArgError. The output file can be compressed with
+     * gzip, the vpz::Vpz reads these files transparently.
+     *
+     * @code
+     * vpz::VpzWriter w("grid.vpz.gz", 9);
+     * w.beginProject("me");
+     * w.beginCoupledModel("top");
+     * for (int i = 0; i < n; ++i) {
+     *     w.writeAtomicModel(name(i), "cell", conds, "", ins, outs);
+     * }
+     * for (...) {
+     *     w.writeInternalConnection(name(i), "out", name(j), "in");
+     * }
+     * w.endCoupledModel();
+     * w.writeDynamics(dynamics);
+     * w.beginExperiment("exp", 100.0);
+     * w.beginCondition("cond");
+     * w.writeConditionPort("x", value::Double(1.0));
+     * w.endCondition();
+     * w.writeViews(views);
+     * w.endExperiment();
+     * w.close();
+     * @endcode
+     */
+    class VLE_API VpzWriter
+    {
+    public:
+        typedef std::vector < std::string > StringList;
+
+        /**
+         * @brief Open the file and write the XML header.
+         * @param filename The output file.
+         * @param compression The gzip compression level from 0 (no
+         * compression) to 9.
+         * @throw utils::FileError if the file cannot be opened.
+         */
+        VpzWriter(const std::string& filename, int compression = 0);
+
+        /**
+         * @brief Write the XML header into the output stream. The stream
+         * must live longer than the writer.
+         * @param out The output stream.
+         */
+        VpzWriter(std::ostream& out);
+
+        /**
+         * @brief Flush and close the output if the writer opened it. The
+         * document is not completed, call close() before.
+         */
+        ~VpzWriter();
+
+        /**
+         * @brief Open the vle_project element.
+         * @param author The author of the project.
+         * @param version The version of the project.
+         * @param date The date of the project.
+         * @param instance The instance of the project, ignored if negative.
+         * @throw utils::ArgError if the author is empty or if the project
+         * is already opened.
+         */
+        void beginProject(const std::string& author,
+                          const std::string& version = "1.0",
+                          const std::string& date = std::string(),
+                          int instance = -1);
+
+        /**
+         * @brief Open a coupled model. The first model opens the
+         * structures, the others are submodels of the current coupled
+         * model.
+         * @param name The name of the coupled model.
+         * @param inputs The input ports.
+         * @param outputs The output ports.
+         * @throw utils::ArgError if a model cannot be opened here.
+         */
+        void beginCoupledModel(const std::string& name,
+                               const StringList& inputs = StringList(),
+                               const StringList& outputs = StringList());
+
+        /**
+         * @brief Write an atomic model into the current coupled model, or
+         * as the whole structures if no coupled model is opened.
+         * @param name The name of the atomic model.
+         * @param dynamics The name of the vpz::Dynamic.
+         * @param conditions The names of the vpz::Condition.
+         * @param observables The name of the vpz::Observable.
+         * @param inputs The input ports.
+         * @param outputs The output ports.
+         * @throw utils::ArgError if a model cannot be written here.
+         */
+        void writeAtomicModel(const std::string& name,
+                              const std::string& dynamics,
+                              const StringList& conditions = StringList(),
+                              const std::string& observables = std::string(),
+                              const StringList& inputs = StringList(),
+                              const StringList& outputs = StringList());
+
+        /**
+         * @brief Write an already built model (atomic or coupled) into the
+         * current coupled model, or as the whole structures if no coupled
+         * model is opened.
+         * @param model The model to write.
+         * @throw utils::ArgError if a model cannot be written here.
+         */
+        void writeModel(const BaseModel& model);
+
+        /**
+         * @brief Write a connection between two submodels of the current
+         * coupled model. After the first connection, no submodel can be
+         * added to the current coupled model.
+         * @throw utils::ArgError if no coupled model is opened.
+         */
+        void writeInternalConnection(const std::string& src,
+                                     const std::string& srcport,
+                                     const std::string& dst,
+                                     const std::string& dstport);
+
+        /**
+         * @brief Write a connection from an input port of the current
+         * coupled model to a submodel.
+         * @throw utils::ArgError if no coupled model is opened.
+         */
+        void writeInputConnection(const std::string& port,
+                                  const std::string& dst,
+                                  const std::string& dstport);
+
+        /**
+         * @brief Write a connection from a submodel to an output port of
+         * the current coupled model.
+         * @throw utils::ArgError if no coupled model is opened.
+         */
+        void writeOutputConnection(const std::string& src,
+                                   const std::string& srcport,
+                                   const std::string& port);
+
+        /**
+         * @brief Close the current coupled model. Closing the top coupled
+         * model closes the structures.
+         * @throw utils::ArgError if no coupled model is opened.
+         */
+        void endCoupledModel();
+
+        /**
+         * @brief Write the dynamics after the structures.
+         * @throw utils::ArgError if the structures are not closed.
+         */
+        void writeDynamics(const Dynamics& dynamics);
+
+        /**
+         * @brief Write the classes after the dynamics.
+         * @throw utils::ArgError if the structures are not closed.
+         */
+        void writeClasses(const Classes& classes);
+
+        /**
+         * @brief Open the experiment element.
+         * @param name The name of the experiment.
+         * @param duration The duration of the experiment.
+         * @param begin The begin date of the experiment.
+         * @param combination The combination of the experiment, "linear",
+         * "total" or empty.
+         * @throw utils::ArgError if the name is empty or the combination
+         * unknown, or if the experiment cannot be opened here.
+         */
+        void beginExperiment(const std::string& name,
+                             double duration,
+                             double begin = 0.0,
+                             const std::string& combination = "linear");
+
+        /**
+         * @brief Open a condition into the experiment.
+         * @param name The name of the condition.
+         * @throw utils::ArgError if no experiment is opened.
+         */
+        void beginCondition(const std::string& name);
+
+        /**
+         * @brief Write a port of the current condition with one value.
+         * @param port The name of the port.
+         * @param value The value to write.
+         * @throw utils::ArgError if no condition is opened.
+         */
+        void writeConditionPort(const std::string& port,
+                                const value::Value& value);
+
+        /**
+         * @brief Close the current condition.
+         * @throw utils::ArgError if no condition is opened.
+         */
+        void endCondition();
+
+        /**
+         * @brief Write an already built condition into the experiment.
+         * @throw utils::ArgError if no experiment is opened.
+         */
+        void writeCondition(const Condition& condition);
+
+        /**
+         * @brief Write the views of the experiment. No condition can be
+         * written after the views.
+         * @throw utils::ArgError if no experiment is opened.
+         */
+        void writeViews(const Views& views);
+
+        /**
+         * @brief Close the experiment.
+         * @throw utils::ArgError if no experiment is opened.
+         */
+        void endExperiment();
+
+        /**
+         * @brief Close the vle_project and flush the output. If the writer
+         * opened the file, the file is closed.
+         * @throw utils::ArgError if the document is not complete.
+         * @throw utils::FileError if the file cannot be written.
+         */
+        void close();
+
+    private:
+        VpzWriter(const VpzWriter& other);
+        VpzWriter& operator=(const VpzWriter& other);
+
+        class Pimpl;
+        Pimpl* m_pimpl;
+    };
+
+}} // namespace vle vpz
+
+#endif
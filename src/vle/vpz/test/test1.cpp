@@ -50,6 +50,8 @@
 #include <vle/vle.hpp>
 #include <limits>
 #include <fstream>
+#include <sstream>
+#include <clocale>
 
 struct F
 {
@@ -334,6 +336,80 @@ BOOST_AUTO_TEST_CASE(value_table)
 }
 
 
+BOOST_AUTO_TEST_CASE(value_double_conversion)
+{
+    const char* locales[] = { "fr_FR.UTF-8", "de_DE.UTF-8", "fr_FR", 0 };
+    for (const char** it = locales; *it; ++it) {
+        if (std::setlocale(LC_ALL, *it)) {
+            break;
+        }
+    }
+
+    BOOST_REQUIRE_EQUAL(vpz::xmlCharToDouble((const xmlChar*)"1.5"), 1.5);
+    BOOST_REQUIRE_EQUAL(vpz::xmlCharToDouble((const xmlChar*)" -0.25"),
+                        -0.25);
+    BOOST_REQUIRE_EQUAL(vpz::xmlCharToDouble((const xmlChar*)"0.1"), 0.1);
+    BOOST_REQUIRE_EQUAL(
+        vpz::xmlCharToDouble((const xmlChar*)"1.200000000000000"), 1.2);
+    BOOST_REQUIRE_EQUAL(vpz::xmlCharToDouble((const xmlChar*)"1e-5"), 1e-5);
+    BOOST_REQUIRE_EQUAL(vpz::xmlCharToDouble((const xmlChar*)"2.5E+3"),
+                        2500.0);
+    BOOST_REQUIRE_EQUAL(
+        vpz::xmlCharToDouble((const xmlChar*)"0.30000000000000004441"),
+        0.30000000000000004441);
+    BOOST_REQUIRE_EQUAL(
+        vpz::xmlCharToDouble((const xmlChar*)"1.7976931348623157e308"),
+        std::numeric_limits < double >::max());
+    BOOST_REQUIRE_EQUAL(vpz::xmlCharToDouble((const xmlChar*)"-inf"),
+                        -std::numeric_limits < double >::infinity());
+    BOOST_REQUIRE_THROW(vpz::xmlCharToDouble((const xmlChar*)"abc"),
+                        utils::SaxParserError);
+
+    const char* t1 = "<?xml version=\"1.0\"?>\n"
+        "<tuple>1.5\n\t 2.25  3e2 4.5abc</tuple>\n";
+
+    value::Tuple* v = value::toTupleValue(vpz::Vpz::parseValue(t1));
+    BOOST_REQUIRE_EQUAL(v->size(), (size_t)4);
+    BOOST_REQUIRE_EQUAL(v->operator[](0), 1.5);
+    BOOST_REQUIRE_EQUAL(v->operator[](1), 2.25);
+    BOOST_REQUIRE_EQUAL(v->operator[](2), 300.0);
+    BOOST_REQUIRE_EQUAL(v->operator[](3), 4.5);
+    delete v;
+
+    std::setlocale(LC_ALL, "C");
+}
+
+BOOST_AUTO_TEST_CASE(value_table_large)
+{
+    const value::Table::index width = 100;
+    const value::Table::index height = 500;
+
+    std::ostringstream out;
+    out << "<?xml version=\"1.0\"?>\n"
+        << "<table width=\"" << width << "\" height=\"" << height << "\">";
+    for (value::Table::index j = 0; j < height; ++j) {
+        for (value::Table::index i = 0; i < width; ++i) {
+            out << (j * width + i) * 0.5 << ' ';
+        }
+        out << '\n';
+    }
+    out << "</table>";
+
+    value::Table* v = value::toTableValue(vpz::Vpz::parseValue(out.str()));
+    BOOST_REQUIRE_EQUAL(v->width(), width);
+    BOOST_REQUIRE_EQUAL(v->height(), height);
+    for (value::Table::index j = 0; j < height; ++j) {
+        for (value::Table::index i = 0; i < width; ++i) {
+            BOOST_REQUIRE_EQUAL(v->get(i, j), (j * width + i) * 0.5);
+        }
+    }
+    delete v;
+
+    const char* t2 = "<?xml version=\"1.0\"?>\n"
+        "<table width=\"2\" height=\"2\">1 2 3 4 5</table>\n";
+    BOOST_REQUIRE_THROW(vpz::Vpz::parseValue(t2), std::exception);
+}
+
 BOOST_AUTO_TEST_CASE(value_table_map)
 {
     const char* t1 = "<?xml version=\"1.0\"?>\n"
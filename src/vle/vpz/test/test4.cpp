@@ -34,12 +34,16 @@
 #include <boost/test/output_test_stream.hpp>
 #include <boost/test/floating_point_comparison.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 #include <iostream>
+#include <cstdio>
 #include <vle/value/Value.hpp>
 #include <vle/value/Map.hpp>
 #include <vle/value/Integer.hpp>
 #include <vle/value/Double.hpp>
 #include <vle/vpz/Vpz.hpp>
+#include <vle/vpz/CompiledVpz.hpp>
+#include <vle/vpz/VpzWriter.hpp>
 #include <vle/vpz/AtomicModel.hpp>
 #include <vle/vpz/CoupledModel.hpp>
 #include <vle/utils/Path.hpp>
@@ -804,6 +808,150 @@ BOOST_AUTO_TEST_CASE(test_read_write_read)
     check_unittest_vpz(vpz);
 }
 
+BOOST_AUTO_TEST_CASE(test_read_write_compiled)
+{
+    vpz::Vpz vpz;
+    vpz.parseFile(utils::Path::path().getTemplate("unittest.vpz"));
+    check_unittest_vpz(vpz);
+
+    std::string xml(vpz.writeToString());
+    std::ostringstream out;
+    vpz::CompiledVpz::write(vpz, out);
+    delete vpz.project().model().model();
+    vpz.clear();
+
+    std::string str(out.str());
+    BOOST_REQUIRE(vpz::CompiledVpz::isCompiled(str.data(), str.size()));
+
+    vpz::CompiledVpz::read(vpz, str.data(), str.size());
+    check_unittest_vpz(vpz);
+    BOOST_REQUIRE_EQUAL(vpz.writeToString().size(), xml.size());
+    delete vpz.project().model().model();
+    vpz.clear();
+
+    BOOST_REQUIRE_THROW(vpz::CompiledVpz::read(vpz, str.data(),
+                                               str.size() / 2),
+                        utils::FileError);
+    vpz.clear();
+}
+
+BOOST_AUTO_TEST_CASE(test_experiment_seed)
+{
+    vpz::Vpz vpz;
+    vpz.parseFile(utils::Path::path().getTemplate("unittest.vpz"));
+    vpz.project().experiment().setSeed(123456789u);
+
+    std::string xml(vpz.writeToString());
+    std::ostringstream out;
+    vpz::CompiledVpz::write(vpz, out);
+    delete vpz.project().model().model();
+    vpz.clear();
+    BOOST_REQUIRE_EQUAL(vpz.project().experiment().seed(), 0u);
+
+    vpz.parseMemory(xml);
+    BOOST_REQUIRE_EQUAL(vpz.project().experiment().seed(), 123456789u);
+    delete vpz.project().model().model();
+    vpz.clear();
+
+    std::string str(out.str());
+    vpz::CompiledVpz::read(vpz, str.data(), str.size());
+    BOOST_REQUIRE_EQUAL(vpz.project().experiment().seed(), 123456789u);
+    delete vpz.project().model().model();
+    vpz.clear();
+}
+
+BOOST_AUTO_TEST_CASE(test_write_streaming)
+{
+    vpz::Vpz vpz;
+    vpz.parseFile(utils::Path::path().getTemplate("unittest.vpz"));
+    const vpz::Project& project(vpz.project());
+
+    std::ostringstream out;
+    vpz::VpzWriter writer(out);
+    writer.beginProject(project.author(), project.version(), project.date());
+    writer.writeModel(*project.model().model());
+    writer.writeDynamics(project.dynamics());
+    writer.writeClasses(project.classes());
+    writer.beginExperiment(project.experiment().name(),
+                           project.experiment().duration(),
+                           project.experiment().begin(),
+                           project.experiment().combination());
+
+    const vpz::ConditionList& cnds(
+        project.experiment().conditions().conditionlist());
+    for (vpz::ConditionList::const_iterator it = cnds.begin();
+         it != cnds.end(); ++it) {
+        writer.writeCondition(it->second);
+    }
+    writer.writeViews(project.experiment().views());
+    writer.endExperiment();
+    writer.close();
+
+    delete vpz.project().model().model();
+    vpz.clear();
+
+    vpz.parseMemory(out.str());
+    check_unittest_vpz(vpz);
+    delete vpz.project().model().model();
+}
+
+BOOST_AUTO_TEST_CASE(test_write_streaming_generated)
+{
+    std::string filename(utils::Path::buildTemp("vpzwriter.vpz.gz"));
+
+    {
+        std::vector < std::string > ports(1, "p");
+
+        vpz::VpzWriter writer(filename, 9);
+        writer.beginProject("vle");
+        writer.beginCoupledModel("top", ports, ports);
+        BOOST_REQUIRE_THROW(writer.endExperiment(), utils::ArgError);
+        for (int i = 0; i < 100; ++i) {
+            std::string name("m" + boost::lexical_cast < std::string >(i));
+            writer.writeAtomicModel(name, "dyn",
+                                    std::vector < std::string >(1, "cnd"),
+                                    std::string(), ports, ports);
+        }
+        writer.writeInputConnection("p", "m0", "p");
+        for (int i = 1; i < 100; ++i) {
+            writer.writeInternalConnection(
+                "m" + boost::lexical_cast < std::string >(i - 1), "p",
+                "m" + boost::lexical_cast < std::string >(i), "p");
+        }
+        writer.writeOutputConnection("m99", "p", "p");
+        BOOST_REQUIRE_THROW(writer.writeAtomicModel("x", "dyn"),
+                            utils::ArgError);
+        writer.endCoupledModel();
+
+        vpz::Dynamics dynamics;
+        dynamics.add(vpz::Dynamic("dyn"));
+        writer.writeDynamics(dynamics);
+        writer.beginExperiment("exp", 10.0);
+        writer.beginCondition("cnd");
+        writer.writeConditionPort("x", value::Double(1.5));
+        writer.endCondition();
+        writer.endExperiment();
+        writer.close();
+    }
+
+    vpz::Vpz vpz(filename);
+    vpz::CoupledModel* top(vpz.project().model().model()->toCoupled());
+    BOOST_REQUIRE(top);
+    BOOST_REQUIRE_EQUAL(top->getModelList().size(), (size_t)100);
+
+    vpz::ModelPortList lst;
+    top->findModel("m0")->getAtomicModelsTarget("p", lst);
+    BOOST_REQUIRE_EQUAL(lst.size(), (vpz::ModelPortList::size_type)1);
+    BOOST_REQUIRE_EQUAL(lst.begin()->first->getName(), "m1");
+
+    const vpz::Condition& cnd(
+        vpz.project().experiment().conditions().get("cnd"));
+    BOOST_REQUIRE_CLOSE(value::toDouble(cnd.firstValue("x")), 1.5, 1e-10);
+
+    delete vpz.project().model().model();
+    std::remove(filename.c_str());
+}
+
 BOOST_AUTO_TEST_CASE(test_read_write_read2)
 {
     vpz::Vpz vpz;
@@ -36,13 +36,21 @@
 #include <stdexcept>
 #include <limits>
 #include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <set>
 #include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/ClassModel.hpp>
+#include <vle/vpz/CompiledVpz.hpp>
 #include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/LatticeModel.hpp>
+#include <vle/vpz/ModelPortList.hpp>
 #include <vle/utils/Path.hpp>
 #include <vle/utils/Trace.hpp>
 #include <vle/value/Value.hpp>
 #include <vle/vpz/Vpz.hpp>
 #include <vle/vpz/Vpz.hpp>
+#include <vle/translator/MatrixTranslator.hpp>
 #include <vle/vle.hpp>
 
 struct F
@@ -783,3 +791,469 @@ BOOST_AUTO_TEST_CASE(test_name)
     BOOST_REQUIRE_EQUAL(a->getCompleteName(), "top,top2,g");
     BOOST_REQUIRE_EQUAL(b->getCompleteName(), "top,top1,x");
 }
+
+BOOST_AUTO_TEST_CASE(test_model_port_list)
+{
+    CoupledModel* top = new CoupledModel("top", 0);
+    AtomicModel* models[3] = { top->addAtomicModel("a"),
+        top->addAtomicModel("b"), top->addAtomicModel("c") };
+    std::sort(models, models + 3);
+    AtomicModel* a = models[0];
+    AtomicModel* b = models[1];
+    AtomicModel* c = models[2];
+
+    ModelPortList lst;
+    lst.add(c, "in2");
+    lst.add(a, "in1");
+    lst.add(c, "in1");
+    lst.add(b, "in1");
+    lst.add(a, "in2");
+    BOOST_REQUIRE_EQUAL(lst.size(), 5u);
+
+    /* sorted by model, the ports of a model in the order of insertion. */
+    ModelPortList::const_iterator it = lst.begin();
+    BOOST_REQUIRE(it->first == a and it->second == "in1"); ++it;
+    BOOST_REQUIRE(it->first == a and it->second == "in2"); ++it;
+    BOOST_REQUIRE(it->first == b and it->second == "in1"); ++it;
+    BOOST_REQUIRE(it->first == c and it->second == "in2"); ++it;
+    BOOST_REQUIRE(it->first == c and it->second == "in1"); ++it;
+    BOOST_REQUIRE(it == lst.end());
+
+    BOOST_REQUIRE(lst.exist(c, "in1"));
+    BOOST_REQUIRE(not lst.exist(b, "in2"));
+
+    lst.remove(a, "in1");
+    BOOST_REQUIRE(not lst.exist(a, "in1"));
+    BOOST_REQUIRE(lst.exist(a, "in2"));
+    lst.erase(c);
+    BOOST_REQUIRE_EQUAL(lst.size(), 2u);
+
+    ModelPortList other;
+    other.add(a, "in3");
+    other.add(c, "in3");
+    lst.merge(other);
+    BOOST_REQUIRE_EQUAL(lst.size(), 4u);
+    it = lst.begin();
+    BOOST_REQUIRE(it->first == a and it->second == "in2"); ++it;
+    BOOST_REQUIRE(it->first == a and it->second == "in3"); ++it;
+    BOOST_REQUIRE(it->first == b); ++it;
+    BOOST_REQUIRE(it->first == c);
+
+    delete top;
+}
+
+BOOST_AUTO_TEST_CASE(test_model_port_list_hub)
+{
+    CoupledModel* top = new CoupledModel("top", 0);
+    std::vector < AtomicModel* > models;
+
+    for (int i = 0; i < 1000; ++i) {
+        models.push_back(top->addAtomicModel((fmt("m%1%") % i).str()));
+    }
+    std::sort(models.begin(), models.end());
+
+    /* the hub receives the models in the reverse order of the addresses,
+     * the other list is merged before any read. */
+    ModelPortList hub, other;
+    for (int i = 999; i >= 0; --i) {
+        hub.add(models[i], "in");
+        hub.add(models[i], "in2");
+    }
+    other.add(models[500], "in3");
+    other.add(models[0], "in3");
+    hub.merge(other);
+    BOOST_REQUIRE_EQUAL(hub.size(), 2002u);
+
+    ModelPortList::const_iterator it = hub.begin();
+    BOOST_REQUIRE(it->first == models[0] and it->second == "in"); ++it;
+    BOOST_REQUIRE(it->first == models[0] and it->second == "in2"); ++it;
+    BOOST_REQUIRE(it->first == models[0] and it->second == "in3");
+    for (it = hub.begin() + 1; it != hub.end(); ++it) {
+        BOOST_REQUIRE(not (it->first < (it - 1)->first));
+    }
+    BOOST_REQUIRE(hub.exist(models[500], "in3"));
+    BOOST_REQUIRE(hub.exist(models[999], "in2"));
+
+    hub.add(models[10], "in4");
+    BOOST_REQUIRE(hub.exist(models[10], "in4"));
+    BOOST_REQUIRE((hub.begin() + 23)->second == "in4");
+
+    delete top;
+}
+
+BOOST_AUTO_TEST_CASE(test_interned_names)
+{
+    CoupledModel* top = new CoupledModel("top", 0);
+    AtomicModel* a = top->addAtomicModel("a");
+    AtomicModel* b = top->addAtomicModel(std::string("b"));
+    a->addOutputPort("out");
+    b->addInputPort("in");
+    top->addInternalConnection("a", "out", "b", "in");
+
+    ModelList::const_iterator it = top->getModelList().find("a");
+    BOOST_REQUIRE(it != top->getModelList().end());
+    BOOST_REQUIRE(it->second == a);
+    BOOST_REQUIRE(&it->first.str() == &a->getName());
+
+    ConnectionList::const_iterator jt = b->getInputPortList().find("in");
+    BOOST_REQUIRE(jt != b->getInputPortList().end());
+    BOOST_REQUIRE(&jt->first.str() == &utils::Symbol("in").str());
+
+    BaseModel::rename(a, "c");
+    BOOST_REQUIRE(top->getModelList().find("a") == top->getModelList().end());
+    BOOST_REQUIRE(top->findModel("c") == a);
+    BOOST_REQUIRE(&a->getName() == &utils::Symbol("c").str());
+    BOOST_REQUIRE(top->getModelList().begin()->first == "b");
+
+    delete top;
+}
+
+BOOST_AUTO_TEST_CASE(test_class_model)
+{
+    /* the class: in -> a -> b -> out and b -> sub/c. */
+    CoupledModel* cls = new CoupledModel("cls", 0);
+    cls->addInputPort("in");
+    cls->addOutputPort("out");
+    AtomicModel* a = cls->addAtomicModel("a");
+    AtomicModel* b = cls->addAtomicModel("b");
+    CoupledModel* sub = cls->addCoupledModel("sub");
+    AtomicModel* c = sub->addAtomicModel("c");
+    a->addInputPort("in");
+    a->addOutputPort("out");
+    b->addInputPort("in");
+    b->addOutputPort("out");
+    c->addInputPort("in");
+    sub->addInputPort("in");
+    sub->addInputConnection("in", c, "in");
+    cls->addInputConnection("in", a, "in");
+    cls->addInternalConnection(a, "out", b, "in");
+    cls->addInternalConnection(b, "out", sub, "in");
+    cls->addOutputConnection(b, "out", "out");
+
+    CoupledModel* top = new CoupledModel("top", 0);
+    ClassModel* i1 = new ClassModel("i1", top, cls);
+    ClassModel* i2 = new ClassModel("i2", top, cls);
+    top->addInternalConnection(i1, "out", i2, "in");
+
+    BOOST_REQUIRE(i1->isClass() and i1->classModel() == cls);
+    BOOST_REQUIRE(i1->findModel("sub")->isClass());
+    BaseModel* a1 = i1->findModel("a");
+    BaseModel* b1 = i1->findModel("b");
+    BaseModel* c1 = i1->findModel("sub")->toCoupled()->findModel("c");
+    BaseModel* a2 = i2->findModel("a");
+    BaseModel* c2 = i2->findModel("sub")->toCoupled()->findModel("c");
+    BOOST_REQUIRE(a1 and a1 != a and b1 and c1 and a2 and c2);
+    BOOST_REQUIRE_EQUAL(a1->getOutPort("out").size(), 0u);
+    BOOST_REQUIRE_EQUAL(i1->getInternalInPort("in").size(), 0u);
+
+    ModelPortList lst;
+    a1->getAtomicModelsTarget("out", lst);
+    BOOST_REQUIRE_EQUAL(lst.size(), 1u);
+    BOOST_REQUIRE(lst.exist(b1, "in"));
+
+    lst.clear();
+    b1->getAtomicModelsTarget("out", lst);
+    BOOST_REQUIRE_EQUAL(lst.size(), 2u);
+    BOOST_REQUIRE(lst.exist(a2, "in"));
+    BOOST_REQUIRE(lst.exist(c1, "in"));
+
+    lst.clear();
+    a2->getAtomicModelsSource("in", lst);
+    BOOST_REQUIRE_EQUAL(lst.size(), 1u);
+    BOOST_REQUIRE(lst.exist(b1, "out"));
+
+    lst.clear();
+    c2->getAtomicModelsSource("in", lst);
+    BOOST_REQUIRE_EQUAL(lst.size(), 1u);
+    BOOST_REQUIRE(lst.exist(i2->findModel("b"), "out"));
+
+    /* the instance is written as a copy of the class. */
+    CoupledModel* copy = static_cast < CoupledModel* >(cls->clone());
+    BaseModel::rename(copy, "i1");
+    std::ostringstream expected, written, cloned;
+    copy->writeXML(expected);
+    i1->writeXML(written);
+    BaseModel* clone = i1->clone();
+    BOOST_REQUIRE(clone->isClass());
+    clone->writeXML(cloned);
+    BOOST_REQUIRE_EQUAL(written.str(), expected.str());
+    BOOST_REQUIRE_EQUAL(cloned.str(), expected.str());
+    delete clone;
+    delete copy;
+
+    /* after expand, the connections are stored into the instance. */
+    i1->expand();
+    BOOST_REQUIRE(not i1->isClass());
+    BOOST_REQUIRE(i1->findModel("sub")->isClass());
+    BOOST_REQUIRE_EQUAL(a1->getOutPort("out").size(), 1u);
+    BOOST_REQUIRE_EQUAL(i1->getInternalInPort("in").size(), 1u);
+    lst.clear();
+    b1->getAtomicModelsTarget("out", lst);
+    BOOST_REQUIRE_EQUAL(lst.size(), 2u);
+    BOOST_REQUIRE(lst.exist(a2, "in"));
+    BOOST_REQUIRE(lst.exist(c1, "in"));
+
+    delete top;
+    delete cls;
+}
+
+BOOST_AUTO_TEST_CASE(test_lattice)
+{
+    const char* ports[8] = { "N", "S", "W", "E", "NW", "NE", "SW", "SE" };
+    CoupledModel* top = new CoupledModel("top", 0);
+    LatticeModel* grid = new LatticeModel("grid", top, 3, 4);
+    grid->setNeighbourhood(LatticeModel::MOORE, false);
+
+    for (unsigned int i = 0; i < 3; ++i) {
+        for (unsigned int j = 0; j < 4; ++j) {
+            AtomicModel* cell = grid->addCell(
+                i, j, (fmt("c_%1%_%2%") % i % j).str());
+            cell->addOutputPort("out");
+            for (int k = 0; k < 8; ++k) {
+                cell->addInputPort(ports[k]);
+            }
+        }
+    }
+
+    BOOST_REQUIRE_THROW(grid->addCell(1, 1, "other"), utils::DevsGraphError);
+    BOOST_REQUIRE_THROW(grid->addCell(3, 0, "other"), utils::DevsGraphError);
+    BOOST_REQUIRE(grid->isLattice());
+    BOOST_REQUIRE(not top->isLattice());
+
+    AtomicModel* center = grid->cell(1, 1);
+    AtomicModel* corner = grid->cell(0, 0);
+    unsigned int row, column;
+    BOOST_REQUIRE(grid->findCell(grid->cell(2, 3), row, column));
+    BOOST_REQUIRE_EQUAL(row, 2u);
+    BOOST_REQUIRE_EQUAL(column, 3u);
+    BOOST_REQUIRE(not grid->findCell(grid, row, column));
+
+    ModelPortList result;
+    center->getAtomicModelsTarget("out", result);
+    BOOST_REQUIRE_EQUAL(result.size(), (size_t)8);
+    BOOST_REQUIRE(result.exist(grid->cell(0, 1), "S"));
+    BOOST_REQUIRE(result.exist(grid->cell(2, 2), "NW"));
+    result.clear();
+
+    corner->getAtomicModelsTarget("out", result);
+    BOOST_REQUIRE_EQUAL(result.size(), (size_t)3);
+    result.clear();
+
+    corner->getAtomicModelsSource("S", result);
+    BOOST_REQUIRE_EQUAL(result.size(), (size_t)1);
+    BOOST_REQUIRE(result.exist(grid->cell(1, 0), "out"));
+    result.clear();
+
+    CoupledModel::StringList lst;
+    grid->getLatticeConnections(lst);
+    BOOST_REQUIRE_EQUAL(lst.size(), (size_t)(58 * 4));
+
+    grid->setWrap(true, true);
+    corner->getAtomicModelsTarget("out", result);
+    BOOST_REQUIRE_EQUAL(result.size(), (size_t)8);
+    BOOST_REQUIRE(result.exist(grid->cell(2, 3), "SE"));
+    result.clear();
+
+    double* heat = grid->addField("heat", 1.0);
+    double* next = grid->addField("next");
+    BOOST_REQUIRE_THROW(grid->addField("heat"), utils::ArgError);
+    BOOST_REQUIRE_THROW(grid->field("unknown"), utils::ArgError);
+    heat[grid->index(1, 2)] = 3.0;
+    grid->swapFields("heat", "next");
+    BOOST_REQUIRE_EQUAL(grid->field("next")[grid->index(1, 2)], 3.0);
+    BOOST_REQUIRE_EQUAL(grid->field("heat"), next);
+
+    CoupledModel* copy = static_cast < CoupledModel* >(top->clone());
+    LatticeModel* grid2 = static_cast < LatticeModel* >(
+        copy->findModel("grid"));
+    BOOST_REQUIRE(grid2->isLattice());
+    BOOST_REQUIRE(grid2->cell(1, 1) != center);
+    BOOST_REQUIRE_EQUAL(grid2->cell(1, 1)->getName(), "c_1_1");
+    BOOST_REQUIRE_EQUAL(grid2->field("next")[grid2->index(1, 2)], 3.0);
+    grid2->cell(1, 1)->getAtomicModelsTarget("out", result);
+    BOOST_REQUIRE_EQUAL(result.size(), (size_t)8);
+    result.clear();
+    delete copy;
+
+    grid->delModel(center);
+    BOOST_REQUIRE(not grid->cell(1, 1));
+    corner->getAtomicModelsTarget("out", result);
+    BOOST_REQUIRE_EQUAL(result.size(), (size_t)7);
+    result.clear();
+
+    std::ostringstream out;
+    grid->writeXML(out);
+    BOOST_REQUIRE(out.str().find("<origin model=\"c_0_0\" port=\"out\" />")
+                  != std::string::npos);
+
+    grid->setNeighbourhood(LatticeModel::VON_NEUMANN, true);
+    grid->setWrap(false, false);
+    grid->cell(0, 1)->addOutputPort("S");
+    grid->cell(0, 1)->getAtomicModelsTarget("S", result);
+    BOOST_REQUIRE_EQUAL(result.size(), (size_t)0);
+    grid->cell(0, 2)->addOutputPort("S");
+    grid->cell(0, 2)->getAtomicModelsTarget("S", result);
+    BOOST_REQUIRE_EQUAL(result.size(), (size_t)1);
+    BOOST_REQUIRE(result.exist(grid->cell(1, 2), "N"));
+
+    delete top;
+}
+
+static std::set < std::string > targets(AtomicModel* model,
+                                        const std::string& port)
+{
+    ModelPortList result;
+    std::set < std::string > names;
+
+    model->getAtomicModelsTarget(port, result);
+    for (ModelPortList::const_iterator it = result.begin();
+         it != result.end(); ++it) {
+        names.insert(it->first->getName() + ":" + it->second.str());
+    }
+    return names;
+}
+
+BOOST_AUTO_TEST_CASE(test_lattice_compiled)
+{
+    Vpz vpz;
+    CoupledModel* top = new CoupledModel("top", 0);
+    LatticeModel* grid = new LatticeModel("grid", top, 3, 4);
+    vpz.project().model().setModel(top);
+    grid->setNeighbourhood(LatticeModel::MOORE, false);
+    grid->addNeighbour(0, 2, "far", "W");
+    grid->setWrap(true, false);
+
+    for (unsigned int i = 0; i < 3; ++i) {
+        for (unsigned int j = 0; j < 4; ++j) {
+            if (i != 1 or j != 2) {
+                AtomicModel* cell = grid->addCell(
+                    i, j, (fmt("c_%1%_%2%") % i % j).str());
+                cell->addOutputPort("out");
+                cell->addOutputPort("far");
+                cell->addInputPort("W");
+                cell->addInputPort("S");
+            }
+        }
+    }
+    AtomicModel* sink = grid->addAtomicModel("sink");
+    sink->addInputPort("in");
+    grid->addInternalConnection("c_0_0", "out", "sink", "in");
+    grid->addField("heat", 1.5)[grid->index(2, 3)] = 4.0;
+
+    BOOST_REQUIRE_THROW(grid->setCell(1, 2, 0), utils::DevsGraphError);
+    BOOST_REQUIRE_THROW(grid->setCell(1, 2, grid->cell(0, 0)),
+                        utils::DevsGraphError);
+    BOOST_REQUIRE_THROW(grid->setCell(0, 0, sink), utils::DevsGraphError);
+
+    std::ostringstream out;
+    CompiledVpz::write(vpz, out);
+    std::string str(out.str());
+    vpz.clear();
+    delete top;
+
+    CompiledVpz::read(vpz, str.data(), str.size());
+    CoupledModel* top2 = static_cast < CoupledModel* >(
+        vpz.project().model().model());
+    BaseModel* mdl = top2->findModel("grid");
+    BOOST_REQUIRE(mdl and mdl->isLattice());
+    LatticeModel* grid2 = static_cast < LatticeModel* >(mdl);
+
+    BOOST_REQUIRE_EQUAL(grid2->rows(), 3u);
+    BOOST_REQUIRE_EQUAL(grid2->columns(), 4u);
+    BOOST_REQUIRE(grid2->wrapRows());
+    BOOST_REQUIRE(not grid2->wrapColumns());
+    BOOST_REQUIRE_EQUAL(grid2->stencil().size(), 9u);
+    BOOST_REQUIRE_EQUAL(grid2->stencil().back().column, 2);
+    BOOST_REQUIRE_EQUAL(grid2->stencil().back().output, "far");
+    BOOST_REQUIRE(not grid2->cell(1, 2));
+    BOOST_REQUIRE_EQUAL(grid2->cell(2, 3)->getName(), "c_2_3");
+    BOOST_REQUIRE_EQUAL(grid2->field("heat")[grid2->index(2, 3)], 4.0);
+    BOOST_REQUIRE_EQUAL(grid2->field("heat")[0], 1.5);
+
+    /* only the explicit connection is stored into the ports. */
+    BOOST_REQUIRE_EQUAL(grid2->cell(0, 0)->getOutPort("out").size(), 1u);
+    BOOST_REQUIRE_EQUAL(grid2->cell(0, 1)->getOutPort("out").size(), 0u);
+
+    std::set < std::string > expected;
+    expected.insert("c_2_0:S");
+    expected.insert("c_0_1:W");
+    expected.insert("sink:in");
+    BOOST_REQUIRE(targets(grid2->cell(0, 0), "out") == expected);
+    expected.clear();
+    expected.insert("c_0_2:W");
+    BOOST_REQUIRE(targets(grid2->cell(0, 0), "far") == expected);
+
+    delete top2;
+    vpz.clear();
+}
+
+BOOST_AUTO_TEST_CASE(test_lattice_translator)
+{
+    /* The connections of MatrixTranslator::translateSymmetricConnection2D
+     * for the cell (i, j). */
+    const int offsets[8][2] = {
+        { 0, -1 }, { -1, 0 }, { 0, 1 }, { 1, 0 },
+        { -1, -1 }, { -1, 1 }, { 1, -1 }, { 1, 1 } };
+    const char* outputs[8] = { "W", "N", "E", "S", "SW", "SE", "NW", "NE" };
+    const char* inputs[8] = { "E", "S", "W", "N", "SE", "SW", "NE", "NW" };
+    const char* ports[8] = { "N", "S", "W", "E", "NW", "NE", "SW", "SE" };
+
+    for (int symmetric = 0; symmetric < 2; ++symmetric) {
+        CoupledModel* top = new CoupledModel("top", 0);
+        CoupledModel* explicitgrid = new CoupledModel("explicit", top);
+        LatticeModel* grid = new LatticeModel("grid", top, 3, 3);
+        translator::MatrixTranslator::setNeighbours(grid, 8, symmetric);
+
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                std::string name((fmt("c_%1%_%2%") % i % j).str());
+                AtomicModel* a = explicitgrid->addAtomicModel(name);
+                AtomicModel* b = grid->addCell(i, j, name);
+                a->addOutputPort("out");
+                b->addOutputPort("out");
+                for (int k = 0; k < 8; ++k) {
+                    a->addInputPort(ports[k]);
+                    a->addOutputPort(ports[k]);
+                    b->addInputPort(ports[k]);
+                    b->addOutputPort(ports[k]);
+                }
+            }
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                for (int k = 0; k < 8; ++k) {
+                    int x = i + offsets[k][0];
+                    int y = j + offsets[k][1];
+                    if (x >= 0 and x < 3 and y >= 0 and y < 3) {
+                        explicitgrid->addInternalConnection(
+                            (fmt("c_%1%_%2%") % i % j).str(),
+                            symmetric ? outputs[k] : "out",
+                            (fmt("c_%1%_%2%") % x % y).str(), inputs[k]);
+                    }
+                }
+            }
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                AtomicModel* a = static_cast < AtomicModel* >(
+                    explicitgrid->findModel((fmt("c_%1%_%2%") % i % j).str()));
+                AtomicModel* b = grid->cell(i, j);
+
+                BOOST_REQUIRE(targets(a, "out") == targets(b, "out"));
+                for (int k = 0; k < 8; ++k) {
+                    BOOST_REQUIRE(targets(a, ports[k]) ==
+                                  targets(b, ports[k]));
+                }
+            }
+        }
+
+        std::set < std::string > center(
+            targets(grid->cell(1, 1), symmetric ? "SW" : "out"));
+        BOOST_REQUIRE(center.count("c_0_0:SE"));
+        BOOST_REQUIRE_EQUAL(center.size(), (size_t)(symmetric ? 1 : 8));
+
+        delete top;
+    }
+}